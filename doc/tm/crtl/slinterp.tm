@@ -755,6 +755,34 @@
 \seealso{SLexecute_function}
 \done
 
+\function{SLang_get_function_id}
+\synopsis{Get a number that identifies the definition of a function}
+\usage{unsigned long SLang_get_function_id (SLang_Name_Type *nt)}
+\description
+  This function returns a non-zero number that identifies the current
+  definition of the \slang function \var{nt}.  The number changes
+  when the function is redefined.  It returns 0 if \var{nt} is not a
+  function defined by \slang code, or if the function has not been
+  loaded yet.  Since a process created by \var{fork} inherits the
+  functions of its parent, the number may be passed to the child
+  process and given to \var{SLang_get_function_from_id} to find the
+  same definition there.
+\seealso{SLang_get_function_from_id, SLang_get_function}
+\done
+
+\function{SLang_get_function_from_id}
+\synopsis{Find a function by its name and id}
+\usage{SLang_Name_Type *SLang_get_function_from_id (char *name, unsigned long id)}
+\description
+  This function searches all namespaces, including the private ones,
+  for a function called \var{name} whose definition has the id
+  \var{id} returned by \var{SLang_get_function_id}.  The name must
+  not be qualified by a namespace.  It returns \var{NULL} if there is
+  no such function, e.g., because the function was defined or
+  redefined after the process was forked.
+\seealso{SLang_get_function_id, SLang_get_function}
+\done
+
 \function{SLexecute_function}
 \synopsis{Execute a \slang or intrinsic function}
 \usage{int SLexecute_function (SLang_Name_Type *nt)}
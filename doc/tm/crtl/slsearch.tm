@@ -58,7 +58,10 @@
   The length of the object may be obtained via the
   \cfun{SLsearch_match_len} function.
 \notes
-  This function uses the Boyer-Moore search algorithm when possible.
+  When possible, this function looks for the places where the first and
+  last bytes of a short key occur, and compares the rest of the key only
+  at those places.  Otherwise, it uses the Boyer-Moore search algorithm
+  when possible.
 \seealso{SLsearch_new, SLsearch_backward, SLsearch_delete, SLsearch_match_len}
 \done
 
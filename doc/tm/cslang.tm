@@ -1216,6 +1216,51 @@
 
 #%}}}
 
+\sect{Interpreter Instances} #%{{{
+
+  An application may create additional instances of the interpreter
+  via the \cfun{SLang_create_interp} function.  Each instance has its
+  own stacks and namespaces, and its own values of settings such as
+  \ivar{_auto_declare}.  A new instance starts out with the intrinsic
+  functions, variables, and constants of the current one, but none of
+  its variables or functions.  Hence, the application should
+  initialize the interpreter and add its intrinsics before creating
+  additional instances.  For example, an application that handles
+  independent requests could keep a pool of instances, and use one
+  per request:
+#v+
+    SLang_Interp_Type *interp, *main_interp;
+
+    if (-1 == SLang_init_all ()) exit (1);
+    if (NULL == (interp = SLang_create_interp ())) exit (1);
+      .
+      .
+    main_interp = SLang_get_interp ();
+    (void) SLang_set_interp (interp);
+    if (-1 == SLang_load_string (request))
+      SLang_restart (1);
+    (void) SLang_set_interp (main_interp);
+      .
+      .
+    SLang_free_interp (interp);
+#v-
+  Here, \cfun{SLang_set_interp} makes an instance current, and a
+  \NULL argument refers to the instance that was created when the
+  interpreter was initialized.  An intrinsic function may make another
+  instance current, but it must switch back before returning.  The
+  current instance cannot be freed.
+
+  The data types, the string table, the error state, and signal
+  handlers are shared by all instances.  For this reason, the
+  instances may not be used concurrently: only one instance may be used
+  at a time, and a multi-threaded application must serialize all calls
+  to the library, regardless of which instance each thread uses.
+  Instances isolate the variables and functions of independent scripts,
+  but they do not provide parallelism.  Code that is to run in parallel
+  should be run in separate processes, e.g., via the \var{pool} module.
+
+#%}}}
+
 \sect{Exceptions}
 #%}}}
 
@@ -138,6 +138,89 @@
 \seealso{_get_frame_info, _use_frame_namespace}
 \done
 
+\function{_profile_clear}
+\synopsis{Discard the samples taken by the profiler}
+\usage{_profile_clear ()}
+\description
+  This function discards the samples that have been recorded by the
+  sampling profiler.  It does not stop the profiler.
+\seealso{_profile_start, _profile_stop, _profile_folded}
+\done
+
+\function{_profile_folded}
+\synopsis{Get the stacks sampled by the profiler}
+\usage{(String_Type[] stacks, Int_Type[] counts) = _profile_folded ()}
+\description
+  This function returns the distinct call stacks that were sampled by
+  the profiler in the so-called folded form, together with the number
+  of timer ticks that were counted for each.  The functions in a stack
+  are separated by semicolons with the outermost one first.  Code that
+  is not in a function is represented by \exmp{<top-level>}.
+\qualifiers
+  If the \exmp{lines} qualifier is present, the line number of each
+  frame will be appended to the function name, e.g.,
+  \exmp{slsh_main:12;compute:30}.
+\example
+  The following writes the stacks in the format that is expected by
+  tools that create flame graphs:
+#v+
+    (stacks, counts) = _profile_folded ();
+    () = array_map (Int_Type, &fprintf, fp, "%s %d\n", stacks, counts);
+#v-
+\notes
+  The profiler records at most 128 frames of a stack.  Functions with
+  the same name that are defined in different files or namespaces are
+  not distinguished.
+\seealso{_profile_lines, _profile_start, _profile_clear}
+\done
+
+\function{_profile_lines}
+\synopsis{Get the number of samples taken at each line}
+\usage{(files, lines, counts) = _profile_lines ()}
+\description
+  This function returns the number of timer ticks that the sampling
+  profiler has counted for each line that was being executed when a
+  sample was taken.  The files and line numbers are returned as arrays
+  of type \dtype{String_Type} and \dtype{Int_Type}, and are sorted by file
+  and line.  The time spent in intrinsic functions is attributed to the
+  line that called them.
+\seealso{_profile_folded, _profile_start, _profile_clear}
+\done
+
+\function{_profile_start}
+\synopsis{Start the sampling profiler}
+\usage{_profile_start ([Double_Type interval [, Int_Type max_samples]])}
+\description
+  This function starts a profiler that periodically records the stack
+  of active functions and the line that is being executed.  The
+  samples are driven by a \var{SIGPROF} timer that expires after each
+  \exmp{interval} seconds of CPU time used by the process.  The default
+  interval is 0.01 seconds.  The samples are kept in a buffer that holds
+  at most \exmp{max_samples} of them, and the oldest samples are
+  discarded when it is full.  The default size of the buffer is 20000
+  samples.
+
+  Since the samples are only taken between the bytecodes of the
+  interpreter, the overhead of the profiler is small, and the code
+  does not have to be compiled in a special way.
+\notes
+  The profiler installs its own handler for the \var{SIGPROF} signal,
+  which is restored by \ifun{_profile_stop}.  This function is not
+  available on systems that do not support \ifun{setitimer}.
+\seealso{_profile_stop, _profile_folded, _profile_lines, setitimer}
+\done
+
+\function{_profile_stop}
+\synopsis{Stop the sampling profiler}
+\usage{_profile_stop ()}
+\description
+  This function stops the timer that is used by the sampling profiler
+  and restores the previous \var{SIGPROF} handler.  The samples that have
+  been taken may still be retrieved using \ifun{_profile_folded} and
+  \ifun{_profile_lines}.
+\seealso{_profile_start, _profile_clear}
+\done
+
 \function{_set_bof_handler}
 \synopsis{Set the beginning of function callback handler}
 \usage{_set_bof_handler (Ref_Type func)}
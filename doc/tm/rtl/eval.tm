@@ -23,6 +23,62 @@
 \seealso{eval, getenv}
 \done
 
+\variable{_bytecode_cache}
+\synopsis{Control the use of bytecode images of loaded files}
+\usage{Int_Type _bytecode_cache}
+\description
+  When a file such as \exmp{"site.sl"} is loaded, the interpreter can
+  use a bytecode image of its compiled form in \exmp{site.slc} instead
+  of compiling it.  An image is used only if it was produced by the
+  same version of the library from a file of the same size and
+  modification time.  The value of this variable is a bitmapped value
+  that controls the use of these images as follows:
+#v+
+   Value      Description
+   -----------------------------------------------------------------
+     1        Valid bytecode images will be loaded.
+     2        A bytecode image of a file will be written when the
+              file is compiled.
+#v-
+  The default value is 1.
+\notes
+  The preprocessor directives of a file are evaluated when its image
+  is produced.  An image is not used if the outcome of an
+  \exmp{#ifexists} or \exmp{#ifeval} condition has changed, but
+  changes to the environment variables tested by \exmp{#if$ENV} are
+  not detected.
+
+  If an image turns out to be corrupt, the file is compiled instead.
+
+  An image is not written if an error occurred while loading the
+  file, and a file produced by \ifun{byte_compile_file} will not be
+  overwritten.
+\seealso{evalfile, byte_compile_file}
+\done
+
+\variable{_lazy_compile}
+\synopsis{Defer the compilation of function bodies}
+\usage{Int_Type _lazy_compile}
+\description
+  If the value of this variable is non-zero when a function is
+  defined, the body of the function will not be compiled until the
+  function is first called.  Until then, only the tokens of the body
+  are kept.  This reduces the time and memory required to load a
+  large file of which only a few functions are used.  The default
+  value is 0.
+\notes
+  Since the body is compiled when the function is called, errors such
+  as references to undefined variables are reported then rather than
+  when the function is defined.  For the same reason, the names in
+  the body refer to the objects that are visible when the function is
+  first called.  A syntax error that involves the braces of the body
+  is still reported when the function is defined.
+
+  The bodies of functions in a file that is being saved as a bytecode
+  image are always compiled when defined.
+\seealso{_bytecode_cache, eval, evalfile}
+\done
+
 \function{autoload}
 \synopsis{Load a function from a file}
 \usage{autoload (String_Type funct, String_Type file)}
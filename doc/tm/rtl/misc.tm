@@ -298,6 +298,30 @@
   This function sets the \ivar{__argc} and \ivar{__argv} intrinsic variables.
 \done
 
+\function{_slstring_stats}
+\synopsis{Get statistics about the table of interned strings}
+\usage{Struct_Type _slstring_stats ()}
+\description
+  The interpreter keeps a single copy of each string that it uses in a
+  hash table.  The table starts out small and doubles in size when the
+  number of strings exceeds the number of buckets.  The buckets of the
+  old table are moved to the new one a few at a time as strings are
+  created, so that no single operation pays for the whole resize.  This
+  function returns a structure with the following fields that describe
+  the current state of the table:
+#v+
+    num_strings    number of strings in the table
+    num_buckets    number of buckets in the table
+    load_factor    num_strings/num_buckets
+    max_chain      length of the longest chain of the table
+    num_resizes    number of times the table has grown
+    rehashing      non-zero if a resize is still in progress
+#v-
+\notes
+  This function is intended for diagnostic purposes.  Computing the
+  \exmp{max_chain} field requires a scan of the entire table.
+\done
+
 \variable{_slang_install_prefix}
 \synopsis{S-Lang's installation prefix}
 \usage{String_Type _slang_install_prefix}
@@ -156,6 +156,38 @@
 \seealso{_print_stack, _stk_reverse, _stk_roll}
 \done
 
+\function{_get_stack_limits}
+\synopsis{Get the maximum sizes of the interpreter stacks}
+\usage{(max_stack, max_locals, max_depth) = _get_stack_limits ()}
+\description
+  This function returns the maximum number of objects that may be on the
+  stack, the maximum number of local variables of the active functions,
+  and the maximum depth of function calls.
+\seealso{_set_stack_limits, _stkdepth}
+\done
+
+\function{_set_stack_limits}
+\synopsis{Set the maximum sizes of the interpreter stacks}
+\usage{_set_stack_limits (max_stack, max_locals, max_depth)}
+\description
+  The stacks used by the interpreter start out small and grow as needed.
+  This function sets the limits up to which they may grow: the maximum
+  number of objects that may be on the stack, the maximum number of local
+  variables of the active functions, and the maximum depth of function
+  calls.  A value of 0 leaves the corresponding limit unchanged.  A
+  \exmp{StackOverflowError} exception is thrown when a limit is exceeded.
+\example
+#v+
+   % Allow the stack to hold 10 million objects
+   _set_stack_limits (10000000, 0, 0);
+#v-
+\notes
+  Each function call also uses space on the stack of the C runtime
+  library.  Hence a large value of \exmp{max_depth} may cause the
+  program to crash.
+\seealso{_get_stack_limits, _stkdepth}
+\done
+
 \function{_stk_reverse}
 \synopsis{Reverse the order of the objects on the stack}
 \usage{_stk_reverse (Integer_Type n)}
@@ -0,0 +1,103 @@
+\function{strbuilder_append}
+\synopsis{Append objects to a string builder}
+\usage{strbuilder_append (StringBuilder_Type sb, obj, ...)}
+\description
+  This function appends the bytes of each of the objects following
+  \exmp{sb} to the end of the string builder.  Strings and binary strings
+  are appended as they are.  Other objects are appended in the form
+  produced by the \ifun{string} function.
+\example
+  Building a string from many pieces using the \var{+} operator or
+  \ifun{strcat} creates a new string for each step, which takes time
+  proportional to the square of the length of the result.  With a string
+  builder, the time is proportional to the length of the result:
+#v+
+    sb = strbuilder_new ();
+    foreach line (lines)
+      strbuilder_append (sb, line, "\n");
+    text = strbuilder_string (sb);
+#v-
+\seealso{strbuilder_appendf, strbuilder_new, strbuilder_string}
+\done
+
+\function{strbuilder_appendf}
+\synopsis{Append formatted text to a string builder}
+\usage{strbuilder_appendf (StringBuilder_Type sb, String_Type fmt, ...)}
+\description
+  This function formats the objects following \exmp{fmt} as the
+  \ifun{sprintf} function would, and appends the result to the string
+  builder \exmp{sb}.
+\example
+#v+
+    strbuilder_appendf (sb, "%-10s %8.2f\n", name, amount);
+#v-
+\seealso{strbuilder_append, sprintf, strbuilder_new}
+\done
+
+\function{strbuilder_bstring}
+\synopsis{Get the contents of a string builder as a binary string}
+\usage{BString_Type strbuilder_bstring (StringBuilder_Type sb)}
+\description
+  This function returns the bytes that have been appended to the string
+  builder \exmp{sb} as a binary string.  Unlike \ifun{strbuilder_string},
+  the result may contain null characters.
+\seealso{strbuilder_string, strbuilder_write}
+\done
+
+\function{strbuilder_clear}
+\synopsis{Remove the contents of a string builder}
+\usage{strbuilder_clear (StringBuilder_Type sb)}
+\description
+  This function empties the string builder \exmp{sb}.  The memory used
+  by the builder is kept so that it may be reused without being
+  allocated again.
+\seealso{strbuilder_new}
+\done
+
+\function{strbuilder_new}
+\synopsis{Create a string builder}
+\usage{StringBuilder_Type strbuilder_new ([Int_Type size])}
+\description
+  This function returns a new, empty string builder.  A string builder
+  is a buffer of bytes that may be efficiently extended by the
+  \ifun{strbuilder_append} and \ifun{strbuilder_appendf} functions.  The
+  buffer grows as needed.  If the optional \exmp{size} argument is given,
+  the buffer will initially have room for that many bytes.
+
+  The \ifun{length} function returns the number of bytes in the
+  builder, and the \ifun{string} function returns its contents.
+\notes
+  Like lists, string builders are passed by reference.
+\seealso{strbuilder_append, strbuilder_appendf, strbuilder_string, strbuilder_bstring, strbuilder_write, strbuilder_clear}
+\done
+
+\function{strbuilder_string}
+\synopsis{Get the contents of a string builder as a string}
+\usage{String_Type strbuilder_string (StringBuilder_Type sb)}
+\description
+  This function returns the text that has been appended to the string
+  builder \exmp{sb} as a string.  The builder is not modified, and more
+  text may be appended to it afterwards.
+\notes
+  If the builder contains null characters, the string will end at the
+  first of them.  Use \ifun{strbuilder_bstring} to obtain all the bytes.
+\seealso{strbuilder_bstring, strbuilder_append, strbuilder_write}
+\done
+
+\function{strbuilder_write}
+\synopsis{Write the contents of a string builder to a file}
+\usage{UInt_Type strbuilder_write (StringBuilder_Type sb, File_Type fp)}
+\description
+  This function writes the bytes of the string builder \exmp{sb} to the
+  open file \exmp{fp} without first creating a string from them.  It
+  returns the number of bytes written, or -1 upon error, in which case
+  \ivar{errno} will be set.
+\example
+#v+
+    fp = fopen ("report.txt", "w");
+    () = strbuilder_write (sb, fp);
+    () = fclose (fp);
+#v-
+\seealso{strbuilder_string, fwrite}
+\done
+
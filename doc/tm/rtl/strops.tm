@@ -23,6 +23,31 @@
   will be returned.  An array value for the optional whitespace\n\
   argument is not supported.
 
+\function{array_sprintf}
+\synopsis{Format the elements of arrays}
+\usage{String_Type[] array_sprintf (String_Type format, ...)}
+\description
+  This function formats the corresponding elements of its array
+  arguments using the \ifun{sprintf} format \exmp{format}, and returns
+  the results as an array of strings.  Scalar arguments are used for
+  every element.  The result has the shape of the first array argument,
+  and the other array arguments must have the same number of elements.
+  If none of the arguments are arrays, a single element array is
+  returned.
+
+  It is equivalent to calling \ifun{array_map} with \ifun{sprintf},
+  but it is faster since the loop over the elements takes place in C.
+\example
+#v+
+    names = ["apple", "pear"];
+    lines = array_sprintf ("%-10s %6.2f\n", names, prices);
+#v-
+\notes
+  Unlike \ifun{sprintf}, it is an error for the format to require more
+  arguments than were passed.
+\seealso{sprintf, array_map, strjoin}
+\done
+
 \function{count_char_occurrences}
 \synopsis{Count the number of occurrences of a character in a string}
 \usage{UInt_Type count_char_occurrences (str, ch)}
@@ -329,7 +354,7 @@
 \notes
   The \ifun{set_float_format} function controls the format for the
   \exmp{S} conversion of floating point numbers.
-\seealso{string, sscanf, message, pack, set_float_format}
+\seealso{array_sprintf, string, sscanf, message, pack, set_float_format}
 \done
 
 \function{sscanf}
@@ -561,6 +586,18 @@
   bytes (numbered from 1) of the start of the match in \exmp{str}.
   The exact substring matched may be found using
   \ifun{string_match_nth}.
+
+  If \exmp{str} is an array of strings, the pattern is compiled once and
+  matched against each element of the array.  In this case, the function
+  returns an array of the same shape whose elements are the positions of
+  the matches, with 0 for the elements that do not match or are \NULL.
+  The values returned by \ifun{string_match_nth} are not defined after
+  such a call.
+\example
+  The following selects the lines that contain a date:
+#v+
+    dated = lines[where (string_match (lines, "[0-9]+-[0-9]+-[0-9]+"))];
+#v-
 \notes
   Positions in the string are specified using byte-offsets not
   character offsets. The value returned by this function is measured
@@ -570,8 +607,16 @@
   the \module{pcre} module for better, more sophisticated regular
   expressions.
 
+  Unless the pattern contains a back-reference such as \exmp{\\1}, the
+  time taken by the match grows no faster than the length of the string
+  times the length of the pattern.  Patterns with back-references are
+  matched by backtracking, which may take much longer.
+
+  The compiled form of the most recently used patterns is cached.  The
+  size of the cache may be changed using \ifun{set_regexp_cache_size}.
+
   The \exmp{pos} argument was made optional in version 2.2.3.
-\seealso{string_matches, string_match_nth, strcmp, strncmp}
+\seealso{string_matches, string_match_nth, set_regexp_cache_size, strcmp, strncmp}
 \done
 
 \function{string_match_nth}
@@ -622,6 +667,11 @@
   will return an array of strings whose \exmp{ith} element is the string that
   corresponds to the return value of the \ifun{string_match_nth}
   function.
+
+  If \exmp{str} is an array of strings, the function returns an array of
+  the same shape whose elements are the values that would be returned
+  for the corresponding element of \exmp{str}, i.e., an array of strings
+  or \NULL.
 \example
 #v+
     strs = string_matches ("p0.5keV_27deg.dat",
@@ -643,6 +693,33 @@
 \seealso{string_match, string_match_nth, strcmp, strncmp}
 \done
 
+\function{set_regexp_cache_size}
+\synopsis{Set the number of regular expressions to cache}
+\usage{set_regexp_cache_size (Int_Type n)}
+\description
+  The functions \ifun{string_match} and \ifun{string_matches} keep the
+  compiled form of the \exmp{n} most recently used regular expressions
+  in a cache, so that a pattern that is used again need not be compiled
+  again.  This function sets the size of the cache, which must be at
+  least 1.  If the cache holds more than \exmp{n} patterns, the least
+  recently used ones are removed.  The default size is 32.
+
+  A program that cycles through more patterns than the cache holds will
+  compile each pattern every time that it is used, and may run faster
+  with a larger cache.
+\seealso{get_regexp_cache_size, string_match, string_matches}
+\done
+
+\function{get_regexp_cache_size}
+\synopsis{Get the number of regular expressions to cache}
+\usage{Int_Type get_regexp_cache_size ()}
+\description
+  This function returns the maximum number of compiled regular
+  expressions that are kept by \ifun{string_match} and
+  \ifun{string_matches}.
+\seealso{set_regexp_cache_size, string_match}
+\done
+
 \function{strjoin}
 \synopsis{Concatenate elements of a string array}
 \usage{String_Type strjoin (Array_Type a [, String_Type delim])}
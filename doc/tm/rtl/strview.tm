@@ -0,0 +1,78 @@
+\function{strview}
+\synopsis{Create a view of part of a string}
+\usage{StringView_Type strview (String_Type s [,Int_Type pos [,Int_Type len]])}
+\description
+  This function returns a view of \exmp{len} bytes of the string
+  \exmp{s}, starting at the byte offset \exmp{pos}.  As with
+  \ifun{substrbytes}, the first byte is at \exmp{pos=1}.  If \exmp{pos}
+  is not given, the view starts at the beginning of the string.  If
+  \exmp{len} is not given, or is negative, the view extends to the end of
+  the string.  Values that fall outside of the string are clipped to it.
+  The first argument may also be a view, in which case the result is a
+  view of the same string.
+
+  Unlike \ifun{substrbytes}, which copies the bytes to a new string, a
+  view refers to the bytes of the original string.  Views may be compared
+  with each other and with strings using the usual comparison operators,
+  and the \var{+} operator may be used to concatenate them.  The
+  \ifun{length} function returns the number of bytes in a view.
+
+  A view is converted to a string when it is used where a string is
+  required, e.g., as an argument to a function such as \ifun{strup}, or as
+  a key of an associative array.  The \ifun{string} function or a
+  typecast to \var{String_Type} may be used to perform the conversion
+  explicitly.
+\example
+#v+
+    line = "name=value";
+    key = strview (line, 1, 4);
+    if (key == "name") value = strview (line, 6);
+#v-
+\notes
+  A view keeps the string that it refers to in memory.  Use \ifun{string}
+  to create a copy of a small part of a large string that is to be kept.
+\seealso{strview_chop, strview_tok, strview_trim, substrbytes}
+\done
+
+\function{strview_chop}
+\synopsis{Split a string into an array of views}
+\usage{StringView_Type[] strview_chop (String_Type s, Int_Type delim)}
+\description
+  This function behaves like \ifun{strchop} without a quote character,
+  except that the elements of the returned array are views of the string
+  \exmp{s} instead of new strings.  The string \exmp{s} may also be a view.
+\example
+#v+
+    foreach field (strview_chop (line, ','))
+      {
+         if (field == "") continue;
+           .
+           .
+      }
+#v-
+\seealso{strchop, strview, strview_tok}
+\done
+
+\function{strview_tok}
+\synopsis{Divide a string into an array of views of tokens}
+\usage{StringView_Type[] strview_tok (String_Type s [,String_Type white])}
+\description
+  This function behaves like \ifun{strtok}, except that the elements of
+  the returned array are views of the string \exmp{s} instead of new
+  strings.  The string \exmp{s} may also be a view.  If the optional
+  \exmp{white} argument is given, it specifies the set of characters that
+  separate the tokens, in the form used by \ifun{strtrans}.  Otherwise the
+  tokens are separated by whitespace.
+\seealso{strtok, strview, strview_chop, strview_trim}
+\done
+
+\function{strview_trim}
+\synopsis{Remove whitespace from the ends of a string as a view}
+\usage{StringView_Type strview_trim (String_Type s [,String_Type white])}
+\description
+  This function behaves like \ifun{strtrim}, except that the result is a
+  view of the string \exmp{s} instead of a new string.  The string
+  \exmp{s} may also be a view.
+\seealso{strtrim, strview, strview_tok}
+\done
+
@@ -5585,6 +5585,8 @@
    Usage: slsh [OPTIONS] [-|file [args...]]
     --help           Print this help
     --version        Show slsh version information
+    --cache          Save and use bytecode images of loaded files
+    --lazy           Compile function bodies when they are first called
     -e string        Execute 'string' as S-Lang code
     -g               Compile with debugging code, tracebacks, etc
     -n               Don't load personal init file
@@ -6134,6 +6136,15 @@ profiler will first be demonstrated in the context of \slprof, and
 after that follows a discussion of how to use \file{profile.sl} for
 other \slang applications.
 
+When given the \exmp{--sample} option, \slprof uses the sampling
+profiler that is built into the interpreter instead of the hooks.  It
+periodically records the stack of active functions and the current
+line without instrumenting the code, which makes it suitable for long
+running scripts.  The report lists the number of samples taken at each
+line, and the \exmp{--folded} option writes the sampled stacks in the
+folded form that is used by tools that create flame graphs.  See the
+documentation for \ifun{_profile_start} for more information.
+
 (To be completed...)
 
 #i regexp.tm
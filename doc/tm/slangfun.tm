@@ -72,6 +72,12 @@ conforming \slang applications.  Those functions are described in
 \chapter{Functions that Operate on Binary Strings}
 #i rtl/bstr.tm
 
+\chapter{String Builder Functions}
+#i rtl/strbld.tm
+
+\chapter{String View Functions}
+#i rtl/strview.tm
+
 \chapter{Functions that Manipulate Structures}
 #i rtl/struct.tm
 
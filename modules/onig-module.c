@@ -499,40 +499,99 @@ static int do_onig_search_internal (Onig_Type *o, OnigOptionType option, UChar *
    return -2;
 }
 
+/* Returns the number of registers if str matches, 0 if not, or -1 upon
+ * error.  If end_pos is negative, the search extends to the end of str.
+ */
+static int onig_search_string (Onig_Type *o, OnigOptionType option, char *str, char *str_end,
+			       int start_pos, int end_pos)
+{
+   int status;
+
+   if (end_pos < 0)
+     end_pos = (int) (str_end - str);
+
+   status = do_onig_search_internal (o, option, (UChar *)str, (UChar *)str_end, start_pos, end_pos);
+   if (status >= 0)
+     {
+	o->match_pos = status;
+	return o->region->num_regs;
+     }
+   o->match_pos = -1;
+
+   if (status == -1)
+     return 0;			       /* no match */
+
+   return -1;
+}
+
+/* If str is an array of strings, each element is searched, and an array
+ * of the return values is pushed.  The matches are those of the last
+ * element.
+ */
+static void onig_search_array (Onig_Type *o, OnigOptionType option, SLang_Array_Type *at,
+			       int start_pos, int end_pos)
+{
+   SLang_Array_Type *int_at;
+   SLuindex_Type i, num;
+   char **strs;
+   int *nregs;
+
+   if (NULL == (int_at = SLang_create_array1 (SLANG_INT_TYPE, 0, NULL, at->dims, at->num_dims, 0)))
+     return;
+
+   strs = (char **) at->data;
+   nregs = (int *) int_at->data;
+   num = at->num_elements;
+   for (i = 0; i < num; i++)
+     {
+	char *str = strs[i];
+
+	if (str == NULL)
+	  continue;
+	if (-1 == (nregs[i] = onig_search_string (o, option, str, str + strlen (str), start_pos, end_pos)))
+	  {
+	     SLang_free_array (int_at);
+	     return;
+	  }
+     }
+   (void) SLang_push_array (int_at, 1);
+}
+
 /* Usage: onig_search (o, str [start, end] [,option]) */
-static int do_onig_search (void)
+static void do_onig_search (void)
 {
    int start_pos = 0, end_pos = -1;
-   char *str, *str_end;
+   char *str = NULL, *str_end;
    SLang_BString_Type *bstr = NULL;
+   SLang_Array_Type *at = NULL;
    Onig_Type *o;
    SLang_MMT_Type *mmt;
-   int status = -1;
+   int status;
    OnigOptionType option = ONIG_OPTION_NONE;
 
    switch (SLang_Num_Function_Args)
      {
       default:
 	SLang_verror (SL_Usage_Error, "Usage: n = onig_search (compiled_pattern, str [,start_ofs, end_ofs] [,option])");
-	return -1;
+	return;
 
       case 5:
 	if (-1 == pop_onig_option (&option))
-	  return -1;
+	  return;
 	/* fall through */
       case 4:
 	if (-1 == SLang_pop_int (&end_pos))
-	  return -1;
+	  return;
 	if (-1 == SLang_pop_int (&start_pos))
-	  return -1;
+	  return;
 	break;
       case 3:
 	if (-1 == pop_onig_option (&option))
-	  return -1;
+	  return;
 	if (option & ~(ONIG_OPTION_NOTBOL|ONIG_OPTION_NOTEOL))
 	  {
 	     SLang_verror (SL_InvalidParm_Error, "onig_search: invalid option flags");
-	     return -1;
+	     return;
 	  }
 	break;
       case 2:
@@ -543,63 +602,53 @@ static int do_onig_search (void)
      {
       case SLANG_STRING_TYPE:
 	if (-1 == SLang_pop_slstring (&str))
-	  return -1;
+	  return;
 	str_end = str + strlen (str);
 	break;
 
+      case SLANG_ARRAY_TYPE:
+	if (-1 == SLang_pop_array_of_type (&at, SLANG_STRING_TYPE))
+	  return;
+	str_end = NULL;
+	break;
+
       case SLANG_BSTRING_TYPE:
       default:
 	  {
 	     SLstrlen_Type len;
 
 	     if (-1 == SLang_pop_bstring(&bstr))
-	       return -1;
+	       return;
 
 	     str = (char *)SLbstring_get_pointer(bstr, &len);
 	     if (str == NULL)
 	       {
 		  SLbstring_free (bstr);
-		  return -1;
+		  return;
 	       }
 	     str_end = str + len;
 	  }
 	break;
      }
 
-   if (end_pos < 0)
-     end_pos = (int) (str_end - str);
-
    if (NULL == (mmt = SLang_pop_mmt (Onig_Type_Id)))
      goto free_and_return;
    o = (Onig_Type *)SLang_object_from_mmt (mmt);
 
-   status = do_onig_search_internal (o, option, (UChar *)str, (UChar *)str_end, start_pos, end_pos);
-   if (status >= 0)
-     {
-	o->match_pos = status;
-	status = o->region->num_regs;
-	goto free_and_return;
-     }
-   o->match_pos = -1;
+   if (at != NULL)
+     onig_search_array (o, option, at, start_pos, end_pos);
+   else if (-1 != (status = onig_search_string (o, option, str, str_end, start_pos, end_pos)))
+     (void) SLang_push_int (status);
 
-   if (status == -1)
-     {				       /* no match */
-	status = 0;
-	goto free_and_return;
-     }
-
-   /* Else an error occurred */
-   /* drop */
+   SLang_free_mmt (mmt);
 
 free_and_return:
-
-   SLang_free_mmt (mmt);
-   if (bstr != NULL)
+   if (at != NULL)
+     SLang_free_array (at);
+   else if (bstr != NULL)
      SLbstring_free (bstr);
    else
      SLang_free_slstring (str);
-
-   return status;
 }
 
 static int get_nth_start_stop (Onig_Type *o, unsigned int n,
@@ -750,7 +799,7 @@ static SLang_Intrin_Fun_Type Onig_Intrinsics [] =
 {
    MAKE_INTRINSIC_0("onig_version", do_onig_version, S),
    MAKE_INTRINSIC_0("onig_new", do_onig_new, V),
-   MAKE_INTRINSIC_0("onig_search", do_onig_search, I),
+   MAKE_INTRINSIC_0("onig_search", do_onig_search, V),
    MAKE_INTRINSIC_2("onig_nth_match", nth_match, V, O, I),
    MAKE_INTRINSIC_3("onig_nth_substr", nth_substr, V, O, S, I),
    MAKE_INTRINSIC_0("onig_set_warn_func", set_warn_func, V),
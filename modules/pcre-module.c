@@ -171,46 +171,82 @@ static int _pcre_exec_1 (PCRE_Type *pt, char *str, unsigned int len, int pos, in
    return rc;
 }
 
-static int _pcre_exec (void)
+/* If str is an array of strings, the pattern is matched against each
+ * element, and an array of the return values is pushed.  The substrings
+ * are those of the last element.
+ */
+static int _pcre_exec_array (PCRE_Type *pt, SLang_Array_Type *at, int pos, int options)
+{
+   SLang_Array_Type *int_at;
+   SLuindex_Type i, num;
+   char **strs;
+   int *nmatches;
+
+   if (NULL == (int_at = SLang_create_array1 (SLANG_INT_TYPE, 0, NULL, at->dims, at->num_dims, 0)))
+     return -1;
+
+   strs = (char **) at->data;
+   nmatches = (int *) int_at->data;
+   num = at->num_elements;
+   for (i = 0; i < num; i++)
+     {
+	if (strs[i] == NULL)
+	  continue;
+	if (-1 == (nmatches[i] = _pcre_exec_1 (pt, strs[i], strlen (strs[i]), pos, options)))
+	  {
+	     SLang_free_array (int_at);
+	     return -1;
+	  }
+     }
+   return SLang_push_array (int_at, 1);
+}
+
+static void _pcre_exec (void)
 {
    PCRE_Type *p;
-   SLang_MMT_Type *mmt;
-   char *str;
+   SLang_MMT_Type *mmt = NULL;
+   char *str = NULL;
    SLang_BString_Type *bstr = NULL;
+   SLang_Array_Type *at = NULL;
    SLstrlen_Type len;
    int pos = 0;
    int options = 0;
-   int ret = -1;
+   int ret;
 
    switch (SLang_Num_Function_Args)
      {
       case 4:
 	if (-1 == SLang_pop_integer (&options))
-	  return -1;
+	  return;
 	/* fall through */
       case 3:
 	/* fall through */
 	if (-1 == SLang_pop_integer (&pos))
-	  return -1;
+	  return;
 	/* fall through */
       default:
 	switch (SLang_peek_at_stack())
 	  {
 	   case SLANG_STRING_TYPE:
 	     if (-1 == SLang_pop_slstring (&str))
-	       return -1;
+	       return;
 	     len = strlen (str);
 	     break;
 
+	   case SLANG_ARRAY_TYPE:
+	     if (-1 == SLang_pop_array_of_type (&at, SLANG_STRING_TYPE))
+	       return;
+	     break;
+
 	   case SLANG_BSTRING_TYPE:
 	   default:
 	     if (-1 == SLang_pop_bstring(&bstr))
-	       return -1;
+	       return;
 	     str = (char *)SLbstring_get_pointer(bstr, &len);
 	     if (str == NULL)
 	       {
 		  SLbstring_free (bstr);
-		  return -1;
+		  return;
 	       }
 	     break;
 	  }
@@ -220,16 +256,24 @@ static int _pcre_exec (void)
      goto free_and_return;
    p = (PCRE_Type *)SLang_object_from_mmt (mmt);
 
-   ret = _pcre_exec_1 (p, str, len, pos, options);
+   if (at != NULL)
+     {
+	(void) _pcre_exec_array (p, at, pos, options);
+	goto free_and_return;
+     }
+
+   if (-1 != (ret = _pcre_exec_1 (p, str, len, pos, options)))
+     (void) SLang_push_int (ret);
 
 free_and_return:
 
-   SLang_free_mmt (mmt);
-   if (bstr != NULL)
+   SLang_free_mmt (mmt);	       /* NULL ok */
+   if (at != NULL)
+     SLang_free_array (at);
+   else if (bstr != NULL)
      SLbstring_free (bstr);
    else
      SLang_free_slstring (str);
-   return ret;
 }
 
 static int get_nth_start_stop (PCRE_Type *pt, unsigned int n,
@@ -421,7 +465,7 @@ static void destroy_pcre (SLtype type, VOID_STAR f)
 #define S SLANG_STRING_TYPE
 static SLang_Intrin_Fun_Type PCRE_Intrinsics [] =
 {
-   MAKE_INTRINSIC_0("pcre_exec", _pcre_exec, I),
+   MAKE_INTRINSIC_0("pcre_exec", _pcre_exec, V),
    MAKE_INTRINSIC_0("pcre_compile", _pcre_compile, V),
    MAKE_INTRINSIC_2("pcre_nth_match", _pcre_nth_match, V, P, I),
    MAKE_INTRINSIC_3("pcre_nth_substr", _pcre_nth_substr, V, P, S, I),
@@ -0,0 +1,993 @@
+/* -*- mode: C; mode: fold; -*- */
+/*
+Copyright (C) 2009-2020,2021 John E. Davis
+
+This file is part of the S-Lang Library.
+
+The S-Lang Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The S-Lang Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+USA.
+*/
+
+/* This module provides the low-level support for the pool.sl process
+ * pool: a bidirectional channel between a parent and a worker process,
+ * and a compact binary encoding of S-Lang objects that is used to pass
+ * jobs and results over it.  Since both ends of a channel are forks of
+ * the same process, the encoding uses the native byte order and the
+ * native sizes of the numeric types.
+ */
+#include "config.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#ifdef HAVE_SYS_TYPES_H
+# include <sys/types.h>
+#endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+# include <sys/socket.h>
+#endif
+
+#include <slang.h>
+
+SLANG_MODULE(pool);
+
+#define MAX_ENCODE_DEPTH	256
+
+#define TAG_NULL	'N'
+#define TAG_STRING	'S'
+#define TAG_BSTRING	'B'
+#define TAG_SCALAR	'V'
+#define TAG_ARRAY	'A'
+#define TAG_STRUCT	'T'
+#define TAG_LIST	'L'
+#define TAG_FUNCTION	'F'
+
+typedef unsigned int Pool_Len_Type;    /* 4 bytes on supported systems */
+
+typedef struct
+{
+   unsigned char *buf;
+   SLstrlen_Type len;
+   SLstrlen_Type size;
+}
+Buffer_Type;
+
+static int grow_buffer (Buffer_Type *b, SLstrlen_Type dlen) /*{{{*/
+{
+   SLstrlen_Type size;
+   unsigned char *buf;
+
+   if (b->len + dlen <= b->size)
+     return 0;
+
+   if (b->len + dlen < b->len)
+     {
+	SLang_verror (SL_LimitExceeded_Error, "pool: object is too large to encode");
+	return -1;
+     }
+
+   size = 2*b->size;
+   if (size < 256) size = 256;
+   while (size < b->len + dlen)
+     size *= 2;
+
+   if (NULL == (buf = (unsigned char *) SLrealloc ((char *)b->buf, size)))
+     return -1;
+   b->buf = buf;
+   b->size = size;
+   return 0;
+}
+/*}}}*/
+
+static int put_bytes (Buffer_Type *b, VOID_STAR data, SLstrlen_Type n)
+{
+   if (-1 == grow_buffer (b, n))
+     return -1;
+   memcpy (b->buf + b->len, data, n);
+   b->len += n;
+   return 0;
+}
+
+static int put_tag (Buffer_Type *b, unsigned char tag)
+{
+   return put_bytes (b, &tag, 1);
+}
+
+static int put_len (Buffer_Type *b, Pool_Len_Type n)
+{
+   return put_bytes (b, &n, sizeof (Pool_Len_Type));
+}
+
+/* Numeric types whose values have no references to other memory, and may
+ * be passed as raw bytes.
+ */
+static int is_raw_type (SLtype type)
+{
+   switch (type)
+     {
+      case SLANG_CHAR_TYPE: case SLANG_UCHAR_TYPE:
+      case SLANG_SHORT_TYPE: case SLANG_USHORT_TYPE:
+      case SLANG_INT_TYPE: case SLANG_UINT_TYPE:
+      case SLANG_LONG_TYPE: case SLANG_ULONG_TYPE:
+#ifdef HAVE_LONG_LONG
+      case SLANG_LLONG_TYPE: case SLANG_ULLONG_TYPE:
+#endif
+      case SLANG_FLOAT_TYPE: case SLANG_DOUBLE_TYPE:
+      case SLANG_COMPLEX_TYPE:
+      case SLANG_DATATYPE_TYPE:
+	return 1;
+      default:
+	break;
+     }
+   return 0;
+}
+
+static int encode_object (Buffer_Type *, unsigned int);
+
+static int encode_array (Buffer_Type *b, SLang_Array_Type *at, unsigned int depth) /*{{{*/
+{
+   SLuindex_Type i, num;
+   SLtype type = at->data_type;
+   unsigned int d;
+   unsigned char *data;
+
+   if ((-1 == put_tag (b, TAG_ARRAY))
+       || (-1 == put_len (b, type))
+       || (-1 == put_len (b, at->num_dims)))
+     return -1;
+   for (d = 0; d < at->num_dims; d++)
+     {
+	if (-1 == put_len (b, (Pool_Len_Type) at->dims[d]))
+	  return -1;
+     }
+
+   num = at->num_elements;
+   data = (unsigned char *) at->data;
+
+   if (is_raw_type (type))
+     return put_bytes (b, data, num * at->sizeof_type);
+
+   if (at->sizeof_type != sizeof (VOID_STAR))
+     {
+	SLang_verror (SL_NotImplemented_Error,
+		      "pool: unable to encode an array of %s",
+		      SLclass_get_datatype_name (type));
+	return -1;
+     }
+
+   for (i = 0; i < num; i++)
+     {
+	VOID_STAR p = (VOID_STAR) (data + i * at->sizeof_type);
+
+	if (*(VOID_STAR *) p == NULL)
+	  {
+	     if (-1 == put_tag (b, TAG_NULL))
+	       return -1;
+	     continue;
+	  }
+	if ((-1 == SLang_push_value (type, p))
+	    || (-1 == encode_object (b, depth + 1)))
+	  return -1;
+     }
+   return 0;
+}
+/*}}}*/
+
+static int encode_struct (Buffer_Type *b, unsigned int depth) /*{{{*/
+{
+   SLang_Struct_Type *s;
+   SLang_Array_Type *at = NULL;
+   char **names;
+   SLuindex_Type i, num;
+   int status = -1;
+
+   if (-1 == SLang_pop_struct (&s))
+     return -1;
+
+   if ((-1 == SLang_push_struct (s))
+       || (-1 == SLang_execute_function ("get_struct_field_names"))
+       || (-1 == SLang_pop_array_of_type (&at, SLANG_STRING_TYPE)))
+     goto free_return;
+
+   num = at->num_elements;
+   names = (char **) at->data;
+   if ((-1 == put_tag (b, TAG_STRUCT))
+       || (-1 == put_len (b, num)))
+     goto free_return;
+
+   for (i = 0; i < num; i++)
+     {
+	Pool_Len_Type len = strlen (names[i]);
+	if ((-1 == put_len (b, len))
+	    || (-1 == put_bytes (b, names[i], len)))
+	  goto free_return;
+     }
+   for (i = 0; i < num; i++)
+     {
+	if ((-1 == SLang_push_struct_field (s, names[i]))
+	    || (-1 == encode_object (b, depth + 1)))
+	  goto free_return;
+     }
+   status = 0;
+
+free_return:
+   if (at != NULL) SLang_free_array (at);
+   SLang_free_struct (s);
+   return status;
+}
+/*}}}*/
+
+static int encode_list (Buffer_Type *b, unsigned int depth) /*{{{*/
+{
+   int n, depth0 = SLstack_depth ();
+
+   /* __push_list leaves the elements on the stack in order with the last
+    * one on top.  Reverse them so that they may be popped in order.
+    */
+   if (-1 == SLang_execute_function ("__push_list"))
+     return -1;
+   n = SLstack_depth () - depth0 + 1;
+   if ((n < 0)
+       || (-1 == put_tag (b, TAG_LIST))
+       || (-1 == put_len (b, (Pool_Len_Type) n))
+       || (-1 == SLreverse_stack (n)))
+     goto return_error;
+
+   while (n > 0)
+     {
+	n--;
+	if (-1 == encode_object (b, depth + 1))
+	  goto return_error;
+     }
+   return 0;
+
+return_error:
+   if (n > 0)
+     (void) SLdo_pop_n (n);
+   return -1;
+}
+/*}}}*/
+
+/* A function is encoded by its id and by its name, qualified by its
+ * namespace as in the string representation of a reference to it.  A
+ * function that was not defined by S-Lang code has no id, and is looked up
+ * by the qualified name.
+ */
+static int encode_function (Buffer_Type *b) /*{{{*/
+{
+   SLang_Name_Type *nt;
+   unsigned long id;
+   char *name = NULL;
+   Pool_Len_Type len;
+   int status = -1;
+
+   if (NULL == (nt = SLang_pop_function ()))
+     return -1;
+
+   id = SLang_get_function_id (nt);
+   if ((-1 == SLang_push_function (nt))
+       || (-1 == SLang_execute_function ("string"))
+       || (-1 == SLang_pop_slstring (&name)))
+     goto free_return;
+
+   /* Skip the & */
+   len = strlen (name + 1);
+   if ((0 == put_tag (b, TAG_FUNCTION))
+       && (0 == put_bytes (b, &id, sizeof (unsigned long)))
+       && (0 == put_len (b, len))
+       && (0 == put_bytes (b, (VOID_STAR) (name + 1), len)))
+     status = 0;
+
+free_return:
+   if (name != NULL) SLang_free_slstring (name);
+   SLang_free_function (nt);
+   return status;
+}
+/*}}}*/
+
+/* Encode the object at the top of the stack, removing it */
+static int encode_object (Buffer_Type *b, unsigned int depth) /*{{{*/
+{
+   SLang_Array_Type *at;
+   SLtype type;
+   int status;
+
+   if (depth > MAX_ENCODE_DEPTH)
+     {
+	SLang_verror (SL_LimitExceeded_Error, "pool: object is too deeply nested to encode");
+	(void) SLdo_pop ();
+	return -1;
+     }
+
+   type = (SLtype) SLang_peek_at_stack ();
+   switch (type)
+     {
+      case SLANG_NULL_TYPE:
+	if (-1 == SLang_pop_null ())
+	  return -1;
+	return put_tag (b, TAG_NULL);
+
+      case SLANG_STRING_TYPE:
+	  {
+	     char *s;
+	     Pool_Len_Type len;
+
+	     if (-1 == SLang_pop_slstring (&s))
+	       return -1;
+	     len = strlen (s);
+	     status = -1;
+	     if ((0 == put_tag (b, TAG_STRING))
+		 && (0 == put_len (b, len))
+		 && (0 == put_bytes (b, s, len)))
+	       status = 0;
+	     SLang_free_slstring (s);
+	     return status;
+	  }
+
+      case SLANG_BSTRING_TYPE:
+	  {
+	     SLang_BString_Type *bs;
+	     unsigned char *ptr;
+	     SLstrlen_Type len;
+
+	     if (-1 == SLang_pop_bstring (&bs))
+	       return -1;
+	     status = -1;
+	     if ((NULL != (ptr = SLbstring_get_pointer (bs, &len)))
+		 && (0 == put_tag (b, TAG_BSTRING))
+		 && (0 == put_len (b, len))
+		 && (0 == put_bytes (b, ptr, len)))
+	       status = 0;
+	     SLbstring_free (bs);
+	     return status;
+	  }
+
+      case SLANG_ARRAY_TYPE:
+	if (-1 == SLang_pop_array (&at, 0))
+	  return -1;
+	status = encode_array (b, at, depth);
+	SLang_free_array (at);
+	return status;
+
+      case SLANG_STRUCT_TYPE:
+	return encode_struct (b, depth);
+
+      case SLANG_LIST_TYPE:
+	return encode_list (b, depth);
+
+      case SLANG_REF_TYPE:
+	return encode_function (b);
+
+      case (SLtype) -1:
+	return -1;
+
+      default:
+	break;
+     }
+
+   if (0 == is_raw_type (type))
+     {
+	SLang_verror (SL_NotImplemented_Error, "pool: unable to encode an object of type %s",
+		      SLclass_get_datatype_name (type));
+	(void) SLdo_pop ();
+	return -1;
+     }
+
+   if (-1 == SLang_pop_array (&at, 1))
+     return -1;
+   status = -1;
+   if ((0 == put_tag (b, TAG_SCALAR))
+       && (0 == put_len (b, type))
+       && (0 == put_bytes (b, at->data, at->sizeof_type)))
+     status = 0;
+   SLang_free_array (at);
+   return status;
+}
+/*}}}*/
+
+typedef struct
+{
+   unsigned char *ptr;
+   unsigned char *pmax;
+}
+Decode_Type;
+
+static int decode_error (void)
+{
+   SLang_verror (SL_Data_Error, "pool: corrupt or truncated object encoding");
+   return -1;
+}
+
+static int get_bytes (Decode_Type *d, VOID_STAR data, SLstrlen_Type n)
+{
+   if ((SLstrlen_Type)(d->pmax - d->ptr) < n)
+     return decode_error ();
+   memcpy (data, d->ptr, n);
+   d->ptr += n;
+   return 0;
+}
+
+static int get_len (Decode_Type *d, Pool_Len_Type *np)
+{
+   return get_bytes (d, np, sizeof (Pool_Len_Type));
+}
+
+/* Gets a length-prefixed run of bytes without copying it */
+static unsigned char *get_chars (Decode_Type *d, Pool_Len_Type *lenp)
+{
+   unsigned char *p;
+
+   if (-1 == get_len (d, lenp))
+     return NULL;
+   if ((Pool_Len_Type)(d->pmax - d->ptr) < *lenp)
+     {
+	(void) decode_error ();
+	return NULL;
+     }
+   p = d->ptr;
+   d->ptr += *lenp;
+   return p;
+}
+
+static int decode_object (Decode_Type *, unsigned int);
+
+static int decode_array (Decode_Type *d, unsigned int depth) /*{{{*/
+{
+   SLang_Array_Type *at;
+   SLindex_Type dims[SLARRAY_MAX_DIMS];
+   Pool_Len_Type type, num_dims, dim;
+   SLuindex_Type i, num;
+   unsigned char *data;
+   unsigned int k;
+
+   if ((-1 == get_len (d, &type))
+       || (-1 == get_len (d, &num_dims)))
+     return -1;
+
+   if ((num_dims == 0) || (num_dims > SLARRAY_MAX_DIMS))
+     return decode_error ();
+
+   for (k = 0; k < num_dims; k++)
+     {
+	if (-1 == get_len (d, &dim))
+	  return -1;
+	dims[k] = (SLindex_Type) dim;
+     }
+
+   if (NULL == (at = SLang_create_array ((SLtype) type, 0, NULL, dims, num_dims)))
+     return -1;
+
+   num = at->num_elements;
+   data = (unsigned char *) at->data;
+
+   if (is_raw_type (type))
+     {
+	if (-1 == get_bytes (d, data, num * at->sizeof_type))
+	  goto return_error;
+	return SLang_push_array (at, 1);
+     }
+
+   for (i = 0; i < num; i++)
+     {
+	if (d->ptr >= d->pmax)
+	  {
+	     (void) decode_error ();
+	     goto return_error;
+	  }
+	if (*d->ptr == TAG_NULL)
+	  {
+	     d->ptr++;
+	     continue;
+	  }
+	if ((-1 == decode_object (d, depth + 1))
+	    || (-1 == SLang_pop_value ((SLtype) type, (VOID_STAR)(data + i * at->sizeof_type))))
+	  goto return_error;
+     }
+   return SLang_push_array (at, 1);
+
+return_error:
+   SLang_free_array (at);
+   return -1;
+}
+/*}}}*/
+
+static int decode_struct (Decode_Type *d, unsigned int depth) /*{{{*/
+{
+   SLang_Struct_Type *s = NULL;
+   char **names;
+   Pool_Len_Type i, num, len;
+   int status = -1;
+
+   if (-1 == get_len (d, &num))
+     return -1;
+   if (num > (Pool_Len_Type)(d->pmax - d->ptr))
+     return decode_error ();
+
+   if (NULL == (names = (char **) SLcalloc (num + 1, sizeof (char *))))
+     return -1;
+
+   for (i = 0; i < num; i++)
+     {
+	unsigned char *p;
+
+	if ((NULL == (p = get_chars (d, &len)))
+	    || (NULL == (names[i] = SLang_create_nslstring ((char *)p, len))))
+	  goto free_return;
+     }
+
+   if (NULL == (s = SLang_create_struct ((SLFUTURE_CONST char **)names, num)))
+     goto free_return;
+
+   for (i = 0; i < num; i++)
+     {
+	if ((-1 == decode_object (d, depth + 1))
+	    || (-1 == SLang_pop_struct_field (s, names[i])))
+	  goto free_return;
+     }
+   status = SLang_push_struct (s);
+
+free_return:
+   if (s != NULL)
+     SLang_free_struct (s);
+   for (i = 0; i < num; i++)
+     {
+	if (names[i] != NULL)
+	  SLang_free_slstring (names[i]);
+     }
+   SLfree ((char *) names);
+   return status;
+}
+/*}}}*/
+
+static int decode_list (Decode_Type *d, unsigned int depth) /*{{{*/
+{
+   SLang_List_Type *list;
+   Pool_Len_Type i, num;
+
+   if (-1 == get_len (d, &num))
+     return -1;
+   if (num > (Pool_Len_Type)(d->pmax - d->ptr))
+     return decode_error ();
+
+   if (NULL == (list = SLang_create_list ((int) num)))
+     return -1;
+
+   for (i = 0; i < num; i++)
+     {
+	if ((-1 == decode_object (d, depth + 1))
+	    || (-1 == SLang_list_append (list, -1)))
+	  {
+	     SLang_free_list (list);
+	     return -1;
+	  }
+     }
+   return SLang_push_list (list, 1);
+}
+/*}}}*/
+
+/* A function can only be called in a process that was forked after it was
+ * defined.  If it has been redefined since, the definition in this process
+ * is not the one that was encoded, and it is not found.
+ */
+static int decode_function (Decode_Type *d) /*{{{*/
+{
+   SLang_Name_Type *nt;
+   unsigned long id;
+   unsigned char *p;
+   char *name, *base;
+   Pool_Len_Type len;
+
+   if ((-1 == get_bytes (d, &id, sizeof (unsigned long)))
+       || (NULL == (p = get_chars (d, &len)))
+       || (NULL == (name = SLang_create_nslstring ((char *) p, len))))
+     return -1;
+
+   if (id == 0)
+     nt = SLang_get_function (name);
+   else
+     {
+	/* The id is looked up by the unqualified name */
+	base = name;
+	while (NULL != (p = (unsigned char *) strstr (base, "->")))
+	  base = (char *) p + 2;
+	nt = SLang_get_function_from_id (base, id);
+     }
+
+   if (nt == NULL)
+     {
+	SLang_verror (SL_UndefinedName_Error,
+		      "pool: function %s is not defined in the worker, or has been redefined since the pool was created",
+		      name);
+	SLang_free_slstring (name);
+	return -1;
+     }
+   SLang_free_slstring (name);
+   return SLang_push_function (nt);
+}
+/*}}}*/
+
+static int decode_object (Decode_Type *d, unsigned int depth) /*{{{*/
+{
+   unsigned char tag, *p;
+   Pool_Len_Type len, type;
+
+   if (depth > MAX_ENCODE_DEPTH)
+     return decode_error ();
+
+   if (-1 == get_bytes (d, &tag, 1))
+     return -1;
+
+   switch (tag)
+     {
+      case TAG_NULL:
+	return SLang_push_null ();
+
+      case TAG_STRING:
+	  {
+	     char *s;
+	     int status;
+
+	     if ((NULL == (p = get_chars (d, &len)))
+		 || (NULL == (s = SLang_create_nslstring ((char *) p, len))))
+	       return -1;
+	     status = SLang_push_string (s);
+	     SLang_free_slstring (s);
+	     return status;
+	  }
+
+      case TAG_BSTRING:
+	  {
+	     SLang_BString_Type *bs;
+	     int status;
+
+	     if ((NULL == (p = get_chars (d, &len)))
+		 || (NULL == (bs = SLbstring_create (p, len))))
+	       return -1;
+	     status = SLang_push_bstring (bs);
+	     SLbstring_free (bs);
+	     return status;
+	  }
+
+      case TAG_SCALAR:
+	  {
+	     unsigned char buf[64];
+	     SLang_Array_Type *at;
+	     SLindex_Type one = 1;
+	     int status;
+
+	     if (-1 == get_len (d, &type))
+	       return -1;
+	     if (0 == is_raw_type (type))
+	       return decode_error ();
+	     /* Use a temporary array to find the size of the type */
+	     if (NULL == (at = SLang_create_array ((SLtype) type, 0, NULL, &one, 1)))
+	       return -1;
+	     status = -1;
+	     if ((at->sizeof_type <= sizeof (buf))
+		 && (0 == get_bytes (d, buf, at->sizeof_type)))
+	       status = SLang_push_value ((SLtype) type, (VOID_STAR) buf);
+	     SLang_free_array (at);
+	     return status;
+	  }
+
+      case TAG_ARRAY:
+	return decode_array (d, depth);
+
+      case TAG_STRUCT:
+	return decode_struct (d, depth);
+
+      case TAG_LIST:
+	return decode_list (d, depth);
+
+      case TAG_FUNCTION:
+	return decode_function (d);
+
+      default:
+	break;
+     }
+   return decode_error ();
+}
+/*}}}*/
+
+static int encode_to_buffer (Buffer_Type *b)
+{
+   b->buf = NULL;
+   b->len = b->size = 0;
+
+   if (0 == encode_object (b, 0))
+     return 0;
+
+   SLfree ((char *) b->buf);
+   b->buf = NULL;
+   return -1;
+}
+
+static int decode_buffer (unsigned char *buf, SLstrlen_Type len)
+{
+   Decode_Type d;
+
+   d.ptr = buf;
+   d.pmax = buf + len;
+   if (-1 == decode_object (&d, 0))
+     return -1;
+
+   if (d.ptr != d.pmax)
+     {
+	(void) SLdo_pop ();
+	return decode_error ();
+     }
+   return 0;
+}
+
+/* Usage: bstr = _pool_encode (obj) */
+static void pool_encode_intrin (void) /*{{{*/
+{
+   Buffer_Type b;
+   SLang_BString_Type *bs;
+
+   if (-1 == encode_to_buffer (&b))
+     return;
+
+   bs = SLbstring_create_malloced (b.buf, b.len, 1);
+   if (bs == NULL)
+     return;
+   (void) SLang_push_bstring (bs);
+   SLbstring_free (bs);
+}
+/*}}}*/
+
+/* Usage: obj = _pool_decode (bstr) */
+static void pool_decode_intrin (void) /*{{{*/
+{
+   SLang_BString_Type *bs;
+   unsigned char *ptr;
+   SLstrlen_Type len;
+
+   if (-1 == SLang_pop_bstring (&bs))
+     return;
+
+   if (NULL != (ptr = SLbstring_get_pointer (bs, &len)))
+     (void) decode_buffer (ptr, len);
+   SLbstring_free (bs);
+}
+/*}}}*/
+
+/* Usage: (fd_parent, fd_worker) = _pool_channel () */
+static void pool_channel_intrin (void) /*{{{*/
+{
+#ifdef HAVE_SOCKETPAIR
+   SLFile_FD_Type *f0, *f1;
+   int fds[2];
+
+   if (-1 == socketpair (AF_UNIX, SOCK_STREAM, 0, fds))
+     {
+	SLerrno_set_errno (errno);
+	SLang_verror (SL_OS_Error, "pool: socketpair failed: %s",
+		      SLerrno_strerror (errno));
+	return;
+     }
+
+   if (NULL == (f0 = SLfile_create_fd ("*pool*", fds[0])))
+     {
+	(void) close (fds[0]);
+	(void) close (fds[1]);
+	return;
+     }
+   if (NULL == (f1 = SLfile_create_fd ("*pool*", fds[1])))
+     {
+	SLfile_free_fd (f0);
+	(void) close (fds[1]);
+	return;
+     }
+   (void) SLfile_push_fd (f0);
+   (void) SLfile_push_fd (f1);
+   SLfile_free_fd (f0);
+   SLfile_free_fd (f1);
+#else
+   SLang_verror (SL_NotImplemented_Error, "pool: socketpair is not supported on this system");
+#endif
+}
+/*}}}*/
+
+static int write_all (int fd, unsigned char *buf, SLstrlen_Type len) /*{{{*/
+{
+   while (len > 0)
+     {
+	ssize_t n;
+#if defined(HAVE_SYS_SOCKET_H) && defined(MSG_NOSIGNAL)
+	/* A worker that has exited must not raise SIGPIPE in the parent */
+	n = send (fd, buf, len, MSG_NOSIGNAL);
+	if ((n == -1) && (errno == ENOTSOCK))
+	  n = write (fd, buf, len);
+#else
+	n = write (fd, buf, len);
+#endif
+	if (n == -1)
+	  {
+#ifdef EINTR
+	     if ((errno == EINTR) && (0 == SLang_handle_interrupt ()))
+	       continue;
+#endif
+	     return -1;
+	  }
+	buf += n;
+	len -= n;
+     }
+   return 0;
+}
+/*}}}*/
+
+/* Returns the number of bytes read, which is less than len only at EOF */
+static int read_all (int fd, unsigned char *buf, SLstrlen_Type len, SLstrlen_Type *nreadp) /*{{{*/
+{
+   SLstrlen_Type nread = 0;
+
+   while (nread < len)
+     {
+	ssize_t n = read (fd, buf + nread, len - nread);
+	if (n == -1)
+	  {
+#ifdef EINTR
+	     if ((errno == EINTR) && (0 == SLang_handle_interrupt ()))
+	       continue;
+#endif
+	     return -1;
+	  }
+	if (n == 0)
+	  break;
+	nread += n;
+     }
+   *nreadp = nread;
+   return 0;
+}
+/*}}}*/
+
+static int pop_fd (int *fdp)
+{
+   SLFile_FD_Type *f;
+   int status;
+
+   if (-1 == SLfile_pop_fd (&f))
+     return -1;
+   status = SLfile_get_fd (f, fdp);
+   SLfile_free_fd (f);
+   return status;
+}
+
+/* Usage: status = _pool_send (fd, obj);
+ * Returns 0 upon success, or -1 with errno set if the write failed.
+ */
+static int pool_send_intrin (void) /*{{{*/
+{
+   Buffer_Type b;
+   Pool_Len_Type len;
+   int fd, status;
+
+   if (-1 == encode_to_buffer (&b))
+     {
+	(void) SLdo_pop ();	       /* the fd */
+	return -1;
+     }
+
+   if (-1 == pop_fd (&fd))
+     {
+	SLfree ((char *) b.buf);
+	return -1;
+     }
+
+   len = b.len;
+   status = 0;
+   if ((-1 == write_all (fd, (unsigned char *) &len, sizeof (Pool_Len_Type)))
+       || (-1 == write_all (fd, b.buf, b.len)))
+     {
+	SLerrno_set_errno (errno);
+	status = -1;
+     }
+   SLfree ((char *) b.buf);
+   return status;
+}
+/*}}}*/
+
+/* Usage: (obj, status) = _pool_recv (fd);
+ * status is 1 if an object was read, 0 upon end of file, and -1 if the read
+ * failed.  obj is NULL unless status is 1.
+ */
+static void pool_recv_intrin (void) /*{{{*/
+{
+   SLFile_FD_Type *f;
+   Pool_Len_Type len;
+   SLstrlen_Type nread;
+   unsigned char *buf;
+   int fd, status;
+
+   if (-1 == SLfile_pop_fd (&f))
+     return;
+   status = SLfile_get_fd (f, &fd);
+   SLfile_free_fd (f);
+   if (status == -1)
+     return;
+
+   if (-1 == read_all (fd, (unsigned char *) &len, sizeof (Pool_Len_Type), &nread))
+     goto return_errno;
+   if (nread == 0)
+     goto return_eof;
+   if (nread != sizeof (Pool_Len_Type))
+     {
+	(void) decode_error ();
+	return;
+     }
+
+   if (NULL == (buf = (unsigned char *) SLmalloc (len + 1)))
+     return;
+
+   if (-1 == read_all (fd, buf, len, &nread))
+     {
+	SLfree ((char *) buf);
+	goto return_errno;
+     }
+   if (nread != len)
+     {
+	SLfree ((char *) buf);
+	(void) decode_error ();
+	return;
+     }
+
+   status = decode_buffer (buf, len);
+   SLfree ((char *) buf);
+   if (status == 0)
+     (void) SLang_push_int (1);
+   return;
+
+return_errno:
+   SLerrno_set_errno (errno);
+   (void) SLang_push_null ();
+   (void) SLang_push_int (-1);
+   return;
+
+return_eof:
+   (void) SLang_push_null ();
+   (void) SLang_push_int (0);
+}
+/*}}}*/
+
+static SLang_Intrin_Fun_Type Module_Intrinsics [] =
+{
+   MAKE_INTRINSIC_0("_pool_channel", pool_channel_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_pool_send", pool_send_intrin, SLANG_INT_TYPE),
+   MAKE_INTRINSIC_0("_pool_recv", pool_recv_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_pool_encode", pool_encode_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_pool_decode", pool_decode_intrin, SLANG_VOID_TYPE),
+   SLANG_END_INTRIN_FUN_TABLE
+};
+
+int init_pool_module_ns (char *ns_name)
+{
+   SLang_NameSpace_Type *ns = SLns_create_namespace (ns_name);
+   if (ns == NULL)
+     return -1;
+
+   if (-1 == SLns_add_intrin_fun_table (ns, Module_Intrinsics, NULL))
+     return -1;
+
+   return 0;
+}
+
+/* This function is optional */
+void deinit_pool_module (void)
+{
+}
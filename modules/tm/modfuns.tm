@@ -135,6 +135,12 @@ The \module{png} module includes a number of functions for dealing
 with PNG images and colormaps.  Use \exmp{require("png")} to load it.
 #i pngfuns.tm
 
+\chapter{Process Pool Module}
+The \module{pool} module runs \slang functions in parallel using a
+pool of forked worker processes.  Use \exmp{require("pool")} to load
+it.  It requires the \module{fork} and \module{select} modules.
+#i poolfuns.tm
+
 \chapter{Random Number Module}
 The \module{rand} module provides a number of random number functions.
 It may be loaded using \exmp{require("rand")}.
@@ -157,4 +163,9 @@ This module has has a number of statistics functions. Use
 \exmp{require("stats")} to load it.
 #i statsfuns.tm
 
+\chapter{Varray Module}
+The \module{varray} module creates arrays whose data are mapped from
+files or shared memory.  Use \exmp{require("varray")} to load it.
+#i varrayfuns.tm
+
 \end{\documentstyle}
@@ -84,6 +84,11 @@
  Upon success, this function returns a positive integer equal to 1 plus the
  number of so-called captured substrings.  It will return 0 if the pattern
  failed to match the string.
+
+ If \var{str} is an array of strings, the pattern is applied to each
+ element of the array and an array of the same shape holding the
+ individual return values is returned.  In this case, the functions that
+ return captured substrings refer to the match of the last element.
 \seealso{onig_new, onig_nth_match, onig_nth_substr}
 \done
 
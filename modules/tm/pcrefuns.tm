@@ -58,6 +58,11 @@
  Upon success, this function returns a positive integer equal to 1 plus the
  number of so-called captured substrings.  It returns 0 if the pattern
  fails to match the string.
+
+ If \var{str} is an array of strings, the pattern is applied to each
+ element of the array and an array of the same shape holding the
+ individual return values is returned.  In this case, the functions that
+ return captured substrings refer to the match of the last element.
 \seealso{pcre_compile, pcre_nth_match, pcre_nth_substr, pcre_matches}
 \done
 
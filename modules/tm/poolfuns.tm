@@ -0,0 +1,116 @@
+\function{pool_new}
+\synopsis{Create a pool of worker processes}
+\usage{p = pool_new (Int_Type num_workers)}
+\description
+  This function forks \exmp{num_workers} worker processes and returns
+  an object that represents the pool.  The workers are copies of the
+  calling process, and share all of the functions and variables that
+  were defined at the time of the call.  Jobs may be passed to the
+  workers using the \sfun{pool_submit} and \sfun{pool_map} functions.
+\qualifiers
+\qualifier{init}{reference to a function to be called by each worker when it starts}
+\notes
+  Functions are passed to the workers by reference, and only functions
+  that were defined before the pool was created may be used.  A job
+  that calls a function that was defined or redefined since then fails
+  with \exmp{UndefinedNameError}.  The arguments and results of a job
+  are copied between the processes, and may consist of numbers,
+  strings, binary strings, arrays, lists, structures, and references
+  to functions.  Associative arrays and references to variables are
+  not supported.
+
+  The \exmp{init} function is run in the worker processes, and not in
+  the calling process.  It may be used to set up per-worker state such
+  as open files.
+
+  Large numeric arrays may be shared with the workers instead of copied
+  by creating them with the \ifun{shm_array} function of the
+  \module{varray} module before the pool is created.  Values written
+  into such an array by a worker are seen by the other processes, e.g.,
+#v+
+    variable out = shm_array (Double_Type, [n]);
+    define work (i) { out[i] = compute (i); return 0; }
+    p = pool_new (4);
+    () = pool_map (p, &work, [0:n-1]);
+#v-
+\seealso{pool_map, pool_submit, pool_close, fork}
+\done
+
+\function{pool_map}
+\synopsis{Apply a function to each element of an array or list in parallel}
+\usage{results = pool_map (p, Ref_Type func, Array_Type|List_Type a)}
+\description
+  This function calls \exmp{func} for each element of \exmp{a} using
+  the worker processes of the pool \exmp{p}, and returns the results.
+  The function must return a single value.  If \exmp{a} is a list, a
+  list of the results will be returned.  Otherwise the results are
+  returned as an array with the same shape as \exmp{a}.
+
+  The elements of \exmp{a} are sent to the workers in chunks to reduce
+  the overhead of passing the individual elements between the
+  processes.
+\qualifiers
+\qualifier{chunksize}{number of elements per job}{length(a)/(4*num_workers)}
+\example
+#v+
+    define slow_square (x) { sleep (0.1); return x*x; }
+    variable p = pool_new (4);
+    variable y = pool_map (p, &slow_square, [1:100]);
+    pool_close (p);
+#v-
+\notes
+  If \exmp{func} throws an exception in a worker process, the same
+  exception will be thrown by \ifun{pool_map}.
+\seealso{pool_new, pool_submit, array_map}
+\done
+
+\function{pool_submit}
+\synopsis{Call a function in a worker process}
+\usage{future = pool_submit (p, Ref_Type func, args...)}
+\description
+  This function queues a call to \exmp{func} with the specified
+  arguments to be run by one of the workers of the pool \exmp{p}, and
+  returns immediately.  The object that it returns may be passed to
+  \sfun{pool_wait} to obtain the values returned by the function, or to
+  \sfun{pool_ready} to see whether the call has finished.
+\example
+#v+
+    variable f1 = pool_submit (p, &compute, data1);
+    variable f2 = pool_submit (p, &compute, data2);
+    variable r1 = pool_wait (f1), r2 = pool_wait (f2);
+#v-
+\seealso{pool_wait, pool_ready, pool_map, pool_new}
+\done
+
+\function{pool_wait}
+\synopsis{Wait for a function call submitted to a pool to finish}
+\usage{values = pool_wait (future)}
+\description
+  This function waits for the call associated with \exmp{future} to
+  finish, and returns the values that the function returned.  If the
+  function threw an exception, the same exception will be thrown by
+  \ifun{pool_wait}.  If the worker process exited during the call, a
+  \exmp{RunTimeError} exception will be thrown, and the pool will start
+  a new worker in its place.
+\seealso{pool_submit, pool_ready}
+\done
+
+\function{pool_ready}
+\synopsis{See whether a function call submitted to a pool has finished}
+\usage{Int_Type pool_ready (future)}
+\description
+  This function returns 1 if the call associated with \exmp{future}
+  has finished, in which case \sfun{pool_wait} will return without
+  waiting.  Otherwise it returns 0.
+\seealso{pool_submit, pool_wait}
+\done
+
+\function{pool_close}
+\synopsis{Stop the worker processes of a pool}
+\usage{pool_close (p)}
+\description
+  This function closes the connections to the worker processes of the
+  pool \exmp{p} and waits for them to exit.  Calls that have not yet
+  finished will fail with a \exmp{RunTimeError} exception.
+\seealso{pool_new}
+\done
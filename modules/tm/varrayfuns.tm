@@ -0,0 +1,48 @@
+\function{mmap_array}
+\synopsis{Map a file into a read-only array}
+\usage{Array_Type mmap_array (String_Type file, offset, DataType_Type type, Int_Type[] dims)}
+\description
+  This function uses the \exmp{mmap} system function to map the
+  contents of the specified file, starting at the byte \exmp{offset},
+  into an array of the specified type and dimensions.  The array is
+  read-only, and its data are read from the file as they are accessed.
+  The data type must be a numeric type.
+\seealso{shm_array}
+\done
+
+\function{shm_array}
+\synopsis{Create an array whose data are shared with forked processes}
+\usage{Array_Type shm_array (DataType_Type type, Int_Type[] dims)}
+\description
+  This function creates an array of the specified numeric type and
+  dimensions whose data are allocated in a shared memory mapping.
+  Unless the \exmp{file} qualifier is used, the elements of the array
+  are initialized to 0.  Child processes
+  created by \ifun{fork} after the array was created share the data
+  with the parent process: a value written into the array by one of
+  the processes is seen by all of them without being copied.
+\qualifiers
+\qualifier{file}{back the mapping by this file, which is created or extended as necessary}
+\example
+#v+
+    variable a = shm_array (Double_Type, [1000]);
+    variable pid = fork ();
+    if (pid == 0)
+      {
+         a[[0:499]] = 1.0;
+         _exit (0);
+      }
+    a[[500:999]] = 2.0;
+    () = waitpid (pid, 0);
+    % sum(a) is now 1500
+#v-
+\notes
+  Only the data are shared; an operation that creates a new array,
+  such as \exmp{a = a + 1}, produces an ordinary array.  Use an
+  assignment such as \exmp{a[*] += 1} to change the shared values.
+
+  If the \exmp{file} qualifier is used, unrelated processes that map
+  the same file share the data as well.  On Linux, a file in
+  \exmp{/dev/shm} may be used to avoid writing the data to disk.
+\seealso{mmap_array, fork, pool_new}
+\done
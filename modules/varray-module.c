@@ -30,6 +30,13 @@ SLANG_MODULE(varray);
 
 # include <sys/types.h>
 # include <sys/stat.h>
+# include <errno.h>
+# ifdef HAVE_UNISTD_H
+#  include <unistd.h>
+# endif
+# ifdef HAVE_FCNTL_H
+#  include <fcntl.h>
+# endif
 # ifdef HAVE_SYS_MMAN_H
 #  include <sys/mman.h>
 # endif
@@ -37,6 +44,9 @@ SLANG_MODULE(varray);
 # ifndef MAP_FAILED
 #  define MAP_FAILED	-1
 # endif
+# if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS	MAP_ANON
+# endif
 
 typedef struct
 {
@@ -138,82 +148,62 @@ static int pop_size_t (size_t *sp)
 #endif
 }
 
-/* usage:
- *  a = mmap_array (file, offset, type, [dims]);
- */
-static void mmap_array (void)
+static int get_sizeof_type (SLFUTURE_CONST char *fun, SLtype type, size_t *sizep)
 {
-   SLang_Array_Type *a, *a_dims;
-   char *file;
-   SLtype type;
-   SLindex_Type *dims;
-   unsigned int num_dims;
-   unsigned int i;
-   SLuindex_Type num_elements;
-   size_t offset;
-   size_t sizeof_type;
-   size_t num_bytes;
-   MMap_Type *m;
-
-   m = NULL;
-   a_dims = NULL;
-   file = NULL;
-
-   if (-1 == SLang_pop_array_of_type (&a_dims, SLANG_ARRAY_INDEX_TYPE))
-     return;
-
-   num_dims = a_dims->num_elements;
-   dims = (SLindex_Type *)a_dims->data;
-
-   if (-1 == SLang_pop_datatype (&type))
-     goto return_error;
-
    switch (type)
      {
       case SLANG_CHAR_TYPE:
       case SLANG_UCHAR_TYPE:
-	sizeof_type = 1;
+	*sizep = 1;
 	break;
 
       case SLANG_SHORT_TYPE:
       case SLANG_USHORT_TYPE:
-	sizeof_type = sizeof(short);
+	*sizep = sizeof(short);
 	break;
 
       case SLANG_INT_TYPE:
       case SLANG_UINT_TYPE:
-	sizeof_type = sizeof (int);
+	*sizep = sizeof (int);
 	break;
 
       case SLANG_LONG_TYPE:
       case SLANG_ULONG_TYPE:
-	sizeof_type = sizeof (long);
+	*sizep = sizeof (long);
 	break;
 
       case SLANG_FLOAT_TYPE:
-	sizeof_type = sizeof (float);
+	*sizep = sizeof (float);
 	break;
 
       case SLANG_DOUBLE_TYPE:
-	sizeof_type = sizeof (double);
+	*sizep = sizeof (double);
 	break;
 
       case SLANG_COMPLEX_TYPE:
-	sizeof_type = 2 * sizeof (double);
+	*sizep = 2 * sizeof (double);
 	break;
 
       default:
-	SLang_verror (SL_NOT_IMPLEMENTED, "mmap_array: unsupported data type");
-	goto return_error;
+	SLang_verror (SL_NOT_IMPLEMENTED, "%s: unsupported data type", fun);
+	return -1;
      }
+   return 0;
+}
+
+static int get_num_elements (SLFUTURE_CONST char *fun, SLindex_Type *dims, unsigned int num_dims,
+			     SLuindex_Type *nump)
+{
+   SLuindex_Type num_elements;
+   unsigned int i;
 
    num_elements = 1;
    for (i = 0; i < num_dims; i++)
      {
 	if (dims[i] < 0)
 	  {
-	     SLang_verror (SL_INVALID_PARM, "mmap_array: dims array must be positive");
-	     goto return_error;
+	     SLang_verror (SL_INVALID_PARM, "%s: dims array must be positive", fun);
+	     return -1;
 	  }
 
 	num_elements *= dims[i];
@@ -221,6 +211,43 @@ static void mmap_array (void)
    if (num_dims == 0)
      num_elements = 0;
 
+   *nump = num_elements;
+   return 0;
+}
+
+/* usage:
+ *  a = mmap_array (file, offset, type, [dims]);
+ */
+static void mmap_array (void)
+{
+   SLang_Array_Type *a, *a_dims;
+   char *file;
+   SLtype type;
+   SLindex_Type *dims;
+   unsigned int num_dims;
+   SLuindex_Type num_elements;
+   size_t offset;
+   size_t sizeof_type;
+   size_t num_bytes;
+   MMap_Type *m;
+
+   m = NULL;
+   a_dims = NULL;
+   file = NULL;
+
+   if (-1 == SLang_pop_array_of_type (&a_dims, SLANG_ARRAY_INDEX_TYPE))
+     return;
+
+   num_dims = a_dims->num_elements;
+   dims = (SLindex_Type *)a_dims->data;
+
+   if (-1 == SLang_pop_datatype (&type))
+     goto return_error;
+
+   if ((-1 == get_sizeof_type ("mmap_array", type, &sizeof_type))
+       || (-1 == get_num_elements ("mmap_array", dims, num_dims, &num_elements)))
+     goto return_error;
+
    num_bytes = sizeof_type * num_elements;
 
    if (-1 == pop_size_t (&offset))
@@ -252,12 +279,129 @@ static void mmap_array (void)
    if (file != NULL)
      SLang_free_slstring (file);
 }
+/* Map num_bytes of memory that is shared with child processes created by
+ * fork.  If file is non-NULL, the mapping is backed by that file, which is
+ * created or extended as necessary, and may also be shared with unrelated
+ * processes that map the same file.
+ */
+static MMap_Type *mmap_shared (char *file, size_t num_bytes)
+{
+   MMap_Type *m;
+   VOID_STAR addr;
+   int flags = MAP_SHARED;
+   int fd = -1;
+
+   if (NULL == (m = (MMap_Type *) SLmalloc (sizeof (MMap_Type))))
+     return NULL;
+
+   /* mmap does not permit a length of 0 */
+   m->size_mmapped = (num_bytes ? num_bytes : 1);
+
+   if (file == NULL)
+     {
+# ifdef MAP_ANONYMOUS
+	flags |= MAP_ANONYMOUS;
+# else
+	SLang_verror (SL_NOT_IMPLEMENTED, "shm_array: anonymous mappings are not supported; use the file qualifier");
+	SLfree ((char *) m);
+	return NULL;
+# endif
+     }
+   else
+     {
+	struct stat st;
+
+	fd = open (file, O_RDWR|O_CREAT, 0600);
+	if (fd == -1)
+	  {
+	     SLang_verror (SL_OBJ_NOPEN, "shm_array: unable to open %s: %s",
+			   file, SLerrno_strerror (errno));
+	     SLfree ((char *) m);
+	     return NULL;
+	  }
+	if ((-1 == fstat (fd, &st))
+	    || (((size_t) st.st_size < m->size_mmapped)
+		&& (-1 == ftruncate (fd, m->size_mmapped))))
+	  {
+	     SLang_verror (SL_INTRINSIC_ERROR, "shm_array: unable to size %s: %s",
+			   file, SLerrno_strerror (errno));
+	     (void) close (fd);
+	     SLfree ((char *) m);
+	     return NULL;
+	  }
+     }
+
+   addr = (VOID_STAR)mmap (NULL, m->size_mmapped, PROT_READ|PROT_WRITE, flags, fd, 0);
+   if (fd != -1)
+     (void) close (fd);
+
+   if (addr == (VOID_STAR)MAP_FAILED)
+     {
+	SLang_verror (SL_INTRINSIC_ERROR, "shm_array: mmap failed: %s", SLerrno_strerror (errno));
+	SLfree ((char *) m);
+	return NULL;
+     }
+   m->addr = addr;
+   m->data = addr;
+   return m;
+}
+
+/* usage:
+ *  a = shm_array (type, [dims] ; file=name);
+ */
+static void shm_array (void)
+{
+   SLang_Array_Type *a, *a_dims;
+   char *file;
+   SLtype type;
+   SLindex_Type *dims;
+   unsigned int num_dims;
+   SLuindex_Type num_elements;
+   size_t sizeof_type;
+   MMap_Type *m;
+
+   m = NULL;
+   file = NULL;
+
+   if (-1 == SLang_pop_array_of_type (&a_dims, SLANG_ARRAY_INDEX_TYPE))
+     return;
+
+   num_dims = a_dims->num_elements;
+   dims = (SLindex_Type *)a_dims->data;
+
+   if ((-1 == SLang_pop_datatype (&type))
+       || (-1 == get_sizeof_type ("shm_array", type, &sizeof_type))
+       || (-1 == get_num_elements ("shm_array", dims, num_dims, &num_elements))
+       || (-1 == SLang_get_string_qualifier ("file", &file, NULL)))
+     goto return_error;
+
+   if (NULL == (m = mmap_shared (file, sizeof_type * num_elements)))
+     goto return_error;
+
+   if (NULL == (a = SLang_create_array (type, 0, m->data, dims, num_dims)))
+     goto return_error;
+
+   a->free_fun = unmmap_array;
+   a->client_data = (VOID_STAR) m;
+
+   m = NULL;			       /* done with this */
+
+   (void) SLang_push_array (a, 1);
+
+   return_error:
+   if (m != NULL)
+     free_mmap_type (m);
+   SLang_free_array (a_dims);
+   if (file != NULL)
+     SLang_free_slstring (file);
+}
 #endif				       /* HAVE_MMAP */
 
 static SLang_Intrin_Fun_Type Module_Intrinsics [] =
 {
 #ifdef HAVE_MMAP
    MAKE_INTRINSIC_0("mmap_array", mmap_array, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("shm_array", shm_array, SLANG_VOID_TYPE),
 #endif
    SLANG_END_INTRIN_FUN_TABLE
 };
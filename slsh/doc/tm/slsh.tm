@@ -12,6 +12,8 @@
 \mansynopsis{slsh}{
   \arg{\option{--help}}
   \arg{\option{--version}}
+  \arg{\option{--cache}}
+  \arg{\option{--lazy}}
   \arg{\option{-g}}
   \arg{\option{-n}}
   \arg{\option{--init}{file}}
@@ -43,6 +45,14 @@
       \man_options_entry{\option{--version}}{
         Show \slsh version information
       }
+      \man_options_entry{\option{--cache}}{
+        Save the compiled form of each loaded file as a bytecode image
+        and use it to load the file when it has not changed
+      }
+      \man_options_entry{\option{--lazy}}{
+        Compile the body of each function when the function is first called
+        rather than when it is defined
+      }
       \man_options_entry{\option{-g}}{
         Compile with debugging code, tracebacks, etc
       }
@@ -474,6 +474,8 @@ static void usage (void)
 Usage: slsh [OPTIONS] [-|file [args...]]\n\
  --help           Print this help\n\
  --version        Show slsh version information\n\
+ --cache          Save and use bytecode images of loaded files\n\
+ --lazy           Compile function bodies when they are first called\n\
  -e string        Execute 'string' as S-Lang code\n\
  -g               Compile with debugging code, tracebacks, etc\n\
  -n               Don't load personal init file\n\
@@ -644,6 +646,22 @@ int main (int argc, char **argv)
 	     continue;
 	  }
 
+	if (0 == strcmp (arg, "--cache"))
+	  {
+	     (void) SLang_bytecode_cache (SLANG_BYTECODE_CACHE_READ|SLANG_BYTECODE_CACHE_WRITE);
+	     argc--;
+	     argv++;
+	     continue;
+	  }
+
+	if (0 == strcmp (arg, "--lazy"))
+	  {
+	     (void) SLang_lazy_compile (1);
+	     argc--;
+	     argv++;
+	     continue;
+	  }
+
 	if (0 == strcmp (arg, "--no-readline"))
 	  {
 	     use_readline = 0;
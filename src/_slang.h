@@ -138,12 +138,13 @@ typedef enum
    SLANG_BC_BINARY		= 0x51,
    SLANG_BC_INTEGER_PLUS	= 0x52,
    SLANG_BC_INTEGER_MINUS	= 0x53,
-   SLANG_BC_UNUSED_0x54		= 0x54,
-   SLANG_BC_UNUSED_0x55		= 0x55,
-   SLANG_BC_UNUSED_0x56		= 0x56,
-   SLANG_BC_UNUSED_0x57		= 0x57,
-   SLANG_BC_UNUSED_0x58		= 0x58,
-   SLANG_BC_UNUSED_0x59		= 0x59,
+   /* SLANG_BC_BINARY is rewritten to one of these at run-time */
+   SLANG_BC_BINARY_INT		= 0x54,
+   SLANG_BC_BINARY_UINT		= 0x55,
+   SLANG_BC_BINARY_LONG		= 0x56,
+   SLANG_BC_BINARY_LLONG	= 0x57,
+   SLANG_BC_BINARY_FLOAT	= 0x58,
+   SLANG_BC_BINARY_DOUBLE	= 0x59,
    SLANG_BC_UNUSED_0x5A		= 0x5A,
    SLANG_BC_UNUSED_0x5B		= 0x5B,
    SLANG_BC_UNUSED_0x5C		= 0x5C,
@@ -179,7 +180,7 @@ typedef enum
    SLANG_BC_UNUSED_0x74		= 0x74,
    SLANG_BC_BOS			= 0x75,
    SLANG_BC_EOS			= 0x76,
-   SLANG_BC_UNUSED_0x77		= 0x77,
+   SLANG_BC_TAIL_CALL		= 0x77,	       /* return f(...) */
    SLANG_BC_UNUSED_0x78		= 0x78,
    SLANG_BC_UNUSED_0x79		= 0x79,
    SLANG_BC_UNUSED_0x7A		= 0x7A,
@@ -246,15 +247,18 @@ typedef enum
    SLANG_BC_LIT_AGET1_INT_BINARY= 0xB4,
    SLANG_BC_BINARY2		= 0xB5,
    SLANG_BC_LVAR_LIT_AGET1	= 0xB6,
-   SLANG_BC_UNUSED_0xB7		= 0xB7,
-   SLANG_BC_UNUSED_0xB8		= 0xB8,
-   SLANG_BC_UNUSED_0xB9		= 0xB9,
-   SLANG_BC_UNUSED_0xBA		= 0xBA,
-   SLANG_BC_UNUSED_0xBB		= 0xBB,
-   SLANG_BC_UNUSED_0xBC		= 0xBC,
-   SLANG_BC_UNUSED_0xBD		= 0xBD,
-   SLANG_BC_UNUSED_0xBE		= 0xBE,
-   SLANG_BC_UNUSED_0xBF		= 0xBF,
+   /* 0xB7-0xBF and 0xC6-0xFF are used for the superinstructions defined
+    * in slsuperbc.inc.
+    */
+   SLANG_BC_SUPER_0xB7		= 0xB7,
+   SLANG_BC_SUPER_0xB8		= 0xB8,
+   SLANG_BC_SUPER_0xB9		= 0xB9,
+   SLANG_BC_SUPER_0xBA		= 0xBA,
+   SLANG_BC_SUPER_0xBB		= 0xBB,
+   SLANG_BC_SUPER_0xBC		= 0xBC,
+   SLANG_BC_SUPER_0xBD		= 0xBD,
+   SLANG_BC_SUPER_0xBE		= 0xBE,
+   SLANG_BC_SUPER_0xBF		= 0xBF,
 
    /* The following do not actually occur in inner_interp.  They used
     * to signify the bytecode has been combined with another.
@@ -266,64 +270,64 @@ typedef enum
    SLANG_BC_COMBINED		= 0xC4,
    SLANG_BC_BLOCK_COMBINED	= 0xC5,
 #define SLANG_IS_BC_COMBINED(b) ((0xC0 <= (b)) && ((b) <= 0xC5))
-   SLANG_BC_UNUSED_0xC6		= 0xC6,
-   SLANG_BC_UNUSED_0xC7		= 0xC7,
-   SLANG_BC_UNUSED_0xC8		= 0xC8,
-   SLANG_BC_UNUSED_0xC9		= 0xC9,
-   SLANG_BC_UNUSED_0xCA		= 0xCA,
-   SLANG_BC_UNUSED_0xCB		= 0xCB,
-   SLANG_BC_UNUSED_0xCC		= 0xCC,
-   SLANG_BC_UNUSED_0xCD		= 0xCD,
-   SLANG_BC_UNUSED_0xCE		= 0xCE,
-   SLANG_BC_UNUSED_0xCF		= 0xCF,
-   SLANG_BC_UNUSED_0xD0		= 0xD0,
-   SLANG_BC_UNUSED_0xD1		= 0xD1,
-   SLANG_BC_UNUSED_0xD2		= 0xD2,
-   SLANG_BC_UNUSED_0xD3		= 0xD3,
-   SLANG_BC_UNUSED_0xD4		= 0xD4,
-   SLANG_BC_UNUSED_0xD5		= 0xD5,
-   SLANG_BC_UNUSED_0xD6		= 0xD6,
-   SLANG_BC_UNUSED_0xD7		= 0xD7,
-   SLANG_BC_UNUSED_0xD8		= 0xD8,
-   SLANG_BC_UNUSED_0xD9		= 0xD9,
-   SLANG_BC_UNUSED_0xDA		= 0xDA,
-   SLANG_BC_UNUSED_0xDB		= 0xDB,
-   SLANG_BC_UNUSED_0xDC		= 0xDC,
-   SLANG_BC_UNUSED_0xDD		= 0xDD,
-   SLANG_BC_UNUSED_0xDE		= 0xDE,
-   SLANG_BC_UNUSED_0xDF		= 0xDF,
-   SLANG_BC_UNUSED_0xE0		= 0xE0,
-   SLANG_BC_UNUSED_0xE1		= 0xE1,
-   SLANG_BC_UNUSED_0xE2		= 0xE2,
-   SLANG_BC_UNUSED_0xE3		= 0xE3,
-   SLANG_BC_UNUSED_0xE4		= 0xE4,
-   SLANG_BC_UNUSED_0xE5		= 0xE5,
-   SLANG_BC_UNUSED_0xE6		= 0xE6,
-   SLANG_BC_UNUSED_0xE7		= 0xE7,
-   SLANG_BC_UNUSED_0xE8		= 0xE8,
-   SLANG_BC_UNUSED_0xE9		= 0xE9,
-   SLANG_BC_UNUSED_0xEA		= 0xEA,
-   SLANG_BC_UNUSED_0xEB		= 0xEB,
-   SLANG_BC_UNUSED_0xEC		= 0xEC,
-   SLANG_BC_UNUSED_0xED		= 0xED,
-   SLANG_BC_UNUSED_0xEE		= 0xEE,
-   SLANG_BC_UNUSED_0xEF		= 0xEF,
-   SLANG_BC_UNUSED_0xF0		= 0xF0,
-   SLANG_BC_UNUSED_0xF1		= 0xF1,
-   SLANG_BC_UNUSED_0xF2		= 0xF2,
-   SLANG_BC_UNUSED_0xF3		= 0xF3,
-   SLANG_BC_UNUSED_0xF4		= 0xF4,
-   SLANG_BC_UNUSED_0xF5		= 0xF5,
-   SLANG_BC_UNUSED_0xF6		= 0xF6,
-   SLANG_BC_UNUSED_0xF7		= 0xF7,
-   SLANG_BC_UNUSED_0xF8		= 0xF8,
-   SLANG_BC_UNUSED_0xF9		= 0xF9,
-   SLANG_BC_UNUSED_0xFA		= 0xFA,
-   SLANG_BC_UNUSED_0xFB		= 0xFB,
-   SLANG_BC_UNUSED_0xFC		= 0xFC,
-   SLANG_BC_UNUSED_0xFD		= 0xFD,
-   SLANG_BC_UNUSED_0xFE		= 0xFE,
-   SLANG_BC_UNUSED_0xFF		= 0xFF
+   SLANG_BC_SUPER_0xC6		= 0xC6,
+   SLANG_BC_SUPER_0xC7		= 0xC7,
+   SLANG_BC_SUPER_0xC8		= 0xC8,
+   SLANG_BC_SUPER_0xC9		= 0xC9,
+   SLANG_BC_SUPER_0xCA		= 0xCA,
+   SLANG_BC_SUPER_0xCB		= 0xCB,
+   SLANG_BC_SUPER_0xCC		= 0xCC,
+   SLANG_BC_SUPER_0xCD		= 0xCD,
+   SLANG_BC_SUPER_0xCE		= 0xCE,
+   SLANG_BC_SUPER_0xCF		= 0xCF,
+   SLANG_BC_SUPER_0xD0		= 0xD0,
+   SLANG_BC_SUPER_0xD1		= 0xD1,
+   SLANG_BC_SUPER_0xD2		= 0xD2,
+   SLANG_BC_SUPER_0xD3		= 0xD3,
+   SLANG_BC_SUPER_0xD4		= 0xD4,
+   SLANG_BC_SUPER_0xD5		= 0xD5,
+   SLANG_BC_SUPER_0xD6		= 0xD6,
+   SLANG_BC_SUPER_0xD7		= 0xD7,
+   SLANG_BC_SUPER_0xD8		= 0xD8,
+   SLANG_BC_SUPER_0xD9		= 0xD9,
+   SLANG_BC_SUPER_0xDA		= 0xDA,
+   SLANG_BC_SUPER_0xDB		= 0xDB,
+   SLANG_BC_SUPER_0xDC		= 0xDC,
+   SLANG_BC_SUPER_0xDD		= 0xDD,
+   SLANG_BC_SUPER_0xDE		= 0xDE,
+   SLANG_BC_SUPER_0xDF		= 0xDF,
+   SLANG_BC_SUPER_0xE0		= 0xE0,
+   SLANG_BC_SUPER_0xE1		= 0xE1,
+   SLANG_BC_SUPER_0xE2		= 0xE2,
+   SLANG_BC_SUPER_0xE3		= 0xE3,
+   SLANG_BC_SUPER_0xE4		= 0xE4,
+   SLANG_BC_SUPER_0xE5		= 0xE5,
+   SLANG_BC_SUPER_0xE6		= 0xE6,
+   SLANG_BC_SUPER_0xE7		= 0xE7,
+   SLANG_BC_SUPER_0xE8		= 0xE8,
+   SLANG_BC_SUPER_0xE9		= 0xE9,
+   SLANG_BC_SUPER_0xEA		= 0xEA,
+   SLANG_BC_SUPER_0xEB		= 0xEB,
+   SLANG_BC_SUPER_0xEC		= 0xEC,
+   SLANG_BC_SUPER_0xED		= 0xED,
+   SLANG_BC_SUPER_0xEE		= 0xEE,
+   SLANG_BC_SUPER_0xEF		= 0xEF,
+   SLANG_BC_SUPER_0xF0		= 0xF0,
+   SLANG_BC_SUPER_0xF1		= 0xF1,
+   SLANG_BC_SUPER_0xF2		= 0xF2,
+   SLANG_BC_SUPER_0xF3		= 0xF3,
+   SLANG_BC_SUPER_0xF4		= 0xF4,
+   SLANG_BC_SUPER_0xF5		= 0xF5,
+   SLANG_BC_SUPER_0xF6		= 0xF6,
+   SLANG_BC_SUPER_0xF7		= 0xF7,
+   SLANG_BC_SUPER_0xF8		= 0xF8,
+   SLANG_BC_SUPER_0xF9		= 0xF9,
+   SLANG_BC_SUPER_0xFA		= 0xFA,
+   SLANG_BC_SUPER_0xFB		= 0xFB,
+   SLANG_BC_SUPER_0xFC		= 0xFC,
+   SLANG_BC_SUPER_0xFD		= 0xFD,
+   SLANG_BC_SUPER_0xFE		= 0xFE,
+   SLANG_BC_SUPER_0xFF		= 0xFF
 }
 _pSLang_BC_Type;
 
@@ -462,8 +466,10 @@ extern int _pSLstruct_define_struct2 (void);
 extern int _pSLstruct_define_typedef (void);
 
 extern SLang_Object_Type *_pSLstruct_get_field_value (SLang_Struct_Type *, SLCONST char *);
+extern SLang_Object_Type *_pSLstruct_get_field_value_cached (SLang_Struct_Type *, SLCONST char *, unsigned char *);
 extern int _pSLstruct_push_field_ref (SLFUTURE_CONST char *);
 extern int _pSLstruct_push_field (SLang_Struct_Type *s, SLFUTURE_CONST char *name, int do_free);
+extern int _pSLstruct_push_field_cached (SLang_Struct_Type *s, SLFUTURE_CONST char *name, unsigned char *cache, int do_free);
 extern int _pSLstruct_pop_field (SLang_Struct_Type *s, SLFUTURE_CONST char *name, int do_free);
 
 extern int _pSLang_get_qualifiers_intrin (SLang_Struct_Type **);   /* Value is not to be freed by caller */
@@ -499,6 +505,7 @@ extern void SLang_free_object (SLang_Object_Type *);
 extern int _pSLanytype_typecast (SLtype, VOID_STAR, SLuindex_Type,
 				 SLtype, VOID_STAR);
 extern void _pSLstring_intrinsic (void);
+extern void _pSLstring_stats_intrinsic (void);
 extern int _pSLformat_as_binary (unsigned int min_num_bits, int use_binary_prefix);
 
 #if 0
@@ -593,9 +600,12 @@ extern SLFUTURE_CONST char *_pSLang_cur_namespace_intrinsic (void);
 extern SLang_Array_Type *_pSLang_apropos (SLFUTURE_CONST char *, SLFUTURE_CONST char *, unsigned int);
 extern void _pSLang_implements_intrinsic (SLFUTURE_CONST char *);
 extern SLang_Array_Type *_pSLns_list_namespaces (void);
+extern void _pSLns_free_namespaces (void (*)(SLang_Name_Type *));
+extern SLang_NameSpace_Type *_pSLns_swap_namespace_list (SLang_NameSpace_Type *);
 extern SLang_Name_Type *_pSLns_locate_hashed_name (SLang_NameSpace_Type *, SLCONST char *, SLstr_Hash_Type);
 extern int _pSLns_add_hashed_name (SLang_NameSpace_Type *, SLang_Name_Type *, SLstr_Hash_Type);
 extern SLang_NameSpace_Type *_pSLns_find_object_namespace (SLang_Name_Type *nt);
+extern SLang_Name_Type *_pSLns_find_object (SLCONST char *, int (*)(SLang_Name_Type *, VOID_STAR), VOID_STAR);
 extern SLang_Name_Type *_pSLns_locate_name (SLang_NameSpace_Type *, SLCONST char *);
 extern SLang_NameSpace_Type *_pSLns_get_private_namespace (SLFUTURE_CONST char *name, SLFUTURE_CONST char *nsname);
 extern SLang_NameSpace_Type *_pSLns_create_namespace2 (SLFUTURE_CONST char *name, SLFUTURE_CONST char *nsname);
@@ -642,6 +652,8 @@ extern int _pSLcall_bof_handler (SLFUTURE_CONST char *, SLFUTURE_CONST char *);
 extern int _pSLcall_eof_handler (void);
 extern int _pSLcall_debug_hook (SLFUTURE_CONST char *file, int linenum);
 /* extern int _pSLcall_debug_hook (char *file, int linenum, char *funct); */
+#define SLANG_NUM_BOSEOS_HOOKS		5
+extern void _pSLang_swap_boseos_hooks (SLang_Name_Type **);
 #endif
 
 extern char *_pSLstring_dup_hashed_string (SLCONST char *, SLstr_Hash_Type);
@@ -652,6 +664,7 @@ extern int _pSLinit_slcomplex (void);
 
 extern int _pSLang_init_slstrops (void);
 extern int _pSLstrops_do_sprintf_n (int);
+extern char *_pSLstrops_sprintf_n (int);
 extern int _pSLang_sscanf (void);
 extern double _pSLang_atof (SLFUTURE_CONST char *);
 
@@ -967,6 +980,8 @@ extern void _pSLstruct_pop_args (int *);
 extern void _pSLstruct_push_args (SLang_Array_Type *);
 
 extern int _pSLang_init_sllist (void);
+extern int _pSLang_init_slstrbld (void);
+extern int _pSLang_init_slstrvw (void);
 extern int _pSLlist_inline_list (void);
 
 extern int _pSLarray_aput1 (unsigned int);
@@ -1008,6 +1023,18 @@ extern int _pSLcompile_push_context (SLang_Load_Type *);
 extern int _pSLcompile_pop_context (void);
 extern int _pSLang_Auto_Declare_Globals;
 extern int _pSLang_Load_File_Verbose;
+extern int _pSLang_Bytecode_Cache;
+extern int _pSLang_Lazy_Compile;
+
+extern void _pSLcompile_start_image (void);
+extern unsigned char *_pSLcompile_end_image (unsigned int *);
+extern int _pSLcompile_load_image (SLang_Load_Type *,
+				   SLCONST unsigned char *, unsigned int,
+				   int (*)(int, SLFUTURE_CONST char *));
+/* The kinds of preprocessor conditions upon which an image depends */
+#define _pSLIMAGE_GUARD_EXISTS	1
+#define _pSLIMAGE_GUARD_EVAL	2
+extern void _pSLcompile_add_image_guard (int, SLFUTURE_CONST char *, int);
 
 typedef struct _pSLtoken_String_List_Type
 {
@@ -1090,6 +1117,10 @@ extern char *_pSLskip_whitespace (SLCONST char *s);
 /* slospath.c */
 extern char *_pSLpath_find_file (SLFUTURE_CONST char *, int);   /* slstring returned */
 
+/* slsearch.c */
+extern SLuchar_Type *_pSLsearch_bytes (SLuchar_Type *, SLuchar_Type *,
+				       SLuchar_Type *, SLstrlen_Type);
+
 /* Read but do not set this variable. */
 extern volatile int _pSLang_Error;
 
@@ -1400,6 +1431,14 @@ _pSLEval_Context;
 extern int _pSLget_token (_pSLang_Token_Type *);
 extern void _pSLparse_error (int, SLCONST char *, _pSLang_Token_Type *, int);
 extern void _pSLparse_start (SLang_Load_Type *);
+/* The tokens of a function body whose compilation has been deferred until
+ * the function is first called.  See _pSLang_Lazy_Compile.
+ */
+typedef struct _pSLang_Lazy_Body_Type _pSLang_Lazy_Body_Type;
+extern int _pSLparse_lazy_body (SLang_Load_Type *, _pSLang_Lazy_Body_Type *);
+extern void _pSLparse_free_lazy_body (_pSLang_Lazy_Body_Type *);
+extern int _pSLcompile_lazy_body_ok (void);
+extern void _pSLcompile_set_lazy_body (_pSLang_Lazy_Body_Type *);
 extern int _pSLget_rpn_token (_pSLang_Token_Type *);
 extern void _pSLcompile_byte_compiled (void);
 
@@ -1494,6 +1533,19 @@ extern void _pSLang_signal_interrupt (void);
 extern int _pSLsig_block_and_call (int (*)(VOID_STAR), VOID_STAR);
 extern int _pSLsig_handle_signals (void);
 extern int _pSLang_check_signals_hook (VOID_STAR);
+
+/* The sampling profiler (slprof.c) */
+typedef struct
+{
+   SLCONST char *function;	       /* NULL for top-level code */
+   SLCONST char *file;
+   unsigned int line;
+}
+_pSLang_Profile_Frame_Type;
+#define SLPROF_MAX_FRAMES	128
+extern void _pSLang_signal_profiler (void);
+extern void _pSLprof_add_sample (_pSLang_Profile_Frame_Type *, unsigned int);
+extern int _pSLang_init_slprof (void);
 #else
 #define _pSLsig_block_and_call(f,v) f(v)
 #endif
@@ -18,6 +18,13 @@
 
 #define SLANG_USE_INLINE_CODE		1
 
+/* If the compiler supports computed gotos (gcc, clang), the interpreter will
+ * use them to dispatch bytecodes.  Set this to 0 to use a switch statement.
+ */
+#ifndef SLANG_USE_COMPUTED_GOTO
+# define SLANG_USE_COMPUTED_GOTO	1
+#endif
+
 /* Add extra information for tracking down errors. */
 #define SLANG_HAS_DEBUG_CODE		1
 
@@ -38,6 +38,46 @@ USA.
 
 #define USE_UNUSED_BYCODES_IN_SWITCH	1
 
+/* If non-zero, inner_interp will count the pairs of adjacent bytecodes that
+ * it executes and append the counts to stats.txt upon exit.  The output is
+ * used by util/mksuperbc.sl to create slsuperbc.inc.
+ */
+#ifndef GATHER_STATISTICS
+# define GATHER_STATISTICS		0
+#endif
+
+/* Superinstructions are formed from pairs of frequently occurring simple
+ * bytecodes.  They are not used when gathering statistics since the pairs
+ * they replace would not be counted.
+ */
+#if USE_COMBINED_BYTECODES && !GATHER_STATISTICS
+# define USE_SUPER_BYTECODES		1
+#else
+# define USE_SUPER_BYTECODES		0
+#endif
+
+/* A SLANG_BC_BINARY bytecode that keeps seeing operands of the same
+ * arithmetic type is rewritten to a bytecode specialized for that type.
+ */
+#if SLANG_OPTIMIZE_FOR_SPEED
+# define USE_QUICKENED_BINARY		1
+#else
+# define USE_QUICKENED_BINARY		0
+#endif
+
+/* gcc and clang permit the address of a label to be taken and jumped to.
+ * This is used by the inner interpreter to jump from the end of one
+ * bytecode handler directly to the next handler via a table of labels,
+ * rather than going back through a single switch statement.  Since every
+ * bytecode must have an entry in that table, this requires the unused ones
+ * to be present in the switch.
+ */
+#if SLANG_USE_COMPUTED_GOTO && defined(__GNUC__) && USE_UNUSED_BYCODES_IN_SWITCH
+# define USE_COMPUTED_GOTO_DISPATCH	1
+#else
+# define USE_COMPUTED_GOTO_DISPATCH	0
+#endif
+
 struct _pSLBlock_Type;
 
 typedef struct
@@ -55,6 +95,9 @@ typedef struct
 #if SLANG_HAS_BOSEOS
    int issue_bofeof_info;
 #endif
+   /* If non-NULL, the body has not been compiled yet and is NULL */
+   _pSLang_Lazy_Body_Type *lazy_body;
+   unsigned long id;		       /* see SLang_get_function_id */
 }
 Function_Header_Type;
 
@@ -184,6 +227,21 @@ static SLang_Struct_Type **Function_Qualifiers_Stack;
 static _pSLang_Function_Type *Current_Function = NULL;
 static Function_Header_Type *Current_Function_Header;
 
+/* A call in tail position, i.e., return f(...), is performed by saving the
+ * function and its arguments here and returning.  The execute_slang_fun
+ * call that is returned to then calls the function in place of the one
+ * that returned, without growing the C stack or the function stack.  Tail
+ * calls are not used within a try statement or by a function with an
+ * EXIT_BLOCK, since these must run after the called function returns.
+ */
+static _pSLang_Function_Type *Tail_Call_Function;
+static unsigned int Tail_Call_Linenum;
+static int Tail_Call_Num_Args;
+#if SLANG_HAS_QUALIFIERS
+static SLang_Struct_Type *Tail_Call_Qualifiers;
+#endif
+static int Tail_Calls_Disabled = 1;    /* zero while executing a function */
+
 typedef struct
 {
    _pSLang_Function_Type *function;
@@ -222,16 +280,46 @@ static int Lang_Break = 0;
 static int Lang_Return = 0;
 /* static int Lang_Continue = 0; */
 
+/* The stacks grow as needed up to these limits */
+static unsigned int Max_Stack_Len = SLANG_MAX_STACK_LEN;
+static unsigned int Max_Local_Stack_Len = SLANG_MAX_LOCAL_STACK;
+static unsigned int Max_Recursion_Depth = SLANG_MAX_RECURSIVE_DEPTH;
+
 static SLang_Object_Type *Run_Stack;
 static SLang_Object_Type *Stack_Pointer;
 static SLang_Object_Type *Stack_Pointer_Max;
+static unsigned int Run_Stack_Len;     /* allocated size of Run_Stack */
+
+/* Num_Args_Stack, Frame_Pointer_Stack, Function_Qualifiers_Stack, and
+ * Function_Stack have Frame_Stack_Len elements.  Frame_Stack_Max is the
+ * smaller of that and Max_Recursion_Depth.
+ */
+static unsigned int Frame_Stack_Len;
+static unsigned int Frame_Stack_Max;
+
+/* Since pointers to local variables are held by references and by the C
+ * stack, the local variable stack is never moved.  Rather, when a frame
+ * does not fit in the current chunk of the stack, the frame is put in a
+ * new chunk that is twice as large.
+ */
+typedef struct
+{
+   SLang_Object_Type *base;	       /* base[0] is not used */
+   SLang_Object_Type *max;
+   SLang_Object_Type *prev_frame;      /* frame in the previous chunk */
+   unsigned int num_below;	       /* number of slots in previous chunks */
+}
+Local_Stack_Chunk_Type;
+#define MAX_LOCAL_STACK_CHUNKS	32
+static Local_Stack_Chunk_Type Local_Stack_Chunks[MAX_LOCAL_STACK_CHUNKS];
+static unsigned int Local_Stack_Chunk; /* index of the chunk in use */
 
-static SLang_Object_Type *Local_Variable_Stack;
 static SLang_Object_Type *Local_Variable_Stack_Max;
-static SLang_Object_Type *Local_Variable_Frame;   /* points into Local_Variable_Stack */
+static SLang_Object_Type *Local_Variable_Frame;   /* points into a chunk */
 
 #define INTERRUPT_ERROR		0x01
 #define INTERRUPT_SIGNAL	0x02
+#define INTERRUPT_PROFILE	0x04
 static volatile int Handle_Interrupt;	       /* bitmapped value */
 #define IS_SLANG_ERROR	(Handle_Interrupt & INTERRUPT_ERROR)
 
@@ -239,6 +327,7 @@ static void free_function_header (Function_Header_Type *);
 
 #if SLANG_HAS_SIGNALS
 static int check_signals (void);
+static void take_profile_sample (SLBlock_Type *);
 #endif
 
 #if SLANG_OPTIMIZE_FOR_SPEED
@@ -298,6 +387,48 @@ static int init_interpreter (void);
 
 /* These routines are assumed to work even in the presence of a SLang_Error. */
 
+/* Make room for n more objects on the run-time stack.  Since the stack may
+ * move, pointers into it must not be held across a push.
+ */
+static int grow_run_stack (unsigned int n)
+{
+   SLang_Object_Type *new_stack;
+   unsigned int depth, len;
+
+   depth = (unsigned int) (Stack_Pointer - Run_Stack);
+   if ((depth > Max_Stack_Len) || (n > Max_Stack_Len - depth))
+     {
+	(void) SLang_set_error (SL_STACK_OVERFLOW);
+	return -1;
+     }
+
+   len = Run_Stack_Len;
+   while (len < depth + n)
+     {
+	if (len > Max_Stack_Len/2)
+	  {
+	     len = Max_Stack_Len;
+	     break;
+	  }
+	len *= 2;
+     }
+   if (len > Max_Stack_Len)
+     len = Max_Stack_Len;
+
+   if (len > Run_Stack_Len)
+     {
+	new_stack = (SLang_Object_Type *) _SLrecalloc ((char *) Run_Stack, len, sizeof (SLang_Object_Type));
+	if (new_stack == NULL)
+	  return -1;
+	Frame_Pointer = new_stack + (Frame_Pointer - Run_Stack);
+	Stack_Pointer = new_stack + depth;
+	Run_Stack = new_stack;
+	Run_Stack_Len = len;
+     }
+   Stack_Pointer_Max = Run_Stack + len;
+   return 0;
+}
+
 _INLINE_ static int pop_object (SLang_Object_Type *x)
 {
    register SLang_Object_Type *y;
@@ -522,8 +653,9 @@ _INLINE_ static int push_object (SLang_Object_Type *x)
    /* flag it now */
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  return -1;
+	y = Stack_Pointer;
      }
 
    *y = *x;
@@ -544,8 +676,9 @@ int SLclass_push_ptr_obj (SLtype type, VOID_STAR pval)
 
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  return -1;
+	y = Stack_Pointer;
      }
 
    y->o_data_type = type;
@@ -562,8 +695,9 @@ _INLINE_ static int push_int_object (SLtype type, int x)
 
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  return -1;
+	y = Stack_Pointer;
      }
 
    y->o_data_type = type;
@@ -583,8 +717,9 @@ _INLINE_ static int push_array_index (SLtype type, SLindex_Type x)
 
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  return -1;
+	y = Stack_Pointer;
      }
 
    y->o_data_type = type;
@@ -608,9 +743,12 @@ int _pSLang_push_array (SLang_Array_Type *at, int free_array)
 
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	if (free_array) SLang_free_array (at);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  {
+	     if (free_array) SLang_free_array (at);
+	     return -1;
+	  }
+	y = Stack_Pointer;
      }
 
    if (free_array == 0) at->num_refs++;
@@ -629,8 +767,9 @@ _INLINE_ static int push_double_object (SLtype type, double x)
 
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  return -1;
+	y = Stack_Pointer;
      }
 
    y->o_data_type = type;
@@ -653,8 +792,9 @@ _INLINE_ static int push_char_object (SLtype type, char x)
 
    IF_UNLIKELY(y >= Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack (1))
+	  return -1;
+	y = Stack_Pointer;
      }
 
    y->o_data_type = type;
@@ -923,8 +1063,9 @@ int SLdup_n (int n)
      }
    if (top + n > Stack_Pointer_Max)
      {
-	(void) SLang_set_error (SL_STACK_OVERFLOW);
-	return -1;
+	if (-1 == grow_run_stack ((unsigned int) n))
+	  return -1;
+	top = Stack_Pointer;
      }
    bot = top - n;
 
@@ -952,10 +1093,176 @@ int SLdup_n (int n)
 
 /*{{{ inner interpreter and support functions */
 
+/* Double the size of the stacks that are indexed by Recursion_Depth or
+ * Frame_Pointer_Depth.  The caller generates the error if this fails.
+ */
+static int grow_frame_stacks (void)
+{
+   unsigned int len, depth;
+   VOID_STAR p;
+
+   if (Frame_Stack_Len >= Max_Recursion_Depth)
+     return -1;
+
+   len = 2 * Frame_Stack_Len;
+   if ((len < Frame_Stack_Len) || (len > Max_Recursion_Depth))
+     len = Max_Recursion_Depth;
+
+   if (NULL == (p = _SLrecalloc ((char *) Num_Args_Stack, len, sizeof (int))))
+     return -1;
+   Num_Args_Stack = (int *) p;
+
+   if (NULL == (p = _SLrecalloc ((char *) Frame_Pointer_Stack, len, sizeof (unsigned int))))
+     return -1;
+   Frame_Pointer_Stack = (unsigned int *) p;
+
+#if SLANG_HAS_QUALIFIERS
+   if (NULL == (p = _SLrecalloc ((char *) Function_Qualifiers_Stack, len, sizeof (SLang_Struct_Type *))))
+     return -1;
+   Function_Qualifiers_Stack = (SLang_Struct_Type **) p;
+#endif
+
+   depth = (unsigned int) (Function_Stack_Ptr - Function_Stack);
+   if (NULL == (p = _SLrecalloc ((char *) Function_Stack, len, sizeof (Function_Stack_Type))))
+     return -1;
+   Function_Stack = (Function_Stack_Type *) p;
+   Function_Stack_Ptr = Function_Stack + depth;
+
+   Frame_Stack_Len = len;
+   Frame_Stack_Max = len;
+   return 0;
+}
+
+static void set_local_stack_max (void)
+{
+   Local_Stack_Chunk_Type *c = Local_Stack_Chunks + Local_Stack_Chunk;
+
+   Local_Variable_Stack_Max = c->max;
+   if (Max_Local_Stack_Len < c->num_below)
+     Local_Variable_Stack_Max = c->base;
+   else if (Max_Local_Stack_Len - c->num_below < (unsigned int) (c->max - c->base))
+     Local_Variable_Stack_Max = c->base + (Max_Local_Stack_Len - c->num_below);
+}
+
+/* Move to the next chunk of the local variable stack, which must have room
+ * for a frame of n local variables.  The caller generates the error if this
+ * fails.
+ */
+static int push_local_stack_chunk (unsigned int n)
+{
+   Local_Stack_Chunk_Type *c, *next;
+   unsigned int used, len;
+
+   c = Local_Stack_Chunks + Local_Stack_Chunk;
+   used = c->num_below + (unsigned int) (Local_Variable_Frame - c->base);
+   if ((used >= Max_Local_Stack_Len) || (n >= Max_Local_Stack_Len - used)
+       || (Local_Stack_Chunk + 1 == MAX_LOCAL_STACK_CHUNKS))
+     return -1;
+
+   next = c + 1;
+   if ((next->base != NULL) && ((unsigned int) (next->max - next->base) <= n))
+     {
+	SLfree ((char *) next->base);
+	next->base = NULL;
+     }
+
+   if (next->base == NULL)
+     {
+	len = 2 * (unsigned int) (c->max - c->base);
+	if (len <= n)
+	  len = n + 1;
+	if (len > Max_Local_Stack_Len - used)
+	  len = Max_Local_Stack_Len - used;
+	next->base = (SLang_Object_Type *) _SLcalloc (len, sizeof (SLang_Object_Type));
+	if (next->base == NULL)
+	  return -1;
+	next->max = next->base + len;
+     }
+   next->prev_frame = Local_Variable_Frame;
+   next->num_below = used;
+   Local_Stack_Chunk++;
+   Local_Variable_Frame = next->base;
+   set_local_stack_max ();
+   return 0;
+}
+
+/* Return to the previous chunk of the local variable stack.  The current
+ * one is kept for reuse, but any beyond it are freed.
+ */
+static void pop_local_stack_chunk (void)
+{
+   Local_Stack_Chunk_Type *c = Local_Stack_Chunks + Local_Stack_Chunk;
+
+   if ((Local_Stack_Chunk + 1 < MAX_LOCAL_STACK_CHUNKS)
+       && (c[1].base != NULL))
+     {
+	SLfree ((char *) c[1].base);
+	c[1].base = NULL;
+     }
+   Local_Variable_Frame = c->prev_frame;
+   Local_Stack_Chunk--;
+   set_local_stack_max ();
+}
+
+/* Returns 1 if obj is a local variable of an active frame */
+static int is_active_local_variable (SLang_Object_Type *obj)
+{
+   unsigned int i;
+
+   for (i = 0; i <= Local_Stack_Chunk; i++)
+     {
+	Local_Stack_Chunk_Type *c = Local_Stack_Chunks + i;
+	if ((obj <= c->base) || (obj >= c->max))
+	  continue;
+	if (i == Local_Stack_Chunk)
+	  return (obj <= Local_Variable_Frame);
+	return (obj <= c[1].prev_frame);
+     }
+   return 0;
+}
+
+/* A limit of 0 leaves the corresponding limit unchanged.  Lowering a limit
+ * does not shrink a stack, but prevents it from being used beyond the new
+ * limit.
+ */
+int SLang_set_stack_limits (unsigned int max_stack_len,
+			    unsigned int max_local_stack,
+			    unsigned int max_recursion_depth)
+{
+   if (max_stack_len)
+     {
+	Max_Stack_Len = max_stack_len;
+	if (Run_Stack != NULL)
+	  Stack_Pointer_Max = Run_Stack + ((Run_Stack_Len < Max_Stack_Len) ? Run_Stack_Len : Max_Stack_Len);
+     }
+   if (max_local_stack)
+     {
+	Max_Local_Stack_Len = max_local_stack;
+	if (Local_Stack_Chunks[0].base != NULL)
+	  set_local_stack_max ();
+     }
+   if (max_recursion_depth)
+     {
+	Max_Recursion_Depth = max_recursion_depth;
+	Frame_Stack_Max = (Frame_Stack_Len < Max_Recursion_Depth) ? Frame_Stack_Len : Max_Recursion_Depth;
+     }
+   return 0;
+}
+
+void SLang_get_stack_limits (unsigned int *max_stack_len,
+			     unsigned int *max_local_stack,
+			     unsigned int *max_recursion_depth)
+{
+   if (max_stack_len != NULL) *max_stack_len = Max_Stack_Len;
+   if (max_local_stack != NULL) *max_local_stack = Max_Local_Stack_Len;
+   if (max_recursion_depth != NULL) *max_recursion_depth = Max_Recursion_Depth;
+}
+
 _INLINE_
 int _pSL_increment_frame_pointer (void)
 {
-   IF_UNLIKELY(Recursion_Depth >= SLANG_MAX_RECURSIVE_DEPTH)
+   IF_UNLIKELY((Recursion_Depth >= Frame_Stack_Max)
+	       && (-1 == grow_frame_stacks ()))
      {
 #if SLANG_HAS_QUALIFIERS
 	if (Next_Function_Qualifiers != NULL)
@@ -996,7 +1303,7 @@ int _pSL_decrement_frame_pointer (void)
      }
 
    Recursion_Depth--;
-   if (Recursion_Depth < SLANG_MAX_RECURSIVE_DEPTH)
+   if (Recursion_Depth < Frame_Stack_Len)
      {
 	SLang_Num_Function_Args = Num_Args_Stack [Recursion_Depth];
 #if SLANG_HAS_QUALIFIERS
@@ -1273,7 +1580,8 @@ int SLang_get_string_qualifier (SLCONST char *name, char **p, SLFUTURE_CONST cha
 _INLINE_
 static int start_arg_list (void)
 {
-   IF_LIKELY(Frame_Pointer_Depth < SLANG_MAX_RECURSIVE_DEPTH)
+   IF_LIKELY((Frame_Pointer_Depth < Frame_Stack_Max)
+	     || (0 == grow_frame_stacks ()))
      {
 	Frame_Pointer_Stack [Frame_Pointer_Depth] = (unsigned int) (Frame_Pointer - Run_Stack);
 	Frame_Pointer = Stack_Pointer;
@@ -1293,7 +1601,8 @@ int SLang_start_arg_list (void)
 
 int _pSLang_restart_arg_list (int nargs)
 {
-   if (Frame_Pointer_Depth < SLANG_MAX_RECURSIVE_DEPTH)
+   if ((Frame_Pointer_Depth < Frame_Stack_Max)
+       || (0 == grow_frame_stacks ()))
      {
 	if ((nargs < 0) || (Run_Stack + nargs > Stack_Pointer))
 	  {
@@ -1319,7 +1628,7 @@ _INLINE_ static int end_arg_list (void)
 	return -1;
      }
    Frame_Pointer_Depth--;
-   if (Frame_Pointer_Depth < SLANG_MAX_RECURSIVE_DEPTH)
+   if (Frame_Pointer_Depth < Frame_Stack_Len)
      {
 	Next_Function_Num_Args = (int) (Stack_Pointer - Frame_Pointer);
 	Frame_Pointer = Run_Stack + Frame_Pointer_Stack [Frame_Pointer_Depth];
@@ -1788,6 +2097,155 @@ static int dbl_dbl_binary_result (int op, SLang_Object_Type *obja, SLang_Object_
 #endif				       /* SLANG_HAS_FLOAT */
 #endif				       /* SLANG_OPTIMIZE_FOR_SPEED */
 
+#if USE_QUICKENED_BINARY
+/* Each of these functions performs ap op bp, where ap and bp are the top two
+ * objects on the stack and are of the same type.  The result replaces ap.
+ * Operations that are not handled here, e.g., integer division, cause 1 to
+ * be returned.  Otherwise 0 is returned.
+ */
+# define QUICK_ARITH_OPS(field) \
+      case SLANG_PLUS: ap->v.field = a + b; break; \
+      case SLANG_MINUS: ap->v.field = a - b; break; \
+      case SLANG_TIMES: ap->v.field = a * b; break;
+# define QUICK_BIT_OPS(field) \
+      case SLANG_BAND: ap->v.field = a & b; break; \
+      case SLANG_BXOR: ap->v.field = a ^ b; break; \
+      case SLANG_BOR: ap->v.field = a | b; break; \
+      case SLANG_SHL: ap->v.field = a << b; break; \
+      case SLANG_SHR: ap->v.field = a >> b; break;
+# define QUICK_FLOAT_OPS(field) \
+      case SLANG_DIVIDE: ap->v.field = a / b; break;
+# define QUICK_CMP_OP(op, expr) \
+      case op: ap->v.char_val = (char) (expr); ap->o_data_type = SLANG_CHAR_TYPE; break;
+# define DEFINE_QUICK_BINARY(name, ctype, field, other_ops) \
+static int name (int op, SLang_Object_Type *ap, SLang_Object_Type *bp) \
+{ \
+   ctype a = ap->v.field; \
+   ctype b = bp->v.field; \
+   switch (op) \
+     { \
+      QUICK_ARITH_OPS(field) \
+      other_ops(field) \
+      QUICK_CMP_OP(SLANG_EQ, a == b) \
+      QUICK_CMP_OP(SLANG_NE, a != b) \
+      QUICK_CMP_OP(SLANG_GT, a > b) \
+      QUICK_CMP_OP(SLANG_GE, a >= b) \
+      QUICK_CMP_OP(SLANG_LT, a < b) \
+      QUICK_CMP_OP(SLANG_LE, a <= b) \
+      default: \
+	return 1; \
+     } \
+   Stack_Pointer = bp; \
+   return 0; \
+}
+
+DEFINE_QUICK_BINARY(int_int_quick_binary, int, int_val, QUICK_BIT_OPS)
+DEFINE_QUICK_BINARY(uint_uint_quick_binary, unsigned int, uint_val, QUICK_BIT_OPS)
+DEFINE_QUICK_BINARY(long_long_quick_binary, long, long_val, QUICK_BIT_OPS)
+# ifdef HAVE_LONG_LONG
+DEFINE_QUICK_BINARY(llong_llong_quick_binary, long long, llong_val, QUICK_BIT_OPS)
+# endif
+# if SLANG_HAS_FLOAT
+DEFINE_QUICK_BINARY(float_float_quick_binary, float, float_val, QUICK_FLOAT_OPS)
+DEFINE_QUICK_BINARY(dbl_dbl_quick_binary, double, double_val, QUICK_FLOAT_OPS)
+# endif
+
+/* The bc_sub_type field of a binary operation bytecode holds the state of
+ * its type-feedback: the low 3 bits count the number of consecutive times
+ * that both operands had the type given by the next 3 bits.  The top 2 bits
+ * count the number of times that the bytecode was quickened and reverted.
+ * Once that becomes too large, the bytecode is left alone.
+ *
+ * A SLANG_BC_BINARY bytecode is quickened by replacing it with one of the
+ * SLANG_BC_BINARY_<type> bytecodes.  The combined bytecodes that perform a
+ * binary operation cannot be replaced in this way.  Instead their count is
+ * set to QB_QUICKENED.
+ */
+# define QB_COUNT_MASK		0x07
+# define QB_QUICKENED		0x07
+# define QB_KIND_SHIFT		3
+# define QB_KIND_MASK		(0x07 << QB_KIND_SHIFT)
+# define QB_KIND_NEVER		QB_KIND_MASK
+# define QB_DEOPT_SHIFT		6
+# define QB_DEOPT_MASK		(0x03 << QB_DEOPT_SHIFT)
+# define QUICKEN_THRESHOLD	4
+# define MAX_BINARY_DEOPTS	3
+
+static _pSLang_BC_Type get_quick_binary_bytecode (SLtype type)
+{
+   switch (type)
+     {
+      case SLANG_INT_TYPE: return SLANG_BC_BINARY_INT;
+      case SLANG_UINT_TYPE: return SLANG_BC_BINARY_UINT;
+      case SLANG_LONG_TYPE: return SLANG_BC_BINARY_LONG;
+# ifdef HAVE_LONG_LONG
+      case SLANG_LLONG_TYPE: return SLANG_BC_BINARY_LLONG;
+# endif
+# if SLANG_HAS_FLOAT
+      case SLANG_FLOAT_TYPE: return SLANG_BC_BINARY_FLOAT;
+      case SLANG_DOUBLE_TYPE: return SLANG_BC_BINARY_DOUBLE;
+# endif
+     }
+   return SLANG_BC_BINARY;
+}
+
+/* This is called before the binary operation at addr is performed upon the
+ * top two objects on the stack.  It updates the type-feedback and returns
+ * the SLANG_BC_BINARY_<type> bytecode if the operation should be quickened.
+ * Otherwise it returns SLANG_BC_BINARY.
+ */
+static _pSLang_BC_Type binary_type_feedback (SLBlock_Type *addr)
+{
+   unsigned int state = addr->bc_sub_type;
+   unsigned int kind, count;
+   _pSLang_BC_Type bc;
+   SLtype type;
+
+   if (((state & QB_KIND_MASK) == QB_KIND_NEVER)
+       || (Stack_Pointer < Run_Stack + 2))
+     return SLANG_BC_BINARY;
+
+   type = (Stack_Pointer-1)->o_data_type;
+   if ((type != (Stack_Pointer-2)->o_data_type)
+       || (SLANG_BC_BINARY == (bc = get_quick_binary_bytecode (type))))
+     {
+	addr->bc_sub_type = (unsigned char) (state & QB_DEOPT_MASK);
+	return SLANG_BC_BINARY;
+     }
+
+   kind = 1 + (bc - SLANG_BC_BINARY_INT);
+   count = 1;
+   if (kind == ((state & QB_KIND_MASK) >> QB_KIND_SHIFT))
+     count += (state & QB_COUNT_MASK);
+
+   if (count >= QUICKEN_THRESHOLD)
+     count = QB_QUICKENED;
+
+   addr->bc_sub_type = (unsigned char) ((state & QB_DEOPT_MASK)
+					| (kind << QB_KIND_SHIFT) | count);
+   return (count == QB_QUICKENED) ? bc : SLANG_BC_BINARY;
+}
+
+static void quicken_binary (SLBlock_Type *addr)
+{
+   _pSLang_BC_Type bc = binary_type_feedback (addr);
+
+   if (bc != SLANG_BC_BINARY)
+     addr->bc_main_type = bc;
+}
+
+/* Called when a quickened operation sees operands of the wrong type */
+static void deopt_binary (SLBlock_Type *addr)
+{
+   unsigned int ndeopts = 1 + (addr->bc_sub_type >> QB_DEOPT_SHIFT);
+
+   if (ndeopts > MAX_BINARY_DEOPTS)
+     addr->bc_sub_type = QB_KIND_NEVER;
+   else
+     addr->bc_sub_type = (unsigned char) (ndeopts << QB_DEOPT_SHIFT);
+}
+#endif				       /* USE_QUICKENED_BINARY */
+
 int _pSLang_do_binary_ab (int op, SLang_Object_Type *obja, SLang_Object_Type *objb)
 {
 #if SLANG_OPTIMIZE_FOR_SPEED
@@ -2107,6 +2565,50 @@ static int do_binary (int op)
    return ret;
 }
 
+#if USE_QUICKENED_BINARY
+/* This is used by the combined bytecodes that perform the binary operation
+ * given by addr.  Since they cannot be replaced by the SLANG_BC_BINARY_<type>
+ * bytecodes, the quickened operation is selected by the type-feedback state.
+ */
+# define QUICK_BINARY_CASE(bc, type, fun) \
+      case 1 + ((bc) - SLANG_BC_BINARY_INT): \
+	if ((bp->o_data_type != (type)) || ((bp-1)->o_data_type != (type))) \
+	  break; \
+	if (0 == fun (addr->b.i_blk, bp-1, bp)) \
+	  return 0; \
+	return do_binary (addr->b.i_blk);
+
+static int do_binary_site (SLBlock_Type *addr)
+{
+   unsigned int state = addr->bc_sub_type;
+   SLang_Object_Type *bp = Stack_Pointer - 1;
+
+   if (((state & QB_COUNT_MASK) != QB_QUICKENED) || (bp <= Run_Stack))
+     {
+	(void) binary_type_feedback (addr);
+	return do_binary (addr->b.i_blk);
+     }
+
+   switch ((state & QB_KIND_MASK) >> QB_KIND_SHIFT)
+     {
+	QUICK_BINARY_CASE(SLANG_BC_BINARY_INT, SLANG_INT_TYPE, int_int_quick_binary)
+	QUICK_BINARY_CASE(SLANG_BC_BINARY_UINT, SLANG_UINT_TYPE, uint_uint_quick_binary)
+	QUICK_BINARY_CASE(SLANG_BC_BINARY_LONG, SLANG_LONG_TYPE, long_long_quick_binary)
+# ifdef HAVE_LONG_LONG
+	QUICK_BINARY_CASE(SLANG_BC_BINARY_LLONG, SLANG_LLONG_TYPE, llong_llong_quick_binary)
+# endif
+# if SLANG_HAS_FLOAT
+	QUICK_BINARY_CASE(SLANG_BC_BINARY_FLOAT, SLANG_FLOAT_TYPE, float_float_quick_binary)
+	QUICK_BINARY_CASE(SLANG_BC_BINARY_DOUBLE, SLANG_DOUBLE_TYPE, dbl_dbl_quick_binary)
+# endif
+     }
+   deopt_binary (addr);
+   return do_binary (addr->b.i_blk);
+}
+#else
+# define do_binary_site(addr) do_binary((addr)->b.i_blk)
+#endif
+
 _INLINE_
 static int do_binary_b (int op, SLang_Object_Type *bp)
 {
@@ -3167,7 +3669,7 @@ static SLang_Object_Type *lv_ref_check_object (VOID_STAR vdata)
 {
    SLang_Object_Type *obj = *(SLang_Object_Type **)vdata;
 
-   if (obj > Local_Variable_Frame)
+   if (0 == is_active_local_variable (obj))
      {
 	_pSLang_verror (SL_UNDEFINED_NAME, "Local variable reference is out of scope");
 	return NULL;
@@ -3282,7 +3784,10 @@ static void set_deref_lvalue (SLBlock_Type *bc_blk)
 }
 #endif
 
-static int push_struct_field (SLFUTURE_CONST char *name)
+/* If non-NULL, field_cache is the inline cache of the field index for the
+ * bytecode doing the access.
+ */
+static int push_struct_field (SLFUTURE_CONST char *name, unsigned char *field_cache)
 {
    SLang_Class_Type *cl;
    SLang_Object_Type obj;
@@ -3292,12 +3797,12 @@ static int push_struct_field (SLFUTURE_CONST char *name)
      return -1;
 
    if (SLANG_STRUCT_TYPE == (type = obj.o_data_type))
-     return _pSLstruct_push_field (obj.v.struct_val, name, 1);
+     return _pSLstruct_push_field_cached (obj.v.struct_val, name, field_cache, 1);
 
    GET_CLASS(cl, (SLtype) type);
 
    if (cl->is_struct)
-     return _pSLstruct_push_field (obj.v.struct_val, name, 1);
+     return _pSLstruct_push_field_cached (obj.v.struct_val, name, field_cache, 1);
 
    if (cl->cl_sget == NULL)
      {
@@ -3372,6 +3877,42 @@ static int deref_call_object (SLang_Object_Type *obj, int linenum)
    return -1;
 }
 
+static void execute_slang_fun (_pSLang_Function_Type *, unsigned int);
+static int compile_lazy_function (_pSLang_Function_Type *, Function_Header_Type *);
+
+/* If objp is a struct whose field is a reference to a function, return the
+ * function.  Otherwise return NULL.  Since the field is looked up each time,
+ * the caller will see the field being assigned a different function.
+ */
+static SLang_Name_Type *get_struct_method (SLang_Object_Type *objp, SLFUTURE_CONST char *name,
+					   unsigned char *field_cache)
+{
+   SLang_Object_Type *fobj;
+   SLang_Ref_Type *ref;
+   SLang_Name_Type *nt;
+
+   if (objp->o_data_type != SLANG_STRUCT_TYPE)
+     {
+	SLang_Class_Type *cl;
+	GET_CLASS(cl, objp->o_data_type);
+	if (0 == cl->is_struct)
+	  return NULL;
+     }
+
+   fobj = _pSLstruct_get_field_value_cached (objp->v.struct_val, name, field_cache);
+   if ((fobj == NULL)
+       || (fobj->o_data_type != SLANG_REF_TYPE)
+       || (NULL == (ref = (SLang_Ref_Type *)fobj->v.ref))
+       || (0 == ref->data_is_nametype))
+     return NULL;
+
+   nt = *(SLang_Name_Type **)ref->data;
+   if (0 == is_nametype_callable (nt))
+     return NULL;
+
+   return nt;
+}
+
 /*  This arises from code such as a.f(x,y) with the following on the stack:
  *
  *     __args x y a
@@ -3381,14 +3922,31 @@ static int deref_call_object (SLang_Object_Type *obj, int linenum)
  *     __args a x y _eargs (@a.field)
  *
  */
-static int do_struct_method (SLFUTURE_CONST char *name, int linenum)
+static int do_struct_method (SLFUTURE_CONST char *name, unsigned char *field_cache, int linenum)
 {
    SLang_Object_Type obj;
+   SLang_Name_Type *nt;
+
+   if ((Stack_Pointer != Run_Stack)
+       && (NULL != (nt = get_struct_method (Stack_Pointer-1, name, field_cache))))
+     {
+	/* The struct stays on the stack as the first argument */
+	if ((-1 == end_arg_list ())
+	    || (-1 == roll_stack (Next_Function_Num_Args)))
+	  return -1;
+
+	if ((nt->name_type == SLANG_FUNCTION) || (nt->name_type == SLANG_PFUNCTION))
+	  {
+	     execute_slang_fun ((_pSLang_Function_Type *) nt, linenum);
+	     return IS_SLANG_ERROR ? -1 : 0;
+	  }
+	return inner_interp_nametype (nt, linenum);
+     }
 
    if (-1 == SLdup_n (1))
      return -1;			       /* stack: __args x y a a */
 
-   if (-1 == push_struct_field (name))
+   if (-1 == push_struct_field (name, field_cache))
      return -1;			       /* stack: __args x y a a.name */
 
    if (-1 == pop_object(&obj))
@@ -3729,41 +4287,269 @@ static SLang_Object_Type Switch_Objects[SLANG_MAX_NESTED_SWITCH];
 static SLang_Object_Type *Switch_Obj_Ptr = Switch_Objects;
 static SLang_Object_Type *Switch_Obj_Max = Switch_Objects + SLANG_MAX_NESTED_SWITCH;
 
-/* Returns 0 if the loops were completed, 1 if they were terminated via break,
- * or -1 if an error occured.
+#if SLANG_OPTIMIZE_FOR_SPEED
+/* This implements foreach over a linear array of a numeric type when the
+ * loop variable is a local variable.  The elements are copied directly into
+ * the variable rather than being pushed onto the stack.  The array is on the
+ * top of the stack.  It returns 0 if the loop is not of this form, 1 if it
+ * was carried out, or -1 upon error.
  */
-static int
-lang_do_loops (int stype, SLBlock_Type *block, unsigned int num_blocks)
+static int do_numeric_array_foreach (SLBlock_Type *block)
 {
-   int i, ctrl;
-   int first, last;
-   SLBlock_Type *blks[4];
-   SLCONST char *loop_name;
-   SLang_Foreach_Context_Type *foreach_context;
-   SLang_Class_Type *cl;
-   int type;
-   unsigned int j;
+   SLang_Object_Type array_obj, *objp;
+   SLang_Array_Type *at;
+   SLuindex_Type i, num;
+   SLtype data_type;
+   size_t sizeof_type;
+   int status;
 
-   j = 0;
-   for (i = 0; i < (int) num_blocks; i++)
-     {
-	if (block[i].bc_main_type != SLANG_BC_BLOCK)
-	  {
-#if USE_BC_LINE_NUM
-	     if (block[i].bc_main_type == SLANG_BC_LINE_NUM)
-	       continue;
-#endif
-	     _pSLang_verror (SL_SYNTAX_ERROR, "Bytecode is not a looping block");
-	     return -1;
-	  }
-	blks[j] = block[i].b.blk;
-	j++;
-     }
+   if ((block->bc_main_type != SLANG_BC_SET_LOCAL_LVALUE)
+       || (block->bc_sub_type != SLANG_BCST_ASSIGN))
+     return 0;
 
-   num_blocks = j;
-   block = blks[0];
+   at = (Stack_Pointer - 1)->v.array_val;
+   if (at->flags & (SLARR_DATA_VALUE_IS_RANGE|SLARR_DATA_VALUE_IS_POINTER))
+     return 0;
 
-   switch (stype)
+   data_type = at->data_type;
+   switch (data_type)
+     {
+      case SLANG_CHAR_TYPE: case SLANG_UCHAR_TYPE:
+      case SLANG_SHORT_TYPE: case SLANG_USHORT_TYPE:
+      case SLANG_INT_TYPE: case SLANG_UINT_TYPE:
+      case SLANG_LONG_TYPE: case SLANG_ULONG_TYPE:
+#ifdef HAVE_LONG_LONG
+      case SLANG_LLONG_TYPE: case SLANG_ULLONG_TYPE:
+#endif
+#if SLANG_HAS_FLOAT
+      case SLANG_FLOAT_TYPE: case SLANG_DOUBLE_TYPE:
+#endif
+	break;
+
+      default:
+	return 0;
+     }
+
+   if (-1 == pop_object (&array_obj))
+     return -1;
+
+   objp = Local_Variable_Frame - block->b.i_blk;
+   block++;
+   sizeof_type = at->sizeof_type;
+   num = at->num_elements;
+   status = 1;
+
+   for (i = 0; i < num; i++)
+     {
+	if (IS_SLANG_ERROR)
+	  {
+	     status = -1;
+	     break;
+	  }
+	if (objp->o_data_type != data_type)
+	  {
+	     if (SLANG_CLASS_TYPE_SCALAR != GET_CLASS_TYPE(objp->o_data_type))
+	       SLang_free_object (objp);
+	     objp->o_data_type = data_type;
+	  }
+	/* The members of the union all start at its beginning */
+	memcpy ((char *) &objp->v, (char *) at->data + i * sizeof_type, sizeof_type);
+
+	inner_interp (block);
+	if (Lang_Break) break;
+	Lang_Break_Condition = /* Lang_Continue = */ 0;
+     }
+
+   SLang_free_object (&array_obj);
+   return status;
+}
+#endif
+
+#if SLANG_OPTIMIZE_FOR_SPEED
+/* The test and increment blocks of a C-style for loop are usually simple
+ * comparisons and increments of integer local variables, as in
+ * for (i = 0; i < n; i++).  If so, and the variables have integer values,
+ * the loop carries them out directly instead of running the blocks.  Since
+ * the types are checked on every iteration, the body may change them.
+ */
+typedef struct
+{
+   int op;			       /* 0 if the test is not simple */
+   SLang_Object_Type *a, *b;
+   SLang_Object_Type literal;
+}
+For_Test_Type;
+
+typedef struct
+{
+   SLang_Object_Type *obj;	       /* NULL if the increment is not simple */
+   int delta;
+}
+For_Bump_Type;
+
+static void get_simple_for_test (SLBlock_Type *b, For_Test_Type *t)
+{
+   t->op = 0;
+   switch (b->bc_main_type)
+     {
+      case SLANG_BC_LLVARIABLE_BINARY:
+	t->a = Local_Variable_Frame - (b+1)->b.i_blk;
+	t->b = Local_Variable_Frame - (b+2)->b.i_blk;
+	break;
+
+      case SLANG_BC_LIVARIABLE_BINARY:
+	t->a = Local_Variable_Frame - (b+1)->b.i_blk;
+	t->b = &t->literal;
+	t->literal.v.int_val = (int) (b+2)->b.l_blk;
+	break;
+
+      case SLANG_BC_ILVARIABLE_BINARY:
+	t->a = &t->literal;
+	t->b = Local_Variable_Frame - (b+2)->b.i_blk;
+	t->literal.v.int_val = (int) (b+1)->b.l_blk;
+	break;
+
+      default:
+	return;
+     }
+   t->literal.o_data_type = SLANG_INT_TYPE;
+
+   if ((b+3)->bc_main_type != SLANG_BC_LAST_BLOCK)
+     return;
+
+   switch (b->b.i_blk)
+     {
+      case SLANG_EQ: case SLANG_NE:
+      case SLANG_GT: case SLANG_GE:
+      case SLANG_LT: case SLANG_LE:
+	t->op = b->b.i_blk;
+	break;
+     }
+}
+
+/* Returns -1 if the test block has to be executed */
+static int do_simple_for_test (For_Test_Type *t, int *ctrlp)
+{
+   int a, b;
+
+   if ((t->op == 0)
+       || (t->a->o_data_type != SLANG_INT_TYPE)
+       || (t->b->o_data_type != SLANG_INT_TYPE))
+     return -1;
+
+   a = t->a->v.int_val;
+   b = t->b->v.int_val;
+   switch (t->op)
+     {
+      case SLANG_EQ: *ctrlp = (a == b); break;
+      case SLANG_NE: *ctrlp = (a != b); break;
+      case SLANG_GT: *ctrlp = (a > b); break;
+      case SLANG_GE: *ctrlp = (a >= b); break;
+      case SLANG_LT: *ctrlp = (a < b); break;
+      default: *ctrlp = (a <= b); break;
+     }
+   return 0;
+}
+
+static void get_simple_for_bump (SLBlock_Type *b, For_Bump_Type *bump)
+{
+   int delta = 0, has_literal = 0;
+
+   bump->obj = NULL;
+   bump->delta = 0;
+   if ((b->bc_main_type == SLANG_BC_LITERAL_INT)
+       && (b->bc_sub_type == SLANG_INT_TYPE))
+     {
+	delta = (int) b->b.l_blk;
+	has_literal = 1;
+	b++;
+     }
+
+   if (b->bc_main_type == SLANG_BC_SET_LOCAL_LVALUE)
+     {
+	if ((b+1)->bc_main_type != SLANG_BC_LAST_BLOCK)
+	  return;
+     }
+   else if (b->bc_main_type != SLANG_BC_SET_LOCLV_LASTBLOCK)
+     return;
+
+   switch (b->bc_sub_type)
+     {
+      case SLANG_BCST_PLUSPLUS:
+      case SLANG_BCST_POST_PLUSPLUS:
+	if (has_literal) return;
+	delta = 1;
+	break;
+      case SLANG_BCST_MINUSMINUS:
+      case SLANG_BCST_POST_MINUSMINUS:
+	if (has_literal) return;
+	delta = -1;
+	break;
+      case SLANG_BCST_PLUSEQS:
+	if (has_literal == 0) return;
+	break;
+      case SLANG_BCST_MINUSEQS:
+	if (has_literal == 0) return;
+	delta = -delta;
+	break;
+      default:
+	return;
+     }
+   bump->obj = Local_Variable_Frame - b->b.i_blk;
+   bump->delta = delta;
+}
+
+/* Returns -1 if the increment block has to be executed */
+static int do_simple_for_bump (For_Bump_Type *bump)
+{
+   if ((bump->obj == NULL)
+       || (bump->obj->o_data_type != SLANG_INT_TYPE))
+     return -1;
+
+   bump->obj->v.int_val += bump->delta;
+   return 0;
+}
+#endif
+
+/* Returns 0 if the loops were completed, 1 if they were terminated via break,
+ * or -1 if an error occured.
+ */
+static int
+lang_do_loops (int stype, SLBlock_Type *block, unsigned int num_blocks)
+{
+   int i, ctrl;
+   int first, last;
+   SLBlock_Type *blks[4];
+   SLCONST char *loop_name;
+   SLang_Foreach_Context_Type *foreach_context;
+   SLang_Class_Type *cl;
+   int type;
+   unsigned int j;
+#if SLANG_OPTIMIZE_FOR_SPEED
+   For_Test_Type for_test;
+   For_Bump_Type for_bump;
+#endif
+
+   j = 0;
+   for (i = 0; i < (int) num_blocks; i++)
+     {
+	if (block[i].bc_main_type != SLANG_BC_BLOCK)
+	  {
+#if USE_BC_LINE_NUM
+	     if (block[i].bc_main_type == SLANG_BC_LINE_NUM)
+	       continue;
+#endif
+	     _pSLang_verror (SL_SYNTAX_ERROR, "Bytecode is not a looping block");
+	     return -1;
+	  }
+	blks[j] = block[i].b.blk;
+	j++;
+     }
+
+   num_blocks = j;
+   block = blks[0];
+
+   switch (stype)
      {
 	int next_fn_args;
 
@@ -3787,6 +4573,16 @@ lang_do_loops (int stype, SLBlock_Type *block, unsigned int num_blocks)
 	    || (-1 == (type = peek_at_stack ())))
 	  goto return_error;
 
+#if SLANG_OPTIMIZE_FOR_SPEED
+	if ((type == SLANG_ARRAY_TYPE) && (next_fn_args == 0))
+	  {
+	     int status = do_numeric_array_foreach (block);
+	     if (status == -1)
+	       goto return_error;
+	     if (status == 1)
+	       break;
+	  }
+#endif
 	GET_CLASS(cl, (SLtype)type);
 	if ((cl->cl_foreach == NULL)
 	    || (cl->cl_foreach_open == NULL)
@@ -3886,25 +4682,38 @@ lang_do_loops (int stype, SLBlock_Type *block, unsigned int num_blocks)
 	if (num_blocks != 4) goto wrong_num_blocks_error;
 
 	inner_interp (block);
+#if SLANG_OPTIMIZE_FOR_SPEED
+	get_simple_for_test (blks[1], &for_test);
+	get_simple_for_bump (blks[2], &for_bump);
+#endif
 	while (1)
 	  {
 	     if (IS_SLANG_ERROR)
 	       goto return_error;
 
-	     inner_interp(blks[1]);       /* test */
-	     if (-1 == pop_ctrl_integer (&ctrl))
-	       goto return_error;
+#if SLANG_OPTIMIZE_FOR_SPEED
+	     if (-1 == do_simple_for_test (&for_test, &ctrl))
+#endif
+	       {
+		  inner_interp(blks[1]);       /* test */
+		  if (-1 == pop_ctrl_integer (&ctrl))
+		    goto return_error;
+	       }
 
 	     if (ctrl == 0) break;
 	     inner_interp(blks[3]);       /* code */
 	     if (Lang_Break) break;
-	     inner_interp(blks[2]);       /* bump */
+#if SLANG_OPTIMIZE_FOR_SPEED
+	     if (-1 == do_simple_for_bump (&for_bump))
+#endif
+	       inner_interp(blks[2]);       /* bump */
 	     Lang_Break_Condition = /* Lang_Continue = */ 0;
 	  }
 	break;
 
       case SLANG_BCST_FOR:
 	  {
+	     unsigned int num;
 #if SLANG_OPTIMIZE_FOR_SPEED
 	     SLang_Object_Type *objp;
 #endif
@@ -3928,18 +4737,25 @@ lang_do_loops (int stype, SLBlock_Type *block, unsigned int num_blocks)
 		  block++;
 	       }
 #endif
+	     /* The number of iterations after the first is computed in
+	      * advance so that the loop variable cannot overflow.  A step of
+	      * 0 loops forever.
+	      */
+	     if (ctrl >= 0)
+	       {
+		  if (first > last) break;
+		  num = (ctrl == 0) ? 0
+		    : ((unsigned int) last - (unsigned int) first) / (unsigned int) ctrl;
+	       }
+	     else
+	       {
+		  if (first < last) break;
+		  num = ((unsigned int) first - (unsigned int) last) / (0U - (unsigned int) ctrl);
+	       }
+
 	     i = first;
 	     while (1)
 	       {
-		  /* It is ugly to have this test here but I do not know of a
-		   * simple way to do this without using two while loops.
-		   */
-		  if (ctrl >= 0)
-		    {
-		       if (i > last) break;
-		    }
-		  else if (i < last) break;
-
 		  if (IS_SLANG_ERROR) goto return_error;
 #if SLANG_OPTIMIZE_FOR_SPEED
 		  if (objp != NULL)
@@ -3960,6 +4776,12 @@ lang_do_loops (int stype, SLBlock_Type *block, unsigned int num_blocks)
 		  if (Lang_Break) break;
 		  Lang_Break_Condition = /* Lang_Continue = */ 0;
 
+		  if (num == 0)
+		    {
+		       if (ctrl == 0) continue;
+		       break;
+		    }
+		  num--;
 		  i += ctrl;
 	       }
 	  }
@@ -4223,6 +5045,7 @@ static int do_try_internal (SLBlock_Type *ev_block, SLBlock_Type *final)
 
 static void do_try (SLBlock_Type *ev_block, SLBlock_Type *final)
 {
+   Tail_Calls_Disabled++;
    (void) do_try_internal (ev_block, final);
 
    if (final->b.blk->bc_main_type)
@@ -4240,6 +5063,7 @@ static void do_try (SLBlock_Type *ev_block, SLBlock_Type *final)
 
 	Lang_Break = br; Lang_Return = r; Lang_Break_Condition = bc;
      }
+   Tail_Calls_Disabled--;
 }
 
 /* This evaluates:
@@ -4522,17 +5346,31 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
    SLBlock_Type *exit_block_save;
    SLBlock_Type **user_block_save;
    SLBlock_Type *user_blocks[MAX_USER_BLOCKS];
-   int issue_bofeof_info = 0;
+   int issue_bofeof_info;
    int nargs;
+   int tail_calls_disabled_save;
+   _pSLang_Function_Type *tail_call_fun;
 
    exit_block_save = Exit_Block_Ptr;
    user_block_save = User_Block_Ptr;
+   tail_calls_disabled_save = Tail_Calls_Disabled;
+
+   execute_function:
+
    User_Block_Ptr = user_blocks;
    memset ((char *)user_blocks, 0, MAX_USER_BLOCKS*sizeof (SLBlock_Type *));
    Exit_Block_Ptr = NULL;
+   Tail_Calls_Disabled = 0;
+   issue_bofeof_info = 0;
+   tail_call_fun = NULL;
 
    if (-1 == increment_slang_frame_pointer (fun, linenum))
-     return;
+     {
+	Exit_Block_Ptr = exit_block_save;
+	User_Block_Ptr = user_block_save;
+	Tail_Calls_Disabled = tail_calls_disabled_save;
+	return;
+     }
    nargs = SLang_Num_Function_Args;
 
    header = fun->header;
@@ -4540,6 +5378,12 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
     * like:  define crash () { eval ("define crash ();") }
     */
    header->num_refs++;
+
+   IF_UNLIKELY(header->body == NULL)
+     {
+	if (-1 == compile_lazy_function (fun, header))
+	  goto the_return;
+     }
    n_locals = header->nlocals;
 
    /* let the error propagate through since it will do no harm
@@ -4548,11 +5392,15 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
    /* set new stack frame */
    lvf = frame = Local_Variable_Frame;
    i = n_locals;
-   if ((lvf + i) >= Local_Variable_Stack_Max)
+   IF_UNLIKELY((lvf + i) >= Local_Variable_Stack_Max)
      {
-	_pSLang_verror(SL_STACK_OVERFLOW, "%s: Local Variable Stack Overflow",
-		     fun->name);
-	goto the_return;
+	if (-1 == push_local_stack_chunk (i))
+	  {
+	     _pSLang_verror(SL_STACK_OVERFLOW, "%s: Local Variable Stack Overflow",
+			    fun->name);
+	     goto the_return;
+	  }
+	lvf = frame = Local_Variable_Frame;
      }
 
    while (i--)
@@ -4599,6 +5447,8 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
 	  }
 
 	inner_interp (header->body);
+	tail_call_fun = Tail_Call_Function;
+	Tail_Call_Function = NULL;
 	Lang_Break_Condition = Lang_Return = Lang_Break = 0;
 	if (Exit_Block_Ptr != NULL) inner_interp(Exit_Block_Ptr);
 
@@ -4619,6 +5469,8 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
    else
      {
 	inner_interp (header->body);
+	tail_call_fun = Tail_Call_Function;
+	Tail_Call_Function = NULL;
 	Lang_Break_Condition = Lang_Return = Lang_Break = 0;
 	if (Exit_Block_Ptr != NULL) inner_interp(Exit_Block_Ptr);
      }
@@ -4649,6 +5501,9 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
 	lvf--;
      }
    Local_Variable_Frame = lvf;
+   if ((Local_Stack_Chunk != 0)
+       && (lvf == Local_Stack_Chunks[Local_Stack_Chunk].base))
+     pop_local_stack_chunk ();
 
    the_return:
 
@@ -4660,6 +5515,7 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
    Lang_Break_Condition = Lang_Return = Lang_Break = 0;
    Exit_Block_Ptr = exit_block_save;
    User_Block_Ptr = user_block_save;
+   Tail_Calls_Disabled = tail_calls_disabled_save;
 
    if (nargs != SLang_Num_Function_Args)
      SLang_verror (SL_INTERNAL_ERROR, "execute_slang_fun: SLang_Num_Function_Args changed");
@@ -4669,6 +5525,29 @@ static void execute_slang_fun (_pSLang_Function_Type *fun, unsigned int linenum)
    if (issue_bofeof_info)
      (void) _pSLcall_eof_handler ();
 #endif
+
+   if (tail_call_fun == NULL)
+     return;
+
+   /* The arguments of the tail call are on the stack */
+   if (0 == IS_SLANG_ERROR)
+     {
+	fun = tail_call_fun;
+	linenum = Tail_Call_Linenum;
+	Next_Function_Num_Args = Tail_Call_Num_Args;
+#if SLANG_HAS_QUALIFIERS
+	Next_Function_Qualifiers = Tail_Call_Qualifiers;
+	Tail_Call_Qualifiers = NULL;
+#endif
+	goto execute_function;
+     }
+#if SLANG_HAS_QUALIFIERS
+   if (Tail_Call_Qualifiers != NULL)
+     {
+	SLang_free_struct (Tail_Call_Qualifiers);
+	Tail_Call_Qualifiers = NULL;
+     }
+#endif
 }
 
 static void do_traceback (SLCONST char *message)
@@ -5374,26 +6253,28 @@ do_inner_interp_error (SLBlock_Type *err_block,
    return -1;
 }
 
-#define GATHER_STATISTICS 0
 #if GATHER_STATISTICS
-static unsigned int Bytecodes[0xFFFF];
+static unsigned int Bytecodes[0x10000];
 
+/* The file is appended to so that the statistics from several runs may be
+ * combined by util/mksuperbc.sl.
+ */
 static void print_stats (void)
 {
    unsigned int i;
    unsigned long total;
-   FILE *fp = fopen ("stats.txt", "w");
+   FILE *fp = fopen ("stats.txt", "a");
    if (fp == NULL)
      return;
 
    total = 0;
-   for (i = 0; i < 0xFFFF; i++)
+   for (i = 0; i < 0x10000; i++)
      total += Bytecodes[i];
 
    if (total == 0)
      total = 1;
 
-   for (i = 0; i < 0xFFFF; i++)
+   for (i = 0; i < 0x10000; i++)
      {
 	if (Bytecodes[i])
 	  fprintf (fp, "0x%04X %9u %e\n", i, Bytecodes[i], Bytecodes[i]/(double) total);
@@ -5440,6 +6321,136 @@ static void add_to_statistics (SLBlock_Type *b)
       else execute_intrinsic_fun (f); \
    }
 
+/* The handlers for the following bytecodes neither transfer control nor
+ * look beyond the current value of addr.  Besides being used for the
+ * bytecodes themselves, any two of them may be paired to form one of the
+ * superinstructions listed in slsuperbc.inc.
+ */
+#define DO_BC_LVARIABLE PUSH_LOCAL_VARIABLE(addr->b.i_blk)
+#define DO_BC_GVARIABLE \
+   { \
+      if (-1 == _pSLpush_slang_obj (&addr->b.nt_gvar_blk->obj)) \
+	do_name_type_error (addr->b.nt_blk); \
+   }
+#define DO_BC_PVARIABLE DO_BC_GVARIABLE
+#define DO_BC_INTRINSIC \
+   { \
+      EXECUTE_INTRINSIC(addr) \
+      if (IS_SLANG_ERROR) \
+	do_traceback(addr->b.nt_ifun_blk->name); \
+   }
+#define DO_BC_ICONST \
+   { push_int_object (addr->b.iconst_blk->data_type, addr->b.iconst_blk->value); }
+#define DO_BC_HCONST \
+   { SLclass_push_short_obj (addr->b.iconst_blk->data_type, addr->b.hconst_blk->value); }
+#define DO_BC_LCONST \
+   { SLclass_push_long_obj (addr->b.iconst_blk->data_type, addr->b.lconst_blk->value); }
+#define DO_BC_SET_LOCAL_LVALUE \
+   { set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk); }
+#define DO_BC_SET_GLOBAL_LVALUE \
+   { \
+      if (-1 == set_lvalue_obj (addr->bc_sub_type, &addr->b.nt_gvar_blk->obj)) \
+	do_name_type_error (addr->b.nt_blk); \
+   }
+#define DO_BC_SET_STRUCT_LVALUE { set_struct_lvalue (addr); }
+#define DO_BC_SET_ARRAY_LVALUE { set_array_lvalue (addr->bc_sub_type); }
+#define DO_BC_FIELD { (void) push_struct_field (addr->b.s_blk, &addr->bc_sub_type); }
+#define DO_BC_LOBJPTR { (void) push_lv_as_ref (Local_Variable_Frame - addr->b.i_blk); }
+#define DO_BC_GOBJPTR { (void) _pSLang_push_nt_as_ref (addr->b.nt_blk); }
+#define DO_BC_LITERAL_INT { push_int_object (addr->bc_sub_type, (int) addr->b.l_blk); }
+#define DO_BC_LITERAL_STR { _pSLang_dup_and_push_slstring (addr->b.s_blk); }
+#if SLANG_HAS_FLOAT
+# define DO_BC_DCONST { push_double_object (SLANG_DOUBLE_TYPE, addr->b.dconst_blk->d); }
+# define DO_BC_LITERAL_DBL { push_double_object (addr->bc_sub_type, *addr->b.double_blk); }
+#else
+# define DO_BC_DCONST \
+   { _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type); }
+# define DO_BC_LITERAL_DBL DO_BC_DCONST
+#endif
+#define DO_BC_UNARY { do_unary (addr->b.i_blk, SLANG_BC_UNARY); }
+#define DO_BC_BINARY { (void) do_binary_site (addr); }
+#if USE_QUICKENED_BINARY
+/* The quickened forms of SLANG_BC_BINARY check that the operands still have
+ * the expected type.  If not, the bytecode reverts to SLANG_BC_BINARY.
+ * Operations that the type-specific function does not handle go through
+ * the generic code.
+ */
+# define DO_QUICK_BINARY(type, fun) \
+   { \
+      SLang_Object_Type *bp_ = Stack_Pointer - 1; \
+      IF_UNLIKELY((bp_ <= Run_Stack) \
+		  || (bp_->o_data_type != (type)) \
+		  || ((bp_-1)->o_data_type != (type))) \
+	{ \
+	   addr->bc_main_type = SLANG_BC_BINARY; \
+	   deopt_binary (addr); \
+	   (void) do_binary (addr->b.i_blk); \
+	} \
+      else if (0 != fun (addr->b.i_blk, bp_-1, bp_)) \
+	(void) do_binary (addr->b.i_blk); \
+   }
+#endif
+#define DO_BC_INTEGER_PLUS \
+   { \
+      if (0 == push_int_object (addr->bc_sub_type, (int) addr->b.l_blk)) \
+	(void) do_binary (SLANG_PLUS); \
+   }
+#define DO_BC_INTEGER_MINUS \
+   { \
+      if (0 == push_int_object (addr->bc_sub_type, (int) addr->b.l_blk)) \
+	(void) do_binary (SLANG_MINUS); \
+   }
+#define DO_BC_EXCH { (void) SLreverse_stack (2); }
+#define DO_BC_CALL_DIRECT { (*addr->b.call_function) (); }
+#define DO_BC_CALL_DIRECT_FRAME { do_bc_call_direct_frame (addr->b.call_function); }
+#define DO_BC_CALL_DIRECT_NARGS { do_bc_call_direct_nargs (addr->b.call_function); }
+#define DO_BC_EARG_LVARIABLE \
+   { \
+      PUSH_LOCAL_VARIABLE(addr->b.i_blk) \
+      (void) end_arg_list (); \
+   }
+#define DO_BC_LVARIABLE_AGET \
+   { \
+      if (0 == carefully_push_object (Local_Variable_Frame - addr->b.i_blk)) \
+	do_bc_call_direct_nargs (_pSLarray_aget); \
+   }
+#define DO_BC_LVARIABLE_APUT \
+   { \
+      if (0 == carefully_push_object (Local_Variable_Frame - addr->b.i_blk)) \
+	do_bc_call_direct_nargs (_pSLarray_aput); \
+   }
+
+/* The following macros are used by inner_interp for the bytecode dispatch.
+ * BC_NEXT is to be used in place of `break' at the end of a handler.
+ */
+#if USE_COMPUTED_GOTO_DISPATCH
+# define BC_SWITCH(t) goto *Bytecode_Labels[(t)]; switch (t)
+# define BC_CASE(t) case t: bc_label_##t
+# define BC_LABEL(t) [t] = &&bc_label_##t
+# define BC_NEXT \
+   do \
+     { \
+	IF_UNLIKELY(Handle_Interrupt != 0) goto check_interrupt; \
+	addr++; \
+	goto *Bytecode_Labels[addr->bc_main_type]; \
+     } \
+   while (0)
+#else
+# define BC_SWITCH(t) switch (t)
+# define BC_CASE(t) case t
+# define BC_NEXT break
+#endif
+
+/* A handler that continues into the next one uses BC_FALLTHROUGH.  gcc
+ * does not recognize a fall through comment before a BC_CASE that is
+ * followed by a label.
+ */
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+# define BC_FALLTHROUGH __attribute__ ((fallthrough))
+#else
+# define BC_FALLTHROUGH
+#endif
+
 /* inner interpreter */
 /* The return value from this function is only meaningful when it is used
  * to process blocks for the switch statement.  If it returns 0, the calling
@@ -5449,6 +6460,117 @@ static void add_to_statistics (SLBlock_Type *b)
 static int inner_interp (SLBlock_Type *addr_start)
 {
    SLBlock_Type *block, *err_block, *addr;
+#if USE_COMPUTED_GOTO_DISPATCH
+   /* Each bytecode must have an entry here and a BC_CASE in the switch */
+   static VOID_STAR Bytecode_Labels[256] =
+     {
+	BC_LABEL(SLANG_BC_LAST_BLOCK), BC_LABEL(SLANG_BC_LVARIABLE),
+	BC_LABEL(SLANG_BC_GVARIABLE), BC_LABEL(SLANG_BC_IVARIABLE),
+	BC_LABEL(SLANG_BC_RVARIABLE), BC_LABEL(SLANG_BC_INTRINSIC),
+	BC_LABEL(SLANG_BC_FUNCTION), BC_LABEL(SLANG_BC_MATH_UNARY),
+	BC_LABEL(SLANG_BC_APP_UNARY), BC_LABEL(SLANG_BC_ARITH_UNARY),
+	BC_LABEL(SLANG_BC_ARITH_BINARY), BC_LABEL(SLANG_BC_ICONST),
+	BC_LABEL(SLANG_BC_DCONST), BC_LABEL(SLANG_BC_FCONST),
+	BC_LABEL(SLANG_BC_LLCONST), BC_LABEL(SLANG_BC_PVARIABLE),
+	BC_LABEL(SLANG_BC_PFUNCTION), BC_LABEL(SLANG_BC_HCONST),
+	BC_LABEL(SLANG_BC_LCONST), BC_LABEL(SLANG_BC_UNUSED_0x13),
+	BC_LABEL(SLANG_BC_UNUSED_0x14), BC_LABEL(SLANG_BC_UNUSED_0x15),
+	BC_LABEL(SLANG_BC_UNUSED_0x16), BC_LABEL(SLANG_BC_UNUSED_0x17),
+	BC_LABEL(SLANG_BC_UNUSED_0x18), BC_LABEL(SLANG_BC_UNUSED_0x19),
+	BC_LABEL(SLANG_BC_UNUSED_0x1A), BC_LABEL(SLANG_BC_UNUSED_0x1B),
+	BC_LABEL(SLANG_BC_UNUSED_0x1C), BC_LABEL(SLANG_BC_UNUSED_0x1D),
+	BC_LABEL(SLANG_BC_UNUSED_0x1E), BC_LABEL(SLANG_BC_UNUSED_0x1F),
+	BC_LABEL(SLANG_BC_SET_LOCAL_LVALUE), BC_LABEL(SLANG_BC_SET_GLOBAL_LVALUE),
+	BC_LABEL(SLANG_BC_SET_INTRIN_LVALUE), BC_LABEL(SLANG_BC_SET_STRUCT_LVALUE),
+	BC_LABEL(SLANG_BC_SET_ARRAY_LVALUE), BC_LABEL(SLANG_BC_SET_DEREF_LVALUE),
+	BC_LABEL(SLANG_BC_FIELD), BC_LABEL(SLANG_BC_METHOD),
+	BC_LABEL(SLANG_BC_LVARIABLE_AGET), BC_LABEL(SLANG_BC_LVARIABLE_APUT),
+	BC_LABEL(SLANG_BC_LOBJPTR), BC_LABEL(SLANG_BC_GOBJPTR),
+	BC_LABEL(SLANG_BC_FIELD_REF), BC_LABEL(SLANG_BC_OBSOLETE_DEREF_FUN_CALL),
+	BC_LABEL(SLANG_BC_DEREF_FUN_CALL), BC_LABEL(SLANG_BC_UNUSED_0x2F),
+	BC_LABEL(SLANG_BC_UNUSED_0x30), BC_LABEL(SLANG_BC_UNUSED_0x31),
+	BC_LABEL(SLANG_BC_UNUSED_0x32), BC_LABEL(SLANG_BC_UNUSED_0x33),
+	BC_LABEL(SLANG_BC_UNUSED_0x34), BC_LABEL(SLANG_BC_UNUSED_0x35),
+	BC_LABEL(SLANG_BC_UNUSED_0x36), BC_LABEL(SLANG_BC_UNUSED_0x37),
+	BC_LABEL(SLANG_BC_UNUSED_0x38), BC_LABEL(SLANG_BC_UNUSED_0x39),
+	BC_LABEL(SLANG_BC_UNUSED_0x3A), BC_LABEL(SLANG_BC_UNUSED_0x3B),
+	BC_LABEL(SLANG_BC_UNUSED_0x3C), BC_LABEL(SLANG_BC_UNUSED_0x3D),
+	BC_LABEL(SLANG_BC_UNUSED_0x3E), BC_LABEL(SLANG_BC_UNUSED_0x3F),
+	BC_LABEL(SLANG_BC_LITERAL), BC_LABEL(SLANG_BC_LITERAL_INT),
+	BC_LABEL(SLANG_BC_LITERAL_DBL), BC_LABEL(SLANG_BC_LITERAL_STR),
+	BC_LABEL(SLANG_BC_DOLLAR_STR), BC_LABEL(SLANG_BC_UNUSED_0x45),
+	BC_LABEL(SLANG_BC_UNUSED_0x46), BC_LABEL(SLANG_BC_UNUSED_0x47),
+	BC_LABEL(SLANG_BC_UNUSED_0x48), BC_LABEL(SLANG_BC_UNUSED_0x49),
+	BC_LABEL(SLANG_BC_UNUSED_0x4A), BC_LABEL(SLANG_BC_UNUSED_0x4B),
+	BC_LABEL(SLANG_BC_UNUSED_0x4C), BC_LABEL(SLANG_BC_UNUSED_0x4D),
+	BC_LABEL(SLANG_BC_UNUSED_0x4E), BC_LABEL(SLANG_BC_UNUSED_0x4F),
+	BC_LABEL(SLANG_BC_UNARY), BC_LABEL(SLANG_BC_BINARY),
+	BC_LABEL(SLANG_BC_INTEGER_PLUS), BC_LABEL(SLANG_BC_INTEGER_MINUS),
+	BC_LABEL(SLANG_BC_BINARY_INT), BC_LABEL(SLANG_BC_BINARY_UINT),
+	BC_LABEL(SLANG_BC_BINARY_LONG), BC_LABEL(SLANG_BC_BINARY_LLONG),
+	BC_LABEL(SLANG_BC_BINARY_FLOAT), BC_LABEL(SLANG_BC_BINARY_DOUBLE),
+	BC_LABEL(SLANG_BC_UNUSED_0x5A), BC_LABEL(SLANG_BC_UNUSED_0x5B),
+	BC_LABEL(SLANG_BC_UNUSED_0x5C), BC_LABEL(SLANG_BC_UNUSED_0x5D),
+	BC_LABEL(SLANG_BC_UNUSED_0x5E), BC_LABEL(SLANG_BC_UNUSED_0x5F),
+	BC_LABEL(SLANG_BC_TMP), BC_LABEL(SLANG_BC_EXCH),
+	BC_LABEL(SLANG_BC_LABEL), BC_LABEL(SLANG_BC_BLOCK),
+	BC_LABEL(SLANG_BC_RETURN), BC_LABEL(SLANG_BC_BREAK),
+	BC_LABEL(SLANG_BC_CONTINUE), BC_LABEL(SLANG_BC_UNUSED_0x67),
+	BC_LABEL(SLANG_BC_CONTINUE_N), BC_LABEL(SLANG_BC_BREAK_N),
+	BC_LABEL(SLANG_BC_X_ERROR), BC_LABEL(SLANG_BC_X_USER0),
+	BC_LABEL(SLANG_BC_X_USER1), BC_LABEL(SLANG_BC_X_USER2),
+	BC_LABEL(SLANG_BC_X_USER3), BC_LABEL(SLANG_BC_X_USER4),
+	BC_LABEL(SLANG_BC_CALL_DIRECT), BC_LABEL(SLANG_BC_CALL_DIRECT_FRAME),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_NARGS), BC_LABEL(SLANG_BC_EARG_LVARIABLE),
+#if USE_BC_LINE_NUM
+	BC_LABEL(SLANG_BC_LINE_NUM),
+#else
+	BC_LABEL(SLANG_BC_UNUSED_0x74),
+#endif
+	BC_LABEL(SLANG_BC_BOS), BC_LABEL(SLANG_BC_EOS),
+	BC_LABEL(SLANG_BC_TAIL_CALL), BC_LABEL(SLANG_BC_UNUSED_0x78),
+	BC_LABEL(SLANG_BC_UNUSED_0x79), BC_LABEL(SLANG_BC_UNUSED_0x7A),
+	BC_LABEL(SLANG_BC_UNUSED_0x7B), BC_LABEL(SLANG_BC_UNUSED_0x7C),
+	BC_LABEL(SLANG_BC_UNUSED_0x7D), BC_LABEL(SLANG_BC_UNUSED_0x7E),
+	BC_LABEL(SLANG_BC_UNUSED_0x7F),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_INTRINSIC), BC_LABEL(SLANG_BC_INTRINSIC_CALL_DIRECT),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_LSTR), BC_LABEL(SLANG_BC_CALL_DIRECT_SLFUN),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_RETINTR), BC_LABEL(SLANG_BC_RET_INTRINSIC),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_EARG_LVAR), BC_LABEL(SLANG_BC_CALL_DIRECT_LINT),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_LVAR), BC_LABEL(SLANG_BC_LLVARIABLE_BINARY),
+	BC_LABEL(SLANG_BC_LGVARIABLE_BINARY), BC_LABEL(SLANG_BC_GLVARIABLE_BINARY),
+	BC_LABEL(SLANG_BC_GGVARIABLE_BINARY), BC_LABEL(SLANG_BC_LIVARIABLE_BINARY),
+	BC_LABEL(SLANG_BC_LDVARIABLE_BINARY), BC_LABEL(SLANG_BC_ILVARIABLE_BINARY),
+	BC_LABEL(SLANG_BC_DLVARIABLE_BINARY), BC_LABEL(SLANG_BC_LVARIABLE_BINARY),
+	BC_LABEL(SLANG_BC_GVARIABLE_BINARY), BC_LABEL(SLANG_BC_LITERAL_INT_BINARY),
+	BC_LABEL(SLANG_BC_LITERAL_DBL_BINARY), BC_LABEL(SLANG_BC_LASSIGN_LLBINARY),
+	BC_LABEL(SLANG_BC_LASSIGN_LIBINARY), BC_LABEL(SLANG_BC_LASSIGN_ILBINARY),
+	BC_LABEL(SLANG_BC_LASSIGN_LDBINARY), BC_LABEL(SLANG_BC_LASSIGN_DLBINARY),
+	BC_LABEL(SLANG_BC_RET_LVARIABLE), BC_LABEL(SLANG_BC_RET_LITERAL_INT),
+	BC_LABEL(SLANG_BC_MANY_LVARIABLE), BC_LABEL(SLANG_BC_MANY_LVARIABLE_DIR),
+	BC_LABEL(SLANG_BC_LVARIABLE_AGET1), BC_LABEL(SLANG_BC_LITERAL_AGET1),
+	BC_LABEL(SLANG_BC_LVAR_LVAR_APUT1), BC_LABEL(SLANG_BC_LVARIABLE_APUT1),
+	BC_LABEL(SLANG_BC_LITERAL_APUT1), BC_LABEL(SLANG_BC_LLVARIABLE_BINARY2),
+	BC_LABEL(SLANG_BC_SET_LOCLV_LIT_INT), BC_LABEL(SLANG_BC_SET_LOCLV_LIT_AGET1),
+	BC_LABEL(SLANG_BC_SET_LOCLV_LVAR), BC_LABEL(SLANG_BC_SET_LOCLV_LASTBLOCK),
+	BC_LABEL(SLANG_BC_LVAR_EARG_LVAR), BC_LABEL(SLANG_BC_LVAR_FIELD),
+	BC_LABEL(SLANG_BC_BINARY_LASTBLOCK), BC_LABEL(SLANG_BC_EARG_LVARIABLE_INTRINSIC),
+	BC_LABEL(SLANG_BC_LVAR_LITERAL_INT), BC_LABEL(SLANG_BC_BINARY_SET_LOCLVAL),
+	BC_LABEL(SLANG_BC_LVAR_AGET_SET_LOCLVAL), BC_LABEL(SLANG_BC_LLVAR_BINARY_IF),
+	BC_LABEL(SLANG_BC_IF_BLOCK), BC_LABEL(SLANG_BC_LVAR_SET_FIELD),
+	BC_LABEL(SLANG_BC_PVAR_SET_GLOB_LVAL), BC_LABEL(SLANG_BC_LVAR_SET_GLOB_LVAL),
+	BC_LABEL(SLANG_BC_LIT_AGET1_INT_BINARY), BC_LABEL(SLANG_BC_BINARY2),
+	BC_LABEL(SLANG_BC_LVAR_LIT_AGET1), BC_LABEL(SLANG_BC_LVARIABLE_COMBINED),
+	BC_LABEL(SLANG_BC_GVARIABLE_COMBINED), BC_LABEL(SLANG_BC_LITERAL_COMBINED),
+	BC_LABEL(SLANG_BC_CALL_DIRECT_COMB), BC_LABEL(SLANG_BC_COMBINED),
+	BC_LABEL(SLANG_BC_BLOCK_COMBINED),
+#define SUPER_BC(s,x,y) BC_LABEL(s),
+#define UNUSED_SUPER_BC(s) BC_LABEL(s),
+#include "slsuperbc.inc"
+#undef SUPER_BC
+#undef UNUSED_SUPER_BC
+     };
+#endif
 #if GATHER_STATISTICS
    static int inited = 0;
 
@@ -5482,37 +6604,34 @@ static int inner_interp (SLBlock_Type *addr_start)
    while (1)
      {
 	addr++;
-	switch (addr->bc_main_type)
+	BC_SWITCH (addr->bc_main_type)
 	  {
-	   case SLANG_BC_LAST_BLOCK:
+	   BC_CASE(SLANG_BC_LAST_BLOCK):
 	     goto return_1;
-	   case SLANG_BC_LVARIABLE:
-	     PUSH_LOCAL_VARIABLE (addr->b.i_blk)
-	     break;
-	   case SLANG_BC_GVARIABLE:
-	     if (-1 == _pSLpush_slang_obj (&addr->b.nt_gvar_blk->obj))
-	       do_name_type_error (addr->b.nt_blk);
-	     break;
-
-	   case SLANG_BC_IVARIABLE:
-	   case SLANG_BC_RVARIABLE:
+	   BC_CASE(SLANG_BC_LVARIABLE):
+	     DO_BC_LVARIABLE
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_GVARIABLE):
+	     DO_BC_GVARIABLE
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_IVARIABLE):
+	   BC_CASE(SLANG_BC_RVARIABLE):
 	     push_intrinsic_variable (addr->b.nt_ivar_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_INTRINSIC:
-	     EXECUTE_INTRINSIC(addr)
-	     if (IS_SLANG_ERROR)
-	       do_traceback(addr->b.nt_ifun_blk->name);
-	     break;
+	   BC_CASE(SLANG_BC_INTRINSIC):
+	     DO_BC_INTRINSIC
+	     BC_NEXT;
 
-	   case SLANG_BC_FUNCTION:
+	   BC_CASE(SLANG_BC_FUNCTION):
 	     execute_slang_fun (addr->b.nt_fun_blk, addr->linenum);
 	     if (Lang_Break_Condition) goto handle_break_condition;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_MATH_UNARY:
-	   case SLANG_BC_APP_UNARY:
-	   case SLANG_BC_ARITH_UNARY:
+	   BC_CASE(SLANG_BC_MATH_UNARY):
+	   BC_CASE(SLANG_BC_APP_UNARY):
+	   BC_CASE(SLANG_BC_ARITH_UNARY):
 	     /* Make sure we treat these like function calls since the
 	      * parser took abs(x), sin(x), etc to be a function call.
 	      */
@@ -5521,9 +6640,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  do_app_unary (addr->b.nt_unary_blk);
 		  (void) _pSL_decrement_frame_pointer ();
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_ARITH_BINARY:
+	   BC_CASE(SLANG_BC_ARITH_BINARY):
 	     /* Make sure we treat these like function calls since the
 	      * parser took _op_eqs, etc as function calls.
 	      */
@@ -5532,157 +6651,169 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  do_arith_binary (addr->b.nt_binary_blk);
 		  (void) _pSL_decrement_frame_pointer ();
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_ICONST:
-	     push_int_object (addr->b.iconst_blk->data_type, addr->b.iconst_blk->value);
-	     break;
+	   BC_CASE(SLANG_BC_ICONST):
+	     DO_BC_ICONST
+	     BC_NEXT;
 
 #if SLANG_HAS_FLOAT
-	   case SLANG_BC_DCONST:
-	     push_double_object (SLANG_DOUBLE_TYPE, addr->b.dconst_blk->d);
-	     break;
-	   case SLANG_BC_FCONST:
+	   BC_CASE(SLANG_BC_DCONST):
+	     DO_BC_DCONST
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_FCONST):
 	     SLclass_push_float_obj (SLANG_FLOAT_TYPE, addr->b.fconst_blk->f);
-	     break;
+	     BC_NEXT;
 #endif
 #ifdef HAVE_LONG_LONG
-	   case SLANG_BC_LLCONST:
+	   BC_CASE(SLANG_BC_LLCONST):
 	     SLclass_push_llong_obj (addr->b.llconst_blk->data_type, addr->b.llconst_blk->value);
-	     break;
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_PVARIABLE:
-	     if (-1 == _pSLpush_slang_obj (&addr->b.nt_gvar_blk->obj))
-	       do_name_type_error (addr->b.nt_blk);
-	     break;
+	   BC_CASE(SLANG_BC_PVARIABLE):
+	     DO_BC_PVARIABLE
+	     BC_NEXT;
 
-	   case SLANG_BC_PFUNCTION:
+	   BC_CASE(SLANG_BC_PFUNCTION):
 	     execute_slang_fun (addr->b.nt_fun_blk, addr->linenum);
 	     if (Lang_Break_Condition) goto handle_break_condition;
-	     break;
-	   case SLANG_BC_HCONST:
-	     SLclass_push_short_obj (addr->b.iconst_blk->data_type, addr->b.hconst_blk->value);
-	     break;
-	   case SLANG_BC_LCONST:
-	     SLclass_push_long_obj (addr->b.iconst_blk->data_type, addr->b.lconst_blk->value);
-	     break;
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_TAIL_CALL):
+	     /* This is followed by SLANG_BC_RETURN, which is executed if the
+	      * function cannot be tail-called.
+	      */
+	     if ((Tail_Calls_Disabled == 0) && (Exit_Block_Ptr == NULL)
+		 && (Tail_Call_Function == NULL))
+	       {
+		  Tail_Call_Function = addr->b.nt_fun_blk;
+		  Tail_Call_Linenum = addr->linenum;
+		  Tail_Call_Num_Args = Next_Function_Num_Args;
+		  Next_Function_Num_Args = 0;
+#if SLANG_HAS_QUALIFIERS
+		  Tail_Call_Qualifiers = Next_Function_Qualifiers;
+		  Next_Function_Qualifiers = NULL;
+#endif
+		  Lang_Break_Condition = Lang_Return = Lang_Break = 1;
+		  goto return_1;
+	       }
+	     execute_slang_fun (addr->b.nt_fun_blk, addr->linenum);
+	     if (Lang_Break_Condition) goto handle_break_condition;
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_HCONST):
+	     DO_BC_HCONST
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_LCONST):
+	     DO_BC_LCONST
+	     BC_NEXT;
 
 #if USE_UNUSED_BYCODES_IN_SWITCH
 # ifndef HAVE_LONG_LONG
-	   case SLANG_BC_LLCONST:
+	   BC_CASE(SLANG_BC_LLCONST):
 # endif
-	   case SLANG_BC_UNUSED_0x13:
-	   case SLANG_BC_UNUSED_0x14:
-	   case SLANG_BC_UNUSED_0x15:
-	   case SLANG_BC_UNUSED_0x16:
-	   case SLANG_BC_UNUSED_0x17:
-	   case SLANG_BC_UNUSED_0x18:
-	   case SLANG_BC_UNUSED_0x19:
-	   case SLANG_BC_UNUSED_0x1A:
-	   case SLANG_BC_UNUSED_0x1B:
-	   case SLANG_BC_UNUSED_0x1C:
-	   case SLANG_BC_UNUSED_0x1D:
-	   case SLANG_BC_UNUSED_0x1E:
-	   case SLANG_BC_UNUSED_0x1F:
+	   BC_CASE(SLANG_BC_UNUSED_0x13):
+	   BC_CASE(SLANG_BC_UNUSED_0x14):
+	   BC_CASE(SLANG_BC_UNUSED_0x15):
+	   BC_CASE(SLANG_BC_UNUSED_0x16):
+	   BC_CASE(SLANG_BC_UNUSED_0x17):
+	   BC_CASE(SLANG_BC_UNUSED_0x18):
+	   BC_CASE(SLANG_BC_UNUSED_0x19):
+	   BC_CASE(SLANG_BC_UNUSED_0x1A):
+	   BC_CASE(SLANG_BC_UNUSED_0x1B):
+	   BC_CASE(SLANG_BC_UNUSED_0x1C):
+	   BC_CASE(SLANG_BC_UNUSED_0x1D):
+	   BC_CASE(SLANG_BC_UNUSED_0x1E):
+	   BC_CASE(SLANG_BC_UNUSED_0x1F):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
-#endif
-	   case SLANG_BC_SET_LOCAL_LVALUE:
-	     set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk);
-	     break;
-	   case SLANG_BC_SET_GLOBAL_LVALUE:
-	     if (-1 == set_lvalue_obj (addr->bc_sub_type, &addr->b.nt_gvar_blk->obj))
-	       do_name_type_error (addr->b.nt_blk);
-	     break;
-	   case SLANG_BC_SET_INTRIN_LVALUE:
+	     BC_NEXT;
+#endif
+	   BC_CASE(SLANG_BC_SET_LOCAL_LVALUE):
+	     DO_BC_SET_LOCAL_LVALUE
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_SET_GLOBAL_LVALUE):
+	     DO_BC_SET_GLOBAL_LVALUE
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_SET_INTRIN_LVALUE):
 	     set_intrin_lvalue (addr);
-	     break;
-	   case SLANG_BC_SET_STRUCT_LVALUE:
-	     set_struct_lvalue (addr);
-	     break;
-	   case SLANG_BC_SET_ARRAY_LVALUE:
-	     set_array_lvalue (addr->bc_sub_type);
-	     break;
-	   case SLANG_BC_SET_DEREF_LVALUE:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_SET_STRUCT_LVALUE):
+	     DO_BC_SET_STRUCT_LVALUE
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_SET_ARRAY_LVALUE):
+	     DO_BC_SET_ARRAY_LVALUE
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_SET_DEREF_LVALUE):
 	     set_deref_lvalue (addr->bc_sub_type);
-	     break;
-
-	   case SLANG_BC_FIELD:
-	     (void) push_struct_field (addr->b.s_blk);
-	     break;
-	   case SLANG_BC_METHOD:
-	     do_struct_method (addr->b.s_blk, addr->linenum);
-	     break;
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_FIELD):
+	     DO_BC_FIELD
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_METHOD):
+	     do_struct_method (addr->b.s_blk, &addr->bc_sub_type, addr->linenum);
+	     BC_NEXT;
 #if SLANG_OPTIMIZE_FOR_SPEED
-	   case SLANG_BC_LVARIABLE_AGET:
-	       {
-		  SLang_Object_Type *obj = Local_Variable_Frame - addr->b.i_blk;
-		  if (0 == carefully_push_object (obj))
-		    do_bc_call_direct_nargs (_pSLarray_aget);
-	       }
-	     break;
+	   BC_CASE(SLANG_BC_LVARIABLE_AGET):
+	     DO_BC_LVARIABLE_AGET
+	     BC_NEXT;
 
-	   case SLANG_BC_LVARIABLE_APUT:
-	       {
-		  SLang_Object_Type *obj = Local_Variable_Frame - addr->b.i_blk;
-		  if (0 == carefully_push_object (obj))
-		    do_bc_call_direct_nargs (_pSLarray_aput);
-	       }
-	     break;
+	   BC_CASE(SLANG_BC_LVARIABLE_APUT):
+	     DO_BC_LVARIABLE_APUT
+	     BC_NEXT;
 #else
-	   case SLANG_BC_LVARIABLE_AGET:
-	   case SLANG_BC_LVARIABLE_APUT:
+	   BC_CASE(SLANG_BC_LVARIABLE_AGET):
+	   BC_CASE(SLANG_BC_LVARIABLE_APUT):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_LOBJPTR:
-	     (void)push_lv_as_ref (Local_Variable_Frame - addr->b.i_blk);
-	     break;
+	   BC_CASE(SLANG_BC_LOBJPTR):
+	     DO_BC_LOBJPTR
+	     BC_NEXT;
 
-	   case SLANG_BC_GOBJPTR:
-	     (void)_pSLang_push_nt_as_ref (addr->b.nt_blk);
-	     break;
+	   BC_CASE(SLANG_BC_GOBJPTR):
+	     DO_BC_GOBJPTR
+	     BC_NEXT;
 
-	   case SLANG_BC_FIELD_REF:
+	   BC_CASE(SLANG_BC_FIELD_REF):
 	     (void) _pSLstruct_push_field_ref (addr->b.s_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_OBSOLETE_DEREF_FUN_CALL:
+	   BC_CASE(SLANG_BC_OBSOLETE_DEREF_FUN_CALL):
 	     (void) obsolete_deref_fun_call (addr->linenum);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_DEREF_FUN_CALL:
+	   BC_CASE(SLANG_BC_DEREF_FUN_CALL):
 	     (void) deref_fun_call (addr->linenum);
-	     break;
+	     BC_NEXT;
 
 #if USE_UNUSED_BYCODES_IN_SWITCH
-	   case SLANG_BC_UNUSED_0x2F:
-	   case SLANG_BC_UNUSED_0x30:
-	   case SLANG_BC_UNUSED_0x31:
-	   case SLANG_BC_UNUSED_0x32:
-	   case SLANG_BC_UNUSED_0x33:
-	   case SLANG_BC_UNUSED_0x34:
-	   case SLANG_BC_UNUSED_0x35:
-	   case SLANG_BC_UNUSED_0x36:
-	   case SLANG_BC_UNUSED_0x37:
-	   case SLANG_BC_UNUSED_0x38:
-	   case SLANG_BC_UNUSED_0x39:
-	   case SLANG_BC_UNUSED_0x3A:
-	   case SLANG_BC_UNUSED_0x3B:
-	   case SLANG_BC_UNUSED_0x3C:
-	   case SLANG_BC_UNUSED_0x3D:
-	   case SLANG_BC_UNUSED_0x3E:
-	   case SLANG_BC_UNUSED_0x3F:
+	   BC_CASE(SLANG_BC_UNUSED_0x2F):
+	   BC_CASE(SLANG_BC_UNUSED_0x30):
+	   BC_CASE(SLANG_BC_UNUSED_0x31):
+	   BC_CASE(SLANG_BC_UNUSED_0x32):
+	   BC_CASE(SLANG_BC_UNUSED_0x33):
+	   BC_CASE(SLANG_BC_UNUSED_0x34):
+	   BC_CASE(SLANG_BC_UNUSED_0x35):
+	   BC_CASE(SLANG_BC_UNUSED_0x36):
+	   BC_CASE(SLANG_BC_UNUSED_0x37):
+	   BC_CASE(SLANG_BC_UNUSED_0x38):
+	   BC_CASE(SLANG_BC_UNUSED_0x39):
+	   BC_CASE(SLANG_BC_UNUSED_0x3A):
+	   BC_CASE(SLANG_BC_UNUSED_0x3B):
+	   BC_CASE(SLANG_BC_UNUSED_0x3C):
+	   BC_CASE(SLANG_BC_UNUSED_0x3D):
+	   BC_CASE(SLANG_BC_UNUSED_0x3E):
+	   BC_CASE(SLANG_BC_UNUSED_0x3F):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_LITERAL:
+	   BC_CASE(SLANG_BC_LITERAL):
 #if !SLANG_OPTIMIZE_FOR_SPEED
-	   case SLANG_BC_LITERAL_INT:
+	   BC_CASE(SLANG_BC_LITERAL_INT):
 # if SLANG_HAS_FLOAT
-	   case SLANG_BC_LITERAL_DBL:
+	   BC_CASE(SLANG_BC_LITERAL_DBL):
 # endif
-	   case SLANG_BC_LITERAL_STR:
+	   BC_CASE(SLANG_BC_LITERAL_STR):
 #endif
 	       {
 		  SLang_Class_Type *cl;
@@ -5691,95 +6822,137 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  GET_BUILTIN_CLASS(cl, addr->bc_sub_type);
 		  (*cl->cl_push_literal) (addr->bc_sub_type, (VOID_STAR) &addr->b.ptr_blk);
 	       }
-	     break;
+	     BC_NEXT;
 #if SLANG_OPTIMIZE_FOR_SPEED
-	   case SLANG_BC_LITERAL_INT:
-	     push_int_object (addr->bc_sub_type, (int) addr->b.l_blk);
-	     break;
+	   BC_CASE(SLANG_BC_LITERAL_INT):
+	     DO_BC_LITERAL_INT
+	     BC_NEXT;
 #if SLANG_HAS_FLOAT
-	   case SLANG_BC_LITERAL_DBL:
-	     push_double_object (addr->bc_sub_type, *addr->b.double_blk);
-	     break;
+	   BC_CASE(SLANG_BC_LITERAL_DBL):
+	     DO_BC_LITERAL_DBL
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_LITERAL_STR:
-	     _pSLang_dup_and_push_slstring (addr->b.s_blk);
-	     break;
+	   BC_CASE(SLANG_BC_LITERAL_STR):
+	     DO_BC_LITERAL_STR
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_DOLLAR_STR:
+	   BC_CASE(SLANG_BC_DOLLAR_STR):
 	     (void) _pSLpush_dollar_string (addr->b.s_blk);
-	     break;
+	     BC_NEXT;
 
 #if USE_UNUSED_BYCODES_IN_SWITCH
-	   case SLANG_BC_UNUSED_0x45:
-	   case SLANG_BC_UNUSED_0x46:
-	   case SLANG_BC_UNUSED_0x47:
-	   case SLANG_BC_UNUSED_0x48:
-	   case SLANG_BC_UNUSED_0x49:
-	   case SLANG_BC_UNUSED_0x4A:
-	   case SLANG_BC_UNUSED_0x4B:
-	   case SLANG_BC_UNUSED_0x4C:
-	   case SLANG_BC_UNUSED_0x4D:
-	   case SLANG_BC_UNUSED_0x4E:
-	   case SLANG_BC_UNUSED_0x4F:
+	   BC_CASE(SLANG_BC_UNUSED_0x45):
+	   BC_CASE(SLANG_BC_UNUSED_0x46):
+	   BC_CASE(SLANG_BC_UNUSED_0x47):
+	   BC_CASE(SLANG_BC_UNUSED_0x48):
+	   BC_CASE(SLANG_BC_UNUSED_0x49):
+	   BC_CASE(SLANG_BC_UNUSED_0x4A):
+	   BC_CASE(SLANG_BC_UNUSED_0x4B):
+	   BC_CASE(SLANG_BC_UNUSED_0x4C):
+	   BC_CASE(SLANG_BC_UNUSED_0x4D):
+	   BC_CASE(SLANG_BC_UNUSED_0x4E):
+	   BC_CASE(SLANG_BC_UNUSED_0x4F):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_UNARY:
-	     do_unary (addr->b.i_blk, SLANG_BC_UNARY);
-	     break;
+	   BC_CASE(SLANG_BC_UNARY):
+	     DO_BC_UNARY
+	     BC_NEXT;
 
-	   case SLANG_BC_BINARY:
+	   BC_CASE(SLANG_BC_BINARY):
+#if USE_QUICKENED_BINARY
+	     quicken_binary (addr);
 	     (void) do_binary (addr->b.i_blk);
-	     break;
+#else
+	     DO_BC_BINARY
+#endif
+	     BC_NEXT;
 
 #if SLANG_OPTIMIZE_FOR_SPEED
-	   case SLANG_BC_INTEGER_PLUS:
-	     if (0 == push_int_object (addr->bc_sub_type, (int) addr->b.l_blk))
-	       (void) do_binary (SLANG_PLUS);
-	     break;
+	   BC_CASE(SLANG_BC_INTEGER_PLUS):
+	     DO_BC_INTEGER_PLUS
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_INTEGER_MINUS):
+	     DO_BC_INTEGER_MINUS
+	     BC_NEXT;
+#endif
+#if USE_QUICKENED_BINARY
+	   BC_CASE(SLANG_BC_BINARY_INT):
+	     DO_QUICK_BINARY(SLANG_INT_TYPE, int_int_quick_binary)
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_BINARY_UINT):
+	     DO_QUICK_BINARY(SLANG_UINT_TYPE, uint_uint_quick_binary)
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_BINARY_LONG):
+	     DO_QUICK_BINARY(SLANG_LONG_TYPE, long_long_quick_binary)
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_BINARY_LLONG):
+# ifdef HAVE_LONG_LONG
+	     DO_QUICK_BINARY(SLANG_LLONG_TYPE, llong_llong_quick_binary)
+# else
+	     DO_BC_BINARY
+# endif
+	     BC_NEXT;
 
-	   case SLANG_BC_INTEGER_MINUS:
-	     if (0 == push_int_object (addr->bc_sub_type, (int) addr->b.l_blk))
-	       (void) do_binary (SLANG_MINUS);
-	     break;
+	   BC_CASE(SLANG_BC_BINARY_FLOAT):
+# if SLANG_HAS_FLOAT
+	     DO_QUICK_BINARY(SLANG_FLOAT_TYPE, float_float_quick_binary)
+# else
+	     DO_BC_BINARY
+# endif
+	     BC_NEXT;
+
+	   BC_CASE(SLANG_BC_BINARY_DOUBLE):
+# if SLANG_HAS_FLOAT
+	     DO_QUICK_BINARY(SLANG_DOUBLE_TYPE, dbl_dbl_quick_binary)
+# else
+	     DO_BC_BINARY
+# endif
+	     BC_NEXT;
 #endif
 #if USE_UNUSED_BYCODES_IN_SWITCH
 # if !SLANG_OPTIMIZE_FOR_SPEED
-	   case SLANG_BC_INTEGER_PLUS:
-	   case SLANG_BC_INTEGER_MINUS:
-	     break;
+	   BC_CASE(SLANG_BC_INTEGER_PLUS):
+	   BC_CASE(SLANG_BC_INTEGER_MINUS):
+	     BC_NEXT;
+# endif
+# if !USE_QUICKENED_BINARY
+	   BC_CASE(SLANG_BC_BINARY_INT):
+	   BC_CASE(SLANG_BC_BINARY_UINT):
+	   BC_CASE(SLANG_BC_BINARY_LONG):
+	   BC_CASE(SLANG_BC_BINARY_LLONG):
+	   BC_CASE(SLANG_BC_BINARY_FLOAT):
+	   BC_CASE(SLANG_BC_BINARY_DOUBLE):
 # endif
-	   case SLANG_BC_UNUSED_0x54:
-	   case SLANG_BC_UNUSED_0x55:
-	   case SLANG_BC_UNUSED_0x56:
-	   case SLANG_BC_UNUSED_0x57:
-	   case SLANG_BC_UNUSED_0x58:
-	   case SLANG_BC_UNUSED_0x59:
-	   case SLANG_BC_UNUSED_0x5A:
-	   case SLANG_BC_UNUSED_0x5B:
-	   case SLANG_BC_UNUSED_0x5C:
-	   case SLANG_BC_UNUSED_0x5D:
-	   case SLANG_BC_UNUSED_0x5E:
-	   case SLANG_BC_UNUSED_0x5F:
+	   BC_CASE(SLANG_BC_UNUSED_0x5A):
+	   BC_CASE(SLANG_BC_UNUSED_0x5B):
+	   BC_CASE(SLANG_BC_UNUSED_0x5C):
+	   BC_CASE(SLANG_BC_UNUSED_0x5D):
+	   BC_CASE(SLANG_BC_UNUSED_0x5E):
+	   BC_CASE(SLANG_BC_UNUSED_0x5F):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_TMP:
+	   BC_CASE(SLANG_BC_TMP):
 	     tmp_variable_function (addr);
-	     break;
-	   case SLANG_BC_EXCH:
-	     (void) SLreverse_stack (2);
-	     break;
-	   case SLANG_BC_LABEL:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_EXCH):
+	     DO_BC_EXCH
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_LABEL):
 	       {
 		  int test;
 		  if ((0 == pop_int (&test))
 		      && (test == 0))
 		    goto return_0;
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_BLOCK:
+	   BC_CASE(SLANG_BC_BLOCK):
 #if SLANG_OPTIMIZE_FOR_SPEED
 	     while ((addr->bc_main_type == SLANG_BC_BLOCK)
 		    && (addr->bc_sub_type == 0))
@@ -5792,7 +6965,7 @@ static int inner_interp (SLBlock_Type *addr_start)
 	     if (addr->bc_main_type != SLANG_BC_BLOCK)
 	       {
 		  addr--;
-		  break;
+		  BC_NEXT;
 	       }
 #endif
 	     switch (addr->bc_sub_type) /*{{{*/
@@ -5963,31 +7136,31 @@ static int inner_interp (SLBlock_Type *addr_start)
 /*}}}*/
 
 	     if (Lang_Break_Condition) goto handle_break_condition;
-	     break;
+	     BC_NEXT;
 	  /* End of SLANG_BC_BLOCK */
 
-	   case SLANG_BC_RETURN:
+	   BC_CASE(SLANG_BC_RETURN):
 	     Lang_Break_Condition = Lang_Return = Lang_Break = 1; goto return_1;
-	   case SLANG_BC_BREAK:
+	   BC_CASE(SLANG_BC_BREAK):
 	     Lang_Break_Condition = Lang_Break = 1; goto return_1;
-	   case SLANG_BC_CONTINUE:
+	   BC_CASE(SLANG_BC_CONTINUE):
 	     Lang_Break_Condition = /* Lang_Continue = */ 1; goto return_1;
 
 #if USE_UNUSED_BYCODES_IN_SWITCH
-	   case SLANG_BC_UNUSED_0x67:
+	   BC_CASE(SLANG_BC_UNUSED_0x67):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 #endif
-	   case SLANG_BC_BREAK_N:
+	   BC_CASE(SLANG_BC_BREAK_N):
 	     Lang_Break_Condition = Lang_Break = addr->b.i_blk;
 	     goto return_1;
 
-	   case SLANG_BC_CONTINUE_N:
+	   BC_CASE(SLANG_BC_CONTINUE_N):
 	     Lang_Break = -(addr->b.i_blk - 1);
 	     Lang_Break_Condition = 1;
 	     goto return_1;
 
-	   case SLANG_BC_X_ERROR:
+	   BC_CASE(SLANG_BC_X_ERROR):
 	     if (err_block != NULL)
 	       {
 		  inner_interp(err_block->b.blk);
@@ -5995,141 +7168,139 @@ static int inner_interp (SLBlock_Type *addr_start)
 	       }
 	     else _pSLang_verror(SL_SYNTAX_ERROR, "No ERROR_BLOCK");
 	     if (Lang_Break_Condition) goto handle_break_condition;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_X_USER0:
-	   case SLANG_BC_X_USER1:
-	   case SLANG_BC_X_USER2:
-	   case SLANG_BC_X_USER3:
-	   case SLANG_BC_X_USER4:
+	   BC_CASE(SLANG_BC_X_USER0):
+	   BC_CASE(SLANG_BC_X_USER1):
+	   BC_CASE(SLANG_BC_X_USER2):
+	   BC_CASE(SLANG_BC_X_USER3):
+	   BC_CASE(SLANG_BC_X_USER4):
 	     if (User_Block_Ptr[addr->bc_main_type - SLANG_BC_X_USER0] != NULL)
 	       {
 		  inner_interp(User_Block_Ptr[addr->bc_main_type - SLANG_BC_X_USER0]);
 	       }
 	     else _pSLang_verror(SL_SYNTAX_ERROR, "No block for X_USERBLOCK");
 	     if (Lang_Break_Condition) goto handle_break_condition;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT:
-	     (*addr->b.call_function) ();
-	     break;
+	   BC_CASE(SLANG_BC_CALL_DIRECT):
+	     DO_BC_CALL_DIRECT
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_FRAME:
-	     do_bc_call_direct_frame (addr->b.call_function);
-	     break;
+	   BC_CASE(SLANG_BC_CALL_DIRECT_FRAME):
+	     DO_BC_CALL_DIRECT_FRAME
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_NARGS:
-	     do_bc_call_direct_nargs (addr->b.call_function);
-	     break;
+	   BC_CASE(SLANG_BC_CALL_DIRECT_NARGS):
+	     DO_BC_CALL_DIRECT_NARGS
+	     BC_NEXT;
 
-	   case SLANG_BC_EARG_LVARIABLE:
-	     PUSH_LOCAL_VARIABLE(addr->b.i_blk)
-	     (void) end_arg_list ();
-	     break;
+	   BC_CASE(SLANG_BC_EARG_LVARIABLE):
+	     DO_BC_EARG_LVARIABLE
+	     BC_NEXT;
 #if USE_BC_LINE_NUM
-	   case SLANG_BC_LINE_NUM:
-	     break;
+	   BC_CASE(SLANG_BC_LINE_NUM):
+	     BC_NEXT;
 #else
 # if USE_UNUSED_BYCODES_IN_SWITCH
-	   case SLANG_BC_UNUSED_0x74:
+	   BC_CASE(SLANG_BC_UNUSED_0x74):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 # endif
 #endif
-	   case SLANG_BC_BOS:
+	   BC_CASE(SLANG_BC_BOS):
 #if SLANG_HAS_BOSEOS
 	     BOS_Stack_Depth++;
 	     This_Compile_Linenum = addr->b.line_info->linenum;
 	     (void) _pSLcall_bos_handler (addr->b.line_info->filename, addr->b.line_info->linenum);
 #endif
-	     break;
-	   case SLANG_BC_EOS:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_EOS):
 #if SLANG_HAS_BOSEOS
 	     This_Compile_Linenum = addr->linenum;
 	     (void) _pSLcall_eos_handler ();
 	     BOS_Stack_Depth--;
 #endif
-	     break;
+	     BC_NEXT;
 
 #if USE_UNUSED_BYCODES_IN_SWITCH
-	   case SLANG_BC_UNUSED_0x77:
-	   case SLANG_BC_UNUSED_0x78:
-	   case SLANG_BC_UNUSED_0x79:
-	   case SLANG_BC_UNUSED_0x7A:
-	   case SLANG_BC_UNUSED_0x7B:
-	   case SLANG_BC_UNUSED_0x7C:
-	   case SLANG_BC_UNUSED_0x7D:
-	   case SLANG_BC_UNUSED_0x7E:
-	   case SLANG_BC_UNUSED_0x7F:
+	   BC_CASE(SLANG_BC_UNUSED_0x78):
+	   BC_CASE(SLANG_BC_UNUSED_0x79):
+	   BC_CASE(SLANG_BC_UNUSED_0x7A):
+	   BC_CASE(SLANG_BC_UNUSED_0x7B):
+	   BC_CASE(SLANG_BC_UNUSED_0x7C):
+	   BC_CASE(SLANG_BC_UNUSED_0x7D):
+	   BC_CASE(SLANG_BC_UNUSED_0x7E):
+	   BC_CASE(SLANG_BC_UNUSED_0x7F):
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
-	     break;
+	     BC_NEXT;
 #endif
 
 #if USE_COMBINED_BYTECODES
-	   case SLANG_BC_CALL_DIRECT_INTRINSIC:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_INTRINSIC):
 	     (*addr->b.call_function) ();
 	     addr++;
 	     EXECUTE_INTRINSIC(addr)
 	     if (IS_SLANG_ERROR)
 	       do_traceback(addr->b.nt_ifun_blk->name);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_INTRINSIC_CALL_DIRECT:
+	   BC_CASE(SLANG_BC_INTRINSIC_CALL_DIRECT):
 	     EXECUTE_INTRINSIC(addr)
 	     if (IS_SLANG_ERROR)
 	       {
 		  do_traceback(addr->b.nt_ifun_blk->name);
-		  break;
+		  BC_NEXT;
 	       }
 	     addr++;
 	     (*addr->b.call_function) ();
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_LSTR:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_LSTR):
 	     (*addr->b.call_function) ();
 	     addr++;
 	     _pSLang_dup_and_push_slstring (addr->b.s_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_SLFUN:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_SLFUN):
 	     (*addr->b.call_function) ();
 	     addr++;
 	     execute_slang_fun (addr->b.nt_fun_blk, addr->linenum);
 	     if (Lang_Break_Condition) goto handle_break_condition;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_RETINTR:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_RETINTR):
 	     (*addr->b.call_function) ();
 	     addr++;
-	     /* fall through */
-	   case SLANG_BC_RET_INTRINSIC:
+	     BC_FALLTHROUGH;
+	   BC_CASE(SLANG_BC_RET_INTRINSIC):
 	     EXECUTE_INTRINSIC (addr)
 	     if (0 == Handle_Interrupt)
 	       return 1;
 	     if (IS_SLANG_ERROR)
 	       do_traceback(addr->b.nt_ifun_blk->name);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_EARG_LVAR:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_EARG_LVAR):
 	     (*addr->b.call_function) ();
 	     addr++;
 	     PUSH_LOCAL_VARIABLE (addr->b.i_blk)
 	     (void) end_arg_list ();
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_LINT:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_LINT):
 	     (*addr->b.call_function) ();
 	     addr++;
 	     push_int_object (addr->bc_sub_type, (int) addr->b.l_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_CALL_DIRECT_LVAR:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_LVAR):
 	     (*addr->b.call_function) ();
 	     addr++;
 	     PUSH_LOCAL_VARIABLE (addr->b.i_blk)
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LLVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_LLVARIABLE_BINARY):
 	       {
 		  SLang_Object_Type *obj1 = Local_Variable_Frame - (addr+1)->b.i_blk;
 		  SLang_Object_Type *obj2 = Local_Variable_Frame - (addr+2)->b.i_blk;
@@ -6147,29 +7318,29 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  else do_binary_ab_inc_ref (addr->b.i_blk, obj1, obj2);
 		  addr += 2;
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LGVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_LGVARIABLE_BINARY):
 	     do_binary_ab_inc_ref (addr->b.i_blk,
 			   Local_Variable_Frame - (addr+1)->b.i_blk,
 			   &(addr+2)->b.nt_gvar_blk->obj);
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_GLVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_GLVARIABLE_BINARY):
 	     do_binary_ab_inc_ref (addr->b.i_blk,
 			   &(addr+1)->b.nt_gvar_blk->obj,
 			   Local_Variable_Frame - (addr+2)->b.i_blk);
 	     addr += 2;
-	     break;
-	   case SLANG_BC_GGVARIABLE_BINARY:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_GGVARIABLE_BINARY):
 	     do_binary_ab_inc_ref (addr->b.i_blk,
 			   &(addr+1)->b.nt_gvar_blk->obj,
 			   &(addr+2)->b.nt_gvar_blk->obj);
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LIVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_LIVARIABLE_BINARY):
 	       {
 		  SLang_Object_Type o, *obj1;
 		  o.o_data_type = SLANG_INT_TYPE;
@@ -6181,9 +7352,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		    do_binary_ab_inc_ref (addr->b.i_blk, obj1, &o);
 	       }
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 # if SLANG_HAS_FLOAT
-	   case SLANG_BC_LDVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_LDVARIABLE_BINARY):
 	       {
 		  SLang_Object_Type o, *obj1;
 		  o.o_data_type = SLANG_DOUBLE_TYPE;
@@ -6195,9 +7366,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		    do_binary_ab_inc_ref (addr->b.i_blk, obj1, &o);
 	       }
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 # endif
-	   case SLANG_BC_ILVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_ILVARIABLE_BINARY):
 	       {
 		  SLang_Object_Type o, *obj1;
 		  o.o_data_type = SLANG_INT_TYPE;
@@ -6209,9 +7380,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		    (void) do_binary_ab_inc_ref (addr->b.i_blk, &o, obj1);
 	       }
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 # if SLANG_HAS_FLOAT
-	   case SLANG_BC_DLVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_DLVARIABLE_BINARY):
 	       {
 		  SLang_Object_Type o, *obj1;
 		  o.o_data_type = SLANG_DOUBLE_TYPE;
@@ -6224,21 +7395,21 @@ static int inner_interp (SLBlock_Type *addr_start)
 
 	       }
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 # endif
-	   case SLANG_BC_LVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_LVARIABLE_BINARY):
 	     do_binary_b_inc_ref (addr->b.i_blk,
 			  Local_Variable_Frame - (addr+1)->b.i_blk);
 	     addr++;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_GVARIABLE_BINARY:
+	   BC_CASE(SLANG_BC_GVARIABLE_BINARY):
 	     do_binary_b_inc_ref (addr->b.i_blk,
 			  &(addr+1)->b.nt_gvar_blk->obj);
 	     addr++;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LITERAL_INT_BINARY:
+	   BC_CASE(SLANG_BC_LITERAL_INT_BINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_INT_TYPE;
@@ -6246,9 +7417,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  (void) do_binary_b (addr->b.i_blk, &o);
 	       }
 	     addr++;
-	     break;
+	     BC_NEXT;
 # if SLANG_HAS_FLOAT
-	   case SLANG_BC_LITERAL_DBL_BINARY:
+	   BC_CASE(SLANG_BC_LITERAL_DBL_BINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_DOUBLE_TYPE;
@@ -6256,17 +7427,17 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  (void) do_binary_b (addr->b.i_blk, &o);
 	       }
 	     addr++;
-	     break;
+	     BC_NEXT;
 # endif
-	   case SLANG_BC_LASSIGN_LLBINARY:
+	   BC_CASE(SLANG_BC_LASSIGN_LLBINARY):
 	     (void) do_binary_ab_inc_ref_assign ((addr+1)->b.i_blk,
 						 Local_Variable_Frame - (addr+2)->b.i_blk,
 						 Local_Variable_Frame - (addr+3)->b.i_blk,
 						 Local_Variable_Frame - addr->b.i_blk);
 	     addr += 3;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LASSIGN_LIBINARY:
+	   BC_CASE(SLANG_BC_LASSIGN_LIBINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_INT_TYPE;
@@ -6278,8 +7449,8 @@ static int inner_interp (SLBlock_Type *addr_start)
 						      Local_Variable_Frame - addr->b.i_blk);
 	       }
 	     addr += 3;
-	     break;
-	   case SLANG_BC_LASSIGN_ILBINARY:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_LASSIGN_ILBINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_INT_TYPE;
@@ -6291,9 +7462,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 						      Local_Variable_Frame - addr->b.i_blk);
 	       }
 	     addr += 3;
-	     break;
+	     BC_NEXT;
 # if SLANG_HAS_FLOAT
-	   case SLANG_BC_LASSIGN_LDBINARY:
+	   BC_CASE(SLANG_BC_LASSIGN_LDBINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_DOUBLE_TYPE;
@@ -6305,8 +7476,8 @@ static int inner_interp (SLBlock_Type *addr_start)
 						      Local_Variable_Frame - addr->b.i_blk);
 	       }
 	     addr += 3;
-	     break;
-	   case SLANG_BC_LASSIGN_DLBINARY:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_LASSIGN_DLBINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_DOUBLE_TYPE;
@@ -6318,21 +7489,21 @@ static int inner_interp (SLBlock_Type *addr_start)
 						      Local_Variable_Frame - addr->b.i_blk);
 	       }
 	     addr += 3;
-	     break;
+	     BC_NEXT;
 # endif
-	   case SLANG_BC_RET_LVARIABLE:
+	   BC_CASE(SLANG_BC_RET_LVARIABLE):
 	     if (0 != push_local_variable (addr->b.i_blk))
-	       break;
+	       BC_NEXT;
 	     Lang_Break_Condition = Lang_Return = Lang_Break = 1;
 	     goto return_1;
 
-	   case SLANG_BC_RET_LITERAL_INT:
+	   BC_CASE(SLANG_BC_RET_LITERAL_INT):
 	     if (-1 == push_int_object (addr->bc_sub_type, (int) addr->b.l_blk))
-	       break;
+	       BC_NEXT;
 	     Lang_Break_Condition = Lang_Return = Lang_Break = 1;
 	     goto return_1;
 
-	   case SLANG_BC_MANY_LVARIABLE:
+	   BC_CASE(SLANG_BC_MANY_LVARIABLE):
 	     (void) push_local_variable (addr->b.i_blk);
 	     addr++;
 	     (void) push_local_variable (addr->b.i_blk);
@@ -6343,9 +7514,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  addr++;
 	       }
 	     addr--;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_MANY_LVARIABLE_DIR:
+	   BC_CASE(SLANG_BC_MANY_LVARIABLE_DIR):
 	     (void) push_local_variable (addr->b.i_blk);
 	     addr++;
 	     (void) push_local_variable (addr->b.i_blk);
@@ -6356,9 +7527,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  addr++;
 	       }
 	     (*addr->b.call_function) ();
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVARIABLE_AGET1:
+	   BC_CASE(SLANG_BC_LVARIABLE_AGET1):
 	       {
 		  SLang_Object_Type *o;
 
@@ -6368,29 +7539,29 @@ static int inner_interp (SLBlock_Type *addr_start)
 		    {
 		       addr++;
 		       (void) push_array_element (addr->b.i_blk, o->v.int_val);
-		       break;
+		       BC_NEXT;
 		    }
 		  if (-1 == push_local_variable (addr->b.i_blk))
-		    break;
+		    BC_NEXT;
 		  addr++;
 		  if (-1 == push_local_variable (addr->b.i_blk))
-		    break;
+		    BC_NEXT;
 		  (void) _pSLarray_aget1 (1);
-		  break;
+		  BC_NEXT;
 	       }
 
-	   case SLANG_BC_LITERAL_AGET1:
+	   BC_CASE(SLANG_BC_LITERAL_AGET1):
 	     addr++;		       /* not used */
 	     push_array_element ((addr+1)->b.i_blk, (int) addr->b.l_blk);
 	     addr++;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_LVAR_APUT1:
+	   BC_CASE(SLANG_BC_LVAR_LVAR_APUT1):
 	     if (-1 == push_local_variable (addr->b.i_blk))
-	       break;
+	       BC_NEXT;
 	     addr++;
-	     /* fall through */
-	   case SLANG_BC_LVARIABLE_APUT1:
+	     BC_FALLTHROUGH;
+	   BC_CASE(SLANG_BC_LVARIABLE_APUT1):
 	       {
 		  SLang_Object_Type *o;
 
@@ -6400,23 +7571,23 @@ static int inner_interp (SLBlock_Type *addr_start)
 		    {
 		       addr++;
 		       (void) pop_to_lvar_array_element (addr->b.i_blk, o->v.int_val);
-		       break;
+		       BC_NEXT;
 		    }
 		  if (-1 == push_local_variable (addr->b.i_blk))
-		    break;
+		    BC_NEXT;
 		  addr++;
 		  if (-1 == push_local_variable (addr->b.i_blk))
-		    break;
+		    BC_NEXT;
 		  (void) _pSLarray_aput1 (1);
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LITERAL_APUT1:
+	   BC_CASE(SLANG_BC_LITERAL_APUT1):
 	     (void) pop_to_lvar_array_element ((addr+2)->b.i_blk, (SLindex_Type)((addr+1)->b.l_blk));
 	     addr += 2;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LLVARIABLE_BINARY2:
+	   BC_CASE(SLANG_BC_LLVARIABLE_BINARY2):
 	       {
 		  SLang_Object_Type *obj1 = Local_Variable_Frame - (addr+1)->b.i_blk;
 		  SLang_Object_Type *obj2 = Local_Variable_Frame - (addr+2)->b.i_blk;
@@ -6427,74 +7598,84 @@ static int inner_interp (SLBlock_Type *addr_start)
 		       if (obj1->o_data_type == SLANG_INT_TYPE)
 			 {
 			    if (-1 == int_int_binary_result (addr->b.i_blk, obj1, obj2, &obj3))
-			      break;
+			      BC_NEXT;
 			    addr += 3;
 			    (void) do_binary_b (addr->b.i_blk, &obj3);
-			    break;
+			    BC_NEXT;
 			 }
 # if SLANG_HAS_FLOAT
 		       else if (obj1->o_data_type == SLANG_DOUBLE_TYPE)
 			 {
 			    if (-1 == dbl_dbl_binary_result (addr->b.i_blk, obj1, obj2, &obj3))
-			      break;
+			      BC_NEXT;
 			    addr += 3;
 			    (void) do_binary_b (addr->b.i_blk, &obj3);
-			    break;
+			    BC_NEXT;
 			 }
 # endif
 		    }
 
 		  obj3.o_data_type = SLANG_UNDEFINED_TYPE;
 		  if (-1 == do_binary_ab_inc_ref_assign (addr->b.i_blk, obj1, obj2, &obj3))
-		    break;
+		    BC_NEXT;
 		  addr += 3;
 		  (void) do_binary_b (addr->b.i_blk, &obj3);
 		  SLang_free_object (&obj3);
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_SET_LOCLV_LIT_INT:
+	   BC_CASE(SLANG_BC_SET_LOCLV_LIT_INT):
 	     set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk);
 	     addr++;
 	     push_int_object (addr->bc_sub_type, (int) addr->b.l_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_SET_LOCLV_LIT_AGET1:
+	   BC_CASE(SLANG_BC_SET_LOCLV_LIT_AGET1):
 	     set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk);
 	     addr += 3;
 	     push_array_element (addr->b.i_blk, (int) (addr-1)->b.l_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_SET_LOCLV_LVAR:
+	   BC_CASE(SLANG_BC_SET_LOCLV_LVAR):
 	     set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk);
 	     addr++;
 	     PUSH_LOCAL_VARIABLE (addr->b.i_blk)
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_SET_LOCLV_LASTBLOCK:
+	   BC_CASE(SLANG_BC_SET_LOCLV_LASTBLOCK):
 	     if (0 == set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk))
 	       goto return_1;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_EARG_LVAR:
+	   BC_CASE(SLANG_BC_LVAR_EARG_LVAR):
 	     PUSH_LOCAL_VARIABLE (addr->b.i_blk);
 	     addr++;
 	     PUSH_LOCAL_VARIABLE(addr->b.i_blk);
 	     (void) end_arg_list ();
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_FIELD:
-	     PUSH_LOCAL_VARIABLE (addr->b.i_blk);
-	     addr++;
-	     (void) push_struct_field (addr->b.s_blk);
-	     break;
+	   BC_CASE(SLANG_BC_LVAR_FIELD):
+	       {
+		  SLang_Object_Type *obj = Local_Variable_Frame - addr->b.i_blk;
+		  addr++;
+		  /* Avoid pushing and popping the struct */
+		  if (obj->o_data_type == SLANG_STRUCT_TYPE)
+		    {
+		       (void) _pSLstruct_push_field_cached (obj->v.struct_val, addr->b.s_blk,
+							    &addr->bc_sub_type, 0);
+		       BC_NEXT;
+		    }
+		  if (0 == carefully_push_object (obj))
+		    (void) push_struct_field (addr->b.s_blk, &addr->bc_sub_type);
+	       }
+	     BC_NEXT;
 
-	   case SLANG_BC_BINARY_LASTBLOCK:
-	     if (-1 == do_binary (addr->b.i_blk))
-	       break;
+	   BC_CASE(SLANG_BC_BINARY_LASTBLOCK):
+	     if (-1 == do_binary_site (addr))
+	       BC_NEXT;
 	     goto return_1;
 
-	   case SLANG_BC_EARG_LVARIABLE_INTRINSIC:
+	   BC_CASE(SLANG_BC_EARG_LVARIABLE_INTRINSIC):
 	     PUSH_LOCAL_VARIABLE(addr->b.i_blk);
 	     if (0 == end_arg_list ())
 	       {
@@ -6503,22 +7684,22 @@ static int inner_interp (SLBlock_Type *addr_start)
 		  if (IS_SLANG_ERROR)
 		    do_traceback(addr->b.nt_ifun_blk->name);
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_LITERAL_INT:
+	   BC_CASE(SLANG_BC_LVAR_LITERAL_INT):
 	     PUSH_LOCAL_VARIABLE (addr->b.i_blk);
 	     addr++;
 	     push_int_object (addr->bc_sub_type, (int) addr->b.l_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_BINARY_SET_LOCLVAL:
-	     if (-1 == do_binary (addr->b.i_blk))
-	       break;
+	   BC_CASE(SLANG_BC_BINARY_SET_LOCLVAL):
+	     if (-1 == do_binary_site (addr))
+	       BC_NEXT;
 	     addr++;
 	     (void) set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_AGET_SET_LOCLVAL:
+	   BC_CASE(SLANG_BC_LVAR_AGET_SET_LOCLVAL):
 	       {
 		  SLang_Object_Type *obj = Local_Variable_Frame - addr->b.i_blk;
 		  if ((0 == carefully_push_object (obj))
@@ -6528,9 +7709,9 @@ static int inner_interp (SLBlock_Type *addr_start)
 		       (void) set_lvalue_obj (addr->bc_sub_type, Local_Variable_Frame - addr->b.i_blk);
 		    }
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LLVAR_BINARY_IF:
+	   BC_CASE(SLANG_BC_LLVAR_BINARY_IF):
 	       {
 		  SLang_Object_Type *obj1 = Local_Variable_Frame - (addr+1)->b.i_blk;
 		  SLang_Object_Type *obj2 = Local_Variable_Frame - (addr+2)->b.i_blk;
@@ -6541,53 +7722,53 @@ static int inner_interp (SLBlock_Type *addr_start)
 		       if (obj1->o_data_type == SLANG_INT_TYPE)
 			 {
 			    if (-1 == int_int_binary_result (addr->b.i_blk, obj1, obj2, &obj3))
-			      break;
+			      BC_NEXT;
 			 }
 # if SLANG_HAS_FLOAT
 		       else if (obj1->o_data_type == SLANG_DOUBLE_TYPE)
 			 {
 			    if (-1 == dbl_dbl_binary_result (addr->b.i_blk, obj1, obj2, &obj3))
-			      break;
+			      BC_NEXT;
 			 }
 # endif
 		       else
 			 {
 			    obj3.o_data_type = SLANG_UNDEFINED_TYPE;
 			    if (-1 == do_binary_ab_inc_ref_assign (addr->b.i_blk, obj1, obj2, &obj3))
-			      break;
+			      BC_NEXT;
 			 }
 		    }
 		  else
 		    {
 		       obj3.o_data_type = SLANG_UNDEFINED_TYPE;
 		       if (-1 == do_binary_ab_inc_ref_assign (addr->b.i_blk, obj1, obj2, &obj3))
-			 break;
+			 BC_NEXT;
 		    }
 		  addr += 3;
 		  if (obj3.o_data_type == SLANG_CHAR_TYPE)
 		    {
 		       if (obj3.v.char_val)
 			 goto execute_BC_IF_BLOCK;
-		       break;
+		       BC_NEXT;
 		    }
 		  if (obj3.o_data_type == SLANG_INT_TYPE)
 		    {
 		       if (obj3.v.int_val)
 			 goto execute_BC_IF_BLOCK;
-		       break;
+		       BC_NEXT;
 		    }
 
 		  /* Otherwise let pop_ctrl_integer do the dirty work */
 		  if (-1 == push_object (&obj3))
-		    break;
+		    BC_NEXT;
 	       }
-	     /* fall through */
-	   case SLANG_BC_IF_BLOCK:
+	     BC_FALLTHROUGH;
+	   BC_CASE(SLANG_BC_IF_BLOCK):
 	       {
 		  int i;
 
 		  if ((-1 == pop_ctrl_integer (&i)) || (i == 0))
-		    break;
+		    BC_NEXT;
 	       }
 
 execute_BC_IF_BLOCK:
@@ -6601,36 +7782,36 @@ execute_BC_IF_BLOCK:
 		  if (addr1->bc_main_type == SLANG_BC_RET_LVARIABLE)
 		    {
 		       if (0 != push_local_variable (addr1->b.i_blk))
-			 break;
+			 BC_NEXT;
 		       Lang_Break_Condition = Lang_Return = Lang_Break = 1;
 		       goto return_1;
 		    }
 		  inner_interp (addr1);
 		  if (Lang_Break_Condition) goto handle_break_condition;
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_SET_FIELD:
+	   BC_CASE(SLANG_BC_LVAR_SET_FIELD):
 	     (void) set_struct_obj_lvalue (addr+1, Local_Variable_Frame - addr->b.i_blk, 0);
 	     addr++;
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_PVAR_SET_GLOB_LVAL:
+	   BC_CASE(SLANG_BC_PVAR_SET_GLOB_LVAL):
 	     addr++;
 	     if (-1 == set_lvalue_obj_with_obj (addr->bc_sub_type,
 						&addr->b.nt_gvar_blk->obj,
 						&(addr-1)->b.nt_gvar_blk->obj))
 	       do_name_type_error (addr->b.nt_blk);
-	     break;
-	   case SLANG_BC_LVAR_SET_GLOB_LVAL:
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_LVAR_SET_GLOB_LVAL):
 	     addr++;
 	     if (-1 == set_lvalue_obj_with_obj (addr->bc_sub_type,
 						&addr->b.nt_gvar_blk->obj,
 						Local_Variable_Frame - (addr-1)->b.i_blk))
 	       do_name_type_error (addr->b.nt_blk);
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LIT_AGET1_INT_BINARY:
+	   BC_CASE(SLANG_BC_LIT_AGET1_INT_BINARY):
 	       {
 		  SLang_Object_Type o;
 		  o.o_data_type = SLANG_INT_TYPE;
@@ -6639,159 +7820,130 @@ execute_BC_IF_BLOCK:
 						 (addr+3)->b.i_blk, &o);
 	       }
 	     addr += 4;
-	     break;
-	   case SLANG_BC_BINARY2:
-	     if (0 == do_binary (addr->b.i_blk))
+	     BC_NEXT;
+	   BC_CASE(SLANG_BC_BINARY2):
+	     if (0 == do_binary_site (addr))
 	       {
 		  addr++;
-		  (void) do_binary (addr->b.i_blk);
+		  (void) do_binary_site (addr);
 	       }
-	     break;
+	     BC_NEXT;
 
-	   case SLANG_BC_LVAR_LIT_AGET1:
+	   BC_CASE(SLANG_BC_LVAR_LIT_AGET1):
 	     PUSH_LOCAL_VARIABLE(addr->b.i_blk);
 	     (void) push_array_element ((addr+3)->b.i_blk, (int)((addr+2)->b.l_blk));
 	     addr += 3;
-	     break;
+	     BC_NEXT;
+
+# if USE_SUPER_BYTECODES
+	     /* If the first bytecode of a superinstruction generates an
+	      * error, the error is handled as it would be after that bytecode
+	      * by itself.  If an ERROR_BLOCK clears it, the second bytecode
+	      * is executed.
+	      */
+#  define SUPER_BC(s,x,y) \
+	   BC_CASE(s): \
+	     DO_BC_##x \
+	     IF_UNLIKELY(IS_SLANG_ERROR) \
+	       { \
+		  if (-1 == do_inner_interp_error (err_block, addr_start, addr)) \
+		    return 1; \
+		  if (SLang_get_error ()) \
+		    return 1; \
+		  if (Lang_Break_Condition) goto handle_break_condition; \
+	       } \
+	     addr++; \
+	     DO_BC_##y \
+	     BC_NEXT;
+#  define UNUSED_SUPER_BC(s)
+#  include "slsuperbc.inc"
+#  undef SUPER_BC
+#  undef UNUSED_SUPER_BC
+# endif
 #endif				       /* USE_COMBINED_BYTECODES */
 
 #if USE_UNUSED_BYCODES_IN_SWITCH
 # if !USE_COMBINED_BYTECODES
-	   case SLANG_BC_CALL_DIRECT_INTRINSIC:
-	   case SLANG_BC_INTRINSIC_CALL_DIRECT:
-	   case SLANG_BC_CALL_DIRECT_LSTR:
-	   case SLANG_BC_CALL_DIRECT_SLFUN:
-	   case SLANG_BC_CALL_DIRECT_RETINTR:
-	   case SLANG_BC_RET_INTRINSIC:
-	   case SLANG_BC_CALL_DIRECT_EARG_LVAR:
-	   case SLANG_BC_CALL_DIRECT_LINT:
-	   case SLANG_BC_CALL_DIRECT_LVAR:
-	   case SLANG_BC_LLVARIABLE_BINARY:
-	   case SLANG_BC_LGVARIABLE_BINARY:
-	   case SLANG_BC_GLVARIABLE_BINARY:
-	   case SLANG_BC_GGVARIABLE_BINARY:
-	   case SLANG_BC_LIVARIABLE_BINARY:
-	   case SLANG_BC_LDVARIABLE_BINARY:
-	   case SLANG_BC_ILVARIABLE_BINARY:
-	   case SLANG_BC_DLVARIABLE_BINARY:
-	   case SLANG_BC_LVARIABLE_BINARY:
-	   case SLANG_BC_GVARIABLE_BINARY:
-	   case SLANG_BC_LITERAL_INT_BINARY:
-	   case SLANG_BC_LITERAL_DBL_BINARY:
-	   case SLANG_BC_LASSIGN_LLBINARY:
-	   case SLANG_BC_LASSIGN_LIBINARY:
-	   case SLANG_BC_LASSIGN_ILBINARY:
-	   case SLANG_BC_LASSIGN_LDBINARY:
-	   case SLANG_BC_LASSIGN_DLBINARY:
-	   case SLANG_BC_RET_LVARIABLE:
-	   case SLANG_BC_RET_LITERAL_INT:
-	   case SLANG_BC_MANY_LVARIABLE:
-	   case SLANG_BC_MANY_LVARIABLE_DIR:
-	   case SLANG_BC_LVARIABLE_AGET1:
-	   case SLANG_BC_LITERAL_AGET1:
-	   case SLANG_BC_LVAR_LVAR_APUT1:
-	   case SLANG_BC_LVARIABLE_APUT1:
-	   case SLANG_BC_LITERAL_APUT1:
-	   case SLANG_BC_LLVARIABLE_BINARY2:
-	   case SLANG_BC_SET_LOCLV_LIT_INT:
-	   case SLANG_BC_SET_LOCLV_LIT_AGET1:
-	   case SLANG_BC_SET_LOCLV_LVAR:
-	   case SLANG_BC_SET_LOCLV_LASTBLOCK:
-	   case SLANG_BC_LVAR_EARG_LVAR:
-	   case SLANG_BC_LVAR_FIELD:
-	   case SLANG_BC_BINARY_LASTBLOCK:
-	   case SLANG_BC_EARG_LVARIABLE_INTRINSIC:
-	   case SLANG_BC_LVAR_LITERAL_INT:
-	   case SLANG_BC_BINARY_SET_LOCLVAL:
-	   case SLANG_BC_LVAR_AGET_SET_LOCLVAL:
-	   case SLANG_BC_LLVAR_BINARY_IF:
-	   case SLANG_BC_IF_BLOCK:
-	   case SLANG_BC_LVAR_SET_FIELD:
-	   case SLANG_BC_PVAR_SET_GLOB_LVAL:
-	   case SLANG_BC_LVAR_SET_GLOB_LVAL:
-	   case SLANG_BC_LIT_AGET1_INT_BINARY:
-	   case SLANG_BC_BINARY2:
-	   case SLANG_BC_LVAR_LIT_AGET1:
+	   BC_CASE(SLANG_BC_CALL_DIRECT_INTRINSIC):
+	   BC_CASE(SLANG_BC_INTRINSIC_CALL_DIRECT):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_LSTR):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_SLFUN):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_RETINTR):
+	   BC_CASE(SLANG_BC_RET_INTRINSIC):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_EARG_LVAR):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_LINT):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_LVAR):
+	   BC_CASE(SLANG_BC_LLVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_LGVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_GLVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_GGVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_LIVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_LDVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_ILVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_DLVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_LVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_GVARIABLE_BINARY):
+	   BC_CASE(SLANG_BC_LITERAL_INT_BINARY):
+	   BC_CASE(SLANG_BC_LITERAL_DBL_BINARY):
+	   BC_CASE(SLANG_BC_LASSIGN_LLBINARY):
+	   BC_CASE(SLANG_BC_LASSIGN_LIBINARY):
+	   BC_CASE(SLANG_BC_LASSIGN_ILBINARY):
+	   BC_CASE(SLANG_BC_LASSIGN_LDBINARY):
+	   BC_CASE(SLANG_BC_LASSIGN_DLBINARY):
+	   BC_CASE(SLANG_BC_RET_LVARIABLE):
+	   BC_CASE(SLANG_BC_RET_LITERAL_INT):
+	   BC_CASE(SLANG_BC_MANY_LVARIABLE):
+	   BC_CASE(SLANG_BC_MANY_LVARIABLE_DIR):
+	   BC_CASE(SLANG_BC_LVARIABLE_AGET1):
+	   BC_CASE(SLANG_BC_LITERAL_AGET1):
+	   BC_CASE(SLANG_BC_LVAR_LVAR_APUT1):
+	   BC_CASE(SLANG_BC_LVARIABLE_APUT1):
+	   BC_CASE(SLANG_BC_LITERAL_APUT1):
+	   BC_CASE(SLANG_BC_LLVARIABLE_BINARY2):
+	   BC_CASE(SLANG_BC_SET_LOCLV_LIT_INT):
+	   BC_CASE(SLANG_BC_SET_LOCLV_LIT_AGET1):
+	   BC_CASE(SLANG_BC_SET_LOCLV_LVAR):
+	   BC_CASE(SLANG_BC_SET_LOCLV_LASTBLOCK):
+	   BC_CASE(SLANG_BC_LVAR_EARG_LVAR):
+	   BC_CASE(SLANG_BC_LVAR_FIELD):
+	   BC_CASE(SLANG_BC_BINARY_LASTBLOCK):
+	   BC_CASE(SLANG_BC_EARG_LVARIABLE_INTRINSIC):
+	   BC_CASE(SLANG_BC_LVAR_LITERAL_INT):
+	   BC_CASE(SLANG_BC_BINARY_SET_LOCLVAL):
+	   BC_CASE(SLANG_BC_LVAR_AGET_SET_LOCLVAL):
+	   BC_CASE(SLANG_BC_LLVAR_BINARY_IF):
+	   BC_CASE(SLANG_BC_IF_BLOCK):
+	   BC_CASE(SLANG_BC_LVAR_SET_FIELD):
+	   BC_CASE(SLANG_BC_PVAR_SET_GLOB_LVAL):
+	   BC_CASE(SLANG_BC_LVAR_SET_GLOB_LVAL):
+	   BC_CASE(SLANG_BC_LIT_AGET1_INT_BINARY):
+	   BC_CASE(SLANG_BC_BINARY2):
+	   BC_CASE(SLANG_BC_LVAR_LIT_AGET1):
 # endif
-	   case SLANG_BC_UNUSED_0xB7:
-	   case SLANG_BC_UNUSED_0xB8:
-	   case SLANG_BC_UNUSED_0xB9:
-	   case SLANG_BC_UNUSED_0xBA:
-	   case SLANG_BC_UNUSED_0xBB:
-	   case SLANG_BC_UNUSED_0xBC:
-	   case SLANG_BC_UNUSED_0xBD:
-	   case SLANG_BC_UNUSED_0xBE:
-	   case SLANG_BC_UNUSED_0xBF:
-	   case SLANG_BC_LVARIABLE_COMBINED:
-	   case SLANG_BC_GVARIABLE_COMBINED:
-	   case SLANG_BC_LITERAL_COMBINED:
-	   case SLANG_BC_CALL_DIRECT_COMB:
-	   case SLANG_BC_COMBINED:
-	   case SLANG_BC_BLOCK_COMBINED:
-	   case SLANG_BC_UNUSED_0xC6:
-	   case SLANG_BC_UNUSED_0xC7:
-	   case SLANG_BC_UNUSED_0xC8:
-	   case SLANG_BC_UNUSED_0xC9:
-	   case SLANG_BC_UNUSED_0xCA:
-	   case SLANG_BC_UNUSED_0xCB:
-	   case SLANG_BC_UNUSED_0xCC:
-	   case SLANG_BC_UNUSED_0xCD:
-	   case SLANG_BC_UNUSED_0xCE:
-	   case SLANG_BC_UNUSED_0xCF:
-	   case SLANG_BC_UNUSED_0xD0:
-	   case SLANG_BC_UNUSED_0xD1:
-	   case SLANG_BC_UNUSED_0xD2:
-	   case SLANG_BC_UNUSED_0xD3:
-	   case SLANG_BC_UNUSED_0xD4:
-	   case SLANG_BC_UNUSED_0xD5:
-	   case SLANG_BC_UNUSED_0xD6:
-	   case SLANG_BC_UNUSED_0xD7:
-	   case SLANG_BC_UNUSED_0xD8:
-	   case SLANG_BC_UNUSED_0xD9:
-	   case SLANG_BC_UNUSED_0xDA:
-	   case SLANG_BC_UNUSED_0xDB:
-	   case SLANG_BC_UNUSED_0xDC:
-	   case SLANG_BC_UNUSED_0xDD:
-	   case SLANG_BC_UNUSED_0xDE:
-	   case SLANG_BC_UNUSED_0xDF:
-	   case SLANG_BC_UNUSED_0xE0:
-	   case SLANG_BC_UNUSED_0xE1:
-	   case SLANG_BC_UNUSED_0xE2:
-	   case SLANG_BC_UNUSED_0xE3:
-	   case SLANG_BC_UNUSED_0xE4:
-	   case SLANG_BC_UNUSED_0xE5:
-	   case SLANG_BC_UNUSED_0xE6:
-	   case SLANG_BC_UNUSED_0xE7:
-	   case SLANG_BC_UNUSED_0xE8:
-	   case SLANG_BC_UNUSED_0xE9:
-	   case SLANG_BC_UNUSED_0xEA:
-	   case SLANG_BC_UNUSED_0xEB:
-	   case SLANG_BC_UNUSED_0xEC:
-	   case SLANG_BC_UNUSED_0xED:
-	   case SLANG_BC_UNUSED_0xEE:
-	   case SLANG_BC_UNUSED_0xEF:
-	   case SLANG_BC_UNUSED_0xF0:
-	   case SLANG_BC_UNUSED_0xF1:
-	   case SLANG_BC_UNUSED_0xF2:
-	   case SLANG_BC_UNUSED_0xF3:
-	   case SLANG_BC_UNUSED_0xF4:
-	   case SLANG_BC_UNUSED_0xF5:
-	   case SLANG_BC_UNUSED_0xF6:
-	   case SLANG_BC_UNUSED_0xF7:
-	   case SLANG_BC_UNUSED_0xF8:
-	   case SLANG_BC_UNUSED_0xF9:
-	   case SLANG_BC_UNUSED_0xFA:
-	   case SLANG_BC_UNUSED_0xFB:
-	   case SLANG_BC_UNUSED_0xFC:
-	   case SLANG_BC_UNUSED_0xFD:
-	   case SLANG_BC_UNUSED_0xFE:
-	   case SLANG_BC_UNUSED_0xFF:
+	   BC_CASE(SLANG_BC_LVARIABLE_COMBINED):
+	   BC_CASE(SLANG_BC_GVARIABLE_COMBINED):
+	   BC_CASE(SLANG_BC_LITERAL_COMBINED):
+	   BC_CASE(SLANG_BC_CALL_DIRECT_COMB):
+	   BC_CASE(SLANG_BC_COMBINED):
+	   BC_CASE(SLANG_BC_BLOCK_COMBINED):
+# if USE_SUPER_BYTECODES
+#  define SUPER_BC(s,x,y)
+# else
+#  define SUPER_BC(s,x,y) BC_CASE(s):
+# endif
+# define UNUSED_SUPER_BC(s) BC_CASE(s):
+# include "slsuperbc.inc"
+# undef SUPER_BC
+# undef UNUSED_SUPER_BC
 #else
 	   default:
 #endif
 	     _pSLang_verror (SL_INTERNAL_ERROR, "Byte-Code 0x%X is not valid", addr->bc_main_type);
 	  }
 
+#if USE_COMPUTED_GOTO_DISPATCH
+check_interrupt:
+#endif
 	IF_UNLIKELY(Handle_Interrupt != 0)
 	  {
 	     if (SLang_get_error ())
@@ -6803,6 +7955,8 @@ execute_BC_IF_BLOCK:
 		  /* Otherwise, error cleared.  Continue onto next bytecode */
 	       }
 #if SLANG_HAS_SIGNALS
+	     if (Handle_Interrupt & INTERRUPT_PROFILE)
+	       take_profile_sample (addr);
 	     (void) check_signals ();
 #endif
 	     if (Lang_Break_Condition) goto handle_break_condition;
@@ -6842,8 +7996,18 @@ return_0:
 int _pSLang_Auto_Declare_Globals = 0;
 int (*SLang_Auto_Declare_Var_Hook) (SLFUTURE_CONST char *);
 
+/* If non-zero, the body of a function is not compiled until the function
+ * is first called.  Until then, only its tokens are kept.
+ */
+int _pSLang_Lazy_Compile = 0;
+static _pSLang_Lazy_Body_Type *Lazy_Function_Body;
+
 static int Local_Variable_Number;
 static unsigned int Function_Args_Number;
+/* Non-zero if the function being compiled may not make tail calls.  See
+ * remove_tail_calls.
+ */
+static int Function_Tail_Calls_Disabled;
 
 static int Lang_Defining_Function;
 static void (*Default_Variable_Mode) (_pSLang_Token_Type *);
@@ -6876,7 +8040,46 @@ static SLBlock_Type *This_Compile_Block_Max;
 #define COMPILE_BLOCK_TYPE_TOP_LEVEL	3
 static int This_Compile_Block_Type = COMPILE_BLOCK_TYPE_NONE;
 
+/* If non-NULL, the compiled code is being recorded in a bytecode image.
+ * See the section on bytecode images below.
+ */
+typedef struct _Image_Writer_Type Image_Writer_Type;
+static Image_Writer_Type *Image_Writer;
+static Image_Writer_Type *Finished_Image_Writer;
+static int Image_Requested;
+static Image_Writer_Type *allocate_image_writer (void);
+static void free_image_writer (Image_Writer_Type *);
+static void record_image_variable (SLCONST char *, unsigned char, SLang_NameSpace_Type *);
+static int add_global_variable (SLCONST char *, char, unsigned long, SLang_NameSpace_Type *);
+static int add_local_variable (SLCONST char *, unsigned long);
+static void record_image_execute (SLBlock_Type *);
+static void optimize_nested_blocks (SLBlock_Type *);
+
 /* If it returns 0, DO NOT FREE p */
+#if USE_SUPER_BYTECODES
+/* If b is a superinstruction, restore the pair of bytecodes that it
+ * replaced and return 0.  Otherwise return -1.
+ */
+static int split_super_bytecode (SLBlock_Type *b)
+{
+   switch (b->bc_main_type)
+     {
+#define SUPER_BC(s,x,y) \
+      case s: \
+	b->bc_main_type = SLANG_BC_##x; \
+	(b+1)->bc_main_type = SLANG_BC_##y; \
+	return 0;
+#define UNUSED_SUPER_BC(s)
+#include "slsuperbc.inc"
+#undef SUPER_BC
+#undef UNUSED_SUPER_BC
+      default:
+	break;
+     }
+   return -1;
+}
+#endif
+
 static int lang_free_branch (SLBlock_Type *p)
 {
    while (1)
@@ -6923,6 +8126,10 @@ static int lang_free_branch (SLBlock_Type *p)
 #endif
 	     break;
 	   default:
+#if USE_SUPER_BYTECODES
+	     if (0 == split_super_bytecode (p))
+	       continue;
+#endif
 	     break;
 
 	   case 0:
@@ -6959,6 +8166,8 @@ static void free_function_header (Function_Header_Type *h)
 	  SLfree ((char *) h->body);
      }
 
+   _pSLparse_free_lazy_body (h->lazy_body);
+
    if (h->file != NULL) SLang_free_slstring ((char *) h->file);
 
    if (h->local_variables != NULL)
@@ -6967,6 +8176,8 @@ static void free_function_header (Function_Header_Type *h)
    SLfree ((char *) h);
 }
 
+static unsigned long Last_Function_Id;
+
 static Function_Header_Type *
   allocate_function_header (unsigned int nargs, unsigned int nlocals, SLFUTURE_CONST char *file)
 {
@@ -6978,6 +8189,7 @@ static Function_Header_Type *
      return h;
 
    h->num_refs = 1;
+   h->id = ++Last_Function_Id;
    /* h->body = NULL; */		       /* body added later */
    h->nlocals = nlocals;
    h->nargs = nargs;
@@ -7104,6 +8316,9 @@ int _pSLcompile_push_context (SLang_Load_Type *load_object)
    char *ext;
    int status = -1;
    int free_name = 0;
+   int record_image = Image_Requested;
+
+   Image_Requested = 0;
 
    ext = SLpath_extname (name);
    if (((0 == strncmp (ext, ".slc", 4)) || (0 == strncmp (ext, ".SLC", 4)))
@@ -7136,6 +8351,8 @@ int _pSLcompile_push_context (SLang_Load_Type *load_object)
      }
 
    (void) _pSLerr_suspend_messages ();
+   if (record_image)
+     Image_Writer = allocate_image_writer ();
    status = 0;
    /* fall through */
 
@@ -7163,6 +8380,14 @@ int _pSLcompile_pop_context (void)
 	  }
      }
 
+   /* The image is picked up by _pSLcompile_end_image */
+   if (Image_Writer != NULL)
+     {
+	free_image_writer (Finished_Image_Writer);
+	Finished_Image_Writer = Image_Writer;
+	Image_Writer = NULL;
+     }
+
    (void) pop_block_context ();
    (void) pop_compile_context ();
 
@@ -7667,6 +8892,11 @@ static void lang_try_now(void)
 /* #endif */
    Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
 
+   if (Image_Writer != NULL)
+     record_image_execute (This_Compile_Block);
+   else
+     optimize_nested_blocks (This_Compile_Block);
+
    /* now do it */
    inner_interp (This_Compile_Block);
    (void) lang_free_branch (This_Compile_Block);
@@ -7683,6 +8913,11 @@ static void interp_pending_blocks (void)
    Compile_ByteCode_Ptr->linenum = (unsigned short) This_Compile_Linenum;
    Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
 
+   if (Image_Writer != NULL)
+     record_image_execute (This_Compile_Block);
+   else
+     optimize_nested_blocks (This_Compile_Block);
+
    inner_interp (This_Compile_Block);
    (void) lang_free_branch (This_Compile_Block);
    Compile_ByteCode_Ptr = This_Compile_Block;
@@ -7825,6 +9060,37 @@ SLang_Name_Type *SLang_get_function (SLFUTURE_CONST char *name)
    return NULL;
 }
 
+/* The id of a function identifies its current definition.  Since a forked
+ * process inherits the definitions of its parent, the id may be used there to
+ * find the definition, and to detect that it has been redefined since.
+ */
+unsigned long SLang_get_function_id (SLang_Name_Type *nt)
+{
+   Function_Header_Type *h;
+
+   if ((nt == NULL)
+       || ((nt->name_type != SLANG_FUNCTION) && (nt->name_type != SLANG_PFUNCTION)))
+     return 0;
+
+   if (NULL == (h = ((_pSLang_Function_Type *) nt)->header))
+     return 0;
+
+   return h->id;
+}
+
+static int function_has_id (SLang_Name_Type *nt, VOID_STAR cd)
+{
+   return (*(unsigned long *) cd == SLang_get_function_id (nt));
+}
+
+SLang_Name_Type *SLang_get_function_from_id (SLFUTURE_CONST char *name, unsigned long id)
+{
+   if ((name == NULL) || (id == 0))
+     return NULL;
+
+   return _pSLns_find_object (name, function_has_id, (VOID_STAR) &id);
+}
+
 static void lang_begin_function (void)
 {
    if (This_Compile_Block_Type != COMPILE_BLOCK_TYPE_TOP_LEVEL)
@@ -8458,15 +9724,1248 @@ static void optimize_block1 (SLBlock_Type *b)
      }
 }
 
-static void optimize_block (SLBlock_Type *b)
+#if USE_SUPER_BYTECODES
+static _pSLang_BC_Type find_super_bytecode (_pSLang_BC_Type x, _pSLang_BC_Type y)
 {
-   optimize_block1 (b);
-   optimize_block2 (b);
-   optimize_block3 (b);
-   optimize_block4 (b);
+#define SUPER_BC(s,a,b) \
+   if ((x == SLANG_BC_##a) && (y == SLANG_BC_##b)) return s;
+#define UNUSED_SUPER_BC(s)
+#include "slsuperbc.inc"
+#undef SUPER_BC
+#undef UNUSED_SUPER_BC
+   return SLANG_BC_LAST_BLOCK;
 }
 
-#endif
+/* Replace pairs of simple bytecodes by superinstructions.  This must be
+ * done last since the pairs in slsuperbc.inc were counted from blocks that
+ * had already been through the other passes.  Note that split_super_bytecode
+ * is used by lang_free_branch to undo this.
+ */
+static void optimize_block5 (SLBlock_Type *b)
+{
+   _pSLang_BC_Type s;
+
+   while (b->bc_main_type != SLANG_BC_LAST_BLOCK)
+     {
+	s = find_super_bytecode (b->bc_main_type, (b+1)->bc_main_type);
+	if (s == SLANG_BC_LAST_BLOCK)
+	  {
+	     b++;
+	     continue;
+	  }
+	b->bc_main_type = s;
+	b++;
+	b->bc_main_type = SLANG_BC_COMBINED;
+	b++;
+     }
+}
+#endif
+
+static void optimize_block (SLBlock_Type *b)
+{
+   optimize_block1 (b);
+   optimize_block2 (b);
+   optimize_block3 (b);
+   optimize_block4 (b);
+#if USE_SUPER_BYTECODES
+   optimize_block5 (b);
+#endif
+}
+
+#endif
+
+/*{{{ Bytecode images */
+
+/* A bytecode image permits a file to be loaded without parsing and compiling
+ * it.  Since the top-level statements of a file are executed as soon as they
+ * have been compiled, and the compilation of what follows may depend upon
+ * their effects (e.g., via implements or require), an image is not simply a
+ * collection of functions.  Rather it records the compile-time events in the
+ * order in which they took place: a variable was declared, a function was
+ * defined, or a top-level block was executed.  Loading the image replays
+ * these events.
+ *
+ * Blocks are recorded before the optimizer has been applied to them because
+ * the combined bytecodes do not retain enough information to be written out.
+ * The optimizer is run on a block after it has been recorded, and again when
+ * it is loaded.  Names are written out as strings and are looked up when the
+ * image is loaded.
+ *
+ * The image data consists of 32 bit words in the native byte order: a table
+ * of strings followed by the events.  See sltoken.c for the file format.
+ */
+#define IMAGE_EVENT_END		0
+#define IMAGE_EVENT_VARIABLE	1
+#define IMAGE_EVENT_FUNCTION	2
+#define IMAGE_EVENT_EXECUTE	3
+
+#define IMAGE_NS_GLOBAL		0
+#define IMAGE_NS_STATIC		1
+#define IMAGE_NS_PRIVATE	2
+
+/* The types of operands of an SLBlock_Type object */
+#define IMAGE_OP_NONE		0
+#define IMAGE_OP_RAW		1	       /* integer or float value */
+#define IMAGE_OP_STRING		2
+#define IMAGE_OP_NAME		3
+#define IMAGE_OP_BLOCK		4
+#define IMAGE_OP_CALL		5
+#define IMAGE_OP_LINE_INFO	6
+#define IMAGE_OP_DOUBLE		7
+#define IMAGE_OP_COMPLEX	8
+#define IMAGE_OP_LLONG		9
+#define IMAGE_OP_BSTRING	10
+
+struct _Image_Writer_Type
+{
+   unsigned char *buf;
+   unsigned int len;
+   unsigned int max;
+   SLCONST char **strings;	       /* slstrings */
+   unsigned int num_strings;
+   unsigned int *string_table;	       /* hash table of 1 + index into strings */
+   unsigned int string_table_size;
+   unsigned int *guards;	       /* kind, string index, value triples */
+   unsigned int num_guards;
+   int is_anonymous;		       /* see image_is_anonymous */
+   int has_executed;		       /* non-zero once top-level code has run */
+   int failed;			       /* non-zero if no image is to be written */
+};
+
+typedef struct
+{
+   SLCONST unsigned char *ptr;
+   SLCONST unsigned char *ptr_max;
+   SLCONST char **strings;	       /* slstrings */
+   unsigned int num_strings;
+   unsigned int nlocals;	       /* of the function being read */
+   int is_corrupt;
+}
+Image_Reader_Type;
+
+/* The functions that may be called via SLANG_BC_CALL_DIRECT or
+ * SLANG_BC_CALL_DIRECT_NARGS.  An image refers to them by their index.
+ */
+static int (*Image_Call_Functions[])(void) =
+{
+   dereference_object,
+   _pSLstruct_define_struct,
+   _pSLstruct_define_struct2,
+   _pSLstruct_define_typedef,
+   start_arg_list,
+   end_arg_list,
+   SLdo_pop,
+   case_function,
+   _pSLarray_wildcard_array,
+   _pSLarray_inline_array,
+   _pSLarray_inline_implicit_array,
+   _pSLarray_inline_implicit_arrayn,
+   _pSLlist_inline_list,
+   _pSLarray_aget,
+   _pSLarray_aput,
+   _pSLerr_throw,
+#if SLANG_HAS_QUALIFIERS
+   set_qualifier,
+#endif
+   _pSLarray_push_elem_ref,
+   _pSLarray_matrix_multiply
+};
+#define NUM_IMAGE_CALL_FUNCTIONS \
+   (sizeof (Image_Call_Functions)/sizeof (Image_Call_Functions[0]))
+
+/* The image data begin with this word since raw operands are copied from
+ * the union of an SLBlock_Type object.
+ */
+#define IMAGE_LAYOUT_WORD \
+   ((unsigned int) sizeof (((SLBlock_Type *) NULL)->b) \
+    | ((unsigned int) NUM_IMAGE_CALL_FUNCTIONS << 8))
+
+/* Returns one of the IMAGE_OP_* values for an unoptimized object, or -1 if
+ * the object cannot be written to an image.
+ */
+static int image_operand_type (SLBlock_Type *b)
+{
+   switch (b->bc_main_type)
+     {
+      case SLANG_BC_LAST_BLOCK:
+      case SLANG_BC_SET_ARRAY_LVALUE:
+      case SLANG_BC_SET_DEREF_LVALUE:
+      case SLANG_BC_OBSOLETE_DEREF_FUN_CALL:
+      case SLANG_BC_DEREF_FUN_CALL:
+      case SLANG_BC_LABEL:
+      case SLANG_BC_EOS:
+      case SLANG_BC_X_ERROR:
+      case SLANG_BC_X_USER0:
+      case SLANG_BC_X_USER1:
+      case SLANG_BC_X_USER2:
+      case SLANG_BC_X_USER3:
+      case SLANG_BC_X_USER4:
+	return IMAGE_OP_NONE;
+
+      case SLANG_BC_LVARIABLE:
+      case SLANG_BC_LOBJPTR:
+      case SLANG_BC_SET_LOCAL_LVALUE:
+      case SLANG_BC_EARG_LVARIABLE:
+      case SLANG_BC_LVARIABLE_AGET:
+      case SLANG_BC_LVARIABLE_APUT:
+      case SLANG_BC_UNARY:
+      case SLANG_BC_BINARY:
+      case SLANG_BC_RETURN:
+      case SLANG_BC_BREAK:
+      case SLANG_BC_CONTINUE:
+      case SLANG_BC_BREAK_N:
+      case SLANG_BC_CONTINUE_N:
+      case SLANG_BC_EXCH:
+	return IMAGE_OP_RAW;
+
+      case SLANG_BC_GVARIABLE:
+      case SLANG_BC_IVARIABLE:
+      case SLANG_BC_RVARIABLE:
+      case SLANG_BC_INTRINSIC:
+      case SLANG_BC_FUNCTION:
+      case SLANG_BC_MATH_UNARY:
+      case SLANG_BC_APP_UNARY:
+      case SLANG_BC_ARITH_UNARY:
+      case SLANG_BC_ARITH_BINARY:
+      case SLANG_BC_ICONST:
+      case SLANG_BC_DCONST:
+      case SLANG_BC_FCONST:
+      case SLANG_BC_LLCONST:
+      case SLANG_BC_PVARIABLE:
+      case SLANG_BC_PFUNCTION:
+      case SLANG_BC_HCONST:
+      case SLANG_BC_LCONST:
+      case SLANG_BC_GOBJPTR:
+      case SLANG_BC_SET_GLOBAL_LVALUE:
+      case SLANG_BC_SET_INTRIN_LVALUE:
+      case SLANG_BC_TAIL_CALL:
+	return IMAGE_OP_NAME;
+
+      case SLANG_BC_TMP:
+	if (b->bc_sub_type == SLANG_LVARIABLE)
+	  return IMAGE_OP_RAW;
+	return IMAGE_OP_NAME;
+
+      case SLANG_BC_FIELD:
+      case SLANG_BC_METHOD:
+      case SLANG_BC_FIELD_REF:
+      case SLANG_BC_SET_STRUCT_LVALUE:
+      case SLANG_BC_LITERAL_STR:
+      case SLANG_BC_DOLLAR_STR:
+	return IMAGE_OP_STRING;
+
+      case SLANG_BC_BLOCK:
+	return IMAGE_OP_BLOCK;
+
+      case SLANG_BC_CALL_DIRECT:
+      case SLANG_BC_CALL_DIRECT_NARGS:
+	return IMAGE_OP_CALL;
+
+#if SLANG_HAS_DEBUG_CODE
+      case SLANG_BC_BOS:
+	return IMAGE_OP_LINE_INFO;
+#endif
+
+      case SLANG_BC_LITERAL:
+      case SLANG_BC_LITERAL_INT:
+      case SLANG_BC_LITERAL_DBL:
+	switch (b->bc_sub_type)
+	  {
+	   case SLANG_CHAR_TYPE:
+	   case SLANG_UCHAR_TYPE:
+	   case SLANG_SHORT_TYPE:
+	   case SLANG_USHORT_TYPE:
+	   case SLANG_INT_TYPE:
+	   case SLANG_UINT_TYPE:
+	   case SLANG_LONG_TYPE:
+	   case SLANG_ULONG_TYPE:
+#if SLANG_HAS_FLOAT
+	   case SLANG_FLOAT_TYPE:
+#endif
+	     return IMAGE_OP_RAW;
+#if SLANG_HAS_FLOAT
+	   case SLANG_DOUBLE_TYPE:
+	     return IMAGE_OP_DOUBLE;
+#endif
+#if SLANG_HAS_COMPLEX
+	   case SLANG_COMPLEX_TYPE:
+	     return IMAGE_OP_COMPLEX;
+#endif
+#if defined(HAVE_LONG_LONG) && LLONG_IS_NOT_LONG
+	   case SLANG_LLONG_TYPE:
+	   case SLANG_ULLONG_TYPE:
+	     return IMAGE_OP_LLONG;
+#endif
+	   case SLANG_STRING_TYPE:
+	     return IMAGE_OP_STRING;
+	   case SLANG_BSTRING_TYPE:
+	     return IMAGE_OP_BSTRING;
+	  }
+	return -1;
+
+      default:
+	return -1;
+     }
+}
+
+/* Apply the optimizer to the blocks nested in b, innermost first, as
+ * lang_end_block would have done.
+ */
+static void optimize_nested_blocks (SLBlock_Type *b)
+{
+#if USE_COMBINED_BYTECODES
+   while (b->bc_main_type != SLANG_BC_LAST_BLOCK)
+     {
+	if (b->bc_main_type == SLANG_BC_BLOCK)
+	  {
+	     optimize_nested_blocks (b->b.blk);
+	     optimize_block (b->b.blk);
+	  }
+	b++;
+     }
+#else
+   (void) b;
+#endif
+}
+
+static void optimize_function_body (SLBlock_Type *body)
+{
+   optimize_nested_blocks (body);
+#if USE_COMBINED_BYTECODES
+   optimize_block (body);
+#endif
+}
+
+/* The default linkage of the compiled code depends upon whether or not the
+ * file is loaded into a named namespace.
+ */
+static int image_is_anonymous (void)
+{
+   return (This_Static_NameSpace == This_Private_NameSpace);
+}
+
+static Image_Writer_Type *allocate_image_writer (void)
+{
+   Image_Writer_Type *w;
+
+   if (NULL != (w = (Image_Writer_Type *) SLcalloc (1, sizeof (Image_Writer_Type))))
+     w->is_anonymous = image_is_anonymous ();
+   return w;
+}
+
+static void free_image_writer (Image_Writer_Type *w)
+{
+   unsigned int i;
+
+   if (w == NULL)
+     return;
+
+   for (i = 0; i < w->num_strings; i++)
+     SLang_free_slstring ((char *) w->strings[i]);
+   SLfree ((char *) w->strings);
+   SLfree ((char *) w->string_table);
+   SLfree ((char *) w->guards);
+   SLfree ((char *) w->buf);
+   SLfree ((char *) w);
+}
+
+/* The data are padded to a multiple of 4 bytes */
+static void image_put_bytes (Image_Writer_Type *w, SLCONST VOID_STAR data, unsigned int n)
+{
+   unsigned int len;
+
+   if (w->failed)
+     return;
+
+   len = w->len + ((n + 3) & ~3U);
+   if (len > w->max)
+     {
+	unsigned int max = 2 * w->max + 1024;
+	unsigned char *buf;
+
+	while (max < len)
+	  max *= 2;
+
+	if (NULL == (buf = (unsigned char *) SLrealloc ((char *) w->buf, max)))
+	  {
+	     w->failed = 1;
+	     return;
+	  }
+	w->buf = buf;
+	w->max = max;
+     }
+   memcpy (w->buf + w->len, data, n);
+   memset (w->buf + w->len + n, 0, len - (w->len + n));
+   w->len = len;
+}
+
+static void image_put_word (Image_Writer_Type *w, unsigned int u)
+{
+   _pSLuint32_Type word = (_pSLuint32_Type) u;
+   image_put_bytes (w, (VOID_STAR) &word, sizeof (word));
+}
+
+static int grow_image_string_table (Image_Writer_Type *w)
+{
+   unsigned int *table, i, size, mask;
+   SLCONST char **strings;
+
+   size = (w->string_table_size == 0) ? 256 : 2 * w->string_table_size;
+   if (NULL == (table = (unsigned int *) SLcalloc (size, sizeof (unsigned int))))
+     return -1;
+   strings = (SLCONST char **) SLrealloc ((char *) w->strings, (size/2) * sizeof (char *));
+   if (strings == NULL)
+     {
+	SLfree ((char *) table);
+	return -1;
+     }
+   w->strings = strings;
+
+   mask = size - 1;
+   for (i = 0; i < w->num_strings; i++)
+     {
+	unsigned int j = _pSLstring_get_hash ((SLstr_Type *) strings[i]) & mask;
+	while (table[j] != 0)
+	  j = (j + 1) & mask;
+	table[j] = i + 1;
+     }
+   SLfree ((char *) w->string_table);
+   w->string_table = table;
+   w->string_table_size = size;
+   return 0;
+}
+
+/* Returns the index of the string in the string table.  Slstrings are
+ * unique, so the table is searched for the pointer.
+ */
+static unsigned int image_string_index (Image_Writer_Type *w, SLCONST char *str)
+{
+   SLCONST char *s;
+   unsigned int i, mask;
+
+   if (w->failed)
+     return 0;
+
+   if ((str == NULL)
+       || (NULL == (s = SLang_create_slstring ((char *) str))))
+     {
+	w->failed = 1;
+	return 0;
+     }
+
+   if ((2 * (w->num_strings + 1) > w->string_table_size)
+       && (-1 == grow_image_string_table (w)))
+     {
+	SLang_free_slstring ((char *) s);
+	w->failed = 1;
+	return 0;
+     }
+
+   mask = w->string_table_size - 1;
+   i = _pSLstring_get_hash ((SLstr_Type *) s) & mask;
+   while (w->string_table[i] != 0)
+     {
+	unsigned int j = w->string_table[i] - 1;
+	if (w->strings[j] == s)
+	  {
+	     SLang_free_slstring ((char *) s);
+	     return j;
+	  }
+	i = (i + 1) & mask;
+     }
+   w->strings[w->num_strings] = s;
+   w->string_table[i] = ++w->num_strings;
+   return w->num_strings - 1;
+}
+
+static void image_put_string (Image_Writer_Type *w, SLCONST char *str)
+{
+   unsigned int i = image_string_index (w, str);
+   image_put_word (w, i);
+}
+
+/* The name is written in the form that locate_hashed_name will find when
+ * the image is loaded.  If the object is in a named namespace that is not
+ * otherwise visible, it is written as ns->name.
+ */
+static void image_put_name (Image_Writer_Type *w, SLang_Name_Type *nt)
+{
+   SLCONST char *name = nt->name;
+   SLang_NameSpace_Type *ns;
+   char *encoded;
+
+   if (nt == locate_hashed_name (name, _pSLstring_get_hash ((SLstr_Type *) name), 0))
+     {
+	image_put_string (w, name);
+	image_put_word (w, (unsigned char) nt->name_type);
+	return;
+     }
+
+   ns = _pSLns_find_object_namespace (nt);
+   if ((ns == NULL) || (ns->namespace_name == NULL)
+       || (NULL == (encoded = SLmalloc (strlen (ns->namespace_name) + strlen (name) + 3))))
+     {
+	w->failed = 1;
+	return;
+     }
+   sprintf (encoded, "%s->%s", ns->namespace_name, name);
+   if (nt != locate_hashed_name (encoded, SLcompute_string_hash (encoded), 0))
+     w->failed = 1;
+   image_put_string (w, encoded);
+   image_put_word (w, (unsigned char) nt->name_type);
+   SLfree (encoded);
+}
+
+static void image_put_namespace (Image_Writer_Type *w, SLang_NameSpace_Type *ns)
+{
+   if (ns == This_Private_NameSpace)
+     image_put_word (w, IMAGE_NS_PRIVATE);
+   else if (ns == This_Static_NameSpace)
+     image_put_word (w, IMAGE_NS_STATIC);
+   else if (ns == Global_NameSpace)
+     image_put_word (w, IMAGE_NS_GLOBAL);
+   else
+     w->failed = 1;
+}
+
+static void image_put_block (Image_Writer_Type *w, SLBlock_Type *blk)
+{
+   SLBlock_Type *b;
+   unsigned int n;
+
+   n = 1;
+   for (b = blk; b->bc_main_type != SLANG_BC_LAST_BLOCK; b++)
+     n++;
+   image_put_word (w, n);
+
+   for (b = blk; w->failed == 0; b++)
+     {
+	image_put_word (w, (unsigned int) b->bc_main_type
+			| ((unsigned int) b->bc_sub_type << 8)
+			| ((unsigned int) b->bc_flags << 16));
+	image_put_word (w, b->linenum);
+
+	switch (image_operand_type (b))
+	  {
+	   case IMAGE_OP_NONE:
+	     break;
+
+	   case IMAGE_OP_RAW:
+	     image_put_bytes (w, (VOID_STAR) &b->b, sizeof (b->b));
+	     break;
+
+	   case IMAGE_OP_STRING:
+	     image_put_string (w, b->b.s_blk);
+	     break;
+
+	   case IMAGE_OP_NAME:
+	     image_put_name (w, b->b.nt_blk);
+	     break;
+
+	   case IMAGE_OP_BLOCK:
+	     image_put_block (w, b->b.blk);
+	     break;
+
+	   case IMAGE_OP_CALL:
+	       {
+		  unsigned int i = 0;
+		  while ((i < NUM_IMAGE_CALL_FUNCTIONS)
+			 && (Image_Call_Functions[i] != b->b.call_function))
+		    i++;
+		  if (i == NUM_IMAGE_CALL_FUNCTIONS)
+		    w->failed = 1;
+		  image_put_word (w, i);
+	       }
+	     break;
+
+#if SLANG_HAS_DEBUG_CODE
+	   case IMAGE_OP_LINE_INFO:
+	     if (b->b.line_info == NULL)
+	       {
+		  image_put_word (w, 0);
+		  break;
+	       }
+	     image_put_word (w, 1);
+	     image_put_word (w, (unsigned int) b->b.line_info->linenum);
+	     image_put_string (w, b->b.line_info->filename);
+	     break;
+#endif
+#if SLANG_HAS_FLOAT
+	   case IMAGE_OP_DOUBLE:
+	     image_put_bytes (w, (VOID_STAR) b->b.double_blk, sizeof (double));
+	     break;
+	   case IMAGE_OP_COMPLEX:
+	     image_put_bytes (w, (VOID_STAR) b->b.double_blk, 2 * sizeof (double));
+	     break;
+#endif
+#ifdef HAVE_LONG_LONG
+	   case IMAGE_OP_LLONG:
+	     image_put_bytes (w, (VOID_STAR) b->b.llong_blk, sizeof (long long));
+	     break;
+#endif
+	   case IMAGE_OP_BSTRING:
+	       {
+		  SLstrlen_Type len;
+		  unsigned char *ptr = SLbstring_get_pointer (b->b.bs_blk, &len);
+		  image_put_word (w, (unsigned int) len);
+		  image_put_bytes (w, (VOID_STAR) ptr, (unsigned int) len);
+	       }
+	     break;
+
+	   default:
+	     w->failed = 1;
+	     break;
+	  }
+
+	if (b->bc_main_type == SLANG_BC_LAST_BLOCK)
+	  break;
+     }
+}
+
+static void record_image_variable (SLCONST char *name, unsigned char name_type,
+				   SLang_NameSpace_Type *ns)
+{
+   Image_Writer_Type *w = Image_Writer;
+
+   image_put_word (w, IMAGE_EVENT_VARIABLE);
+   image_put_namespace (w, ns);
+   image_put_word (w, name_type);
+   image_put_string (w, name);
+}
+
+/* This is called after the function has been added and its body is to be
+ * optimized.
+ */
+static void record_image_function (SLCONST char *name, unsigned char type,
+				   SLang_NameSpace_Type *ns, Function_Header_Type *h)
+{
+   Image_Writer_Type *w = Image_Writer;
+   unsigned int i;
+
+   image_put_word (w, IMAGE_EVENT_FUNCTION);
+   image_put_namespace (w, ns);
+   image_put_word (w, type);
+   image_put_string (w, name);
+   image_put_word (w, h->nargs);
+   image_put_word (w, h->nlocals);
+#if SLANG_HAS_BOSEOS
+   image_put_word (w, (unsigned int) h->issue_bofeof_info);
+#else
+   image_put_word (w, 0);
+#endif
+   for (i = 0; i < h->nlocals; i++)
+     image_put_string (w, h->local_variables[i]);
+   image_put_block (w, h->body);
+
+   optimize_function_body (h->body);
+}
+
+/* This is called before a top-level block is executed */
+static void record_image_execute (SLBlock_Type *blk)
+{
+   Image_Writer->has_executed = 1;
+   image_put_word (Image_Writer, IMAGE_EVENT_EXECUTE);
+   image_put_block (Image_Writer, blk);
+
+   optimize_nested_blocks (blk);
+}
+
+/* The preprocessor calls this with the outcome of a condition that depends
+ * upon the state of the interpreter, e.g., #ifexists.  An image is used only
+ * if its conditions have the same outcome before it is loaded.  Since names
+ * are not removed, the outcome of #ifexists is not affected by the code that
+ * precedes it.  This is not true of an expression, so an image is not
+ * produced if one is evaluated after top-level code has been executed.
+ */
+void _pSLcompile_add_image_guard (int kind, SLFUTURE_CONST char *text, int value)
+{
+   Image_Writer_Type *w = Image_Writer;
+   unsigned int *guards;
+
+   if ((w == NULL) || w->failed)
+     return;
+
+   if ((kind != _pSLIMAGE_GUARD_EXISTS) && w->has_executed)
+     {
+	w->failed = 1;
+	return;
+     }
+
+   guards = (unsigned int *) SLrealloc ((char *) w->guards,
+					3 * (w->num_guards + 1) * sizeof (unsigned int));
+   if (guards == NULL)
+     {
+	w->failed = 1;
+	return;
+     }
+   w->guards = guards;
+   guards += 3 * w->num_guards;
+   guards[0] = (unsigned int) kind;
+   guards[1] = image_string_index (w, text);
+   guards[2] = (unsigned int) value;
+   w->num_guards++;
+}
+
+/* The next compile context that gets pushed will be recorded */
+void _pSLcompile_start_image (void)
+{
+   Image_Requested = 1;
+}
+
+/* Returns the malloced image data of the compile context that was recorded
+ * since the matching call to _pSLcompile_start_image, or NULL if no image
+ * was produced.
+ */
+unsigned char *_pSLcompile_end_image (unsigned int *lenp)
+{
+   Image_Writer_Type *w, *data;
+   unsigned char *buf;
+   unsigned int i;
+
+   Image_Requested = 0;
+   w = Finished_Image_Writer;
+   Finished_Image_Writer = NULL;
+   if (w == NULL)
+     return NULL;
+
+   image_put_word (w, IMAGE_EVENT_END);
+   if (w->failed || _pSLang_Error
+       || (NULL == (data = allocate_image_writer ())))
+     {
+	free_image_writer (w);
+	return NULL;
+     }
+
+   image_put_word (data, IMAGE_LAYOUT_WORD);
+   image_put_word (data, (unsigned int) w->is_anonymous);
+   image_put_word (data, w->num_strings);
+   for (i = 0; i < w->num_strings; i++)
+     {
+	unsigned int len = (unsigned int) strlen (w->strings[i]);
+	image_put_word (data, len);
+	image_put_bytes (data, (VOID_STAR) w->strings[i], len + 1);
+     }
+   image_put_word (data, w->num_guards);
+   for (i = 0; i < 3 * w->num_guards; i++)
+     image_put_word (data, w->guards[i]);
+   image_put_bytes (data, (VOID_STAR) w->buf, w->len);
+   free_image_writer (w);
+
+   buf = data->buf;
+   *lenp = data->len;
+   if (data->failed)
+     buf = NULL;
+   else
+     data->buf = NULL;
+   free_image_writer (data);
+   return buf;
+}
+
+/* This does not generate an error since the file will be compiled instead */
+static int image_error (Image_Reader_Type *r)
+{
+   r->is_corrupt = 1;
+   return -1;
+}
+
+/* Returns 1 if the raw operand of b is the index of a local variable */
+static int image_operand_is_local (SLBlock_Type *b)
+{
+   switch (b->bc_main_type)
+     {
+      case SLANG_BC_LVARIABLE:
+      case SLANG_BC_LOBJPTR:
+      case SLANG_BC_SET_LOCAL_LVALUE:
+      case SLANG_BC_EARG_LVARIABLE:
+      case SLANG_BC_LVARIABLE_AGET:
+      case SLANG_BC_LVARIABLE_APUT:
+	return 1;
+      case SLANG_BC_TMP:
+	return (b->bc_sub_type == SLANG_LVARIABLE);
+      default:
+	break;
+     }
+   return 0;
+}
+
+static int image_get_bytes (Image_Reader_Type *r, VOID_STAR data, unsigned int n)
+{
+   unsigned int n4 = (n + 3) & ~3U;
+
+   if ((unsigned int) (r->ptr_max - r->ptr) < n4)
+     return image_error (r);
+
+   if (data != NULL)
+     memcpy (data, r->ptr, n);
+   r->ptr += n4;
+   return 0;
+}
+
+static int image_get_word (Image_Reader_Type *r, unsigned int *up)
+{
+   _pSLuint32_Type word;
+
+   if (-1 == image_get_bytes (r, (VOID_STAR) &word, sizeof (word)))
+     return -1;
+   *up = (unsigned int) word;
+   return 0;
+}
+
+static int image_get_string (Image_Reader_Type *r, SLCONST char **sp)
+{
+   unsigned int i;
+
+   if (-1 == image_get_word (r, &i))
+     return -1;
+   if (i >= r->num_strings)
+     return image_error (r);
+   *sp = r->strings[i];
+   return 0;
+}
+
+static SLang_Name_Type *image_get_name (Image_Reader_Type *r)
+{
+   SLang_Name_Type *nt;
+   SLCONST char *name;
+   unsigned int name_type;
+
+   if ((-1 == image_get_string (r, &name))
+       || (-1 == image_get_word (r, &name_type)))
+     return NULL;
+
+   nt = locate_hashed_name (name, _pSLstring_get_hash ((SLstr_Type *) name), 1);
+   if ((nt == NULL) || ((unsigned char) nt->name_type != name_type))
+     {
+	(void) image_error (r);
+	return NULL;
+     }
+   return nt;
+}
+
+static SLang_NameSpace_Type *image_get_namespace (Image_Reader_Type *r)
+{
+   SLang_NameSpace_Type *ns = NULL;
+   unsigned int kind;
+
+   if (-1 == image_get_word (r, &kind))
+     return NULL;
+
+   switch (kind)
+     {
+      case IMAGE_NS_PRIVATE:
+	ns = This_Private_NameSpace;
+	break;
+      case IMAGE_NS_STATIC:
+	ns = This_Static_NameSpace;
+	break;
+      case IMAGE_NS_GLOBAL:
+	ns = Global_NameSpace;
+	break;
+     }
+   if (ns == NULL)
+     (void) image_error (r);
+   return ns;
+}
+
+static SLBlock_Type *image_get_block (Image_Reader_Type *r)
+{
+   SLBlock_Type *blk, *b;
+   unsigned int i, n, u;
+   SLCONST char *s;
+
+   if (-1 == image_get_word (r, &n))
+     return NULL;
+
+   /* Each object takes at least two words */
+   if ((n == 0) || (n > (unsigned int) (r->ptr_max - r->ptr)/8))
+     {
+	(void) image_error (r);
+	return NULL;
+     }
+
+   if (NULL == (blk = (SLBlock_Type *) SLcalloc (n, sizeof (SLBlock_Type))))
+     return NULL;
+
+   for (i = 0; i < n; i++)
+     {
+	b = blk + i;
+	if (-1 == image_get_word (r, &u))
+	  goto return_error;
+	b->bc_main_type = (_pSLang_BC_Type) (u & 0xFF);
+	b->bc_sub_type = (unsigned char) ((u >> 8) & 0xFF);
+	b->bc_flags = (unsigned char) ((u >> 16) & 0xFF);
+	if (-1 == image_get_word (r, &u))
+	  goto return_error;
+	b->linenum = (unsigned short) u;
+
+	if ((b->bc_main_type == SLANG_BC_LAST_BLOCK) != (i + 1 == n))
+	  {
+	     (void) image_error (r);
+	     goto return_error;
+	  }
+
+	switch (image_operand_type (b))
+	  {
+	   case IMAGE_OP_NONE:
+	     break;
+
+	   case IMAGE_OP_RAW:
+	     if (-1 == image_get_bytes (r, (VOID_STAR) &b->b, sizeof (b->b)))
+	       goto return_error;
+	     if (image_operand_is_local (b)
+		 && ((b->b.i_blk < 0) || ((unsigned int) b->b.i_blk >= r->nlocals)))
+	       {
+		  (void) image_error (r);
+		  goto return_error;
+	       }
+	     break;
+
+	   case IMAGE_OP_STRING:
+	     if ((-1 == image_get_string (r, &s))
+		 || (NULL == (b->b.s_blk = (char *) _pSLstring_dup_slstring (s))))
+	       goto return_error;
+	     break;
+
+	   case IMAGE_OP_NAME:
+	     if (NULL == (b->b.nt_blk = image_get_name (r)))
+	       goto return_error;
+	     break;
+
+	   case IMAGE_OP_BLOCK:
+	     if (NULL == (b->b.blk = image_get_block (r)))
+	       goto return_error;
+	     break;
+
+	   case IMAGE_OP_CALL:
+	     if (-1 == image_get_word (r, &u))
+	       goto return_error;
+	     if (u >= NUM_IMAGE_CALL_FUNCTIONS)
+	       {
+		  (void) image_error (r);
+		  goto return_error;
+	       }
+	     b->b.call_function = Image_Call_Functions[u];
+	     break;
+
+#if SLANG_HAS_DEBUG_CODE
+	   case IMAGE_OP_LINE_INFO:
+	       {
+		  Linenum_Info_Type *info;
+
+		  if (-1 == image_get_word (r, &u))
+		    goto return_error;
+		  if (u == 0)
+		    break;
+
+		  if ((-1 == image_get_word (r, &u))
+		      || (-1 == image_get_string (r, &s))
+		      || (NULL == (info = (Linenum_Info_Type *) SLmalloc (sizeof (Linenum_Info_Type)))))
+		    goto return_error;
+		  info->linenum = (int) u;
+		  if (NULL == (info->filename = (char *) _pSLstring_dup_slstring (s)))
+		    {
+		       SLfree ((char *) info);
+		       goto return_error;
+		    }
+		  b->b.line_info = info;
+	       }
+	     break;
+#endif
+#if SLANG_HAS_FLOAT
+	   case IMAGE_OP_DOUBLE:
+	   case IMAGE_OP_COMPLEX:
+	       {
+		  unsigned int size = sizeof (double);
+		  double *ptr;
+
+		  if (image_operand_type (b) == IMAGE_OP_COMPLEX)
+		    size *= 2;
+		  if (NULL == (ptr = (double *) SLmalloc (size)))
+		    goto return_error;
+		  if (-1 == image_get_bytes (r, (VOID_STAR) ptr, size))
+		    {
+		       SLfree ((char *) ptr);
+		       goto return_error;
+		    }
+		  b->b.double_blk = ptr;
+	       }
+	     break;
+#endif
+#ifdef HAVE_LONG_LONG
+	   case IMAGE_OP_LLONG:
+	       {
+		  long long *ptr;
+
+		  if (NULL == (ptr = (long long *) SLmalloc (sizeof (long long))))
+		    goto return_error;
+		  if (-1 == image_get_bytes (r, (VOID_STAR) ptr, sizeof (long long)))
+		    {
+		       SLfree ((char *) ptr);
+		       goto return_error;
+		    }
+		  b->b.llong_blk = ptr;
+	       }
+	     break;
+#endif
+	   case IMAGE_OP_BSTRING:
+	     if (-1 == image_get_word (r, &u))
+	       goto return_error;
+	     if (u > (unsigned int) (r->ptr_max - r->ptr))
+	       {
+		  (void) image_error (r);
+		  goto return_error;
+	       }
+	     if (NULL == (b->b.bs_blk = SLbstring_create ((unsigned char *) r->ptr, u)))
+	       goto return_error;
+	     (void) image_get_bytes (r, NULL, u);
+	     break;
+
+	   default:
+	     (void) image_error (r);
+	     goto return_error;
+	  }
+     }
+   return blk;
+
+return_error:
+   /* The operand of b has not been set */
+   b->bc_main_type = SLANG_BC_LAST_BLOCK;
+   if (lang_free_branch (blk))
+     SLfree ((char *) blk);
+   return NULL;
+}
+
+static int image_get_strings (Image_Reader_Type *r)
+{
+   unsigned int i, n, len;
+
+   if (-1 == image_get_word (r, &n))
+     return -1;
+   if (n > (unsigned int) (r->ptr_max - r->ptr)/8)
+     return image_error (r);
+
+   if (NULL == (r->strings = (SLCONST char **) SLcalloc (n + 1, sizeof (char *))))
+     return -1;
+
+   for (i = 0; i < n; i++)
+     {
+	if (-1 == image_get_word (r, &len))
+	  return -1;
+	if ((len >= (unsigned int) (r->ptr_max - r->ptr))
+	    || (r->ptr[len] != 0))
+	  return image_error (r);
+	if (NULL == (r->strings[i] = SLang_create_nslstring ((char *) r->ptr, len)))
+	  return -1;
+	r->num_strings++;
+	(void) image_get_bytes (r, NULL, len + 1);
+     }
+   return 0;
+}
+
+static int image_define_variable (Image_Reader_Type *r)
+{
+   SLang_NameSpace_Type *ns;
+   unsigned int name_type;
+   SLCONST char *name;
+
+   if ((NULL == (ns = image_get_namespace (r)))
+       || (-1 == image_get_word (r, &name_type))
+       || (-1 == image_get_string (r, &name)))
+     return -1;
+
+   if ((name_type != SLANG_GVARIABLE) && (name_type != SLANG_PVARIABLE))
+     return image_error (r);
+
+   return add_global_variable (name, (char) name_type, _pSLstring_get_hash ((SLstr_Type *) name), ns);
+}
+
+static int image_define_function (Image_Reader_Type *r)
+{
+   Function_Header_Type *h;
+   SLang_NameSpace_Type *ns;
+   SLBlock_Type *body;
+   unsigned int type, nargs, nlocals, bofeof, i;
+   SLCONST char *name, *s;
+
+   if ((NULL == (ns = image_get_namespace (r)))
+       || (-1 == image_get_word (r, &type))
+       || (-1 == image_get_string (r, &name))
+       || (-1 == image_get_word (r, &nargs))
+       || (-1 == image_get_word (r, &nlocals))
+       || (-1 == image_get_word (r, &bofeof)))
+     return -1;
+
+   if (((type != SLANG_FUNCTION) && (type != SLANG_PFUNCTION))
+       || (nlocals > SLANG_MAX_LOCAL_VARIABLES) || (nargs > nlocals))
+     return image_error (r);
+
+   /* allocate_function_header gets the names from here */
+   for (i = 0; i < nlocals; i++)
+     {
+	if (-1 == image_get_string (r, &s))
+	  return -1;
+	Local_Variable_Names[i] = (char *) s;
+     }
+
+   if (NULL == (h = allocate_function_header (nargs, nlocals, This_Compile_Filename)))
+     return -1;
+#if SLANG_HAS_BOSEOS
+   h->issue_bofeof_info = (int) bofeof;
+#else
+   (void) bofeof;
+#endif
+
+   r->nlocals = nlocals;
+   body = image_get_block (r);
+   r->nlocals = 0;
+   if (body == NULL)
+     {
+	free_function_header (h);
+	return -1;
+     }
+
+   if (-1 == add_slang_function ((char *) name, (unsigned char) type,
+				 _pSLstring_get_hash ((SLstr_Type *) name), h, NULL, ns))
+     {
+	h->body = body;
+	free_function_header (h);
+	return -1;
+     }
+   h->body = body;
+   optimize_function_body (body);
+   return 0;
+}
+
+static int image_execute (Image_Reader_Type *r)
+{
+   SLBlock_Type *blk;
+
+   if (NULL == (blk = image_get_block (r)))
+     return -1;
+
+   optimize_nested_blocks (blk);
+   inner_interp (blk);
+   if (lang_free_branch (blk))
+     SLfree ((char *) blk);
+   Lang_Break = Lang_Break_Condition = Lang_Return = 0;
+   return 0;
+}
+
+/* Returns 1 if the conditions have the same outcome as they did when the
+ * image was produced, 0 if not, or -1 upon error.
+ */
+static int image_check_guards (Image_Reader_Type *r,
+			       int (*check_guard)(int, SLFUTURE_CONST char *))
+{
+   unsigned int i, n, kind, value;
+   SLCONST char *text;
+
+   if (-1 == image_get_word (r, &n))
+     return -1;
+
+   for (i = 0; i < n; i++)
+     {
+	if ((-1 == image_get_word (r, &kind))
+	    || (-1 == image_get_string (r, &text))
+	    || (-1 == image_get_word (r, &value)))
+	  return -1;
+
+	if (((int) value != (*check_guard) ((int) kind, (char *) text))
+	    || _pSLang_Error)
+	  {
+	     /* An error means that the condition cannot be evaluated yet */
+	     if (_pSLang_Error)
+	       _pSLerr_clear_error (0);
+	     return 0;
+	  }
+     }
+   return 1;
+}
+
+/* Load the image data produced by _pSLcompile_end_image.  The check_guard
+ * function is called with the arguments that were passed to
+ * _pSLcompile_add_image_guard and must return the outcome of the condition.
+ * If an outcome differs, nothing is loaded and 0 is returned.  0 is also
+ * returned if the data turn out to be corrupt, in which case the file is to
+ * be compiled as if the image had not been loaded.  Since what precedes the
+ * corrupt part will have been loaded, the functions defined there will be
+ * redefined.  Otherwise 1 is returned, or -1 upon error.
+ */
+int _pSLcompile_load_image (SLang_Load_Type *x,
+			    SLCONST unsigned char *data, unsigned int len,
+			    int (*check_guard)(int, SLFUTURE_CONST char *))
+{
+   Image_Reader_Type r;
+   unsigned int i, event;
+   int status;
+
+   r.ptr = data;
+   r.ptr_max = data + len;
+   r.strings = NULL;
+   r.num_strings = 0;
+   r.nlocals = 0;
+   r.is_corrupt = 0;
+
+   if (-1 == _pSLcompile_push_context (x))
+     return -1;
+
+   if ((-1 == image_get_word (&r, &event))
+       || (-1 == image_get_word (&r, &i)))
+     status = -1;
+   else if (event != IMAGE_LAYOUT_WORD)
+     status = image_error (&r);
+   else if (i != (unsigned int) image_is_anonymous ())
+     status = 2;		       /* the image cannot be used */
+   else if (0 == (status = image_get_strings (&r)))
+     {
+	status = image_check_guards (&r, check_guard);
+	if (status == 1)
+	  status = 0;
+	else if (status == 0)
+	  status = 2;		       /* the image cannot be used */
+     }
+
+   while ((status == 0) && (_pSLang_Error == 0))
+     {
+	if (-1 == image_get_word (&r, &event))
+	  break;
+
+	switch (event)
+	  {
+	   case IMAGE_EVENT_END:
+	     status = 1;
+	     break;
+	   case IMAGE_EVENT_VARIABLE:
+	     status = image_define_variable (&r);
+	     break;
+	   case IMAGE_EVENT_FUNCTION:
+	     status = image_define_function (&r);
+	     break;
+	   case IMAGE_EVENT_EXECUTE:
+	     status = image_execute (&r);
+	     break;
+	   default:
+	     status = image_error (&r);
+	     break;
+	  }
+     }
+
+   if (r.strings != NULL)
+     {
+	for (i = 0; i < r.num_strings; i++)
+	  SLang_free_slstring ((char *) r.strings[i]);
+	SLfree ((char *) r.strings);
+     }
+
+   (void) _pSLcompile_pop_context ();
+   if (_pSLang_Error)
+     return -1;
+   if ((status == 2) || r.is_corrupt)
+     return 0;
+   return 1;
+}
+
+/*}}}*/
 
 static void end_define_function (void)
 {
@@ -8475,9 +10974,27 @@ static void end_define_function (void)
    Locals_NameSpace = NULL;
    Local_Variable_Number = 0;
    Function_Args_Number = 0;
+   Function_Tail_Calls_Disabled = 0;
    Lang_Defining_Function = 0;
 }
 
+/* A tail call frees the local variables of the caller before the called
+ * function runs, and skips any ERROR_BLOCK of the caller.  So the tail calls
+ * of a function that takes a reference to a local variable, or that has an
+ * ERROR_BLOCK, are turned back into normal calls.
+ */
+static void remove_tail_calls (SLBlock_Type *b)
+{
+   while (b->bc_main_type != SLANG_BC_LAST_BLOCK)
+     {
+	if (b->bc_main_type == SLANG_BC_BLOCK)
+	  remove_tail_calls (b->b.blk);
+	else if (b->bc_main_type == SLANG_BC_TAIL_CALL)
+	  b->bc_main_type = (_pSLang_BC_Type) b->b.nt_fun_blk->name_type;
+	b++;
+     }
+}
+
 /* name will be NULL if the object is to simply terminate the function
  * definition.  See SLang_restart.
  */
@@ -8486,52 +11003,219 @@ static int lang_define_function (SLFUTURE_CONST char *name, unsigned char type,
 {
    Function_Header_Type *h;
 
-   if (This_Compile_Block_Type != COMPILE_BLOCK_TYPE_FUNCTION)
+   if (This_Compile_Block_Type != COMPILE_BLOCK_TYPE_FUNCTION)
+     {
+	_pSLang_verror (SL_SYNTAX_ERROR, "Premature end of function");
+	return -1;
+     }
+
+   /* terminate function */
+   Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
+   if (name == NULL)
+     {
+	end_define_function ();
+	return -1;
+     }
+
+   h = allocate_function_header (Function_Args_Number,
+				 Local_Variable_Number,
+				 This_Compile_Filename);
+   if (h == NULL)
+     {
+	end_define_function ();
+	return -1;
+     }
+
+   if (-1 == add_slang_function (name, type, hash, h, NULL, ns))
+     {
+	free_function_header (h);
+	end_define_function ();
+	return -1;
+     }
+
+   h->body = This_Compile_Block;
+   This_Compile_Block = NULL;
+   if (Function_Tail_Calls_Disabled)
+     remove_tail_calls (h->body);
+   if (Lazy_Function_Body != NULL)
+     {
+	/* The body consists only of the terminator */
+	if (lang_free_branch (h->body))
+	  SLfree ((char *) h->body);
+	h->body = NULL;
+	h->lazy_body = Lazy_Function_Body;
+	Lazy_Function_Body = NULL;
+     }
+   else if (Image_Writer == NULL)
+     optimize_function_body (h->body);
+   end_define_function ();
+   if (Image_Writer != NULL)
+     record_image_function (name, type, ns, h);
+   pop_block_context ();
+
+   /* A function is only defined at top-level */
+   if (This_Compile_Block_Type != COMPILE_BLOCK_TYPE_TOP_LEVEL)
+     {
+	_pSLang_verror (SL_INTERNAL_ERROR, "Not at top-level");
+	return -1;
+     }
+   Compile_ByteCode_Ptr = This_Compile_Block;
+   return 0;
+}
+
+int SLang_lazy_compile (int mode)
+{
+   int mode1 = _pSLang_Lazy_Compile;
+   _pSLang_Lazy_Compile = mode;
+   return mode1;
+}
+
+/* This is called by the parser after the arguments of a function have been
+ * compiled to see whether the body may be saved for later.  A body cannot
+ * be deferred when the compiled code is being written out.
+ */
+int _pSLcompile_lazy_body_ok (void)
+{
+   return (_pSLang_Lazy_Compile
+	   && (_pSLcompile_ptr == _pSLcompile)
+	   && (Image_Writer == NULL)
+	   && (This_Compile_Block_Type == COMPILE_BLOCK_TYPE_FUNCTION));
+}
+
+/* The body is attached to the function by lang_define_function.  Any
+ * body that it did not use is freed when this is called with NULL.
+ */
+void _pSLcompile_set_lazy_body (_pSLang_Lazy_Body_Type *body)
+{
+   _pSLparse_free_lazy_body (Lazy_Function_Body);
+   Lazy_Function_Body = body;
+}
+
+static int end_lazy_function (Function_Header_Type *h)
+{
+   unsigned int i, nlocals = (unsigned int) Local_Variable_Number;
+   char **local_variables;
+
+   if (This_Compile_Block_Type != COMPILE_BLOCK_TYPE_FUNCTION)
+     {
+	_pSLang_verror (SL_SYNTAX_ERROR, "Premature end of function");
+	return -1;
+     }
+   Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
+
+   /* The header has the names of the arguments.  Add the other locals. */
+   if (nlocals > h->nlocals)
+     {
+	if (NULL == (local_variables = (char **)SLcalloc (nlocals, sizeof (char *))))
+	  return -1;
+	for (i = 0; i < nlocals; i++)
+	  {
+	     if (NULL == (local_variables[i] = SLang_create_slstring (Local_Variable_Names[i])))
+	       {
+		  free_local_variable_names (local_variables, nlocals);
+		  return -1;
+	       }
+	  }
+	free_local_variable_names (h->local_variables, h->nlocals);
+	h->local_variables = local_variables;
+	h->nlocals = nlocals;
+     }
+
+   h->body = This_Compile_Block;
+   This_Compile_Block = NULL;
+   if (Function_Tail_Calls_Disabled)
+     remove_tail_calls (h->body);
+   optimize_function_body (h->body);
+   end_define_function ();
+   pop_block_context ();
+   Compile_ByteCode_Ptr = This_Compile_Block;
+   return 0;
+}
+
+/* Compile the body of a function that was saved by the parser.  This takes
+ * place in a new compile context that has the namespaces of the file where
+ * the function was defined, with the arguments already declared.  Names in
+ * the body are looked up now rather than when the function was defined.
+ * The tokens are consumed, so the body is compiled only once.
+ */
+static int compile_lazy_function (_pSLang_Function_Type *fun, Function_Header_Type *h)
+{
+   _pSLang_Lazy_Body_Type *body = h->lazy_body;
+   void (*compile)(_pSLang_Token_Type *);
+   SLang_Load_Type *llt;
+   unsigned int i;
+   int status = -1;
+
+   if (body == NULL)
      {
-	_pSLang_verror (SL_SYNTAX_ERROR, "Premature end of function");
+	_pSLang_verror (SL_SYNTAX_ERROR, "The body of %s could not be compiled", fun->name);
 	return -1;
      }
 
-   /* terminate function */
-   Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
-   if (name == NULL)
+   if (NULL == (llt = SLns_allocate_load_type (h->file, NULL)))
+     return -1;
+
+   if (-1 == push_compile_context (h->file))
      {
-	end_define_function ();
+	SLdeallocate_load_type (llt);
 	return -1;
      }
-
-   h = allocate_function_header (Function_Args_Number,
-				 Local_Variable_Number,
-				 This_Compile_Filename);
-   if (h == NULL)
+   This_Static_NameSpace = h->static_ns;
+   This_Private_NameSpace = h->private_ns;
+   if (-1 == push_block_context (COMPILE_BLOCK_TYPE_TOP_LEVEL))
      {
-	end_define_function ();
+	(void) pop_compile_context ();
+	SLdeallocate_load_type (llt);
 	return -1;
      }
+   h->lazy_body = NULL;
 
-   if (-1 == add_slang_function (name, type, hash, h, NULL, ns))
+   (void) _pSLerr_suspend_messages ();
+   compile = _pSLcompile_ptr;
+   _pSLcompile_ptr = _pSLcompile;
+
+   lang_begin_function ();
+   if ((h->nargs != 0)
+       && (NULL != (Locals_NameSpace = _pSLns_allocate_namespace ("**locals**", SLLOCALS_HASH_TABLE_SIZE))))
      {
-	free_function_header (h);
-	end_define_function ();
-	return -1;
+	for (i = 0; i < h->nargs; i++)
+	  {
+	     if (-1 == add_local_variable (h->local_variables[i],
+					   SLcompute_string_hash (h->local_variables[i])))
+	       break;
+	  }
      }
+   Function_Args_Number = Local_Variable_Number;
 
-   h->body = This_Compile_Block;
-   This_Compile_Block = NULL;
-#if USE_COMBINED_BYTECODES
-   optimize_block (h->body);
-#endif
-   end_define_function ();
-   pop_block_context ();
+   if ((_pSLang_Error == 0)
+       && (0 == _pSLparse_lazy_body (llt, body)))
+     status = end_lazy_function (h);
 
-   /* A function is only defined at top-level */
-   if (This_Compile_Block_Type != COMPILE_BLOCK_TYPE_TOP_LEVEL)
+   if (status == -1)
      {
-	_pSLang_verror (SL_INTERNAL_ERROR, "Not at top-level");
-	return -1;
+	if (_pSLang_Error != SL_Usage_Error)
+	  (void) _pSLerr_set_line_info (h->file, (int) This_Compile_Linenum, NULL);
+	(void) _pSLerr_set_line_info (h->file, (int) This_Compile_Linenum, "");
+	reset_compiler_state ();
      }
-   Compile_ByteCode_Ptr = This_Compile_Block;
-   return 0;
+
+   if (This_Compile_Block_Type == COMPILE_BLOCK_TYPE_TOP_LEVEL)
+     {
+	Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
+	if (lang_free_branch (This_Compile_Block))
+	  {
+	     SLfree ((char *) This_Compile_Block);
+	     This_Compile_Block = NULL;
+	  }
+     }
+   (void) pop_block_context ();
+   (void) pop_compile_context ();
+   _pSLcompile_ptr = compile;
+   (void) _pSLerr_resume_messages ();
+
+   SLdeallocate_load_type (llt);
+   _pSLparse_free_lazy_body (body);
+   return status;
 }
 
 static int check_linkage (SLCONST char *name, unsigned long hash, int check_static)
@@ -8596,10 +11280,10 @@ static void lang_end_block (void)
    Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
    branch = This_Compile_Block;  This_Compile_Block = NULL;
 
-#if USE_COMBINED_BYTECODES
-   optimize_block (branch);
-#endif
-
+   /* The optimization is deferred until the enclosing function or top-level
+    * block is complete.  This permits the block to be recorded in a bytecode
+    * image, or moved into the enclosing block if its condition is constant.
+    */
    pop_block_context ();
    node = Compile_ByteCode_Ptr++;
 
@@ -8613,7 +11297,8 @@ static int lang_begin_block (void)
    return push_block_context (COMPILE_BLOCK_TYPE_BLOCK);
 }
 
-static int lang_check_space (void)
+/* Make room for num objects at Compile_ByteCode_Ptr */
+static int lang_check_space_for (unsigned int num)
 {
    size_t dn, n;
    SLBlock_Type *p;
@@ -8624,14 +11309,15 @@ static int lang_check_space (void)
 	return -1;
      }
 
-   /* Allow 1 extra for terminator */
-   if (Compile_ByteCode_Ptr + 1 < This_Compile_Block_Max)
+   if (Compile_ByteCode_Ptr + num < This_Compile_Block_Max)
      return 0;
 
    n = (This_Compile_Block_Max - p);
 
    /* enlarge the space by 20 objects */
    dn = 20;
+   if (dn <= num)
+     dn += num;
 
    if (NULL == (p = (SLBlock_Type *) _SLrecalloc((char *)p, n+dn, sizeof(SLBlock_Type))))
      return -1;
@@ -8645,6 +11331,12 @@ static int lang_check_space (void)
    return 0;
 }
 
+static int lang_check_space (void)
+{
+   /* Allow 1 extra for terminator */
+   return lang_check_space_for (1);
+}
+
 static int add_global_variable (SLCONST char *name, char name_type, unsigned long hash,
 				SLang_NameSpace_Type *ns)
 {
@@ -8675,6 +11367,18 @@ static int add_global_variable (SLCONST char *name, char name_type, unsigned lon
    return 0;
 }
 
+/* This is used by the compiler to declare a variable at top-level */
+static int declare_global_variable (SLCONST char *name, char name_type, unsigned long hash,
+				    SLang_NameSpace_Type *ns)
+{
+   if (-1 == add_global_variable (name, name_type, hash, ns))
+     return -1;
+
+   if (Image_Writer != NULL)
+     record_image_variable (name, (unsigned char) name_type, ns);
+   return 0;
+}
+
 int SLadd_global_variable (SLCONST char *name)
 {
    if (-1 == init_interpreter ())
@@ -8765,10 +11469,16 @@ static void reset_active_interpreter (void)
 
 static void free_local_variables (void)
 {
-   while (Local_Variable_Frame > Local_Variable_Stack)
+   while (1)
      {
-	SLang_free_object (Local_Variable_Frame);
-	Local_Variable_Frame--;
+	while (Local_Variable_Frame > Local_Stack_Chunks[Local_Stack_Chunk].base)
+	  {
+	     SLang_free_object (Local_Variable_Frame);
+	     Local_Variable_Frame--;
+	  }
+	if (Local_Stack_Chunk == 0)
+	  break;
+	pop_local_stack_chunk ();
      }
 }
 
@@ -8821,27 +11531,385 @@ static void compile_line_info (_pSLang_BC_Type bc_main_type, SLFUTURE_CONST char
 {
    Linenum_Info_Type *info;
 
-   if (NULL == (info = (Linenum_Info_Type *) SLmalloc (sizeof (Linenum_Info_Type))))
-     return;
+   if (NULL == (info = (Linenum_Info_Type *) SLmalloc (sizeof (Linenum_Info_Type))))
+     return;
+
+   info->linenum = (int) linenum;
+   if (file == NULL)
+     file = "";
+
+   if (NULL == (info->filename = SLang_create_slstring (file)))
+     {
+	SLfree ((char *) info);
+	return;
+     }
+   Compile_ByteCode_Ptr->bc_main_type = bc_main_type;
+   Compile_ByteCode_Ptr->b.line_info = info;
+   lang_try_now ();
+}
+
+static void set_line_number_info (long val)
+{
+   This_Compile_Linenum = (unsigned int) val;
+}
+#endif
+
+#if SLANG_OPTIMIZE_FOR_SPEED
+/*{{{ Constant folding */
+
+/* Operations whose operands are numeric literals or intrinsic constants are
+ * carried out as they are compiled, e.g., 2*PI/360 is compiled as a single
+ * literal.  Similarly, an if statement whose condition is constant is
+ * replaced by the block that would be executed.  Folding takes place only
+ * within blocks and function bodies since the top-level code is executed as
+ * it is compiled.  Operations that would fail, e.g., an integer division by
+ * 0, are left for the interpreter to report when they are executed.
+ */
+
+/* Push the value of b if it is a numeric constant that may be folded */
+static int push_folding_constant (SLBlock_Type *b)
+{
+   SLang_Class_Type *cl;
+
+   if (b < This_Compile_Block)
+     return -1;
+
+   switch (b->bc_main_type)
+     {
+      case SLANG_BC_LITERAL_INT:
+	return push_int_object (b->bc_sub_type, (int) b->b.l_blk);
+
+      case SLANG_BC_LITERAL:
+	switch (b->bc_sub_type)
+	  {
+	   case SLANG_CHAR_TYPE:
+	   case SLANG_UCHAR_TYPE:
+	   case SLANG_SHORT_TYPE:
+	   case SLANG_USHORT_TYPE:
+	   case SLANG_INT_TYPE:
+	   case SLANG_UINT_TYPE:
+	   case SLANG_LONG_TYPE:
+	   case SLANG_ULONG_TYPE:
+#if SLANG_HAS_FLOAT
+	   case SLANG_FLOAT_TYPE:
+#endif
+	     GET_BUILTIN_CLASS(cl, b->bc_sub_type);
+	     return (*cl->cl_push_literal) (b->bc_sub_type, (VOID_STAR) &b->b.ptr_blk);
+	  }
+	return -1;
+
+#if SLANG_HAS_FLOAT
+      case SLANG_BC_LITERAL_DBL:
+	if (b->bc_sub_type != SLANG_DOUBLE_TYPE)
+	  return -1;
+	return push_double_object (SLANG_DOUBLE_TYPE, *b->b.double_blk);
+#endif
+      default:
+	break;
+     }
+
+   /* The values of the named constants are not known until an image is
+    * loaded, so these are not folded when an image is being recorded.
+    */
+   if (Image_Writer != NULL)
+     return -1;
+
+   switch (b->bc_main_type)
+     {
+      case SLANG_BC_ICONST:
+	return push_int_object (b->b.iconst_blk->data_type, b->b.iconst_blk->value);
+#if SLANG_HAS_FLOAT
+      case SLANG_BC_DCONST:
+	return push_double_object (SLANG_DOUBLE_TYPE, b->b.dconst_blk->d);
+#endif
+      default:
+	break;
+     }
+   return -1;
+}
+
+static int get_folding_constant (SLBlock_Type *b, SLang_Object_Type *obj)
+{
+   if (-1 == push_folding_constant (b))
+     return -1;
+   return pop_object (obj);
+}
+
+static int get_folded_integer (SLang_Object_Type *obj, long *lp)
+{
+   switch (obj->o_data_type)
+     {
+      case SLANG_CHAR_TYPE: *lp = obj->v.char_val; break;
+      case SLANG_UCHAR_TYPE: *lp = obj->v.uchar_val; break;
+      case SLANG_SHORT_TYPE: *lp = obj->v.short_val; break;
+      case SLANG_USHORT_TYPE: *lp = obj->v.ushort_val; break;
+      case SLANG_INT_TYPE: *lp = obj->v.int_val; break;
+      case SLANG_UINT_TYPE: *lp = (long) obj->v.uint_val; break;
+      case SLANG_LONG_TYPE: *lp = obj->v.long_val; break;
+      case SLANG_ULONG_TYPE: *lp = (long) obj->v.ulong_val; break;
+      default:
+	return -1;
+     }
+   return 0;
+}
+
+static void free_folded_literal (SLBlock_Type *b)
+{
+   SLang_Class_Type *cl;
+
+   if ((b->bc_main_type == SLANG_BC_LITERAL)
+       || (b->bc_main_type == SLANG_BC_LITERAL_DBL))
+     {
+	GET_BUILTIN_CLASS(cl, b->bc_sub_type);
+	(*cl->cl_byte_code_destroy) (b->bc_sub_type, (VOID_STAR) &b->b.ptr_blk);
+     }
+}
+
+/* Pop the result of an operation and replace the objects from b up to
+ * Compile_ByteCode_Ptr by a literal with its value.
+ */
+static int replace_by_folded_literal (SLBlock_Type *b)
+{
+   SLang_Object_Type obj;
+   SLBlock_Type lit;
+   long l;
+
+   if (-1 == pop_object (&obj))
+     return -1;
+
+   memset ((char *) &lit, 0, sizeof (SLBlock_Type));
+   lit.bc_sub_type = obj.o_data_type;
+   lit.bc_flags = BC_LITERAL_MASK;
+   if (0 == get_folded_integer (&obj, &l))
+     {
+	lit.bc_main_type = (obj.o_data_type == SLANG_INT_TYPE)
+	  ? SLANG_BC_LITERAL_INT : SLANG_BC_LITERAL;
+	lit.b.l_blk = l;
+     }
+#if SLANG_HAS_FLOAT
+   else if (obj.o_data_type == SLANG_DOUBLE_TYPE)
+     {
+	if (NULL == (lit.b.double_blk = (double *) SLmalloc (sizeof (double))))
+	  return -1;
+	*lit.b.double_blk = obj.v.double_val;
+	lit.bc_main_type = SLANG_BC_LITERAL_DBL;
+     }
+   else if (obj.o_data_type == SLANG_FLOAT_TYPE)
+     {
+	lit.b.float_blk = obj.v.float_val;
+	lit.bc_main_type = SLANG_BC_LITERAL;
+     }
+#endif
+   else
+     {
+	SLang_free_object (&obj);
+	return -1;
+     }
+
+   lit.linenum = b->linenum;
+   while (Compile_ByteCode_Ptr > b)
+     {
+	Compile_ByteCode_Ptr--;
+	free_folded_literal (Compile_ByteCode_Ptr);
+	Compile_ByteCode_Ptr->bc_main_type = 0;
+     }
+   *b = lit;
+   Compile_ByteCode_Ptr = b + 1;
+   return 0;
+}
+
+static int fold_binary (int op)
+{
+   SLang_Object_Type a, b;
+   SLang_Class_Type *a_cl, *b_cl, *c_cl;
+   SLBlock_Type *bc;
+   long divisor;
+
+   bc = Compile_ByteCode_Ptr - 2;
+   if ((-1 == get_folding_constant (bc, &a))
+       || (-1 == get_folding_constant (bc + 1, &b)))
+     return -1;
+
+   GET_BUILTIN_CLASS(a_cl, a.o_data_type);
+   GET_BUILTIN_CLASS(b_cl, b.o_data_type);
+   if (NULL == _pSLclass_get_binary_fun (op, a_cl, b_cl, &c_cl, 0))
+     return -1;
+
+   if (((op == SLANG_DIVIDE) || (op == SLANG_MOD))
+       && (0 == get_folded_integer (&b, &divisor))
+       && (divisor == 0))
+     return -1;
+
+   if (-1 == do_binary_ab (op, &a, &b))
+     return -1;
+
+   return replace_by_folded_literal (bc);
+}
+
+/* Here bc is the first object of the operation, and the operand is at
+ * bc + offset.
+ */
+static int fold_unary (SLBlock_Type *bc, unsigned int offset, int op, int unary_type)
+{
+   int (*r)(int, SLtype, SLtype *);
+   SLang_Object_Type a;
+   SLang_Class_Type *a_cl;
+   SLtype c_type;
+
+   if (bc < This_Compile_Block)
+     return -1;
+   if (-1 == get_folding_constant (bc + offset, &a))
+     return -1;
+
+   GET_BUILTIN_CLASS(a_cl, a.o_data_type);
+   if (unary_type == SLANG_BC_MATH_UNARY)
+     r = (a_cl->cl_math_op == NULL) ? NULL : a_cl->cl_math_op_result_type;
+   else
+     r = (a_cl->cl_unary_op == NULL) ? NULL : a_cl->cl_unary_op_result_type;
+   if ((r == NULL) || (1 != (*r) (op, a.o_data_type, &c_type)))
+     return -1;
+
+   if (-1 == do_unary_op (op, &a, unary_type))
+     return -1;
+
+   return replace_by_folded_literal (bc);
+}
+
+/* A math function such as sqrt(2.0) is compiled as a call of start_arg_list,
+ * the argument, a call of end_arg_list, and the function itself.
+ */
+static int fold_math_unary (SLang_Math_Unary_Type *nt)
+{
+   SLBlock_Type *bc = Compile_ByteCode_Ptr - 3;
+
+   if ((bc < This_Compile_Block)
+       || (bc->bc_main_type != SLANG_BC_CALL_DIRECT)
+       || (bc->b.call_function != start_arg_list)
+       || ((bc+2)->bc_main_type != SLANG_BC_CALL_DIRECT)
+       || ((bc+2)->b.call_function != end_arg_list))
+     return -1;
+
+   return fold_unary (bc, 1, nt->unary_op, SLANG_BC_MATH_UNARY);
+}
+
+/* Returns 0 if the block may be moved into the enclosing one */
+static int is_inlinable_block (SLBlock_Type *b)
+{
+   while (b->bc_main_type != SLANG_BC_LAST_BLOCK)
+     {
+	/* ERROR_BLOCKs and the like belong to the block, and a label
+	 * terminates it.
+	 */
+	if (b->bc_main_type == SLANG_BC_LABEL)
+	  return -1;
+	if ((b->bc_main_type == SLANG_BC_BLOCK)
+	    && (b->bc_sub_type >= SLANG_BCST_ERROR_BLOCK)
+	    && (b->bc_sub_type <= SLANG_BCST_USER_BLOCK4))
+	  return -1;
+	b++;
+     }
+   return 0;
+}
+
+/* Replace the objects from dest up to Compile_ByteCode_Ptr by the contents
+ * of the block keep, and free the block discard.  Either may be NULL.
+ */
+static int replace_by_block (SLBlock_Type *dest, SLBlock_Type *keep, SLBlock_Type *discard)
+{
+   SLBlock_Type *keep_branch = NULL, *discard_branch = NULL, *end;
+   unsigned int n = 0;
+
+   if (keep != NULL)
+     {
+	keep_branch = keep->b.blk;
+	if (-1 == is_inlinable_block (keep_branch))
+	  return -1;
+	while (keep_branch[n].bc_main_type != SLANG_BC_LAST_BLOCK)
+	  n++;
+     }
+   if (discard != NULL)
+     discard_branch = discard->b.blk;
+
+   /* The compile buffer may be moved to make room */
+   end = Compile_ByteCode_Ptr;
+   Compile_ByteCode_Ptr = dest;
+   if (-1 == lang_check_space_for (n + 1))
+     {
+	Compile_ByteCode_Ptr = end;
+	return -1;
+     }
+
+   if (discard_branch != NULL)
+     {
+	if (lang_free_branch (discard_branch))
+	  SLfree ((char *) discard_branch);
+     }
+   if (keep_branch != NULL)
+     {
+	memcpy ((char *) Compile_ByteCode_Ptr, (char *) keep_branch, n * sizeof (SLBlock_Type));
+	Compile_ByteCode_Ptr += n;
+	SLfree ((char *) keep_branch);
+     }
+   Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_LAST_BLOCK;
+   return 0;
+}
+
+/* This is called before the directive has been applied to the block */
+static int fold_conditional_block (int sub_type)
+{
+   SLBlock_Type *bc, *a, *b;
+   SLang_Object_Type obj;
+   long test;
+
+   b = Compile_ByteCode_Ptr - 1;
+   if ((b < This_Compile_Block) || (b->bc_main_type != SLANG_BC_BLOCK))
+     return -1;
+
+   switch (sub_type)
+     {
+      case SLANG_BCST_IF:
+      case SLANG_BCST_IFNOT:
+	a = NULL;
+	bc = b - 1;
+	break;
+
+      case SLANG_BCST_ELSE:
+      case SLANG_BCST_NOTELSE:
+	/* The condition is followed by the blocks for the non-zero and zero
+	 * values, in that order for else, or the reverse for notelse.
+	 */
+	a = b - 1;
+	bc = a - 1;
+	if ((a < This_Compile_Block)
+	    || (a->bc_main_type != SLANG_BC_BLOCK)
+	    || (a->bc_sub_type != 0))
+	  return -1;
+	break;
+
+      default:
+	return -1;
+     }
+
+   if (-1 == get_folding_constant (bc, &obj))
+     return -1;
+   if (-1 == get_folded_integer (&obj, &test))
+     return -1;
 
-   info->linenum = (int) linenum;
-   if (file == NULL)
-     file = "";
+   if ((sub_type == SLANG_BCST_IFNOT) || (sub_type == SLANG_BCST_NOTELSE))
+     test = (test == 0);
 
-   if (NULL == (info->filename = SLang_create_slstring (file)))
+   if (a == NULL)
      {
-	SLfree ((char *) info);
-	return;
+	if (test)
+	  return replace_by_block (bc, b, NULL);
+	return replace_by_block (bc, NULL, b);
      }
-   Compile_ByteCode_Ptr->bc_main_type = bc_main_type;
-   Compile_ByteCode_Ptr->b.line_info = info;
-   lang_try_now ();
+   if (test)
+     return replace_by_block (bc, a, b);
+   return replace_by_block (bc, b, a);
 }
 
-static void set_line_number_info (long val)
-{
-   This_Compile_Linenum = (unsigned int) val;
-}
+/*}}}*/
 #endif
 
 static void compile_directive (unsigned char sub_type, int delay_inner_interp)
@@ -8850,6 +11918,12 @@ static void compile_directive (unsigned char sub_type, int delay_inner_interp)
     * only possible when a block is available.
     */
 
+#if SLANG_OPTIMIZE_FOR_SPEED
+   if ((delay_inner_interp == 0)
+       && (0 == fold_conditional_block (sub_type)))
+     return;
+#endif
+
    /* use BLOCK */
    Compile_ByteCode_Ptr--;
    Compile_ByteCode_Ptr->bc_sub_type = sub_type;
@@ -8865,6 +11939,11 @@ static void compile_directive (unsigned char sub_type, int delay_inner_interp)
 
 static void compile_unary (int op, _pSLang_BC_Type mt)
 {
+#if SLANG_OPTIMIZE_FOR_SPEED
+   if ((mt == SLANG_BC_UNARY)
+       && (0 == fold_unary (Compile_ByteCode_Ptr - 1, 0, op, SLANG_BC_UNARY)))
+     return;
+#endif
    Compile_ByteCode_Ptr->bc_main_type = mt;
    Compile_ByteCode_Ptr->b.i_blk = op;
    Compile_ByteCode_Ptr->bc_sub_type = 0;
@@ -8874,6 +11953,10 @@ static void compile_unary (int op, _pSLang_BC_Type mt)
 
 static void compile_binary (int op)
 {
+#if SLANG_OPTIMIZE_FOR_SPEED
+   if (0 == fold_binary (op))
+     return;
+#endif
    Compile_ByteCode_Ptr->bc_main_type = SLANG_BC_BINARY;
    Compile_ByteCode_Ptr->b.i_blk = op;
    Compile_ByteCode_Ptr->bc_sub_type = 0;
@@ -9000,6 +12083,11 @@ static void compile_hashed_identifier (SLCONST char *name, unsigned long hash, _
      }
 
    name_type = (_pSLang_BC_Type)entry->name_type;
+#if SLANG_OPTIMIZE_FOR_SPEED
+   if ((name_type == SLANG_BC_MATH_UNARY)
+       && (0 == fold_math_unary ((SLang_Math_Unary_Type *) entry)))
+     return;
+#endif
    Compile_ByteCode_Ptr->bc_main_type = name_type;
 
    if (name_type == SLANG_LVARIABLE)   /* == SLANG_BC_LVARIABLE */
@@ -9215,7 +12303,7 @@ static SLang_Name_Type *locate_hashed_name_autodeclare (SLFUTURE_CONST char *nam
        && (-1 == (*SLang_Auto_Declare_Var_Hook) (name)))
      return NULL;
 
-   if ((-1 == add_global_variable (name, SLANG_GVARIABLE, hash, This_Static_NameSpace))
+   if ((-1 == declare_global_variable (name, SLANG_GVARIABLE, hash, This_Static_NameSpace))
        || (NULL == (v = locate_hashed_name (name, hash, 1))))
      return NULL;
 
@@ -9341,6 +12429,7 @@ compile_deref_assign (_pSLang_Token_Type *t)
 static void compile_dot (_pSLang_Token_Type *t, _pSLang_BC_Type bc_main_type)
 {
    Compile_ByteCode_Ptr->bc_main_type = bc_main_type;
+   Compile_ByteCode_Ptr->bc_sub_type = 0;   /* field index cache */
    Compile_ByteCode_Ptr->b.s_blk = _pSLstring_dup_hashed_string(t->v.s_val, t->hash);
    lang_try_now ();
 }
@@ -9359,6 +12448,7 @@ static void compile_ref (SLFUTURE_CONST char *name, unsigned long hash)
      {
 	main_type = SLANG_BC_LOBJPTR;
 	Compile_ByteCode_Ptr->b.i_blk = ((SLang_Local_Var_Type *)entry)->local_var_number;
+	Function_Tail_Calls_Disabled = 1;
      }
    else
      {
@@ -9383,6 +12473,13 @@ static void compile_break (_pSLang_BC_Type break_type,
 	return;
      }
 
+   /* return f(...) */
+   if ((break_type == SLANG_BC_RETURN)
+       && (Compile_ByteCode_Ptr != This_Compile_Block)
+       && (((Compile_ByteCode_Ptr-1)->bc_main_type == SLANG_BC_FUNCTION)
+	   || ((Compile_ByteCode_Ptr-1)->bc_main_type == SLANG_BC_PFUNCTION)))
+     (Compile_ByteCode_Ptr-1)->bc_main_type = SLANG_BC_TAIL_CALL;
+
    Compile_ByteCode_Ptr->bc_main_type = break_type;
    Compile_ByteCode_Ptr->bc_sub_type = 0;
    Compile_ByteCode_Ptr->b.i_blk = opt_val;
@@ -9396,7 +12493,7 @@ static void compile_public_variable_mode (_pSLang_Token_Type *t)
      {
 	if (-1 == check_linkage (t->v.s_val, t->hash, 1))
 	  return;
-	add_global_variable (t->v.s_val, SLANG_GVARIABLE, t->hash, Global_NameSpace);
+	declare_global_variable (t->v.s_val, SLANG_GVARIABLE, t->hash, Global_NameSpace);
      }
    else if (t->type == CBRACKET_TOKEN)
      Compile_Mode_Function = compile_basic_token_mode;
@@ -9427,7 +12524,7 @@ static void compile_static_variable_mode (_pSLang_Token_Type *t)
      {
 	if (-1 == check_linkage (t->v.s_val, t->hash, 0))
 	  return;
-	add_global_variable (t->v.s_val, SLANG_GVARIABLE, t->hash, This_Static_NameSpace);
+	declare_global_variable (t->v.s_val, SLANG_GVARIABLE, t->hash, This_Static_NameSpace);
      }
    else if (t->type == CBRACKET_TOKEN)
      Compile_Mode_Function = compile_basic_token_mode;
@@ -9438,7 +12535,7 @@ static void compile_static_variable_mode (_pSLang_Token_Type *t)
 static void compile_private_variable_mode (_pSLang_Token_Type *t)
 {
    if (t->type == IDENT_TOKEN)
-     add_global_variable (t->v.s_val, SLANG_PVARIABLE, t->hash, This_Private_NameSpace);
+     declare_global_variable (t->v.s_val, SLANG_PVARIABLE, t->hash, This_Private_NameSpace);
    else if (t->type == CBRACKET_TOKEN)
      Compile_Mode_Function = compile_basic_token_mode;
    else
@@ -9536,7 +12633,11 @@ static void compile_directive_mode (_pSLang_Token_Type *t)
 	     break;
 	  }
 	if (0 == check_error_block ())
-	  bc_sub_type = SLANG_BCST_ERROR_BLOCK;
+	  {
+	     bc_sub_type = SLANG_BCST_ERROR_BLOCK;
+	     if (Lang_Defining_Function)
+	       Function_Tail_Calls_Disabled = 1;
+	  }
 	break;
 
       case USRBLK0_TOKEN:
@@ -10233,11 +13334,13 @@ typedef struct _Compile_Context_Type
    int local_variable_number;
    char *local_variable_names[SLANG_MAX_LOCAL_VARIABLES];
    unsigned int function_args_number;
+   int function_tail_calls_disabled;
    void (*compile_mode_function)(_pSLang_Token_Type *);
    SLFUTURE_CONST char *compile_filename;
    unsigned int compile_linenum;
    _pSLang_Function_Type *current_function;
    Function_Header_Type *current_function_header;
+   Image_Writer_Type *image_writer;
 }
 Compile_Context_Type;
 
@@ -10268,6 +13371,7 @@ static int pop_compile_context (void)
    memcpy ((char *)Local_Variable_Names, (char *)cc->local_variable_names, sizeof(Local_Variable_Names));
 
    Function_Args_Number = cc->function_args_number;
+   Function_Tail_Calls_Disabled = cc->function_tail_calls_disabled;
 
    SLang_free_slstring ((char *) This_Compile_Filename);
    This_Compile_Filename = cc->compile_filename;
@@ -10278,6 +13382,12 @@ static int pop_compile_context (void)
 
    Locals_NameSpace = cc->locals_namespace;
 
+   /* A context whose image was not handed off by _pSLcompile_pop_context was
+    * abandoned, e.g., by SLang_restart.
+    */
+   free_image_writer (Image_Writer);
+   Image_Writer = cc->image_writer;
+
    /* These should be when returning from a compile context */
    Lang_Return = 0;
    Lang_Break = 0;
@@ -10333,10 +13443,12 @@ static int push_compile_context (SLFUTURE_CONST char *name)
    memcpy ((char *)cc->local_variable_names, (char *)Local_Variable_Names, sizeof(Local_Variable_Names));
 
    cc->function_args_number = Function_Args_Number;
+   cc->function_tail_calls_disabled = Function_Tail_Calls_Disabled;
    cc->compile_mode_function = Compile_Mode_Function;
 
    cc->current_function_header = Current_Function_Header;
    cc->current_function = Current_Function;
+   cc->image_writer = Image_Writer;
 
    cc->next = Compile_Context_Stack;
    Compile_Context_Stack = cc;
@@ -10346,10 +13458,12 @@ static int push_compile_context (SLFUTURE_CONST char *name)
    Default_Define_Function = define_public_function;
    Lang_Defining_Function = 0;
    Function_Args_Number = 0;
+   Function_Tail_Calls_Disabled = 0;
    Local_Variable_Number = 0;
    Locals_NameSpace = NULL;
    Current_Function = NULL;
    Current_Function_Header = NULL;
+   Image_Writer = NULL;
 
    This_Static_NameSpace = NULL;       /* allocated by caller-- here for completeness */
    This_Private_NameSpace = NULL;       /* allocated by caller-- here for completeness */
@@ -10385,6 +13499,49 @@ void _pSLang_signal_interrupt (void)
    (void) _pSLsig_block_and_call (set_interrupt_state, (VOID_STAR)&mask);
 }
 
+/* This is called from the SIGPROF handler of the profiler.  Signals are not
+ * blocked here since the worst that can happen is that the flag is lost,
+ * and then the ticks get counted by the next sample.
+ */
+void _pSLang_signal_profiler (void)
+{
+   Handle_Interrupt |= INTERRUPT_PROFILE;
+}
+
+/* Record the stack of active functions for the profiler, innermost first */
+static void take_profile_sample (SLBlock_Type *addr)
+{
+   _pSLang_Profile_Frame_Type frames[SLPROF_MAX_FRAMES];
+   Function_Stack_Type *s;
+   unsigned int n;
+   int mask = INTERRUPT_PROFILE;
+
+   (void) _pSLsig_block_and_call (unset_interrupt_state, (VOID_STAR) &mask);
+
+   frames[0].function = NULL;
+   frames[0].file = This_Compile_Filename;
+   if (Current_Function != NULL)
+     frames[0].function = Current_Function->name;
+   if (Current_Function_Header != NULL)
+     frames[0].file = Current_Function_Header->file;
+   frames[0].line = addr->linenum;
+   n = 1;
+
+   s = Function_Stack_Ptr;
+   while ((s > Function_Stack) && (n < SLPROF_MAX_FRAMES))
+     {
+	s--;
+	/* Skip the frame of the application that loaded the first file */
+	if ((s->function == NULL) && (s->file == NULL))
+	  continue;
+	frames[n].function = (s->function != NULL) ? s->function->name : NULL;
+	frames[n].file = s->file;
+	frames[n].line = s->line;
+	n++;
+     }
+   _pSLprof_add_sample (frames, n);
+}
+
 #define CHECK_SIGNALS_NOT_REENTRANT 0
 static int check_signals (void)
 {
@@ -10435,6 +13592,8 @@ int _pSLang_check_signals_hook (VOID_STAR unused)
 
 static void free_stacks (void)
 {
+   unsigned int i;
+
    /* SLfree can grok NULLs */
    SLfree ((char *)Num_Args_Stack); Num_Args_Stack = NULL;
    SLfree ((char *)Run_Stack); Run_Stack = NULL;
@@ -10443,11 +13602,176 @@ static void free_stacks (void)
 #if SLANG_HAS_QUALIFIERS
    SLfree ((char *)Function_Qualifiers_Stack); Function_Qualifiers_Stack = NULL;
 #endif
-   SLfree ((char *)Local_Variable_Stack); Local_Variable_Stack = NULL;
+   for (i = 0; i < MAX_LOCAL_STACK_CHUNKS; i++)
+     {
+	SLfree ((char *)Local_Stack_Chunks[i].base);
+	Local_Stack_Chunks[i].base = NULL;
+     }
+   Local_Stack_Chunk = 0;
+   Local_Variable_Frame = NULL;
+   SLfree ((char *)Function_Stack); Function_Stack = Function_Stack_Ptr = NULL;
+   Run_Stack_Len = Frame_Stack_Len = Frame_Stack_Max = 0;
+}
+
+/* Interpreter instances.  The state of an instance that is not in use is
+ * kept in one of these structures.  The instance created implicitly by the
+ * first call to init_interpreter is Default_Interp.  Only the first one has
+ * static tables linked into its namespaces.
+ */
+struct _pSLang_Interp_Type
+{
+   SLang_NameSpace_Type *global_namespace;
+   SLang_NameSpace_Type *namespace_list;
+   SLang_NameSpace_Type *private_namespace;
+   SLang_NameSpace_Type *static_namespace;
+   SLang_NameSpace_Type *locals_namespace;
+   void (*variable_mode) (_pSLang_Token_Type *);
+   void (*define_function) (SLFUTURE_CONST char *, unsigned long);
+
+   SLang_Object_Type *run_stack;
+   SLang_Object_Type *stack_pointer;
+   SLang_Object_Type *stack_pointer_max;
+   unsigned int run_stack_len;
+
+   int *num_args_stack;
+   unsigned int *frame_pointer_stack;
+#if SLANG_HAS_QUALIFIERS
+   SLang_Struct_Type **function_qualifiers_stack;
+#endif
+   Function_Stack_Type *function_stack;
+   Function_Stack_Type *function_stack_ptr;
+   unsigned int frame_stack_len;
+   unsigned int frame_stack_max;
+   SLang_Object_Type *frame_pointer;
+   unsigned int frame_pointer_depth;
+   unsigned int recursion_depth;
+   int num_function_args;
+
+   Local_Stack_Chunk_Type local_stack_chunks[MAX_LOCAL_STACK_CHUNKS];
+   unsigned int local_stack_chunk;
+   SLang_Object_Type *local_variable_frame;
+
+   unsigned int max_stack_len;
+   unsigned int max_local_stack_len;
+   unsigned int max_recursion_depth;
+
+   int auto_declare_globals;
+   int lazy_compile;
+   int bytecode_cache;
+   int trace;
+   int traceback;
+   SLFUTURE_CONST char *trace_function;
+#if SLANG_HAS_BOSEOS
+   SLang_Name_Type *boseos_hooks[SLANG_NUM_BOSEOS_HOOKS];
+#endif
+};
+
+static SLang_Interp_Type Default_Interp;
+static SLang_Interp_Type *Current_Interp = &Default_Interp;
+
+static void save_interp_state (SLang_Interp_Type *interp)
+{
+   interp->global_namespace = Global_NameSpace;
+   interp->namespace_list = _pSLns_swap_namespace_list (NULL);
+   interp->private_namespace = This_Private_NameSpace;
+   interp->static_namespace = This_Static_NameSpace;
+   interp->locals_namespace = Locals_NameSpace;
+   interp->variable_mode = Default_Variable_Mode;
+   interp->define_function = Default_Define_Function;
+
+   interp->run_stack = Run_Stack;
+   interp->stack_pointer = Stack_Pointer;
+   interp->stack_pointer_max = Stack_Pointer_Max;
+   interp->run_stack_len = Run_Stack_Len;
+
+   interp->num_args_stack = Num_Args_Stack;
+   interp->frame_pointer_stack = Frame_Pointer_Stack;
+#if SLANG_HAS_QUALIFIERS
+   interp->function_qualifiers_stack = Function_Qualifiers_Stack;
+#endif
+   interp->function_stack = Function_Stack;
+   interp->function_stack_ptr = Function_Stack_Ptr;
+   interp->frame_stack_len = Frame_Stack_Len;
+   interp->frame_stack_max = Frame_Stack_Max;
+   interp->frame_pointer = Frame_Pointer;
+   interp->frame_pointer_depth = Frame_Pointer_Depth;
+   interp->recursion_depth = Recursion_Depth;
+   interp->num_function_args = SLang_Num_Function_Args;
+
+   memcpy ((char *) interp->local_stack_chunks, (char *) Local_Stack_Chunks, sizeof (Local_Stack_Chunks));
+   interp->local_stack_chunk = Local_Stack_Chunk;
+   interp->local_variable_frame = Local_Variable_Frame;
+
+   interp->max_stack_len = Max_Stack_Len;
+   interp->max_local_stack_len = Max_Local_Stack_Len;
+   interp->max_recursion_depth = Max_Recursion_Depth;
+
+   interp->auto_declare_globals = _pSLang_Auto_Declare_Globals;
+   interp->lazy_compile = _pSLang_Lazy_Compile;
+   interp->bytecode_cache = _pSLang_Bytecode_Cache;
+   interp->trace = _pSLang_Trace;
+   interp->traceback = SLang_Traceback;
+   interp->trace_function = Trace_Function;
+#if SLANG_HAS_BOSEOS
+   memset ((char *) interp->boseos_hooks, 0, sizeof (interp->boseos_hooks));
+   _pSLang_swap_boseos_hooks (interp->boseos_hooks);
+#endif
+}
+
+static void load_interp_state (SLang_Interp_Type *interp)
+{
+   Global_NameSpace = interp->global_namespace;
+   (void) _pSLns_swap_namespace_list (interp->namespace_list);
+   This_Private_NameSpace = interp->private_namespace;
+   This_Static_NameSpace = interp->static_namespace;
+   Locals_NameSpace = interp->locals_namespace;
+   Default_Variable_Mode = interp->variable_mode;
+   Default_Define_Function = interp->define_function;
+
+   Run_Stack = interp->run_stack;
+   Stack_Pointer = interp->stack_pointer;
+   Stack_Pointer_Max = interp->stack_pointer_max;
+   Run_Stack_Len = interp->run_stack_len;
+
+   Num_Args_Stack = interp->num_args_stack;
+   Frame_Pointer_Stack = interp->frame_pointer_stack;
+#if SLANG_HAS_QUALIFIERS
+   Function_Qualifiers_Stack = interp->function_qualifiers_stack;
+#endif
+   Function_Stack = interp->function_stack;
+   Function_Stack_Ptr = interp->function_stack_ptr;
+   Frame_Stack_Len = interp->frame_stack_len;
+   Frame_Stack_Max = interp->frame_stack_max;
+   Frame_Pointer = interp->frame_pointer;
+   Frame_Pointer_Depth = interp->frame_pointer_depth;
+   Recursion_Depth = interp->recursion_depth;
+   SLang_Num_Function_Args = interp->num_function_args;
+
+   memcpy ((char *) Local_Stack_Chunks, (char *) interp->local_stack_chunks, sizeof (Local_Stack_Chunks));
+   Local_Stack_Chunk = interp->local_stack_chunk;
+   Local_Variable_Frame = interp->local_variable_frame;
+
+   Max_Stack_Len = interp->max_stack_len;
+   Max_Local_Stack_Len = interp->max_local_stack_len;
+   Max_Recursion_Depth = interp->max_recursion_depth;
+   set_local_stack_max ();
+
+   _pSLang_Auto_Declare_Globals = interp->auto_declare_globals;
+   _pSLang_Lazy_Compile = interp->lazy_compile;
+   _pSLang_Bytecode_Cache = interp->bytecode_cache;
+   _pSLang_Trace = interp->trace;
+   SLang_Traceback = interp->traceback;
+   Trace_Function = interp->trace_function;
+#if SLANG_HAS_BOSEOS
+   _pSLang_swap_boseos_hooks (interp->boseos_hooks);
+#endif
 }
 
 static void delete_interpreter (void)
 {
+   /* The cleanup functions run at exit may be called by any instance */
+   (void) SLang_set_interp (&Default_Interp);
+
    if (Run_Stack != NULL)
      {
 	/* Allow any object destructors to run */
@@ -10467,12 +13791,11 @@ static void delete_interpreter (void)
    free_stacks ();
 }
 
-static int init_interpreter (void)
+/* Allocate the global namespace and the stacks of the current instance */
+static int create_interpreter (void)
 {
    SLang_NameSpace_Type *ns;
-
-   if (Global_NameSpace != NULL)
-     return 0;
+   unsigned int len;
 
    free_stacks ();
 
@@ -10484,48 +13807,58 @@ static int init_interpreter (void)
      return -1;
    Global_NameSpace = ns;
 
-   Run_Stack = (SLang_Object_Type *) SLcalloc (SLANG_MAX_STACK_LEN,
+   Run_Stack_Len = SLANG_INITIAL_STACK_LEN;
+   if (Run_Stack_Len > Max_Stack_Len)
+     Run_Stack_Len = Max_Stack_Len;
+   Run_Stack = (SLang_Object_Type *) SLcalloc (Run_Stack_Len,
 						  sizeof (SLang_Object_Type));
    if (Run_Stack == NULL)
      goto return_error;
 
    Stack_Pointer = Run_Stack;
-   Stack_Pointer_Max = Run_Stack + SLANG_MAX_STACK_LEN;
+   Stack_Pointer_Max = Run_Stack + Run_Stack_Len;
+
+   Frame_Stack_Len = SLANG_INITIAL_RECURSIVE_DEPTH;
+   if (Frame_Stack_Len > Max_Recursion_Depth)
+     Frame_Stack_Len = Max_Recursion_Depth;
+   Frame_Stack_Max = Frame_Stack_Len;
 
-   Num_Args_Stack = (int *) _SLcalloc (SLANG_MAX_RECURSIVE_DEPTH, sizeof(int));
+   Num_Args_Stack = (int *) _SLcalloc (Frame_Stack_Len, sizeof(int));
    if (Num_Args_Stack == NULL)
      goto return_error;
 
    Recursion_Depth = 0;
-   Frame_Pointer_Stack = (unsigned int *) _SLcalloc (SLANG_MAX_RECURSIVE_DEPTH, sizeof(unsigned int));
+   Frame_Pointer_Stack = (unsigned int *) _SLcalloc (Frame_Stack_Len, sizeof(unsigned int));
    if (Frame_Pointer_Stack == NULL)
      goto return_error;
    Frame_Pointer_Depth = 0;
    Frame_Pointer = Run_Stack;
 
-   Local_Variable_Stack = (SLang_Object_Type *) _SLcalloc (SLANG_MAX_LOCAL_STACK, sizeof(SLang_Object_Type));
-   if (Local_Variable_Stack == NULL)
+   len = SLANG_INITIAL_LOCAL_STACK;
+   if (len > Max_Local_Stack_Len)
+     len = Max_Local_Stack_Len;
+   Local_Stack_Chunks[0].base = (SLang_Object_Type *) _SLcalloc (len, sizeof(SLang_Object_Type));
+   if (Local_Stack_Chunks[0].base == NULL)
      goto return_error;
-   Local_Variable_Frame = Local_Variable_Stack;
-   Local_Variable_Stack_Max = Local_Variable_Stack + SLANG_MAX_LOCAL_STACK;
+   Local_Stack_Chunks[0].max = Local_Stack_Chunks[0].base + len;
+   Local_Stack_Chunks[0].num_below = 0;
+   Local_Stack_Chunk = 0;
+   Local_Variable_Frame = Local_Stack_Chunks[0].base;
+   set_local_stack_max ();
 
 #if SLANG_HAS_QUALIFIERS
-   Function_Qualifiers_Stack = (SLang_Struct_Type **) SLcalloc (SLANG_MAX_RECURSIVE_DEPTH, sizeof (SLang_Struct_Type *));
+   Function_Qualifiers_Stack = (SLang_Struct_Type **) SLcalloc (Frame_Stack_Len, sizeof (SLang_Struct_Type *));
    if (Function_Qualifiers_Stack == NULL)
      goto return_error;
 #endif
 
-   Function_Stack = (Function_Stack_Type *) _SLcalloc (SLANG_MAX_RECURSIVE_DEPTH, sizeof (Function_Stack_Type));
+   Function_Stack = (Function_Stack_Type *) _SLcalloc (Frame_Stack_Len, sizeof (Function_Stack_Type));
    if (Function_Stack == NULL)
      goto return_error;
 
    Function_Stack_Ptr = Function_Stack;
-   /* Function_Stack_Ptr_Max = Function_Stack_Ptr + SLANG_MAX_RECURSIVE_DEPTH; */
 
    (void) setup_default_compile_linkage (1);
-   if (-1 == SLang_add_cleanup_function (delete_interpreter))
-     goto return_error;
-
    return 0;
 
 return_error:
@@ -10533,6 +13866,284 @@ return_error:
    return -1;
 }
 
+static int init_interpreter (void)
+{
+   if (Global_NameSpace != NULL)
+     return 0;
+
+   if (-1 == create_interpreter ())
+     return -1;
+
+   if (-1 == SLang_add_cleanup_function (delete_interpreter))
+     {
+	free_stacks ();
+	return -1;
+     }
+   return 0;
+}
+
+/* Returns the size of a namespace entry for an intrinsic, or 0 if the
+ * entry was defined by the interpreter.
+ */
+static unsigned int sizeof_intrinsic_entry (int name_type)
+{
+   switch (name_type)
+     {
+      case SLANG_INTRINSIC:
+	return sizeof (SLang_Intrin_Fun_Type);
+      case SLANG_IVARIABLE:
+      case SLANG_RVARIABLE:
+	return sizeof (SLang_Intrin_Var_Type);
+      case SLANG_MATH_UNARY:
+	return sizeof (SLang_Math_Unary_Type);
+      case SLANG_APP_UNARY:
+	return sizeof (SLang_App_Unary_Type);
+      case SLANG_ARITH_UNARY:
+	return sizeof (SLang_Arith_Unary_Type);
+      case SLANG_ARITH_BINARY:
+	return sizeof (SLang_Arith_Binary_Type);
+      case SLANG_HCONSTANT:
+	return sizeof (SLang_HConstant_Type);
+      case SLANG_ICONSTANT:
+	return sizeof (SLang_IConstant_Type);
+      case SLANG_LCONSTANT:
+	return sizeof (SLang_LConstant_Type);
+#if SLANG_HAS_FLOAT
+      case SLANG_DCONSTANT:
+	return sizeof (SLang_DConstant_Type);
+      case SLANG_FCONSTANT:
+	return sizeof (SLang_FConstant_Type);
+#endif
+#ifdef HAVE_LONG_LONG
+      case SLANG_LLCONSTANT:
+	/* Only the ll field is used by the interpreter */
+	return sizeof (SLang_LLConstant_Type);
+#endif
+      default:
+	break;
+     }
+   return 0;
+}
+
+static int has_intrinsics (SLang_NameSpace_Type *ns)
+{
+   unsigned int i;
+
+   for (i = 0; i < ns->table_size; i++)
+     {
+	SLang_Name_Type *t;
+	for (t = ns->table[i]; t != NULL; t = t->next)
+	  {
+	     if (sizeof_intrinsic_entry (t->name_type))
+	       return 1;
+	  }
+     }
+   return 0;
+}
+
+/* The copies are appended to the hash chains so that an intrinsic that
+ * replaced another one of the same name continues to do so.
+ */
+static int copy_intrinsics (SLang_NameSpace_Type *from, SLang_NameSpace_Type *to)
+{
+   unsigned int i;
+
+   for (i = 0; i < from->table_size; i++)
+     {
+	SLang_Name_Type *t;
+	for (t = from->table[i]; t != NULL; t = t->next)
+	  {
+	     SLang_Name_Type *copy, **tail;
+	     unsigned int size;
+
+	     if (0 == (size = sizeof_intrinsic_entry (t->name_type)))
+	       continue;
+
+	     if (NULL == (copy = (SLang_Name_Type *) SLmalloc (size)))
+	       return -1;
+	     memcpy ((char *) copy, (char *) t, size);
+	     if (NULL == (copy->name = SLang_create_slstring (t->name)))
+	       {
+		  SLfree ((char *) copy);
+		  return -1;
+	       }
+	     copy->next = NULL;
+
+	     tail = to->table + (SLcompute_string_hash (copy->name) % to->table_size);
+	     while (*tail != NULL)
+	       tail = &(*tail)->next;
+	     *tail = copy;
+	  }
+     }
+   return 0;
+}
+
+/* Copy the intrinsics of the global namespace and the named namespaces of
+ * another instance into the current one.
+ */
+static int copy_interp_intrinsics (SLang_Interp_Type *from)
+{
+   SLang_NameSpace_Type *ns;
+
+   for (ns = from->namespace_list; ns != NULL; ns = ns->next)
+     {
+	SLang_NameSpace_Type *to;
+
+	if (ns == from->global_namespace)
+	  to = Global_NameSpace;
+	else if ((ns->namespace_name == NULL) || (0 == has_intrinsics (ns)))
+	  continue;
+	else
+	  {
+	     if (NULL == (to = _pSLns_new_namespace (ns->name, ns->table_size)))
+	       return -1;
+	     if (-1 == _pSLns_set_namespace_name (to, ns->namespace_name))
+	       return -1;
+	  }
+
+	if (-1 == copy_intrinsics (ns, to))
+	  return -1;
+     }
+   return 0;
+}
+
+static void free_function_body (SLang_Name_Type *nt)
+{
+   _pSLang_Function_Type *f = (_pSLang_Function_Type *) nt;
+
+   if (f->header != NULL)
+     free_function_header (f->header);
+   else if (f->autoload_file != NULL)
+     SLang_free_slstring ((char *) f->autoload_file);
+
+   f->header = NULL;
+   f->autoload_file = NULL;
+}
+
+/* Free the objects, namespaces, and stacks of the current instance, which
+ * must not be Default_Interp.
+ */
+static void delete_interp_instance (void)
+{
+   if (Run_Stack != NULL)
+     {
+	while (Stack_Pointer != Run_Stack)
+	  SLdo_pop ();
+     }
+
+   _pSLns_free_namespaces (free_function_body);
+   Global_NameSpace = NULL;
+   This_Private_NameSpace = NULL;
+   This_Static_NameSpace = NULL;
+   Locals_NameSpace = NULL;
+   free_stacks ();
+
+   SLang_free_slstring ((char *) Trace_Function);   /* NULL ok */
+   Trace_Function = NULL;
+#if SLANG_HAS_BOSEOS
+   {
+      SLang_Name_Type *hooks[SLANG_NUM_BOSEOS_HOOKS];
+      memset ((char *) hooks, 0, sizeof (hooks));
+      _pSLang_swap_boseos_hooks (hooks);
+   }
+#endif
+}
+
+SLang_Interp_Type *SLang_create_interp (void)
+{
+   SLang_Interp_Type *interp, *current;
+
+   if (-1 == init_interpreter ())
+     return NULL;
+
+   interp = (SLang_Interp_Type *) SLcalloc (1, sizeof (SLang_Interp_Type));
+   if (interp == NULL)
+     return NULL;
+
+   /* The new instance inherits the settings of the current one */
+   current = Current_Interp;
+   save_interp_state (current);
+   interp->max_stack_len = current->max_stack_len;
+   interp->max_local_stack_len = current->max_local_stack_len;
+   interp->max_recursion_depth = current->max_recursion_depth;
+   interp->auto_declare_globals = current->auto_declare_globals;
+   interp->lazy_compile = current->lazy_compile;
+   interp->bytecode_cache = current->bytecode_cache;
+   interp->traceback = current->traceback;
+
+   load_interp_state (interp);
+   Current_Interp = interp;
+
+   if ((-1 == create_interpreter ())
+       || (-1 == copy_interp_intrinsics (current)))
+     {
+	delete_interp_instance ();
+	(void) SLang_set_interp (current);
+	SLfree ((char *) interp);
+	return NULL;
+     }
+
+   (void) SLang_set_interp (current);
+   return interp;
+}
+
+/* An instance may be made current while another one is executing code, e.g.,
+ * by an intrinsic function.  The latter must be made current again before
+ * the intrinsic returns.
+ */
+int SLang_set_interp (SLang_Interp_Type *interp)
+{
+   if (interp == NULL)
+     interp = &Default_Interp;
+
+   if (interp == Current_Interp)
+     return 0;
+
+   save_interp_state (Current_Interp);
+   load_interp_state (interp);
+   Current_Interp = interp;
+   return 0;
+}
+
+SLang_Interp_Type *SLang_get_interp (void)
+{
+   return Current_Interp;
+}
+
+void SLang_free_interp (SLang_Interp_Type *interp)
+{
+   SLang_Interp_Type *current = Current_Interp;
+
+   if ((interp == NULL) || (interp == &Default_Interp))
+     return;
+
+   if (interp == current)
+     {
+	_pSLang_verror (SL_APPLICATION_ERROR, "An interpreter instance may not be freed while it is in use");
+	return;
+     }
+
+   (void) SLang_set_interp (interp);
+   delete_interp_instance ();
+   (void) SLang_set_interp (current);
+   SLfree ((char *) interp);
+}
+
+/* Returns 1 if entry is a copy of the table entry t, as made for an instance
+ * other than the first.  The copy differs only in its name and next fields.
+ */
+static int is_intrinsic_copy (SLang_Name_Type *entry, SLang_Name_Type *t,
+			      unsigned int entry_len)
+{
+   unsigned int ofs = (unsigned int) offsetof (SLang_Name_Type, name_type);
+
+   if ((entry->name_type != t->name_type)
+       || (0 != strcmp (entry->name, t->name)))
+     return 0;
+
+   return (0 == memcmp ((char *) entry + ofs, (char *) t + ofs, entry_len - ofs));
+}
+
 static int add_generic_table (SLang_NameSpace_Type *ns,
 			      SLang_Name_Type *table, SLFUTURE_CONST char *pp_name,
 			      unsigned int entry_len)
@@ -10557,6 +14168,7 @@ static int add_generic_table (SLang_NameSpace_Type *ns,
    t = table;
    while (NULL != (name = t->name))
      {
+	SLang_Name_Type *entry = t;
 	unsigned long hash;
 
 	/* Backward compatibility: '.' WAS used as hash marker */
@@ -10572,7 +14184,19 @@ static int add_generic_table (SLang_NameSpace_Type *ns,
 	if (NULL == (name = SLang_create_slstring (name)))
 	  return -1;
 
-	t->name = name;
+	/* The entries of the table are linked into the namespaces of the
+	 * first instance.  Other instances get copies.
+	 */
+	if (Current_Interp != &Default_Interp)
+	  {
+	     if (NULL == (entry = (SLang_Name_Type *) SLmalloc (entry_len)))
+	       {
+		  SLang_free_slstring ((char *) name);
+		  return -1;
+	       }
+	     memcpy ((char *) entry, (char *) t, entry_len);
+	  }
+	entry->name = name;
 
 	hash = SLcompute_string_hash (name);
 	hash = hash % table_size;
@@ -10583,7 +14207,7 @@ static int add_generic_table (SLang_NameSpace_Type *ns,
 	     SLang_Name_Type *tt = ns_table[(unsigned int) hash];
 	     while (tt != NULL)
 	       {
-		  if (tt == t)
+		  if ((tt == t) || is_intrinsic_copy (tt, t, entry_len))
 		    {
 		       _pSLang_verror (SL_APPLICATION_ERROR,
 				     "An intrinsic symbol table may not be added twice. [%s]",
@@ -10594,8 +14218,8 @@ static int add_generic_table (SLang_NameSpace_Type *ns,
 	       }
 	  }
 
-	t->next = ns_table [(unsigned int) hash];
-	ns_table [(unsigned int) hash] = t;
+	entry->next = ns_table [(unsigned int) hash];
+	ns_table [(unsigned int) hash] = entry;
 
 	t = (SLang_Name_Type *) ((char *)t + entry_len);
      }
@@ -629,6 +629,28 @@ SL_EXTERN int (*SLns_Load_File_Hook) (SLFUTURE_CONST char *, SLFUTURE_CONST char
 SL_EXTERN int SLang_load_file_verbose (int);
 /* Bitmapped value that controls loading messages */
 
+#define SLANG_BYTECODE_CACHE_READ	0x1
+#define SLANG_BYTECODE_CACHE_WRITE	0x2
+SL_EXTERN int SLang_bytecode_cache (int);
+/* Bitmapped value that controls the use of compiled images of loaded files */
+
+SL_EXTERN int SLang_lazy_compile (int);
+/* If non-zero, function bodies are compiled when first called */
+
+/* Interpreter instances share the library state, and may not be used
+ * concurrently by different threads.
+ */
+typedef struct _pSLang_Interp_Type SLang_Interp_Type;
+SL_EXTERN SLang_Interp_Type *SLang_create_interp (void);
+SL_EXTERN int SLang_set_interp (SLang_Interp_Type *);
+SL_EXTERN SLang_Interp_Type *SLang_get_interp (void);
+SL_EXTERN void SLang_free_interp (SLang_Interp_Type *);
+/* An interpreter instance has its own stacks and namespaces.  A new one
+ * starts out with the intrinsics of the current one, but none of its
+ * variables or functions.  Data types, strings, and the error state are
+ * shared by all instances, and only one of them may be used at a time.
+ */
+
 typedef struct SLang_Load_Type
 {
    int type;
@@ -1176,6 +1198,14 @@ SL_EXTERN int SLang_init_import (void);
 
 SL_EXTERN int SLstack_depth(void);
 
+SL_EXTERN int SLang_set_stack_limits (unsigned int, unsigned int, unsigned int);
+SL_EXTERN void SLang_get_stack_limits (unsigned int *, unsigned int *, unsigned int *);
+/* These set and get the maximum sizes of the run-time stack, the local
+ * variable stack, and the depth of function calls.  The stacks grow as
+ * needed up to these limits.  A value of 0 passed to SLang_set_stack_limits
+ * leaves the corresponding limit unchanged.
+ */
+
 SL_EXTERN int SLdo_pop(void);
 SL_EXTERN int SLdo_pop_n(unsigned int);
 
@@ -1298,6 +1328,8 @@ SL_EXTERN int SLexpand_escaped_string (char *dest, char *src, char *src_max,
 				       int utf8_encode);
 
 SL_EXTERN SLang_Name_Type *SLang_get_function (SLFUTURE_CONST char *);
+SL_EXTERN unsigned long SLang_get_function_id (SLang_Name_Type *);
+SL_EXTERN SLang_Name_Type *SLang_get_function_from_id (SLFUTURE_CONST char *, unsigned long);
 SL_EXTERN void SLang_release_function (SLang_Name_Type *);
 
 SL_EXTERN int SLreverse_stack (int);
@@ -2123,6 +2155,8 @@ SL_EXTERN int SLang_get_int_size (SLtype);
 #define SLANG_FILE_PTR_TYPE	(0x08)
 #define SLANG_FILE_FD_TYPE	(0x09)
 #define SLANG_MD5_TYPE		(0x0A)
+#define SLANG_STRBUILDER_TYPE	(0x0B)
+#define SLANG_STRVIEW_TYPE	(0x0C)
 #define SLANG_INTP_TYPE		(0x0F)
 
 /* Integer types */
@@ -381,4 +381,18 @@ int _pSLang_init_boseos (void)
 {
    return SLadd_intrin_fun_table (Intrin_Funs, NULL);
 }
+
+/* The hooks are functions of the interpreter instance that set them */
+void _pSLang_swap_boseos_hooks (SLang_Name_Type **hooks)
+{
+   SLang_Name_Type *h;
+
+   h = BOS_Callback_Handler; BOS_Callback_Handler = hooks[0]; hooks[0] = h;
+   h = EOS_Callback_Handler; EOS_Callback_Handler = hooks[1]; hooks[1] = h;
+   h = BOF_Callback_Handler; BOF_Callback_Handler = hooks[2]; hooks[2] = h;
+   h = EOF_Callback_Handler; EOF_Callback_Handler = hooks[3]; hooks[3] = h;
+#if SLANG_HAS_DEBUGGER_SUPPORT
+   h = Debug_Hook; Debug_Hook = hooks[4]; hooks[4] = h;
+#endif
+}
 #endif				       /* SLANG_HAS_BOSEOS */
@@ -667,52 +667,19 @@ static unsigned int count_byte_occurrences (SLang_BString_Type *b, unsigned char
 /* returns the 1-based byte offset of substring in a string, or 0 */
 static int issubbytes_1 (SLang_BString_Type *as, SLang_BString_Type *bs, unsigned int ofs0)
 {
-   unsigned int lena, lenb;
-   unsigned char *a, *b, *amax, *bmax, *astart;
-   unsigned char ch0;
+   unsigned int lena;
+   unsigned char *a, *p;
 
    a = BS_GET_POINTER(as);
-   b = BS_GET_POINTER(bs);
    lena = as->len;
-   lenb = bs->len;
 
-   if (ofs0)
-     {
-	if (lena < ofs0)
-	  return 0;
-	lena -= ofs0;
-	a += ofs0;
-     }
-
-   if ((lenb > lena) || (lenb == 0))
+   if (lena < ofs0)
      return 0;
 
-   lena -= lenb;
-   amax = a + lena;
-   bmax = b + lenb;
-
-   astart = a;
-   ch0 = *b++;
-   while (a <= amax)
-     {
-	unsigned char *a0, *b0;
-
-	if (ch0 != *a++)
-	  continue;
-	a0 = a;
-	b0 = b;
-	while ((b < bmax) && (*a == *b))
-	  {
-	     a++;
-	     b++;
-	  }
-	if (b == bmax)
-	  return ofs0 + (a0 - astart);
-
-	a = a0;
-	b = b0;
-     }
-   return 0;
+   p = _pSLsearch_bytes (a + ofs0, a + lena, BS_GET_POINTER(bs), bs->len);
+   if (p == NULL)
+     return 0;
+   return 1 + (p - a);
 }
 
 static SLindex_Type issubbytes (void)
@@ -20,16 +20,64 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
 USA.
 */
 
-#define USE_NEW_HASH_CODE	1
+/* slstring.c: The hash function used for strings, for the keys of
+ * associative arrays, and for the names in namespaces:
+ *   0: the original shift-and-add hash
+ *   1: Bob Jenkins' lookup2 hash (32 bit)
+ *   2: a 64 bit multiply-and-fold hash.  This falls back to 1 if the
+ *      compiler has no 64 bit integer type.
+ * It may be selected when building the library, e.g., via
+ * CFLAGS=-DSLSTRING_HASH_FUNCTION=1.  The tables are sized for the hash
+ * functions whose low bits are well-mixed unless it is 0.
+ */
+#ifndef SLSTRING_HASH_FUNCTION
+# define SLSTRING_HASH_FUNCTION	2
+#endif
+#if SLSTRING_HASH_FUNCTION
+# define USE_NEW_HASH_CODE	1
+#else
+# define USE_NEW_HASH_CODE	0
+#endif
+
+/* slstring.c: The hash table used for strings starts out with MIN_SIZE
+ * buckets and doubles, up to MAX_SIZE buckets, when the number of strings
+ * exceeds MAX_LOAD times the number of buckets.  The sizes must be powers
+ * of 2.  Each new string moves REHASH_STEP buckets of the table that is
+ * being replaced.
+ */
+#ifdef __MSDOS_16BIT__
+# define SLSTRING_HASH_TABLE_MIN_SIZE	256
+# define SLSTRING_HASH_TABLE_MAX_SIZE	4096
+#else
+# define SLSTRING_HASH_TABLE_MIN_SIZE	1024
+# define SLSTRING_HASH_TABLE_MAX_SIZE	0x40000000UL
+#endif
+#define SLSTRING_HASH_TABLE_MAX_LOAD	1
+#define SLSTRING_REHASH_STEP		4
+
+/* slsearch.c: If non-zero, a forward search for a short key of single-byte
+ * characters looks for the positions where both the first and the last
+ * byte of the key occur, and compares the rest of the key only there.
+ * If 0, the Boyer-Moore skip table is used for all keys.  This may be set
+ * when building the library, e.g., CFLAGS=-DSLSEARCH_FIRST_LAST_FILTER=0.
+ */
+#ifndef SLSEARCH_FIRST_LAST_FILTER
+# define SLSEARCH_FIRST_LAST_FILTER	1
+#endif
 
-/* slstring.c: Size of the hash table used for strings (prime numbers) */
-#define SLSTRING_HASH_TABLE_SIZE       140009  /* was 32327, 25013, 10007 */
-/* Other large primes: 70001, 100003, 300007,... */
+/* slang.c: The run time stack, the local variable stack, and the stacks
+ * that hold the function call frames start out with the sizes given by
+ * the SLANG_INITIAL_* values and grow as needed up to the SLANG_MAX_*
+ * values.  The maximum values are the defaults for the limits that may be
+ * changed at run-time via SLang_set_stack_limits.
+ */
 /* slang.c: maximum size of run time stack */
 #ifdef __MSDOS_16BIT__
 # define SLANG_MAX_STACK_LEN		500
+# define SLANG_INITIAL_STACK_LEN	500
 #else
-# define SLANG_MAX_STACK_LEN		2500
+# define SLANG_MAX_STACK_LEN		1000000
+# define SLANG_INITIAL_STACK_LEN	256
 #endif
 
 /* slang.c: This sets the size on the depth of function calls.
@@ -38,19 +86,23 @@ USA.
  */
 #ifdef __MSDOS_16BIT__
 # define SLANG_MAX_RECURSIVE_DEPTH	50
+# define SLANG_INITIAL_RECURSIVE_DEPTH	50
 #else
 # if (defined(__WIN32__) || defined(__CYGWIN__))
 #  define SLANG_MAX_RECURSIVE_DEPTH	500
 # else
 #  define SLANG_MAX_RECURSIVE_DEPTH	1500
 # endif
+# define SLANG_INITIAL_RECURSIVE_DEPTH	64
 #endif
 
 /* slang.c: Size of the stack used for local variables */
 #ifdef __MSDOS_16BIT__
 # define SLANG_MAX_LOCAL_STACK		200
+# define SLANG_INITIAL_LOCAL_STACK	200
 #else
 # define SLANG_MAX_LOCAL_STACK		(10*SLANG_MAX_RECURSIVE_DEPTH)
+# define SLANG_INITIAL_LOCAL_STACK	256
 #endif
 
 /* slang.c: The size of the hash table used for local and global objects.
@@ -486,11 +486,73 @@ SLang_NameSpace_Type *_pSLns_find_object_namespace (SLang_Name_Type *nt)
    return NULL;
 }
 
+/* Returns the first object called name in any namespace for which the match
+ * function returns non-zero, or NULL if there is none.
+ */
+SLang_Name_Type *_pSLns_find_object (SLCONST char *name,
+				     int (*match)(SLang_Name_Type *, VOID_STAR),
+				     VOID_STAR cd)
+{
+   SLang_NameSpace_Type *ns;
+   unsigned long hash;
+
+   hash = SLcompute_string_hash (name);
+
+   ns = Namespace_Tables;
+   while (ns != NULL)
+     {
+	SLang_Name_Type *t = ns->table [MAP_HASH_TO_NS_INDEX(hash,ns)];
+	while (t != NULL)
+	  {
+	     if ((0 == strcmp (t->name, name))
+		 && (*match) (t, cd))
+	       return t;
+
+	     t = t->next;
+	  }
+	ns = ns->next;
+     }
+
+   return NULL;
+}
+
 SLang_Name_Type *_pSLns_locate_name (SLang_NameSpace_Type *ns, SLCONST char *name)
 {
    return _pSLns_locate_hashed_name (ns, name, SLcompute_string_hash (name));
 }
 
+static void free_namespace_object (SLang_Name_Type *t)
+{
+   switch (t->name_type)
+     {
+      case SLANG_PVARIABLE:
+      case SLANG_GVARIABLE:
+	SLang_free_object (&((SLang_Global_Var_Type *)t)->obj);
+	break;
+
+      case SLANG_PFUNCTION:
+      case SLANG_FUNCTION:
+	SLang_free_function (t);
+	break;
+
+      case SLANG_ICONSTANT:
+      case SLANG_DCONSTANT:
+      case SLANG_FCONSTANT:
+      case SLANG_LLCONSTANT:
+      case SLANG_HCONSTANT:
+      case SLANG_LCONSTANT:
+      case SLANG_RVARIABLE:
+      case SLANG_IVARIABLE:
+      case SLANG_INTRINSIC:
+      case SLANG_MATH_UNARY:
+      case SLANG_APP_UNARY:
+      case SLANG_ARITH_UNARY:
+      case SLANG_ARITH_BINARY:
+      default:
+	break;
+     }
+}
+
 static void delete_namespace_objects (SLang_NameSpace_Type *ns)
 {
    SLang_Name_Type **table = ns->table;
@@ -502,34 +564,7 @@ static void delete_namespace_objects (SLang_NameSpace_Type *ns)
 	while (t != NULL)
 	  {
 	     SLang_Name_Type *t1 = t->next;
-	     switch (t->name_type)
-	       {
-		case SLANG_PVARIABLE:
-		case SLANG_GVARIABLE:
-		  SLang_free_object (&((SLang_Global_Var_Type *)t)->obj);
-		  break;
-
-		case SLANG_PFUNCTION:
-		case SLANG_FUNCTION:
-		  SLang_free_function (t);
-		  break;
-
-		case SLANG_ICONSTANT:
-		case SLANG_DCONSTANT:
-		case SLANG_FCONSTANT:
-		case SLANG_LLCONSTANT:
-		case SLANG_HCONSTANT:
-		case SLANG_LCONSTANT:
-		case SLANG_RVARIABLE:
-		case SLANG_IVARIABLE:
-		case SLANG_INTRINSIC:
-		case SLANG_MATH_UNARY:
-		case SLANG_APP_UNARY:
-		case SLANG_ARITH_UNARY:
-		case SLANG_ARITH_BINARY:
-		default:
-		  break;
-	       }
+	     free_namespace_object (t);
 	     SLang_free_slstring (t->name);
 	     t = t1;
 	  }
@@ -562,3 +597,51 @@ void _pSLns_delete_namespaces (void)
    /* Namespace_Tables = NULL; v3 */
 }
 
+/* The namespaces of an interpreter instance created by SLang_create_interp
+ * contain no static tables, so unlike the ones above, they can be freed.
+ * The values of the variables are freed first since their destructors may
+ * call functions in any of the namespaces.
+ */
+void _pSLns_free_namespaces (void (*free_function)(SLang_Name_Type *))
+{
+   SLang_NameSpace_Type *ns;
+   unsigned int i;
+
+   for (ns = Namespace_Tables; ns != NULL; ns = ns->next)
+     {
+	for (i = 0; i < ns->table_size; i++)
+	  {
+	     SLang_Name_Type *t;
+	     for (t = ns->table[i]; t != NULL; t = t->next)
+	       {
+		  if ((t->name_type == SLANG_GVARIABLE)
+		      || (t->name_type == SLANG_PVARIABLE))
+		    free_namespace_object (t);
+	       }
+	  }
+     }
+
+   while (NULL != (ns = Namespace_Tables))
+     {
+	Namespace_Tables = ns->next;
+	for (i = 0; i < ns->table_size; i++)
+	  {
+	     SLang_Name_Type *t;
+	     for (t = ns->table[i]; t != NULL; t = t->next)
+	       {
+		  if ((t->name_type == SLANG_FUNCTION)
+		      || (t->name_type == SLANG_PFUNCTION))
+		    (*free_function) (t);
+	       }
+	  }
+	_pSLns_deallocate_namespace (ns);
+     }
+}
+
+/* Each interpreter instance has its own list of namespaces */
+SLang_NameSpace_Type *_pSLns_swap_namespace_list (SLang_NameSpace_Type *list)
+{
+   SLang_NameSpace_Type *old = Namespace_Tables;
+   Namespace_Tables = list;
+   return old;
+}
@@ -65,6 +65,36 @@ static int Last_Line_Number = -1;
 
 static int In_Looping_Context = 0;
 
+/* When a function body is compiled lazily, define_function saves its tokens
+ * in this structure.  When the function is first called, the tokens are
+ * read back by get_token via _pSLparse_lazy_body.
+ */
+struct _pSLang_Lazy_Body_Type
+{
+   _pSLang_Token_Type *tokens;
+   unsigned int num_tokens;
+   unsigned int max_tokens;
+#if SLANG_HAS_BOSEOS
+   int boseos;			       /* value of _boseos_info when defined */
+#endif
+};
+static _pSLang_Lazy_Body_Type *Lazy_Body;
+static unsigned int Lazy_Body_Pos;
+
+static int get_lazy_body_token (_pSLang_Token_Type *ctok)
+{
+   if (Lazy_Body_Pos == Lazy_Body->num_tokens)
+     {
+	init_token (ctok);
+	return ctok->type = EOF_TOKEN;
+     }
+   /* The token is only read once, so it is stolen from the list */
+   *ctok = Lazy_Body->tokens[Lazy_Body_Pos];
+   Lazy_Body->tokens[Lazy_Body_Pos].num_refs = 0;
+   Lazy_Body_Pos++;
+   return ctok->type;
+}
+
 static int unget_token (_pSLang_Token_Type *ctok)
 {
    if (_pSLang_Error)
@@ -93,6 +123,9 @@ static int get_token (_pSLang_Token_Type *ctok)
 	return ctok->type;
      }
 
+   if (Lazy_Body != NULL)
+     return get_lazy_body_token (ctok);
+
    return _pSLget_token (ctok);
 }
 
@@ -717,7 +750,8 @@ static void rpn_parse_line (_pSLang_Token_Type *tok)
 	  compile_token (tok);
 	free_token (tok);
      }
-   while (EOF_TOKEN != _pSLget_rpn_token (tok));
+   while (EOF_TOKEN != ((Lazy_Body != NULL)
+			? get_lazy_body_token (tok) : _pSLget_rpn_token (tok)));
 }
 
 static int get_identifier_token (_pSLang_Token_Type *tok, int string_ok)
@@ -739,9 +773,89 @@ static int get_identifier_token (_pSLang_Token_Type *tok, int string_ok)
    return -1;
 }
 
+static int append_lazy_body_token (_pSLang_Lazy_Body_Type *body, _pSLang_Token_Type *tok)
+{
+   if (body->num_tokens == body->max_tokens)
+     {
+	unsigned int max_tokens = 2 * body->max_tokens + 32;
+	_pSLang_Token_Type *tokens;
+
+	tokens = (_pSLang_Token_Type *) SLrealloc ((char *) body->tokens,
+						   max_tokens * sizeof (_pSLang_Token_Type));
+	if (tokens == NULL)
+	  return -1;
+	body->tokens = tokens;
+	body->max_tokens = max_tokens;
+     }
+   body->tokens[body->num_tokens] = *tok;
+   body->num_tokens++;
+   tok->num_refs = 0;		       /* stealing it */
+   return 0;
+}
+
+/* This saves the tokens of a function body for _pSLparse_lazy_body.  Here
+ * ctok->type is OBRACE_TOKEN, and as with compound_statement, ctok is left
+ * at the matching CBRACE_TOKEN.
+ */
+static _pSLang_Lazy_Body_Type *save_function_body (_pSLang_Token_Type *ctok)
+{
+   _pSLang_Lazy_Body_Type *body;
+   unsigned int depth = 0;
+
+   body = (_pSLang_Lazy_Body_Type *) SLcalloc (1, sizeof (_pSLang_Lazy_Body_Type));
+   if (body == NULL)
+     return NULL;
+#if SLANG_HAS_BOSEOS
+   body->boseos = _pSLang_Compile_BOSEOS;
+#endif
+
+   while (_pSLang_Error == 0)
+     {
+	switch (ctok->type)
+	  {
+	   case EOF_TOKEN:
+	     _pSLparse_error (SL_SYNTAX_ERROR, "Expecting '}'", ctok, 0);
+	     break;
+
+	   case OBRACE_TOKEN:
+	     depth++;
+	     break;
+
+	   case CBRACE_TOKEN:
+	     depth--;
+	     break;
+	  }
+
+	if (_pSLang_Error || (-1 == append_lazy_body_token (body, ctok)))
+	  break;
+
+	if ((ctok->type == CBRACE_TOKEN) && (depth == 0))
+	  return body;
+
+	if (ctok->type == RPN_TOKEN)
+	  {
+	     /* The rest of the line is read by rpn_parse_line up to an
+	      * EOF_TOKEN, which is saved too.
+	      */
+	     while (EOF_TOKEN != _pSLget_rpn_token (ctok))
+	       {
+		  if (-1 == append_lazy_body_token (body, ctok))
+		    break;
+	       }
+	     if (-1 == append_lazy_body_token (body, ctok))
+	       break;
+	  }
+	get_token (ctok);
+     }
+
+   _pSLparse_free_lazy_body (body);
+   return NULL;
+}
+
 static void define_function (_pSLang_Token_Type *ctok, unsigned char type)
 {
    _pSLang_Token_Type fname;
+   _pSLang_Lazy_Body_Type *body = NULL;
 
    switch (type)
      {
@@ -769,7 +883,17 @@ static void define_function (_pSLang_Token_Type *ctok, unsigned char type)
    define_function_args (ctok);
    compile_token_of_type(FARG_TOKEN);
 
-   if (ctok->type == OBRACE_TOKEN)
+   if ((ctok->type == OBRACE_TOKEN)
+       && _pSLcompile_lazy_body_ok ())
+     {
+	if (NULL == (body = save_function_body (ctok)))
+	  {
+	     free_token (&fname);
+	     return;
+	  }
+	_pSLcompile_set_lazy_body (body);
+     }
+   else if (ctok->type == OBRACE_TOKEN)
      {
 	int loop_context = In_Looping_Context;
 	In_Looping_Context = 0;
@@ -786,6 +910,8 @@ static void define_function (_pSLang_Token_Type *ctok, unsigned char type)
 
    fname.type = type;
    compile_token (&fname);
+   if (body != NULL)		       /* freed if it was not used */
+     _pSLcompile_set_lazy_body (NULL);
    free_token (&fname);
 }
 
@@ -1801,6 +1927,106 @@ void _pSLparse_start (SLang_Load_Type *llt)
 #endif
 }
 
+/* Compile the function body saved by save_function_body.  The caller is
+ * expected to have set up the compiler as if the arguments of the function
+ * had just been parsed.
+ */
+int _pSLparse_lazy_body (SLang_Load_Type *llt, _pSLang_Lazy_Body_Type *body)
+{
+   _pSLang_Token_Type ctok;
+   SLang_Load_Type *save_llt;
+   unsigned int save_use_next_token;
+   _pSLang_Token_Type save_next_token;
+   Token_List_Type *save_list;
+   _pSLang_Lazy_Body_Type *save_lazy_body;
+   unsigned int save_lazy_body_pos;
+   int save_looping_context = In_Looping_Context;
+#if SLANG_HAS_BOSEOS
+   int save_boseos = _pSLang_Compile_BOSEOS;
+#endif
+#if SLANG_HAS_DEBUG_CODE
+   int save_last_line_number = Last_Line_Number;
+
+   Last_Line_Number = -1;
+#endif
+   save_use_next_token = Use_Next_Token;
+   save_next_token = Next_Token;
+   save_list = Token_List;
+   save_llt = LLT;
+   save_lazy_body = Lazy_Body;
+   save_lazy_body_pos = Lazy_Body_Pos;
+   LLT = llt;
+   Lazy_Body = body;
+   Lazy_Body_Pos = 0;
+#if SLANG_HAS_BOSEOS
+   _pSLang_Compile_BOSEOS = body->boseos;
+#endif
+
+   init_token (&Next_Token);
+   Use_Next_Token = 0;
+   In_Looping_Context = 0;
+   init_token (&ctok);
+   get_token (&ctok);
+
+   /* This is the level of the body of a function defined at top-level */
+   llt->parse_level = 1;
+   if (ctok.type != OBRACE_TOKEN)
+     _pSLparse_error (SL_INTERNAL_ERROR, "Expecting a saved function body", &ctok, 0);
+   else
+     {
+	compound_statement (&ctok);
+	if ((_pSLang_Error == 0) && (EOF_TOKEN != get_token (&ctok)))
+	  _pSLparse_error (SL_INTERNAL_ERROR, "Saved function body has extra tokens", &ctok, 0);
+     }
+
+   if (_pSLang_Error)
+     {
+	if (_pSLang_Error < 0)	       /* severe error */
+	  save_list = NULL;
+
+	while (Token_List != save_list)
+	  {
+	     if (-1 == pop_token_list (1))
+	       break;
+	  }
+     }
+
+   free_token (&ctok);
+   LLT = save_llt;
+   Lazy_Body = save_lazy_body;
+   Lazy_Body_Pos = save_lazy_body_pos;
+   if (Use_Next_Token)
+     free_token (&Next_Token);
+   Use_Next_Token = save_use_next_token;
+   Next_Token = save_next_token;
+   In_Looping_Context = save_looping_context;
+#if SLANG_HAS_BOSEOS
+   _pSLang_Compile_BOSEOS = save_boseos;
+#endif
+#if SLANG_HAS_DEBUG_CODE
+   Last_Line_Number = save_last_line_number;
+#endif
+   if (_pSLang_Error)
+     return -1;
+   return 0;
+}
+
+void _pSLparse_free_lazy_body (_pSLang_Lazy_Body_Type *body)
+{
+   unsigned int i;
+
+   if (body == NULL)
+     return;
+
+   for (i = 0; i < body->num_tokens; i++)
+     {
+	if (body->tokens[i].num_refs)
+	  free_token (body->tokens + i);
+     }
+   SLfree ((char *) body->tokens);
+   SLfree ((char *) body);
+}
+
 /* variable-list:
  * 	variable-decl
  * 	variable-decl variable-list
@@ -0,0 +1,554 @@
+/* A sampling profiler driven by SIGPROF */
+/*
+Copyright (C) 2004-2020,2021 John E. Davis
+
+This file is part of the S-Lang Library.
+
+The S-Lang Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The S-Lang Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+USA.
+*/
+
+#include "slinclud.h"
+
+#include <signal.h>
+#include <errno.h>
+
+#ifdef HAVE_SYS_TIME_H
+# include <sys/time.h>
+#endif
+
+#include "slang.h"
+#include "_slang.h"
+
+/* The SIGPROF handler only counts the timer ticks and asks the interpreter
+ * to take a sample.  The sample is taken by the inner interpreter before the
+ * next bytecode is executed, where it is safe to look at the function stack.
+ * Each sample records the stack of active functions with the current file
+ * and line of each, weighted by the number of ticks since the last sample.
+ * The samples are kept in a ring buffer, and the oldest ones are discarded
+ * when it is full.
+ */
+
+#if SLANG_HAS_SIGNALS && defined(HAVE_SETITIMER) && defined(ITIMER_PROF) && defined(SIGPROF)
+# define SLANG_HAS_PROFILER 1
+#else
+# define SLANG_HAS_PROFILER 0
+#endif
+
+#define DEFAULT_PROFILE_INTERVAL	0.01
+#define DEFAULT_MAX_SAMPLES		20000
+
+typedef struct
+{
+   unsigned int weight;		       /* number of timer ticks */
+   unsigned int num_frames;
+   _pSLang_Profile_Frame_Type *frames; /* frames[0] is the innermost */
+}
+Sample_Type;
+
+static Sample_Type *Samples = NULL;
+static unsigned int Max_Samples = 0;
+static unsigned int Num_Samples = 0;
+static unsigned int Next_Sample = 0;
+static volatile unsigned int Pending_Ticks = 0;
+
+static void free_sample_frames (Sample_Type *s)
+{
+   _pSLang_Profile_Frame_Type *f, *fmax;
+
+   f = s->frames;
+   fmax = f + s->num_frames;
+   while (f < fmax)
+     {
+	SLang_free_slstring (f->function);
+	SLang_free_slstring (f->file);
+	f++;
+     }
+   s->num_frames = 0;
+   s->weight = 0;
+}
+
+static void free_samples (void)
+{
+   unsigned int i;
+
+   if (Samples == NULL)
+     return;
+
+   for (i = 0; i < Max_Samples; i++)
+     {
+	free_sample_frames (Samples + i);
+	SLfree ((char *) Samples[i].frames);
+     }
+   SLfree ((char *) Samples);
+   Samples = NULL;
+   Max_Samples = Num_Samples = Next_Sample = 0;
+}
+
+static void clear_samples (void)
+{
+   unsigned int i;
+
+   for (i = 0; i < Max_Samples; i++)
+     free_sample_frames (Samples + i);
+   Num_Samples = Next_Sample = 0;
+}
+
+static int allocate_samples (unsigned int max_samples)
+{
+   if ((Samples != NULL) && (max_samples == Max_Samples))
+     return 0;
+
+   free_samples ();
+   if (NULL == (Samples = (Sample_Type *)_SLcalloc (max_samples, sizeof (Sample_Type))))
+     return -1;
+   memset ((char *) Samples, 0, max_samples * sizeof (Sample_Type));
+   Max_Samples = max_samples;
+   return 0;
+}
+
+/* This gets called by the interpreter with the stack of active functions */
+void _pSLprof_add_sample (_pSLang_Profile_Frame_Type *frames, unsigned int num_frames)
+{
+   Sample_Type *s;
+   _pSLang_Profile_Frame_Type *f;
+   unsigned int i, weight;
+
+   weight = Pending_Ticks;
+   Pending_Ticks = 0;
+   if ((weight == 0) || (Samples == NULL) || (num_frames == 0))
+     return;
+
+   /* When the buffer is full, this overwrites the oldest sample */
+   s = Samples + Next_Sample;
+   free_sample_frames (s);
+   f = (_pSLang_Profile_Frame_Type *) SLrealloc ((char *) s->frames, num_frames * sizeof (_pSLang_Profile_Frame_Type));
+   if (f == NULL)
+     return;
+   s->frames = f;
+
+   for (i = 0; i < num_frames; i++)
+     {
+	f[i].function = _pSLstring_dup_slstring (frames[i].function);
+	f[i].file = _pSLstring_dup_slstring (frames[i].file);
+	f[i].line = frames[i].line;
+     }
+   s->num_frames = num_frames;
+   s->weight = weight;
+
+   Next_Sample++;
+   if (Next_Sample == Max_Samples)
+     Next_Sample = 0;
+   if (Num_Samples < Max_Samples)
+     Num_Samples++;
+}
+
+#if SLANG_HAS_PROFILER
+static int Profiler_Running = 0;
+static SLSig_Fun_Type *Old_Sigprof_Handler;
+
+static void sigprof_handler (int sig)
+{
+   int e = errno;
+
+   (void) sig;
+# ifndef SLANG_POSIX_SIGNALS
+   (void) SLsignal (SIGPROF, sigprof_handler);
+# endif
+   Pending_Ticks++;
+   _pSLang_signal_profiler ();
+   errno = e;
+}
+
+static int set_profile_timer (double interval)
+{
+   struct itimerval it;
+
+   it.it_interval.tv_sec = (long) interval;
+   it.it_interval.tv_usec = (long) ((interval - (long) interval) * 1e6);
+   it.it_value = it.it_interval;
+
+   if (-1 == setitimer (ITIMER_PROF, &it, NULL))
+     {
+	SLerrno_set_errno (errno);
+	SLang_verror (SL_OS_Error, "setitimer failed: %s", SLerrno_strerror (errno));
+	return -1;
+     }
+   return 0;
+}
+
+static void stop_profiler (void)
+{
+   if (Profiler_Running == 0)
+     return;
+
+   (void) set_profile_timer (0.0);
+   (void) SLsignal (SIGPROF, Old_Sigprof_Handler);
+   Profiler_Running = 0;
+   Pending_Ticks = 0;
+}
+
+/* Usage: _profile_start ([interval [, max_samples]]) */
+static void profile_start_intrin (void)
+{
+   double interval = DEFAULT_PROFILE_INTERVAL;
+   int max_samples = (Max_Samples ? (int) Max_Samples : DEFAULT_MAX_SAMPLES);
+   SLSig_Fun_Type *old_handler;
+
+   switch (SLang_Num_Function_Args)
+     {
+      case 2:
+	if (-1 == SLang_pop_int (&max_samples))
+	  return;
+	/* fall through */
+      case 1:
+	if (-1 == SLang_pop_double (&interval))
+	  return;
+	/* fall through */
+      case 0:
+	break;
+
+      default:
+	SLang_verror (SL_Usage_Error, "Usage: _profile_start ([interval [, max_samples]])");
+	return;
+     }
+
+   if ((interval < 1e-6) || (max_samples <= 0))
+     {
+	SLang_verror (SL_InvalidParm_Error, "_profile_start: the interval and the number of samples must be positive");
+	return;
+     }
+
+   stop_profiler ();
+   if (-1 == allocate_samples ((unsigned int) max_samples))
+     return;
+
+   old_handler = SLsignal (SIGPROF, sigprof_handler);
+   if (old_handler == (SLSig_Fun_Type *) SIG_ERR)
+     {
+	SLang_verror (SL_OS_Error, "Unable to install a SIGPROF handler");
+	return;
+     }
+   Old_Sigprof_Handler = old_handler;
+   Profiler_Running = 1;
+
+   if (-1 == set_profile_timer (interval))
+     stop_profiler ();
+}
+
+static void profile_stop_intrin (void)
+{
+   stop_profiler ();
+}
+
+static void profile_clear_intrin (void)
+{
+   clear_samples ();
+}
+
+/* Calls f for each sample in the buffer */
+static int map_samples (int (*f)(Sample_Type *, VOID_STAR), VOID_STAR cd)
+{
+   unsigned int i, n;
+
+   n = Num_Samples;
+   if (n == 0)
+     return 0;
+   i = (Next_Sample + Max_Samples - n) % Max_Samples;
+   while (n)
+     {
+	if (-1 == (*f)(Samples + i, cd))
+	  return -1;
+	i++;
+	if (i == Max_Samples)
+	  i = 0;
+	n--;
+     }
+   return 0;
+}
+
+typedef struct
+{
+   char *key;			       /* folded stack */
+   Sample_Type *sample;
+   unsigned int weight;
+}
+Sample_Key_Type;
+
+typedef struct
+{
+   Sample_Key_Type *keys;
+   unsigned int num_keys;
+   int with_lines;
+}
+Sample_Keys_Type;
+
+#define TOP_LEVEL_NAME	"<top-level>"
+
+/* Creates the folded form of the stack: outermost first, separated by `;' */
+static int add_folded_key (Sample_Type *s, VOID_STAR cd)
+{
+   Sample_Keys_Type *k = (Sample_Keys_Type *) cd;
+   _pSLang_Profile_Frame_Type *f;
+   unsigned int i;
+   size_t len;
+   char *key, *p;
+
+   len = 0;
+   for (i = 0; i < s->num_frames; i++)
+     {
+	f = s->frames + i;
+	len += strlen ((f->function != NULL) ? f->function : TOP_LEVEL_NAME) + 1;
+	if (k->with_lines)
+	  len += 12;
+     }
+
+   if (NULL == (key = (char *)SLmalloc (len + 1)))
+     return -1;
+
+   p = key;
+   i = s->num_frames;
+   while (i)
+     {
+	i--;
+	f = s->frames + i;
+	strcpy (p, (f->function != NULL) ? f->function : TOP_LEVEL_NAME);
+	p += strlen (p);
+	if (k->with_lines)
+	  {
+	     sprintf (p, ":%u", f->line);
+	     p += strlen (p);
+	  }
+	if (i)
+	  *p++ = ';';
+     }
+   *p = 0;
+
+   k->keys[k->num_keys].key = key;
+   k->keys[k->num_keys].sample = s;
+   k->keys[k->num_keys].weight = s->weight;
+   k->num_keys++;
+   return 0;
+}
+
+static int add_line_key (Sample_Type *s, VOID_STAR cd)
+{
+   Sample_Keys_Type *k = (Sample_Keys_Type *) cd;
+
+   k->keys[k->num_keys].key = NULL;
+   k->keys[k->num_keys].sample = s;
+   k->keys[k->num_keys].weight = s->weight;
+   k->num_keys++;
+   return 0;
+}
+
+static int compare_folded_keys (const void *a, const void *b)
+{
+   return strcmp (((Sample_Key_Type *)a)->key, ((Sample_Key_Type *)b)->key);
+}
+
+static int compare_line_keys (const void *a, const void *b)
+{
+   _pSLang_Profile_Frame_Type *fa = ((Sample_Key_Type *)a)->sample->frames;
+   _pSLang_Profile_Frame_Type *fb = ((Sample_Key_Type *)b)->sample->frames;
+   int cmp;
+
+   if (fa->file != fb->file)
+     {
+	if (fa->file == NULL) return -1;
+	if (fb->file == NULL) return 1;
+	if (0 != (cmp = strcmp (fa->file, fb->file)))
+	  return cmp;
+     }
+   if (fa->line < fb->line) return -1;
+   return (fa->line > fb->line);
+}
+
+static int same_line (Sample_Key_Type *a, Sample_Key_Type *b)
+{
+   return (0 == compare_line_keys (a, b));
+}
+
+static int same_folded_stack (Sample_Key_Type *a, Sample_Key_Type *b)
+{
+   return (0 == strcmp (a->key, b->key));
+}
+
+static void free_sample_keys (Sample_Keys_Type *k)
+{
+   unsigned int i;
+
+   if (k->keys == NULL)
+     return;
+   for (i = 0; i < k->num_keys; i++)
+     SLfree (k->keys[i].key);
+   SLfree ((char *) k->keys);
+}
+
+/* Sorts the samples and sums the weights of those that compare equal.  The
+ * number of distinct keys is returned.
+ */
+static int get_sample_keys (Sample_Keys_Type *k,
+			    int (*add_key)(Sample_Type *, VOID_STAR),
+			    int (*cmp)(const void *, const void *),
+			    int (*same)(Sample_Key_Type *, Sample_Key_Type *))
+{
+   unsigned int i, j;
+
+   k->num_keys = 0;
+   k->keys = NULL;
+   if (Num_Samples == 0)
+     return 0;
+
+   if (NULL == (k->keys = (Sample_Key_Type *)_SLcalloc (Num_Samples, sizeof (Sample_Key_Type))))
+     return -1;
+
+   if (-1 == map_samples (add_key, (VOID_STAR) k))
+     {
+	free_sample_keys (k);
+	return -1;
+     }
+
+   qsort ((VOID_STAR) k->keys, k->num_keys, sizeof (Sample_Key_Type), cmp);
+
+   j = 0;
+   for (i = 1; i < k->num_keys; i++)
+     {
+	if ((*same)(k->keys + j, k->keys + i))
+	  {
+	     k->keys[j].weight += k->keys[i].weight;
+	     continue;
+	  }
+	j++;
+	if (j == i)
+	  continue;
+	SLfree (k->keys[j].key);
+	k->keys[j] = k->keys[i];
+	k->keys[i].key = NULL;
+     }
+   /* Free the keys that were merged */
+   for (i = j + 1; i < k->num_keys; i++)
+     {
+	SLfree (k->keys[i].key);
+	k->keys[i].key = NULL;
+     }
+   k->num_keys = j + 1;
+   return 0;
+}
+
+static SLang_Array_Type *create_weights_array (Sample_Keys_Type *k)
+{
+   SLang_Array_Type *at;
+   SLindex_Type i, n = (SLindex_Type) k->num_keys;
+   int *data;
+
+   if (NULL == (at = SLang_create_array (SLANG_INT_TYPE, 0, NULL, &n, 1)))
+     return NULL;
+   data = (int *) at->data;
+   for (i = 0; i < n; i++)
+     data[i] = (int) k->keys[i].weight;
+   return at;
+}
+
+/* Usage: (stacks, counts) = _profile_folded ([;lines]) */
+static void profile_folded_intrin (void)
+{
+   Sample_Keys_Type k;
+   SLang_Array_Type *at_stacks, *at_counts;
+   SLindex_Type i, n;
+
+   k.with_lines = SLang_qualifier_exists ("lines");
+   if (-1 == get_sample_keys (&k, add_folded_key, compare_folded_keys, same_folded_stack))
+     return;
+
+   n = (SLindex_Type) k.num_keys;
+   at_counts = NULL;
+   if (NULL == (at_stacks = SLang_create_array (SLANG_STRING_TYPE, 0, NULL, &n, 1)))
+     goto free_and_return;
+   for (i = 0; i < n; i++)
+     {
+	if (NULL == (((char **)at_stacks->data)[i] = SLang_create_slstring (k.keys[i].key)))
+	  goto free_and_return;
+     }
+   if (NULL == (at_counts = create_weights_array (&k)))
+     goto free_and_return;
+
+   (void) SLang_push_array (at_stacks, 0);
+   (void) SLang_push_array (at_counts, 0);
+
+free_and_return:
+   SLang_free_array (at_counts);
+   SLang_free_array (at_stacks);
+   free_sample_keys (&k);
+}
+
+/* Usage: (files, lines, counts) = _profile_lines () */
+static void profile_lines_intrin (void)
+{
+   Sample_Keys_Type k;
+   SLang_Array_Type *at_files, *at_lines, *at_counts;
+   SLindex_Type i, n;
+
+   k.with_lines = 1;
+   if (-1 == get_sample_keys (&k, add_line_key, compare_line_keys, same_line))
+     return;
+
+   n = (SLindex_Type) k.num_keys;
+   at_lines = at_counts = NULL;
+   if (NULL == (at_files = SLang_create_array (SLANG_STRING_TYPE, 0, NULL, &n, 1)))
+     goto free_and_return;
+   if (NULL == (at_lines = SLang_create_array (SLANG_INT_TYPE, 0, NULL, &n, 1)))
+     goto free_and_return;
+   for (i = 0; i < n; i++)
+     {
+	_pSLang_Profile_Frame_Type *f = k.keys[i].sample->frames;
+	if ((f->file != NULL)
+	    && (NULL == (((char **)at_files->data)[i] = (char *) _pSLstring_dup_slstring (f->file))))
+	  goto free_and_return;
+	((int *)at_lines->data)[i] = (int) f->line;
+     }
+   if (NULL == (at_counts = create_weights_array (&k)))
+     goto free_and_return;
+
+   (void) SLang_push_array (at_files, 0);
+   (void) SLang_push_array (at_lines, 0);
+   (void) SLang_push_array (at_counts, 0);
+
+free_and_return:
+   SLang_free_array (at_counts);
+   SLang_free_array (at_lines);
+   SLang_free_array (at_files);
+   free_sample_keys (&k);
+}
+
+static SLang_Intrin_Fun_Type Intrin_Table [] =
+{
+   MAKE_INTRINSIC_0("_profile_start", profile_start_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_profile_stop", profile_stop_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_profile_clear", profile_clear_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_profile_folded", profile_folded_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_profile_lines", profile_lines_intrin, SLANG_VOID_TYPE),
+   SLANG_END_INTRIN_FUN_TABLE
+};
+#endif				       /* SLANG_HAS_PROFILER */
+
+int _pSLang_init_slprof (void)
+{
+#if SLANG_HAS_PROFILER
+   if (-1 == SLadd_intrin_fun_table (Intrin_Table, NULL))
+     return -1;
+#endif
+   return 0;
+}
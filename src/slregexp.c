@@ -25,6 +25,8 @@ USA.
 #include "slang.h"
 #include "_slang.h"
 
+typedef struct _pSLRe_Nfa_Type Re_Nfa_Type;
+
 struct _pSLRegexp_Type
 {
    /* These must be set by calling routine. */
@@ -46,6 +48,7 @@ struct _pSLRegexp_Type
 					* to \0
 					*/
    int offset;			       /* offset to be added to beg_matches */
+   Re_Nfa_Type *nfa;		       /* NULL if the pattern needs backtracking */
 };
 
 #define SET_BIT(b, n) b[(unsigned int) (n) >> 3] |= 1 << ((unsigned int) (n) % 8)
@@ -89,6 +92,8 @@ typedef struct
    SLstrlen_Type len;
    char closed_paren_matches[10];
    int open_paren_number;
+   unsigned long num_steps;
+   unsigned long max_steps;	       /* 0 for no limit */
 }
 Re_Context_Type;
 
@@ -159,6 +164,9 @@ static SLCONST unsigned char *regexp_looking_at (Re_Context_Type *ctx,
    int save_num_open;
    char save_closed_matches[10];
 
+   if (ctx->max_steps && (++ctx->num_steps > ctx->max_steps))
+     return NULL;
+
    p = *regexp++;
 
    while (p != 0)
@@ -423,8 +431,12 @@ static void init_re_context (Re_Context_Type *ctx, SLRegexp_Type *reg,
    ctx->len = len;
 }
 
-static SLCONST unsigned char *regexp_match(SLCONST unsigned char *str,
-					   SLstrlen_Type len, SLRegexp_Type *reg)
+/* If max_steps is non-zero, the search is abandoned after that many calls
+ * of regexp_looking_at, in which case *abortedp is set to 1.
+ */
+static SLCONST unsigned char *regexp_match_limited (SLCONST unsigned char *str,
+						    SLstrlen_Type len, SLRegexp_Type *reg,
+						    unsigned long max_steps, int *abortedp)
 {
    unsigned char c = 0;
    SLCONST unsigned char *estr = str + len;
@@ -436,12 +448,18 @@ static SLCONST unsigned char *regexp_match(SLCONST unsigned char *str,
    if (reg->min_length > len) return NULL;
 
    init_re_context (&ctx_buf, reg, str, len);
+   ctx_buf.max_steps = max_steps;
 
    if (*buf == BOL)
      {
 	if (NULL == (epos = regexp_looking_at (&ctx_buf, str, estr, buf + 1, cs)))
 	  str = NULL;
 
+	if (max_steps && (ctx_buf.num_steps > max_steps))
+	  {
+	     *abortedp = 1;
+	     return NULL;
+	  }
 	fixup_beg_end_matches (&ctx_buf, reg, str, epos);
 	return str;
      }
@@ -484,6 +502,11 @@ static SLCONST unsigned char *regexp_match(SLCONST unsigned char *str,
 	     fixup_beg_end_matches (&ctx_buf, reg, str, epos);
 	     return str;
 	  }
+	if (max_steps && (ctx_buf.num_steps > max_steps))
+	  {
+	     *abortedp = 1;
+	     return NULL;
+	  }
 	if (str >= estr)
 	  break;
 	str++;
@@ -492,8 +515,1126 @@ static SLCONST unsigned char *regexp_match(SLCONST unsigned char *str,
    return NULL;
 }
 
+static SLCONST unsigned char *regexp_match (SLCONST unsigned char *str,
+					    SLstrlen_Type len, SLRegexp_Type *reg)
+{
+   int aborted = 0;
+   return regexp_match_limited (str, len, reg, 0, &aborted);
+}
+
+/* Automaton-based matching.
+ *
+ * The backtracking matcher above can take time that grows as a power of
+ * the length of the string, e.g., for a*a*a*a*a*a*b on a long line of a's.
+ * So a compiled pattern that does not use back-references is also
+ * translated into a program for a Thompson NFA.  A string is matched as
+ * follows:
+ *
+ *   1. Unless the pattern uses \< or \>, which look at the neighbouring
+ *      bytes, a DFA that is built from the program as the bytes of strings
+ *      are seen determines whether the string contains a match at all,
+ *      using a table lookup per byte.
+ *   2. Since most patterns need little backtracking, the backtracking
+ *      matcher is tried next, but it is abandoned after a number of steps
+ *      proportional to the length of the string.
+ *   3. Otherwise the program is run.  For short strings, a backtracking
+ *      search of the program is used.  It records the (instruction,
+ *      position) pairs that have been tried, and since a pair that failed
+ *      once will fail again, no pair is tried twice.  Longer strings are
+ *      matched by a Pike VM, which runs all of the threads in step.
+ *
+ * The threads are tried in the order of preference of the backtracking
+ * matcher, so that the same match and submatches are found in each case,
+ * but in time proportional to the length of the string times the length
+ * of the program.
+ */
+#define NFA_CHAR	1		       /* match a byte in set x */
+#define NFA_SPLIT	2		       /* continue at x, and then y */
+#define NFA_JMP		3		       /* continue at x */
+#define NFA_SAVE	4		       /* save the position in slot x */
+#define NFA_EOL		5
+#define NFA_BOW		6
+#define NFA_EOW		7
+#define NFA_MATCH	8
+
+#define NFA_MAX_INSNS	4096
+#define DFA_MAX_STATES	256
+#define BT_MAX_BITS	(256*1024)     /* limit on program length * string length */
+#define BT_STEPS_PER_BYTE 16
+#define DFA_HASH_SIZE	256	       /* must be a power of 2 */
+
+typedef struct
+{
+   unsigned char op;
+   int x, y;
+}
+Nfa_Insn_Type;
+
+typedef struct _Dfa_State_Type
+{
+   int *pcs;			       /* sorted list of NFA_CHAR instructions */
+   unsigned int num_pcs;
+   char is_match;		       /* the state matches */
+   char eol_match;		       /* it matches at the end of the string */
+   unsigned long hash;
+   struct _Dfa_State_Type **next;      /* indexed by byte class */
+   struct _Dfa_State_Type *hash_next;
+   struct _Dfa_State_Type *list_next;
+}
+Dfa_State_Type;
+
+typedef struct
+{
+   int pc;
+   int slot;			       /* if >= 0, restore slot to val */
+   ssize_t val;
+}
+Nfa_Stack_Type;
+
+typedef struct
+{
+   unsigned int num_threads;
+   int *pcs;
+   ssize_t *slots;		       /* num_slots for each thread */
+}
+Nfa_Thread_List_Type;
+
+struct _pSLRe_Nfa_Type
+{
+   Nfa_Insn_Type *insns;
+   unsigned int num_insns;
+   unsigned char (*sets)[32];	       /* bitmaps of bytes */
+   unsigned int num_sets;
+   unsigned int num_slots;
+   int anchored;		       /* pattern began with ^ */
+   int word_anchors;		       /* pattern uses \< or \> */
+   int use_first_set;		       /* a match must begin with a byte in: */
+   unsigned char first_set[32];
+   int first_byte;		       /* the only byte of first_set, or -1 */
+
+   /* Pike VM work space, allocated when first used */
+   Nfa_Thread_List_Type lists[2];
+   unsigned int *marks;		       /* generation in which a pc was added */
+   unsigned int gen;
+   Nfa_Stack_Type *stack;
+   ssize_t *slots;
+   ssize_t *match_slots;
+
+   /* Work space for the backtracking search of short strings */
+   unsigned char *visited;
+   size_t visited_size;
+   Nfa_Stack_Type *bt_stack;
+   size_t bt_stack_size;
+
+   /* The DFA */
+   int use_dfa;
+   unsigned char byte_class[256];
+   unsigned char class_byte[256];      /* a byte of each class */
+   unsigned int num_classes;
+   Dfa_State_Type *dfa_start;
+   Dfa_State_Type *dfa_hash[DFA_HASH_SIZE];
+   Dfa_State_Type *dfa_states;
+   unsigned int num_dfa_states;
+   int *dfa_pcs;			       /* work space */
+};
+
+static void free_dfa_states (Re_Nfa_Type *nfa)
+{
+   Dfa_State_Type *s, *next;
+
+   s = nfa->dfa_states;
+   while (s != NULL)
+     {
+	next = s->list_next;
+	SLfree ((char *) s->pcs);
+	SLfree ((char *) s->next);
+	SLfree ((char *) s);
+	s = next;
+     }
+   nfa->dfa_states = NULL;
+   nfa->dfa_start = NULL;
+   nfa->num_dfa_states = 0;
+   memset ((char *) nfa->dfa_hash, 0, sizeof (nfa->dfa_hash));
+}
+
+static void free_nfa (Re_Nfa_Type *nfa)
+{
+   unsigned int i;
+
+   if (nfa == NULL)
+     return;
+
+   free_dfa_states (nfa);
+   for (i = 0; i < 2; i++)
+     {
+	SLfree ((char *) nfa->lists[i].pcs);
+	SLfree ((char *) nfa->lists[i].slots);
+     }
+   SLfree ((char *) nfa->marks);
+   SLfree ((char *) nfa->stack);
+   SLfree ((char *) nfa->slots);
+   SLfree ((char *) nfa->match_slots);
+   SLfree ((char *) nfa->visited);
+   SLfree ((char *) nfa->bt_stack);
+   SLfree ((char *) nfa->dfa_pcs);
+   SLfree ((char *) nfa->sets);
+   SLfree ((char *) nfa->insns);
+   SLfree ((char *) nfa);
+}
+
+/* Returns the number of the instruction, or -1 if the program is too long */
+static int nfa_emit (Re_Nfa_Type *nfa, unsigned char op, int x, int y)
+{
+   Nfa_Insn_Type *insn;
+
+   if (nfa->num_insns >= NFA_MAX_INSNS)
+     return -1;
+   insn = nfa->insns + nfa->num_insns;
+   insn->op = op;
+   insn->x = x;
+   insn->y = y;
+   return (int) nfa->num_insns++;
+}
+
+/* Returns the index of the set, adding it if it is not already there */
+static int nfa_add_set (Re_Nfa_Type *nfa, unsigned char *set)
+{
+   unsigned int i;
+
+   for (i = 0; i < nfa->num_sets; i++)
+     {
+	if (0 == memcmp ((char *) nfa->sets[i], (char *) set, 32))
+	  return (int) i;
+     }
+   /* There can be no more sets than instructions */
+   memcpy ((char *) nfa->sets[i], (char *) set, 32);
+   nfa->num_sets++;
+   return (int) i;
+}
+
+/* Computes the set of bytes matched by the atom whose code is at buf, and
+ * returns a pointer past the code, or NULL if the atom is not supported.
+ */
+static unsigned char *nfa_atom_set (unsigned char *buf, unsigned char op, int cs,
+				    unsigned char *set)
+{
+   unsigned int c;
+   unsigned char lit;
+
+   memset ((char *) set, 0, 32);
+   switch (op)
+     {
+      case LITERAL:
+	lit = *buf++;
+	for (c = 0; c < 256; c++)
+	  {
+	     if (lit == UPPERCASE(c)) SET_BIT(set, c);
+	  }
+	return buf;
+
+      case RANGE:
+	for (c = 0; c < 256; c++)
+	  {
+	     if (TEST_BIT(buf, UPPERCASE(c))) SET_BIT(set, c);
+	  }
+	return buf + 32;
+
+      case ANY:
+	for (c = 0; c < 256; c++)
+	  {
+	     if (c != '\n') SET_BIT(set, c);
+	  }
+	return buf;
+
+      case ANY_DIGIT:
+      case ANY_NONDIGIT:
+	for (c = 0; c < 256; c++)
+	  {
+	     if (((c <= '9') && (c >= '0')) == (op == ANY_DIGIT)) SET_BIT(set, c);
+	  }
+	return buf;
+
+      case ANY_SPACE:
+      case ANY_NONSPACE:
+	for (c = 0; c < 256; c++)
+	  {
+	     if (IS_WHITESPACE(c) == (op == ANY_SPACE)) SET_BIT(set, c);
+	  }
+	return buf;
+     }
+   return NULL;
+}
+
+/* x* is compiled as L: SPLIT L+1,L+3; CHAR x; JMP L */
+static int nfa_emit_star (Re_Nfa_Type *nfa, int set)
+{
+   int l = (int) nfa->num_insns;
+
+   if ((-1 == nfa_emit (nfa, NFA_SPLIT, l + 1, l + 3))
+       || (-1 == nfa_emit (nfa, NFA_CHAR, set, 0))
+       || (-1 == nfa_emit (nfa, NFA_JMP, l, 0)))
+     return -1;
+   return 0;
+}
+
+/* Divides the bytes into classes such that the bytes of a class are in
+ * the same NFA sets.  The DFA transitions are indexed by class.
+ */
+static void nfa_compute_byte_classes (Re_Nfa_Type *nfa)
+{
+   unsigned short map[2*256];
+   unsigned int i, c, n;
+
+   memset ((char *) nfa->byte_class, 0, 256);
+   n = 1;
+   for (i = 0; i < nfa->num_sets; i++)
+     {
+	unsigned int m = 0;
+
+	memset ((char *) map, 0xFF, sizeof (map));
+	for (c = 0; c < 256; c++)
+	  {
+	     unsigned int k = 2 * nfa->byte_class[c] + (0 != TEST_BIT(nfa->sets[i], c));
+	     if (map[k] == 0xFFFF)
+	       map[k] = (unsigned short) m++;
+	     nfa->byte_class[c] = (unsigned char) map[k];
+	  }
+	n = m;
+     }
+   nfa->num_classes = n;
+   for (c = 256; c > 0; c--)
+     nfa->class_byte[nfa->byte_class[c-1]] = (unsigned char) (c-1);
+}
+
+/* Translates the code of a compiled pattern.  Returns 0 upon success, in
+ * which case reg->nfa will be NULL if the pattern is not supported, or -1
+ * upon error.
+ */
+static int compile_nfa (SLRegexp_Type *reg)
+{
+   Re_Nfa_Type *nfa;
+   unsigned char *buf = reg->buf;
+   unsigned char set[32];
+   int open_groups[10];
+   int num_open = 0, num_groups = 0;
+   int cs = reg->case_sensitive;
+   Nfa_Insn_Type *insns;
+   unsigned char (*sets)[32];
+   unsigned char p;
+   unsigned int pc;
+
+   reg->nfa = NULL;
+
+   if (NULL == (nfa = (Re_Nfa_Type *) SLcalloc (1, sizeof (Re_Nfa_Type))))
+     return -1;
+   if ((NULL == (nfa->insns = (Nfa_Insn_Type *) SLcalloc (NFA_MAX_INSNS, sizeof (Nfa_Insn_Type))))
+       || (NULL == (nfa->sets = (unsigned char (*)[32]) SLcalloc (NFA_MAX_INSNS, 32))))
+     {
+	free_nfa (nfa);
+	return -1;
+     }
+
+   if (*buf == BOL)
+     {
+	nfa->anchored = 1;
+	buf++;
+     }
+   (void) nfa_emit (nfa, NFA_SAVE, 0, 0);
+
+   while (0 != (p = *buf++))
+     {
+	unsigned char op = p & 0x0F;
+	int k, n0, n1, i, l;
+	int splits[256];
+
+	switch (p)
+	  {
+	   case YES_CASE: cs = 1; continue;
+	   case NO_CASE: cs = 0; continue;
+
+	   case OPAREN:
+	     if ((num_groups == 9) || (num_open == 10))
+	       goto not_supported;
+	     num_groups++;
+	     open_groups[num_open++] = num_groups;
+	     if (-1 == nfa_emit (nfa, NFA_SAVE, 2 * num_groups, 0))
+	       goto not_supported;
+	     continue;
+
+	   case CPAREN:
+	     if (num_open == 0)
+	       goto not_supported;
+	     num_open--;
+	     if (-1 == nfa_emit (nfa, NFA_SAVE, 2 * open_groups[num_open] + 1, 0))
+	       goto not_supported;
+	     continue;
+
+	   case BOW:
+	   case EOW:
+	     if (-1 == nfa_emit (nfa, (p == BOW) ? NFA_BOW : NFA_EOW, 0, 0))
+	       goto not_supported;
+	     continue;
+
+	   case EOL:
+	     if (-1 == nfa_emit (nfa, NFA_EOL, 0, 0))
+	       goto not_supported;
+	     /* This is always the last item of the pattern */
+	     p = 0;
+	     break;
+	  }
+	if (p == 0)
+	  break;
+
+	if (NULL == (buf = nfa_atom_set (buf, op, cs, set)))
+	  goto not_supported;	       /* back-references */
+	k = nfa_add_set (nfa, set);
+
+	switch (p & 0xF0)
+	  {
+	   case 0:
+	     if (-1 == nfa_emit (nfa, NFA_CHAR, k, 0))
+	       goto not_supported;
+	     break;
+
+	   case STAR:
+	     if (-1 == nfa_emit_star (nfa, k))
+	       goto not_supported;
+	     break;
+
+	   case LEAST_ONCE:
+	     l = (int) nfa->num_insns;
+	     if ((-1 == nfa_emit (nfa, NFA_CHAR, k, 0))
+		 || (-1 == nfa_emit (nfa, NFA_SPLIT, l, l + 2)))
+	       goto not_supported;
+	     break;
+
+	   case MAYBE_ONCE:
+	     l = (int) nfa->num_insns;
+	     if ((-1 == nfa_emit (nfa, NFA_SPLIT, l + 1, l + 2))
+		 || (-1 == nfa_emit (nfa, NFA_CHAR, k, 0)))
+	       goto not_supported;
+	     break;
+
+	   case MANY:
+	     n0 = *buf++;
+	     n1 = *buf++;
+	     for (i = 0; i < n0; i++)
+	       {
+		  if (-1 == nfa_emit (nfa, NFA_CHAR, k, 0))
+		    goto not_supported;
+	       }
+	     if (n1 < n0)
+	       {
+		  /* The backtracking matcher has no upper limit in this case */
+		  if (-1 == nfa_emit_star (nfa, k))
+		    goto not_supported;
+		  break;
+	       }
+	     /* x{0,m} is compiled as (x(x(x...)?)?)?, with each SPLIT
+	      * continuing after the last x when the byte does not match.
+	      */
+	     for (i = 0; i < n1 - n0; i++)
+	       {
+		  l = (int) nfa->num_insns;
+		  if ((-1 == nfa_emit (nfa, NFA_SPLIT, l + 1, 0))
+		      || (-1 == nfa_emit (nfa, NFA_CHAR, k, 0)))
+		    goto not_supported;
+		  splits[i] = l;
+	       }
+	     for (i = 0; i < n1 - n0; i++)
+	       nfa->insns[splits[i]].y = (int) nfa->num_insns;
+	     break;
+
+	   default:
+	     goto not_supported;
+	  }
+     }
+
+   if ((-1 == nfa_emit (nfa, NFA_SAVE, 1, 0))
+       || (-1 == nfa_emit (nfa, NFA_MATCH, 0, 0)))
+     goto not_supported;
+
+   /* Release the unused space */
+   insns = (Nfa_Insn_Type *) SLrealloc ((char *) nfa->insns, nfa->num_insns * sizeof (Nfa_Insn_Type));
+   if (insns != NULL) nfa->insns = insns;
+   sets = (unsigned char (*)[32]) SLrealloc ((char *) nfa->sets, (nfa->num_sets + 1) * 32);
+   if (sets != NULL) nfa->sets = sets;
+
+   nfa->num_slots = 2 * (num_groups + 1);
+   for (pc = 0; pc < nfa->num_insns; pc++)
+     {
+	if ((nfa->insns[pc].op == NFA_BOW) || (nfa->insns[pc].op == NFA_EOW))
+	  nfa->word_anchors = 1;
+     }
+   nfa->use_dfa = (nfa->word_anchors == 0);
+   nfa_compute_byte_classes (nfa);
+   reg->nfa = nfa;
+   return 0;
+
+not_supported:
+   free_nfa (nfa);
+   return 0;
+}
+
+static int nfa_alloc_work (Re_Nfa_Type *nfa)
+{
+   unsigned int n = nfa->num_insns;
+   unsigned int i;
+
+   if (nfa->marks != NULL)
+     return 0;
+
+   for (i = 0; i < 2; i++)
+     {
+	if ((NULL == (nfa->lists[i].pcs = (int *) SLmalloc (n * sizeof (int))))
+	    || (NULL == (nfa->lists[i].slots = (ssize_t *) SLmalloc (n * nfa->num_slots * sizeof (ssize_t)))))
+	  return -1;
+     }
+   if ((NULL == (nfa->stack = (Nfa_Stack_Type *) SLmalloc ((n + 1) * sizeof (Nfa_Stack_Type))))
+       || (NULL == (nfa->slots = (ssize_t *) SLmalloc (nfa->num_slots * sizeof (ssize_t))))
+       || (NULL == (nfa->match_slots = (ssize_t *) SLmalloc (nfa->num_slots * sizeof (ssize_t))))
+       || (NULL == (nfa->dfa_pcs = (int *) SLmalloc (n * sizeof (int))))
+       || (NULL == (nfa->marks = (unsigned int *) SLcalloc (n, sizeof (unsigned int)))))
+     return -1;
+   return 0;
+}
+
+/* Returns a new generation for the marks */
+static unsigned int nfa_next_gen (Re_Nfa_Type *nfa)
+{
+   nfa->gen++;
+   if (nfa->gen == 0)
+     {
+	memset ((char *) nfa->marks, 0, nfa->num_insns * sizeof (unsigned int));
+	nfa->gen = 1;
+     }
+   return nfa->gen;
+}
+
+/* Follows the instructions that do not consume a byte from pc, and adds
+ * the threads that reach an NFA_CHAR or NFA_MATCH to the list, in the
+ * order of preference.  The slots of the threads are those in nfa->slots
+ * as modified by the NFA_SAVE instructions along the way.
+ */
+static void nfa_add_thread (Re_Nfa_Type *nfa, Nfa_Thread_List_Type *list, int pc,
+			    SLCONST unsigned char *str, SLstrlen_Type len, SLstrlen_Type pos)
+{
+   Nfa_Stack_Type *stack = nfa->stack;
+   ssize_t *slots = nfa->slots;
+   unsigned int num_slots = nfa->num_slots;
+   unsigned int gen = nfa->gen;
+   unsigned int n = 0;
+
+   stack[n].pc = pc;
+   stack[n].slot = -1;
+   n++;
+
+   while (n)
+     {
+	n--;
+	if (stack[n].slot >= 0)
+	  {
+	     slots[stack[n].slot] = stack[n].val;
+	     continue;
+	  }
+	pc = stack[n].pc;
+
+	while (nfa->marks[pc] != gen)
+	  {
+	     Nfa_Insn_Type *insn = nfa->insns + pc;
+
+	     nfa->marks[pc] = gen;
+	     switch (insn->op)
+	       {
+		case NFA_JMP:
+		  pc = insn->x;
+		  continue;
+
+		case NFA_SPLIT:
+		  stack[n].pc = insn->y;
+		  stack[n].slot = -1;
+		  n++;
+		  pc = insn->x;
+		  continue;
+
+		case NFA_SAVE:
+		  stack[n].slot = insn->x;
+		  stack[n].val = slots[insn->x];
+		  n++;
+		  slots[insn->x] = (ssize_t) pos;
+		  pc++;
+		  continue;
+
+		case NFA_EOL:
+		  if ((pos == len) || ((pos + 1 == len) && (str[pos] == '\n')))
+		    {
+		       pc++;
+		       continue;
+		    }
+		  break;
+
+		case NFA_BOW:
+		  if ((pos == 0)
+		      || ((pos < len) && (0 == IS_WORD_CHAR(str[pos-1])) && IS_WORD_CHAR(str[pos])))
+		    {
+		       pc++;
+		       continue;
+		    }
+		  break;
+
+		case NFA_EOW:
+		  if ((pos == len) || (0 == IS_WORD_CHAR(str[pos])))
+		    {
+		       pc++;
+		       continue;
+		    }
+		  break;
+
+		default:		       /* NFA_CHAR, NFA_MATCH */
+		  list->pcs[list->num_threads] = pc;
+		  memcpy ((char *) (list->slots + list->num_threads * num_slots),
+			  (char *) slots, num_slots * sizeof (ssize_t));
+		  list->num_threads++;
+		  break;
+	       }
+	     break;
+	  }
+     }
+}
+
+/* Adds the NFA_CHAR instructions reachable from pc to the list being
+ * built in nfa->dfa_pcs.
+ */
+static void dfa_add_pcs (Re_Nfa_Type *nfa, int pc, unsigned int *nump,
+			 char *is_matchp, char *eol_matchp)
+{
+   Nfa_Stack_Type *stack = nfa->stack;
+   unsigned int gen = nfa->gen;
+   unsigned int n = 0;
+
+   stack[n++].pc = pc;
+   while (n)
+     {
+	pc = stack[--n].pc;
+	while (nfa->marks[pc] != gen)
+	  {
+	     Nfa_Insn_Type *insn = nfa->insns + pc;
+
+	     nfa->marks[pc] = gen;
+	     switch (insn->op)
+	       {
+		case NFA_JMP:
+		  pc = insn->x;
+		  continue;
+
+		case NFA_SPLIT:
+		  stack[n++].pc = insn->y;
+		  pc = insn->x;
+		  continue;
+
+		case NFA_SAVE:
+		  pc++;
+		  continue;
+
+		case NFA_EOL:
+		  *eol_matchp = 1;
+		  break;
+
+		case NFA_MATCH:
+		  *is_matchp = 1;
+		  break;
+
+		case NFA_CHAR:
+		  nfa->dfa_pcs[(*nump)++] = pc;
+		  break;
+	       }
+	     break;
+	  }
+     }
+}
+
+static int compare_pcs (const void *a, const void *b)
+{
+   return *(const int *) a - *(const int *) b;
+}
+
+/* Returns the DFA state for the list of instructions in nfa->dfa_pcs, or
+ * NULL if there are too many states.
+ */
+static Dfa_State_Type *dfa_get_state (Re_Nfa_Type *nfa, unsigned int num_pcs,
+				      char is_match, char eol_match)
+{
+   Dfa_State_Type *s;
+   int *pcs = nfa->dfa_pcs;
+   unsigned long hash;
+   unsigned int i;
+
+   qsort ((char *) pcs, num_pcs, sizeof (int), compare_pcs);
+   hash = 2166136261UL ^ (unsigned long) (2*is_match + eol_match);
+   for (i = 0; i < num_pcs; i++)
+     hash = (hash ^ (unsigned long) pcs[i]) * 16777619UL;
+
+   s = nfa->dfa_hash[hash & (DFA_HASH_SIZE-1)];
+   while (s != NULL)
+     {
+	if ((s->hash == hash) && (s->num_pcs == num_pcs)
+	    && (s->is_match == is_match) && (s->eol_match == eol_match)
+	    && (0 == memcmp ((char *) s->pcs, (char *) pcs, num_pcs * sizeof (int))))
+	  return s;
+	s = s->hash_next;
+     }
+
+   if (nfa->num_dfa_states == DFA_MAX_STATES)
+     return NULL;
+
+   if (NULL == (s = (Dfa_State_Type *) SLcalloc (1, sizeof (Dfa_State_Type))))
+     return NULL;
+   if ((NULL == (s->pcs = (int *) SLmalloc ((num_pcs + 1) * sizeof (int))))
+       || (NULL == (s->next = (Dfa_State_Type **) SLcalloc (nfa->num_classes, sizeof (Dfa_State_Type *)))))
+     {
+	SLfree ((char *) s->pcs);
+	SLfree ((char *) s);
+	return NULL;
+     }
+   memcpy ((char *) s->pcs, (char *) pcs, num_pcs * sizeof (int));
+   s->num_pcs = num_pcs;
+   s->is_match = is_match;
+   s->eol_match = eol_match;
+   s->hash = hash;
+   s->hash_next = nfa->dfa_hash[hash & (DFA_HASH_SIZE-1)];
+   nfa->dfa_hash[hash & (DFA_HASH_SIZE-1)] = s;
+   s->list_next = nfa->dfa_states;
+   nfa->dfa_states = s;
+   nfa->num_dfa_states++;
+   return s;
+}
+
+/* Computes the state that follows s upon a byte of class cls.  Unless the
+ * pattern is anchored, a match may begin at any byte, so the start of the
+ * program is added to every state.
+ */
+static Dfa_State_Type *dfa_next_state (Re_Nfa_Type *nfa, Dfa_State_Type *s, unsigned int cls)
+{
+   unsigned int ch = nfa->class_byte[cls];
+   unsigned int i, num_pcs = 0;
+   char is_match = 0, eol_match = 0;
+
+   (void) nfa_next_gen (nfa);
+   for (i = 0; i < s->num_pcs; i++)
+     {
+	int pc = s->pcs[i];
+	if (TEST_BIT(nfa->sets[nfa->insns[pc].x], ch))
+	  dfa_add_pcs (nfa, pc + 1, &num_pcs, &is_match, &eol_match);
+     }
+   if (nfa->anchored == 0)
+     dfa_add_pcs (nfa, 0, &num_pcs, &is_match, &eol_match);
+
+   return s->next[cls] = dfa_get_state (nfa, num_pcs, is_match, eol_match);
+}
+
+/* If every match must begin with a byte from a known set, the positions
+ * where other bytes occur need not be tried.
+ */
+static void nfa_compute_first_set (Re_Nfa_Type *nfa)
+{
+   unsigned int i, c, num_pcs = 0, num_bytes = 0;
+   char is_match = 0, eol_match = 0;
+
+   nfa->use_first_set = 0;
+   nfa->first_byte = -1;
+   if (nfa->anchored || nfa->word_anchors)
+     return;
+
+   (void) nfa_next_gen (nfa);
+   dfa_add_pcs (nfa, 0, &num_pcs, &is_match, &eol_match);
+   if (is_match || eol_match)
+     return;
+
+   memset ((char *) nfa->first_set, 0, 32);
+   for (i = 0; i < num_pcs; i++)
+     {
+	unsigned char *set = nfa->sets[nfa->insns[nfa->dfa_pcs[i]].x];
+	for (c = 0; c < 32; c++)
+	  nfa->first_set[c] |= set[c];
+     }
+   for (c = 0; c < 256; c++)
+     {
+	if (TEST_BIT(nfa->first_set, c))
+	  {
+	     num_bytes++;
+	     nfa->first_byte = (int) c;
+	  }
+     }
+   if (num_bytes != 1)
+     nfa->first_byte = -1;
+   nfa->use_first_set = 1;
+}
+
+/* Returns the position of the first byte at or after pos that may begin
+ * a match, or len if there is none.
+ */
+static SLstrlen_Type nfa_skip_to_first (Re_Nfa_Type *nfa, SLCONST unsigned char *str,
+					SLstrlen_Type pos, SLstrlen_Type len)
+{
+   if (nfa->first_byte != -1)
+     {
+	SLCONST unsigned char *p;
+
+	if (pos >= len)
+	  return len;
+	p = (SLCONST unsigned char *) memchr ((char *) str + pos, nfa->first_byte, len - pos);
+	return (p == NULL) ? len : (SLstrlen_Type) (p - str);
+     }
+   while ((pos < len) && (0 == TEST_BIT(nfa->first_set, str[pos])))
+     pos++;
+   return pos;
+}
+
+/* Returns 1 if the string contains a match, 0 if not, or -1 if the DFA
+ * has grown too large.
+ */
+static int dfa_search (Re_Nfa_Type *nfa, SLCONST unsigned char *str, SLstrlen_Type len)
+{
+   Dfa_State_Type *s;
+   SLstrlen_Type pos;
+
+   if (NULL == (s = nfa->dfa_start))
+     {
+	unsigned int num_pcs = 0;
+	char is_match = 0, eol_match = 0;
+
+	(void) nfa_next_gen (nfa);
+	dfa_add_pcs (nfa, 0, &num_pcs, &is_match, &eol_match);
+	if (NULL == (s = nfa->dfa_start = dfa_get_state (nfa, num_pcs, is_match, eol_match)))
+	  return -1;
+     }
+
+   pos = 0;
+   while (1)
+     {
+	Dfa_State_Type *next;
+	unsigned int cls;
+
+	if ((s == nfa->dfa_start) && nfa->use_first_set)
+	  {
+	     if (len == (pos = nfa_skip_to_first (nfa, str, pos, len)))
+	       return 0;
+	  }
+	if (s->is_match)
+	  return 1;
+	if (s->eol_match
+	    && ((pos == len) || ((pos + 1 == len) && (str[pos] == '\n'))))
+	  return 1;
+	if ((pos == len) || ((s->num_pcs == 0) && (s->eol_match == 0)))
+	  return 0;
+
+	cls = nfa->byte_class[str[pos]];
+	if ((NULL == (next = s->next[cls]))
+	    && (NULL == (next = dfa_next_state (nfa, s, cls))))
+	  return -1;
+	s = next;
+	pos++;
+     }
+}
+
+static void nfa_set_no_match (SLRegexp_Type *reg)
+{
+   unsigned int i;
+
+   for (i = 0; i < 10; i++)
+     {
+	reg->beg_matches[i] = -1;
+	reg->end_matches[i] = 0;
+     }
+}
+
+static int nfa_push_bt (Re_Nfa_Type *nfa, size_t *np, int pc, int slot, ssize_t val)
+{
+   Nfa_Stack_Type *e;
+
+   if (*np == nfa->bt_stack_size)
+     {
+	size_t size = 2 * nfa->bt_stack_size + 64;
+	e = (Nfa_Stack_Type *) SLrealloc ((char *) nfa->bt_stack, size * sizeof (Nfa_Stack_Type));
+	if (e == NULL)
+	  return -1;
+	nfa->bt_stack = e;
+	nfa->bt_stack_size = size;
+     }
+   e = nfa->bt_stack + *np;
+   e->pc = pc;
+   e->slot = slot;
+   e->val = val;
+   *np += 1;
+   return 0;
+}
+
+/* Returns 1 if the program matches at start, 0 if not, or -1 upon error.
+ * An entry of the stack with slot < 0 is a thread at position val.
+ */
+static int nfa_backtrack (Re_Nfa_Type *nfa, SLCONST unsigned char *str, SLstrlen_Type len,
+			  SLstrlen_Type start)
+{
+   ssize_t *slots = nfa->slots;
+   size_t n = 0;
+   unsigned int i;
+
+   for (i = 0; i < nfa->num_slots; i++)
+     slots[i] = -1;
+
+   if (-1 == nfa_push_bt (nfa, &n, 0, -1, (ssize_t) start))
+     return -1;
+
+   while (n)
+     {
+	Nfa_Stack_Type *e = nfa->bt_stack + (--n);
+	SLstrlen_Type pos;
+	int pc;
+
+	if (e->slot >= 0)
+	  {
+	     slots[e->slot] = e->val;
+	     continue;
+	  }
+	pc = e->pc;
+	pos = (SLstrlen_Type) e->val;
+
+	while (1)
+	  {
+	     Nfa_Insn_Type *insn = nfa->insns + pc;
+	     size_t bit = (size_t) pc * (len + 1) + pos;
+
+	     if (TEST_BIT(nfa->visited, bit))
+	       break;
+	     SET_BIT(nfa->visited, bit);
+
+	     switch (insn->op)
+	       {
+		case NFA_CHAR:
+		  if ((pos < len) && TEST_BIT(nfa->sets[insn->x], str[pos]))
+		    {
+		       pc++;
+		       pos++;
+		       continue;
+		    }
+		  break;
+
+		case NFA_MATCH:
+		  memcpy ((char *) nfa->match_slots, (char *) slots, nfa->num_slots * sizeof (ssize_t));
+		  return 1;
+
+		case NFA_JMP:
+		  pc = insn->x;
+		  continue;
+
+		case NFA_SPLIT:
+		  if (-1 == nfa_push_bt (nfa, &n, insn->y, -1, (ssize_t) pos))
+		    return -1;
+		  pc = insn->x;
+		  continue;
+
+		case NFA_SAVE:
+		  if (-1 == nfa_push_bt (nfa, &n, 0, insn->x, slots[insn->x]))
+		    return -1;
+		  slots[insn->x] = (ssize_t) pos;
+		  pc++;
+		  continue;
+
+		case NFA_EOL:
+		  if ((pos == len) || ((pos + 1 == len) && (str[pos] == '\n')))
+		    {
+		       pc++;
+		       continue;
+		    }
+		  break;
+
+		case NFA_BOW:
+		  if ((pos == 0)
+		      || ((pos < len) && (0 == IS_WORD_CHAR(str[pos-1])) && IS_WORD_CHAR(str[pos])))
+		    {
+		       pc++;
+		       continue;
+		    }
+		  break;
+
+		case NFA_EOW:
+		  if ((pos == len) || (0 == IS_WORD_CHAR(str[pos])))
+		    {
+		       pc++;
+		       continue;
+		    }
+		  break;
+	       }
+	     break;
+	  }
+     }
+   return 0;
+}
+
+/* Returns 1 if there is a match, 0 if not, or -1 if the work space could
+ * not be allocated.  The work space is proportional to the product of the
+ * lengths of the string and of the program.
+ */
+static int nfa_backtrack_search (Re_Nfa_Type *nfa, SLCONST unsigned char *str, SLstrlen_Type len)
+{
+   size_t nbytes = ((size_t) nfa->num_insns * (len + 1) + 7) / 8;
+   SLstrlen_Type pos = 0;
+   int ret;
+
+   if (nbytes > nfa->visited_size)
+     {
+	unsigned char *visited = (unsigned char *) SLrealloc ((char *) nfa->visited, nbytes);
+	if (visited == NULL)
+	  return -1;
+	nfa->visited = visited;
+	nfa->visited_size = nbytes;
+     }
+   memset ((char *) nfa->visited, 0, nbytes);
+
+   while (1)
+     {
+	if (nfa->use_first_set
+	    && (len == (pos = nfa_skip_to_first (nfa, str, pos, len))))
+	  return 0;
+	if (0 != (ret = nfa_backtrack (nfa, str, len, pos)))
+	  return ret;
+	if (nfa->anchored || (pos == len))
+	  return 0;
+	pos++;
+     }
+}
+
+/* This finds the same match as regexp_match, and sets the submatches in
+ * the same way.
+ */
+static SLCONST unsigned char *nfa_match (SLRegexp_Type *reg,
+					 SLCONST unsigned char *str, SLstrlen_Type len)
+{
+   Re_Nfa_Type *nfa = reg->nfa;
+   Nfa_Thread_List_Type *clist, *nlist, *tmp;
+   unsigned int num_slots = nfa->num_slots;
+   int matched = 0;
+   SLstrlen_Type pos;
+   unsigned int i;
+
+   if (nfa->marks == NULL)
+     {
+	if (-1 == nfa_alloc_work (nfa))
+	  return regexp_match (str, len, reg);
+	nfa_compute_first_set (nfa);
+     }
+
+   if (nfa->use_dfa)
+     {
+	switch (dfa_search (nfa, str, len))
+	  {
+	   case 0:
+	     nfa_set_no_match (reg);
+	     return NULL;
+	   case -1:
+	     /* Too many states for this pattern.  Use the VM alone. */
+	     free_dfa_states (nfa);
+	     nfa->use_dfa = 0;
+	     break;
+	  }
+     }
+
+   /* Most patterns need little backtracking, and the backtracking matcher
+    * is the fastest way to find the submatches.
+    */
+   {
+      SLCONST unsigned char *m;
+      int aborted = 0;
+
+      m = regexp_match_limited (str, len, reg, BT_STEPS_PER_BYTE * ((unsigned long) len + 1), &aborted);
+      if (aborted == 0)
+	return m;
+   }
+
+   if ((size_t) nfa->num_insns * (len + 1) <= BT_MAX_BITS)
+     {
+	int ret = nfa_backtrack_search (nfa, str, len);
+	if (ret == -1)
+	  return regexp_match (str, len, reg);
+	matched = ret;
+	goto return_match;
+     }
+
+   clist = nfa->lists;
+   nlist = nfa->lists + 1;
+   clist->num_threads = 0;
+   pos = 0;
+   while (1)
+     {
+	if (clist->num_threads == 0)
+	  {
+	     /* Start a new thread only where a match may begin */
+	     if (matched || (nfa->anchored && (pos > 0)))
+	       break;
+	     if (nfa->use_first_set
+		 && (len == (pos = nfa_skip_to_first (nfa, str, pos, len))))
+	       break;
+	     for (i = 0; i < num_slots; i++)
+	       nfa->slots[i] = -1;
+	     (void) nfa_next_gen (nfa);
+	     nfa_add_thread (nfa, clist, 0, str, len, pos);
+	  }
+
+	(void) nfa_next_gen (nfa);
+	nlist->num_threads = 0;
+	for (i = 0; i < clist->num_threads; i++)
+	  {
+	     ssize_t *slots = clist->slots + i * num_slots;
+	     int pc = clist->pcs[i];
+	     Nfa_Insn_Type *insn = nfa->insns + pc;
+
+	     if (insn->op == NFA_MATCH)
+	       {
+		  /* The threads that follow have a lower preference */
+		  memcpy ((char *) nfa->match_slots, (char *) slots, num_slots * sizeof (ssize_t));
+		  matched = 1;
+		  break;
+	       }
+	     if ((pos < len) && TEST_BIT(nfa->sets[insn->x], str[pos]))
+	       {
+		  memcpy ((char *) nfa->slots, (char *) slots, num_slots * sizeof (ssize_t));
+		  nfa_add_thread (nfa, nlist, pc + 1, str, len, pos + 1);
+	       }
+	  }
+	if (pos == len)
+	  break;
+	pos++;
+
+	/* A match that begins here has the lowest preference */
+	if ((matched == 0) && (nfa->anchored == 0)
+	    && ((nfa->use_first_set == 0)
+		|| ((pos < len) && TEST_BIT(nfa->first_set, str[pos]))))
+	  {
+	     for (i = 0; i < num_slots; i++)
+	       nfa->slots[i] = -1;
+	     nfa_add_thread (nfa, nlist, 0, str, len, pos);
+	  }
+	tmp = clist; clist = nlist; nlist = tmp;
+     }
+
+return_match:
+   nfa_set_no_match (reg);
+   if (matched == 0)
+     return NULL;
+
+   for (i = 0; i < num_slots/2; i++)
+     {
+	reg->beg_matches[i] = nfa->match_slots[2*i];
+	reg->end_matches[i] = (size_t) (nfa->match_slots[2*i+1] - nfa->match_slots[2*i]);
+     }
+   return str + nfa->match_slots[0];
+}
+
 char *SLregexp_match (SLRegexp_Type *reg, SLFUTURE_CONST char *str, SLstrlen_Type len)
 {
+   if ((reg->nfa != NULL) && (reg->min_length <= len))
+     return (char *) nfa_match (reg, (SLCONST unsigned char *)str, len);
+
    return (char *) regexp_match ((SLCONST unsigned char *)str, len, reg);
 }
 
@@ -879,6 +2020,7 @@ void SLregexp_free (SLRegexp_Type *reg)
      return;
    if (reg->buf != NULL)
      SLfree ((char *) reg->buf);
+   free_nfa (reg->nfa);
    SLfree ((char *) reg);
 }
 
@@ -908,6 +2050,12 @@ SLRegexp_Type *SLregexp_compile (SLFUTURE_CONST char *pattern, unsigned int flag
 	return NULL;
      }
 
+   if (-1 == compile_nfa (reg))
+     {
+	SLregexp_free (reg);
+	return NULL;
+     }
+
    return reg;
 }
 
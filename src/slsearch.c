@@ -24,6 +24,10 @@ USA.
 #include "slang.h"
 #include "_slang.h"
 
+#if SLSEARCH_FIRST_LAST_FILTER && defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
 #ifdef upcase
 # undef upcase
 #endif
@@ -42,12 +46,21 @@ USA.
  * have upper and lower case versions of the same length.
  *
  * Otherwise, the search search will be performed in a brute-force manner.
+ *
+ * Unless SLSEARCH_FIRST_LAST_FILTER is 0, a forward search that would use
+ * BM with a key of at most FILTER_MAX_KEY_LEN bytes looks instead for the
+ * positions where the first and last bytes of the key both match, 16
+ * positions at a time if SSE2 is available, and compares the rest of the
+ * key only at those positions.  Longer keys let BM skip far enough that it
+ * is faster.  The BM skip table is still used for backward searches.
  */
+#define FILTER_MAX_KEY_LEN	32
 
 typedef struct
 {
    SLuchar_Type *key;
    size_t key_len;
+   int filter_ok;		       /* first/last byte filter may be used */
    size_t fskip_table[256];
    size_t bskip_table[256];
 }
@@ -209,12 +222,183 @@ static SLuchar_Type *
       }
 }
 
+/* Return a pointer to the first occurrence of the key in [p, pmax), or
+ * NULL.  Only the positions where the first and the last bytes of the key
+ * occur are compared with the whole key.
+ */
+SLuchar_Type *_pSLsearch_bytes (SLuchar_Type *p, SLuchar_Type *pmax,
+				SLuchar_Type *key, SLstrlen_Type key_len)
+{
+   SLuchar_Type first, last;
+   SLstrlen_Type mid_len;
+
+   if ((pmax < p)
+       || (key_len == 0)
+       || (key_len > (SLstrlen_Type) (pmax - p)))
+     return NULL;
+
+   first = key[0];
+   if (key_len == 1)
+     return (SLuchar_Type *) memchr ((char *) p, first, pmax - p);
+
+   last = key[key_len - 1];
+   mid_len = key_len - 2;
+   pmax -= key_len - 1;		       /* the last position to try is pmax-1 */
+
+#if SLSEARCH_FIRST_LAST_FILTER && defined(__SSE2__)
+   if (p + 16 <= pmax)
+     {
+	__m128i vfirst = _mm_set1_epi8 ((char) first);
+	__m128i vlast = _mm_set1_epi8 ((char) last);
+
+	while (p + 16 <= pmax)
+	  {
+	     __m128i a = _mm_loadu_si128 ((__m128i *) p);
+	     __m128i b = _mm_loadu_si128 ((__m128i *) (p + key_len - 1));
+	     unsigned int mask;
+	     SLuchar_Type *q;
+
+	     mask = (unsigned int) _mm_movemask_epi8 (_mm_and_si128 (_mm_cmpeq_epi8 (a, vfirst),
+								     _mm_cmpeq_epi8 (b, vlast)));
+	     q = p;
+	     while (mask)
+	       {
+		  if ((mask & 1)
+		      && (0 == memcmp ((char *) q + 1, (char *) key + 1, mid_len)))
+		    return q;
+		  mask >>= 1;
+		  q++;
+	       }
+	     p += 16;
+	  }
+     }
+#endif
+
+   while (p < pmax)
+     {
+	if (NULL == (p = (SLuchar_Type *) memchr ((char *) p, first, pmax - p)))
+	  return NULL;
+	if ((p[key_len - 1] == last)
+	    && (0 == memcmp ((char *) p + 1, (char *) key + 1, mid_len)))
+	  return p;
+	p++;
+     }
+   return NULL;
+}
+
+#if SLSEARCH_FIRST_LAST_FILTER
+/* The same as _pSLsearch_bytes, except that the key has been uppercased and
+ * a byte ch matches the key byte k if ch is k or UPPER_CASE(ch) is k.  The
+ * filter assumes that such a byte is either k or LOWER_CASE(k).
+ */
+static SLuchar_Type *search_bytes_caseless (SLuchar_Type *p, SLuchar_Type *pmax,
+					    SLuchar_Type *key, SLstrlen_Type key_len)
+{
+   SLuchar_Type first_up, first_lo, last_up, last_lo;
+   SLstrlen_Type last_ofs;
+
+   if ((pmax < p)
+       || (key_len == 0)
+       || (key_len > (SLstrlen_Type) (pmax - p)))
+     return NULL;
+
+   last_ofs = key_len - 1;
+   first_up = key[0];
+   first_lo = LOWER_CASE(first_up);
+   last_up = key[last_ofs];
+   last_lo = LOWER_CASE(last_up);
+   pmax -= last_ofs;
+
+# ifdef __SSE2__
+   if (p + 16 <= pmax)
+     {
+	__m128i vfirst_up = _mm_set1_epi8 ((char) first_up);
+	__m128i vfirst_lo = _mm_set1_epi8 ((char) first_lo);
+	__m128i vlast_up = _mm_set1_epi8 ((char) last_up);
+	__m128i vlast_lo = _mm_set1_epi8 ((char) last_lo);
+
+	while (p + 16 <= pmax)
+	  {
+	     __m128i a = _mm_loadu_si128 ((__m128i *) p);
+	     __m128i b = _mm_loadu_si128 ((__m128i *) (p + last_ofs));
+	     unsigned int mask;
+	     SLuchar_Type *q;
+
+	     a = _mm_or_si128 (_mm_cmpeq_epi8 (a, vfirst_up), _mm_cmpeq_epi8 (a, vfirst_lo));
+	     b = _mm_or_si128 (_mm_cmpeq_epi8 (b, vlast_up), _mm_cmpeq_epi8 (b, vlast_lo));
+	     mask = (unsigned int) _mm_movemask_epi8 (_mm_and_si128 (a, b));
+	     q = p;
+	     while (mask)
+	       {
+		  if (mask & 1)
+		    {
+		       SLstrlen_Type j;
+		       for (j = 0; j < key_len; j++)
+			 {
+			    SLuchar_Type ch = q[j];
+			    if ((key[j] != ch) && (key[j] != UPPER_CASE(ch)))
+			      break;
+			 }
+		       if (j == key_len)
+			 return q;
+		    }
+		  mask >>= 1;
+		  q++;
+	       }
+	     p += 16;
+	  }
+     }
+# endif
+
+   while (p < pmax)
+     {
+	SLuchar_Type ch = *p;
+	if (((ch == first_up) || (ch == first_lo))
+	    && (((ch = p[last_ofs]) == last_up) || (ch == last_lo)))
+	  {
+	     SLstrlen_Type j;
+	     for (j = 0; j < key_len; j++)
+	       {
+		  ch = p[j];
+		  if ((key[j] != ch) && (key[j] != UPPER_CASE(ch)))
+		    break;
+	       }
+	     if (j == key_len)
+	       return p;
+	  }
+	p++;
+     }
+   return NULL;
+}
+
+static SLuchar_Type *
+  filter_search_forward (SLsearch_Type *st, SLuchar_Type *beg, SLuchar_Type *end)
+{
+   BoyerMoore_Search_Type *bm = &st->s.bm;
+   SLuchar_Type *p;
+
+   if (st->flags & SLSEARCH_CASELESS)
+     p = search_bytes_caseless (beg, end, bm->key, bm->key_len);
+   else
+     p = _pSLsearch_bytes (beg, end, bm->key, bm->key_len);
+
+   st->match_len = (p == NULL) ? 0 : bm->key_len;
+   return p;
+}
+#endif
+
 static SLuchar_Type *bm_search (SLsearch_Type *st,
                                 SLuchar_Type *pmin, SLuchar_Type *p, SLuchar_Type *pmax,
                                 int dir)
 {
    if (dir > 0)
-     return bm_search_forward (st, p, pmax);
+     {
+#if SLSEARCH_FIRST_LAST_FILTER
+	if (st->s.bm.filter_ok)
+	  return filter_search_forward (st, p, pmax);
+#endif
+	return bm_search_forward (st, p, pmax);
+     }
    else
      return bm_search_backward (st, pmin, p, pmax);
 }
@@ -460,6 +644,22 @@ static void init_skip_table (SLuchar_Type *key, SLstrlen_Type key_len,
      }
 }
 
+/* Returns 1 if the only bytes that match the uppercase byte k in a
+ * case-insensitive search are k and LOWER_CASE(k).
+ */
+static int is_simple_case_pair (SLuchar_Type k)
+{
+   unsigned int i;
+
+   for (i = 0; i < 256; i++)
+     {
+	if ((UPPER_CASE(i) == k)
+	    && (i != k) && (i != LOWER_CASE(k)))
+	  return 0;
+     }
+   return 1;
+}
+
 static void bm_free (SLsearch_Type *st)
 {
    SLang_free_slstring ((char *) st->s.bm.key);
@@ -548,6 +748,11 @@ static SLsearch_Type *bm_open_search (SLuchar_Type *key, int flags)
 
    st->search_fun = bm_search;
 
+   st->s.bm.filter_ok = ((keylen > 0) && (keylen <= FILTER_MAX_KEY_LEN)
+			 && ((0 == (flags & SLSEARCH_CASELESS))
+			     || (is_simple_case_pair (st->s.bm.key[0])
+				 && is_simple_case_pair (st->s.bm.key[keylen-1]))));
+
    init_skip_table (st->s.bm.key, st->s.bm.key_len, st->s.bm.fskip_table, 1, flags);
    init_skip_table (st->s.bm.key, st->s.bm.key_len, st->s.bm.bskip_table, -1, flags);
    return st;
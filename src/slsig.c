@@ -843,7 +843,7 @@ int SLang_init_signal (void)
 	s++;
      }
 
-   return 0;
+   return _pSLang_init_slprof ();
 }
 #endif				       /* SLANG_HAS_SIGNALS */
 
@@ -1084,6 +1084,29 @@ static int stack_depth_intrin (void)
    return SLstack_depth ();
 }
 
+static void set_stack_limits_intrin (int *max_stack_len, int *max_local_stack,
+				     int *max_recursion_depth)
+{
+   if ((*max_stack_len < 0) || (*max_local_stack < 0) || (*max_recursion_depth < 0))
+     {
+	_pSLang_verror (SL_InvalidParm_Error, "_set_stack_limits: expecting non-negative limits");
+	return;
+     }
+   (void) SLang_set_stack_limits ((unsigned int) *max_stack_len,
+				  (unsigned int) *max_local_stack,
+				  (unsigned int) *max_recursion_depth);
+}
+
+static void get_stack_limits_intrin (void)
+{
+   unsigned int max_stack_len, max_local_stack, max_recursion_depth;
+
+   SLang_get_stack_limits (&max_stack_len, &max_local_stack, &max_recursion_depth);
+   (void) SLang_push_uint (max_stack_len);
+   (void) SLang_push_uint (max_local_stack);
+   (void) SLang_push_uint (max_recursion_depth);
+}
+
 static void expand_dollar_string (char *s)
 {
    (void) _pSLpush_dollar_string (s);
@@ -1218,6 +1241,7 @@ static SLang_Intrin_Fun_Type SLang_Basic_Table [] = /*{{{*/
    MAKE_INTRINSIC_SS("autoload",  autoload_intrinsic, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_S("is_defined",  is_defined_intrin, SLANG_INT_TYPE),
    MAKE_INTRINSIC_0("string",  _pSLstring_intrinsic, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_slstring_stats",  _pSLstring_stats_intrinsic, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_0("uname", uname_cmd, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_S("getenv",  intrin_getenv_cmd, SLANG_VOID_TYPE),
 #ifdef HAVE_PUTENV
@@ -1249,6 +1273,8 @@ static SLang_Intrin_Fun_Type SLang_Basic_Table [] = /*{{{*/
    MAKE_INTRINSIC_0("typecast", intrin_typecast, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_0("_stkdepth", stack_depth_intrin, SLANG_INT_TYPE),
    MAKE_INTRINSIC_I("_stk_reverse", intrin_reverse_stack, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_III("_set_stack_limits", set_stack_limits_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("_get_stack_limits", get_stack_limits_intrin, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_0("typeof", intrin_type_info, VOID_TYPE),
    MAKE_INTRINSIC_0("_typeof", intrin_type_info1, VOID_TYPE),
    MAKE_INTRINSIC_I("_pop_n", intrin_pop_n, SLANG_VOID_TYPE),
@@ -1305,6 +1331,8 @@ static SLang_Intrin_Var_Type Intrin_Vars[] =
    MAKE_VARIABLE("_bofeof_info", &_pSLang_Compile_BOFEOF, SLANG_INT_TYPE, 0),
 #endif
    MAKE_VARIABLE("_auto_declare", &_pSLang_Auto_Declare_Globals, SLANG_INT_TYPE, 0),
+   MAKE_VARIABLE("_bytecode_cache", &_pSLang_Bytecode_Cache, SLANG_INT_TYPE, 0),
+   MAKE_VARIABLE("_lazy_compile", &_pSLang_Lazy_Compile, SLANG_INT_TYPE, 0),
    MAKE_VARIABLE("_slangtrace", &_pSLang_Trace, SLANG_INT_TYPE, 0),
    MAKE_VARIABLE("_slang_utf8_ok", &_pSLinterp_UTF8_Mode, SLANG_INT_TYPE, 1),
    MAKE_VARIABLE("_slang_install_prefix", &Install_Prefix, SLANG_STRING_TYPE, 1),
@@ -1356,6 +1384,8 @@ int SLang_init_slang (void) /*{{{*/
        || (-1 == _pSLang_init_slstrops ())
        || (-1 == _pSLang_init_sltime ())
        || (-1 == _pSLang_init_sllist ())
+       || (-1 == _pSLang_init_slstrbld ())
+       || (-1 == _pSLang_init_slstrvw ())
        || (-1 == _pSLstruct_init ())
 #if SLANG_HAS_ASSOC_ARRAYS
        || (-1 == SLang_init_slassoc ())
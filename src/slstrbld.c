@@ -0,0 +1,447 @@
+/* String builder objects */
+/*
+Copyright (C) 2004-2020,2021 John E. Davis
+
+This file is part of the S-Lang Library.
+
+The S-Lang Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The S-Lang Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+USA.
+*/
+
+#include "slinclud.h"
+
+#include <errno.h>
+
+#include "slang.h"
+#include "_slang.h"
+
+/* A string builder is a mutable byte buffer.  Appending to it does not
+ * create a new string, and the buffer grows geometrically, so building a
+ * string from n pieces takes time proportional to its length, rather
+ * than to n times its length as with repeated concatenation.  The result
+ * is hashed and interned only once, when it is extracted as a string.
+ *
+ *    strbuilder_new ([size])
+ *    strbuilder_append (sb, obj, ...)
+ *    strbuilder_appendf (sb, fmt, args...)
+ *    strbuilder_string (sb), strbuilder_bstring (sb)
+ *    strbuilder_write (sb, fp)
+ *    strbuilder_clear (sb)
+ *    length (sb), string (sb)
+ */
+
+typedef struct
+{
+   char *buf;
+   SLstrlen_Type len;
+   SLstrlen_Type size;		       /* bytes allocated for buf */
+   int ref_count;
+}
+StrBuilder_Type;
+
+#define MIN_BUFFER_SIZE	64
+#define MAX_BUFFER_SIZE	((SLstrlen_Type) -1)
+
+static void free_strbuilder (StrBuilder_Type *sb)
+{
+   if (sb == NULL)
+     return;
+
+   if (sb->ref_count > 1)
+     {
+	sb->ref_count--;
+	return;
+     }
+   SLfree (sb->buf);
+   SLfree ((char *) sb);
+}
+
+static StrBuilder_Type *allocate_strbuilder (SLstrlen_Type size)
+{
+   StrBuilder_Type *sb;
+
+   if (NULL == (sb = (StrBuilder_Type *) SLcalloc (1, sizeof (StrBuilder_Type))))
+     return NULL;
+
+   if (size < MIN_BUFFER_SIZE)
+     size = MIN_BUFFER_SIZE;
+
+   if (NULL == (sb->buf = (char *) SLmalloc (size)))
+     {
+	SLfree ((char *) sb);
+	return NULL;
+     }
+   sb->size = size;
+   sb->ref_count = 1;
+   return sb;
+}
+
+static int pop_strbuilder (StrBuilder_Type **sbp)
+{
+   if (-1 == SLclass_pop_ptr_obj (SLANG_STRBUILDER_TYPE, (VOID_STAR *) sbp))
+     {
+	*sbp = NULL;
+	return -1;
+     }
+   return 0;
+}
+
+static int push_strbuilder (StrBuilder_Type *sb, int free_flag)
+{
+   /* SLclass_push_ptr_obj does not do memory management */
+   if (-1 == SLclass_push_ptr_obj (SLANG_STRBUILDER_TYPE, (VOID_STAR) sb))
+     {
+	if (free_flag) free_strbuilder (sb);
+	return -1;
+     }
+
+   if (free_flag == 0)
+     sb->ref_count++;
+
+   return 0;
+}
+
+/* Make room for n more bytes, doubling the buffer as needed */
+static int reserve_bytes (StrBuilder_Type *sb, SLstrlen_Type n)
+{
+   SLstrlen_Type size, needed;
+   char *buf;
+
+   if (n > MAX_BUFFER_SIZE - sb->len)
+     {
+	_pSLang_verror (SL_LimitExceeded_Error, "String builder is too large");
+	return -1;
+     }
+   needed = sb->len + n;
+   if (needed <= sb->size)
+     return 0;
+
+   size = sb->size;
+   while (size < needed)
+     {
+	if (size > MAX_BUFFER_SIZE/2)
+	  {
+	     size = needed;
+	     break;
+	  }
+	size *= 2;
+     }
+
+   if (NULL == (buf = (char *) SLrealloc (sb->buf, size)))
+     return -1;
+
+   sb->buf = buf;
+   sb->size = size;
+   return 0;
+}
+
+static int append_bytes (StrBuilder_Type *sb, SLCONST char *bytes, SLstrlen_Type n)
+{
+   if (-1 == reserve_bytes (sb, n))
+     return -1;
+
+   memcpy (sb->buf + sb->len, bytes, n);
+   sb->len += n;
+   return 0;
+}
+
+/* Strings and binary strings are appended as they are.  Other objects are
+ * appended in the form produced by the string function.
+ */
+static int append_object (StrBuilder_Type *sb)
+{
+   SLang_Object_Type obj;
+   SLang_Class_Type *cl;
+   char *s;
+   int status;
+
+   switch (SLang_peek_at_stack ())
+     {
+      case SLANG_STRING_TYPE:
+	if (-1 == SLang_pop_slstring (&s))
+	  return -1;
+	status = append_bytes (sb, s, (SLstrlen_Type) _pSLstring_bytelen (s));
+	_pSLang_free_slstring (s);
+	return status;
+
+      case SLANG_BSTRING_TYPE:
+	  {
+	     SLang_BString_Type *b;
+	     unsigned char *bytes;
+	     SLstrlen_Type n;
+
+	     if (-1 == SLang_pop_bstring (&b))
+	       return -1;
+	     status = -1;
+	     if (NULL != (bytes = SLbstring_get_pointer (b, &n)))
+	       status = append_bytes (sb, (char *) bytes, n);
+	     SLbstring_free (b);
+	     return status;
+	  }
+
+      default:
+	break;
+     }
+
+   if (-1 == SLang_pop (&obj))
+     return -1;
+
+   cl = _pSLclass_get_class (obj.o_data_type);
+   status = -1;
+   if (NULL != (s = (*cl->cl_string) (obj.o_data_type, (VOID_STAR) &obj.v)))
+     {
+	status = append_bytes (sb, s, strlen (s));
+	SLfree (s);
+     }
+   SLang_free_object (&obj);
+   return status;
+}
+
+/* Usage: sb = strbuilder_new ([size]) */
+static void strbuilder_new (void)
+{
+   StrBuilder_Type *sb;
+   int size = 0;
+
+   if (SLang_Num_Function_Args == 1)
+     {
+	if (-1 == SLang_pop_integer (&size))
+	  return;
+	if (size < 0) size = 0;
+     }
+
+   if (NULL == (sb = allocate_strbuilder ((SLstrlen_Type) size)))
+     return;
+
+   (void) push_strbuilder (sb, 1);
+}
+
+/* Usage: strbuilder_append (sb, obj, ...) */
+static void strbuilder_append (void)
+{
+   StrBuilder_Type *sb;
+   int n = SLang_Num_Function_Args;
+
+   if (n < 1)
+     {
+	_pSLang_verror (SL_Usage_Error, "Usage: strbuilder_append (sb, obj, ...)");
+	return;
+     }
+
+   /* The builder is deepest on the stack.  Reverse it so that it is on
+    * top, followed by the objects in the order of the arguments.
+    */
+   if (-1 == SLreverse_stack (n))
+     return;
+   if (-1 == pop_strbuilder (&sb))
+     {
+	SLdo_pop_n (n - 1);
+	return;
+     }
+
+   n--;
+   while (n > 0)
+     {
+	n--;
+	if (-1 == append_object (sb))
+	  {
+	     SLdo_pop_n (n);
+	     break;
+	  }
+     }
+   free_strbuilder (sb);
+}
+
+/* Usage: strbuilder_appendf (sb, fmt, args...) */
+static void strbuilder_appendf (void)
+{
+   StrBuilder_Type *sb;
+   char *s;
+   int n = SLang_Num_Function_Args;
+
+   if (n < 2)
+     {
+	_pSLang_verror (SL_Usage_Error, "Usage: strbuilder_appendf (sb, fmt, args...)");
+	return;
+     }
+
+   s = _pSLstrops_sprintf_n (n - 2);   /* pops fmt and args */
+   if (-1 == pop_strbuilder (&sb))
+     {
+	SLfree (s);
+	return;
+     }
+   if (s != NULL)
+     {
+	(void) append_bytes (sb, s, strlen (s));
+	SLfree (s);
+     }
+   free_strbuilder (sb);
+}
+
+static void strbuilder_string (void)
+{
+   StrBuilder_Type *sb;
+   char *s;
+
+   if (-1 == pop_strbuilder (&sb))
+     return;
+
+   if (NULL != (s = SLang_create_nslstring (sb->buf, sb->len)))
+     (void) _pSLang_push_slstring (s);   /* frees s */
+
+   free_strbuilder (sb);
+}
+
+static void strbuilder_bstring (void)
+{
+   StrBuilder_Type *sb;
+   SLang_BString_Type *b;
+
+   if (-1 == pop_strbuilder (&sb))
+     return;
+
+   if (NULL != (b = SLbstring_create ((unsigned char *) sb->buf, sb->len)))
+     {
+	(void) SLang_push_bstring (b);
+	SLbstring_free (b);
+     }
+   free_strbuilder (sb);
+}
+
+/* Usage: n = strbuilder_write (sb, fp) */
+static void strbuilder_write (void)
+{
+   StrBuilder_Type *sb;
+   SLang_MMT_Type *mmt;
+   SLang_Class_Type *cl;
+   FILE *fp;
+   SLstrlen_Type num_written = 0;
+   int ret = -1;
+
+   /* This fails without an exception if the file is closed.  In that
+    * case, -1 is returned as fwrite does.
+    */
+   if (-1 == SLang_pop_fileptr (&mmt, &fp))
+     {
+	if (SLang_get_error ())
+	  return;
+	mmt = NULL;
+     }
+
+   if (-1 == pop_strbuilder (&sb))
+     {
+	if (mmt != NULL) SLang_free_mmt (mmt);
+	return;
+     }
+
+   if (mmt != NULL)
+     {
+	/* The cl_fwrite method handles EINTR */
+	cl = _pSLclass_get_class (SLANG_UCHAR_TYPE);
+	ret = (*cl->cl_fwrite) (SLANG_UCHAR_TYPE, fp, (VOID_STAR) sb->buf, sb->len, &num_written);
+	if ((ret == -1) && ferror (fp))
+	  _pSLerrno_errno = errno;
+	SLang_free_mmt (mmt);
+     }
+   free_strbuilder (sb);
+
+   if (ret == -1)
+     (void) SLang_push_integer (-1);
+   else
+     (void) SLang_push_uinteger (num_written);
+}
+
+static void strbuilder_clear (void)
+{
+   StrBuilder_Type *sb;
+
+   if (-1 == pop_strbuilder (&sb))
+     return;
+
+   sb->len = 0;
+   free_strbuilder (sb);
+}
+
+static SLang_Intrin_Fun_Type Intrin_Table [] =
+{
+   MAKE_INTRINSIC_0("strbuilder_new", strbuilder_new, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strbuilder_append", strbuilder_append, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strbuilder_appendf", strbuilder_appendf, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strbuilder_string", strbuilder_string, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strbuilder_bstring", strbuilder_bstring, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strbuilder_write", strbuilder_write, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strbuilder_clear", strbuilder_clear, SLANG_VOID_TYPE),
+   SLANG_END_INTRIN_FUN_TABLE
+};
+
+static int strbuilder_length (SLtype type, VOID_STAR v, SLuindex_Type *len)
+{
+   (void) type;
+   *len = (*(StrBuilder_Type **) v)->len;
+   return 0;
+}
+
+/* The string representation of a builder is its contents */
+static char *string_method (SLtype type, VOID_STAR p)
+{
+   StrBuilder_Type *sb;
+   char *s;
+
+   (void) type;
+   sb = *(StrBuilder_Type **) p;
+
+   if (NULL == (s = (char *) SLmalloc (sb->len + 1)))
+     return NULL;
+   memcpy (s, sb->buf, sb->len);
+   s[sb->len] = 0;
+   return s;
+}
+
+static void cl_strbuilder_destroy (SLtype type, VOID_STAR ptr)
+{
+   (void) type;
+   free_strbuilder (*(StrBuilder_Type **) ptr);
+}
+
+static int cl_strbuilder_push (SLtype type, VOID_STAR ptr)
+{
+   (void) type;
+   return push_strbuilder (*(StrBuilder_Type **) ptr, 0);
+}
+
+int _pSLang_init_slstrbld (void)
+{
+   SLang_Class_Type *cl;
+
+   if (SLclass_is_class_defined (SLANG_STRBUILDER_TYPE))
+     return 0;
+
+   if (NULL == (cl = SLclass_allocate_class ("StringBuilder_Type")))
+     return -1;
+
+   (void) SLclass_set_destroy_function (cl, cl_strbuilder_destroy);
+   (void) SLclass_set_push_function (cl, cl_strbuilder_push);
+   (void) SLclass_set_string_function (cl, string_method);
+   cl->cl_length = strbuilder_length;
+
+   if (-1 == SLclass_register_class (cl, SLANG_STRBUILDER_TYPE, sizeof (StrBuilder_Type), SLANG_CLASS_TYPE_PTR))
+     return -1;
+
+   if (-1 == SLadd_intrin_fun_table (Intrin_Table, NULL))
+     return -1;
+
+   return 0;
+}
@@ -34,9 +34,29 @@ typedef struct _pSLstring_Type
 }
 SLstring_Type;
 
-#define MAP_HASH_TO_INDEX(hash) ((hash) % SLSTRING_HASH_TABLE_SIZE)
+/* The strings are kept in a chained hash table whose size is a power of 2.
+ * It starts out small and doubles when the number of strings exceeds
+ * SLSTRING_HASH_TABLE_MAX_LOAD per bucket.  So that no single call pays
+ * for copying the entire table, the buckets of the old table are moved to
+ * the new one a few at a time as strings are added.  While this is
+ * happening, a string lives in the old table if its bucket there has not
+ * yet been moved, and in the new table otherwise.
+ */
+typedef struct
+{
+   SLstring_Type **buckets;
+   SLstr_Hash_Type size;		       /* power of 2 */
+}
+String_Table_Type;
 
-static SLstring_Type *String_Hash_Table [SLSTRING_HASH_TABLE_SIZE];
+static SLstring_Type *Initial_Buckets [SLSTRING_HASH_TABLE_MIN_SIZE];
+static String_Table_Type String_Table = {Initial_Buckets, SLSTRING_HASH_TABLE_MIN_SIZE};
+static String_Table_Type Old_String_Table = {NULL, 0};
+static SLstr_Hash_Type Rehash_Index;   /* old buckets below this have been moved */
+static SLstr_Hash_Type Num_Strings;
+static unsigned int Num_Resizes;
+
+#define MAP_HASH_TO_INDEX(hash, t) ((hash) & ((t)->size - 1))
 static char Single_Char_Strings [256 * 2];
 
 #if SLANG_OPTIMIZE_FOR_SPEED
@@ -80,7 +100,128 @@ static void uncache_string (SLCONST char *s)
 }
 #endif
 
-#if USE_NEW_HASH_CODE
+#if (SLSTRING_HASH_FUNCTION == 2) && _pSLANG_UINT64_TYPE
+/* This hash function is based upon the final version 3 of wyhash:
+ *
+ *   Wang Yi, 2019.  godspeed_china@yeah.net.
+ *   This is free and unencumbered software released into the public domain.
+ *   See https://github.com/wangyi-fudan/wyhash
+ *
+ * The input is read 8 bytes at a time, and each pair of 64 bit words is
+ * combined by a 64x64->128 bit multiplication whose halves are xored.
+ * Keys of up to 16 bytes take only two multiplications.
+ */
+#define MAKE_UINT64(hi,lo) \
+   (((_pSLuint64_Type)(hi) << 32) | (_pSLuint64_Type)(lo))
+#define HASH_P0	MAKE_UINT64(0xa0761d64UL, 0x78bd642fUL)
+#define HASH_P1	MAKE_UINT64(0xe7037ed1UL, 0xa0b428dbUL)
+#define HASH_P2	MAKE_UINT64(0x8ebc6af0UL, 0x9c88c6e3UL)
+#define HASH_P3	MAKE_UINT64(0x589965ccUL, 0x75374cc3UL)
+
+/* Replace a and b by the low and high halves of a*b */
+_INLINE_
+static void hash_mum (_pSLuint64_Type *a, _pSLuint64_Type *b)
+{
+#ifdef __SIZEOF_INT128__
+   __uint128_t r = (__uint128_t) *a * *b;
+   *a = (_pSLuint64_Type) r;
+   *b = (_pSLuint64_Type) (r >> 64);
+#else
+   _pSLuint64_Type ha = *a >> 32, hb = *b >> 32;
+   _pSLuint64_Type la = *a & 0xFFFFFFFFUL, lb = *b & 0xFFFFFFFFUL;
+   _pSLuint64_Type rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+   _pSLuint64_Type t = rl + (rm0 << 32), lo;
+   _pSLuint64_Type c = (t < rl);
+
+   lo = t + (rm1 << 32);
+   c += (lo < t);
+   *a = lo;
+   *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+_INLINE_
+static _pSLuint64_Type hash_mix (_pSLuint64_Type a, _pSLuint64_Type b)
+{
+   hash_mum (&a, &b);
+   return a ^ b;
+}
+
+/* The byte order does not matter since the hash values never leave the
+ * process.
+ */
+_INLINE_
+static _pSLuint64_Type hash_read64 (SLCONST unsigned char *p)
+{
+   _pSLuint64_Type v;
+   memcpy ((char *) &v, (char *) p, 8);
+   return v;
+}
+
+_INLINE_
+static _pSLuint64_Type hash_read32 (SLCONST unsigned char *p)
+{
+   _pSLuint32_Type v;
+   memcpy ((char *) &v, (char *) p, 4);
+   return v;
+}
+
+_INLINE_
+SLstr_Hash_Type _pSLstring_hash (SLCONST unsigned char *s, SLCONST unsigned char *smax)
+{
+   size_t len = (size_t) (smax - s);
+   _pSLuint64_Type seed = HASH_P0;
+   _pSLuint64_Type a, b;
+
+   if (len <= 16)
+     {
+	if (len >= 4)
+	  {
+	     size_t ofs = (len >> 3) << 2;
+	     a = (hash_read32 (s) << 32) | hash_read32 (s + ofs);
+	     b = (hash_read32 (smax - 4) << 32) | hash_read32 (smax - 4 - ofs);
+	  }
+	else if (len > 0)
+	  {
+	     a = ((_pSLuint64_Type) s[0] << 16) | ((_pSLuint64_Type) s[len >> 1] << 8) | s[len - 1];
+	     b = 0;
+	  }
+	else a = b = 0;
+     }
+   else
+     {
+	size_t i = len;
+	if (i > 48)
+	  {
+	     _pSLuint64_Type see1 = seed, see2 = seed;
+	     do
+	       {
+		  seed = hash_mix (hash_read64 (s) ^ HASH_P1, hash_read64 (s + 8) ^ seed);
+		  see1 = hash_mix (hash_read64 (s + 16) ^ HASH_P2, hash_read64 (s + 24) ^ see1);
+		  see2 = hash_mix (hash_read64 (s + 32) ^ HASH_P3, hash_read64 (s + 40) ^ see2);
+		  s += 48;
+		  i -= 48;
+	       }
+	     while (i > 48);
+	     seed ^= see1 ^ see2;
+	  }
+	while (i > 16)
+	  {
+	     seed = hash_mix (hash_read64 (s) ^ HASH_P1, hash_read64 (s + 8) ^ seed);
+	     s += 16;
+	     i -= 16;
+	  }
+	a = hash_read64 (s + i - 16);
+	b = hash_read64 (s + i - 8);
+     }
+
+   a ^= HASH_P1;
+   b ^= seed;
+   hash_mum (&a, &b);
+   return (SLstr_Hash_Type) hash_mix (a ^ HASH_P0 ^ (_pSLuint64_Type) len, b ^ HASH_P1);
+}
+#else
+# if USE_NEW_HASH_CODE
 /* This hash algorithm comes from:
  *
  *   Bob Jenkins, 1996.  bob_jenkins@burtleburtle.net.
@@ -154,13 +295,13 @@ SLstr_Hash_Type _pSLstring_hash (SLCONST unsigned char *s, SLCONST unsigned char
    /*-------------------------------------------- report the result */
    return (SLstr_Hash_Type) c;
 }
-#else
+# else
 _INLINE_
 unsigned long _pSLstring_hash (SLCONST unsigned char *s, SLCONST unsigned char *smax)
 {
    register unsigned long h = 0;
    register unsigned long sum = 0;
-   unsigned char *smax4;
+   SLCONST unsigned char *smax4;
 
    smax4 = smax - 4;
 
@@ -186,7 +327,95 @@ unsigned long _pSLstring_hash (SLCONST unsigned char *s, SLCONST unsigned char *
 
    return h;
 }
+# endif
 #endif
+_INLINE_
+static SLstring_Type **get_bucket (SLstr_Hash_Type hash)
+{
+   if (Old_String_Table.buckets != NULL)
+     {
+	SLstr_Hash_Type idx = MAP_HASH_TO_INDEX(hash, &Old_String_Table);
+	if (idx >= Rehash_Index)
+	  return Old_String_Table.buckets + idx;
+     }
+   return String_Table.buckets + MAP_HASH_TO_INDEX(hash, &String_Table);
+}
+
+/* Move up to n buckets of the old table to the new one */
+static void rehash_buckets (unsigned int n)
+{
+   while (n && (Old_String_Table.buckets != NULL))
+     {
+	SLstring_Type *sls = Old_String_Table.buckets[Rehash_Index];
+
+	Old_String_Table.buckets[Rehash_Index] = NULL;
+	while (sls != NULL)
+	  {
+	     SLstring_Type *next = sls->next;
+	     SLstring_Type **b = String_Table.buckets + MAP_HASH_TO_INDEX(sls->hash, &String_Table);
+	     sls->next = *b;
+	     *b = sls;
+	     sls = next;
+	  }
+
+	Rehash_Index++;
+	n--;
+	if (Rehash_Index < Old_String_Table.size)
+	  continue;
+
+	if (Old_String_Table.buckets != Initial_Buckets)
+	  SLfree ((char *) Old_String_Table.buckets);
+	Old_String_Table.buckets = NULL;
+	Old_String_Table.size = 0;
+     }
+}
+
+static void resize_string_table (void)
+{
+   SLstring_Type **buckets;
+   SLstr_Hash_Type size;
+   int err;
+
+   /* A resize that is still in progress must finish first */
+   rehash_buckets ((unsigned int) -1);
+
+   size = 2 * String_Table.size;
+   if ((size > SLSTRING_HASH_TABLE_MAX_SIZE) || (size < String_Table.size))
+     return;
+
+   /* If this fails, the table will simply be more heavily loaded */
+   err = SLang_get_error ();
+   buckets = (SLstring_Type **) SLcalloc (size, sizeof (SLstring_Type *));
+   if (buckets == NULL)
+     {
+	if (err == 0)
+	  SLang_set_error (0);
+	return;
+     }
+
+   Old_String_Table = String_Table;
+   String_Table.buckets = buckets;
+   String_Table.size = size;
+   Rehash_Index = 0;
+   Num_Resizes++;
+}
+
+_INLINE_
+static void insert_sls (SLstring_Type *sls)
+{
+   SLstring_Type **b;
+
+   if (Old_String_Table.buckets != NULL)
+     rehash_buckets (SLSTRING_REHASH_STEP);
+   else if (Num_Strings >= SLSTRING_HASH_TABLE_MAX_LOAD * String_Table.size)
+     resize_string_table ();
+
+   b = get_bucket (sls->hash);
+   sls->next = *b;
+   *b = sls;
+   Num_Strings++;
+}
+
 SLstr_Hash_Type SLcompute_string_hash (SLCONST char *s)
 {
 #if SLANG_OPTIMIZE_FOR_SPEED
@@ -202,10 +431,10 @@ SLstr_Hash_Type SLcompute_string_hash (SLCONST char *s)
 _INLINE_
 static SLstring_Type *find_slstring (SLCONST char *s, SLstr_Hash_Type hash)
 {
-   SLstring_Type *sls, *prev;
-   size_t idx = MAP_HASH_TO_INDEX(hash);
+   SLstring_Type *sls, *prev, **b;
 
-   sls = String_Hash_Table [idx];
+   b = get_bucket (hash);
+   sls = *b;
    if ((sls == NULL) || (sls->bytes == s)) return sls;
 
    sls = sls->next;
@@ -222,8 +451,8 @@ static SLstring_Type *find_slstring (SLCONST char *s, SLstr_Hash_Type hash)
 	  {
 	     SLstring_Type *sls0;
 	     prev->next = sls->next;
-	     sls0 = String_Hash_Table[idx];
-	     String_Hash_Table[idx] = sls;
+	     sls0 = *b;
+	     *b = sls;
 	     sls->next = sls0;
 	     return sls;
 	  }
@@ -251,7 +480,7 @@ static SLstring_Type *find_string (SLCONST char *s, unsigned int len, SLstr_Hash
      }
 
    /* Ok, not an slstring.  Try to find a matching one */
-   sls = String_Hash_Table [(unsigned int) MAP_HASH_TO_INDEX(hash)];
+   sls = *get_bucket (hash);
 
    if (sls == NULL)
      return NULL;
@@ -338,10 +567,7 @@ static char *create_long_string (SLCONST char *s, size_t len, SLstr_Hash_Type ha
    cache_string (sls);
 #endif
 
-   hash = MAP_HASH_TO_INDEX(hash);
-   sls->next = String_Hash_Table [(unsigned int)hash];
-   String_Hash_Table [(unsigned int)hash] = sls;
-
+   insert_sls (sls);
    return sls->bytes;
 }
 
@@ -460,12 +686,10 @@ SLCONST char *_pSLstring_dup_slstring (SLCONST char *s)
 
 static void free_sls_string (SLstring_Type *sls)
 {
-   SLstring_Type *sls1, *prev;
-   SLstr_Hash_Type hash = sls->hash;
-
-   hash = MAP_HASH_TO_INDEX(hash);
+   SLstring_Type *sls1, *prev, **b;
 
-   sls1 = String_Hash_Table [(unsigned int) hash];
+   b = get_bucket (sls->hash);
+   sls1 = *b;
 
    prev = NULL;
 
@@ -479,8 +703,9 @@ static void free_sls_string (SLstring_Type *sls)
    if (prev != NULL)
      prev->next = sls->next;
    else
-     String_Hash_Table [(unsigned int) hash] = sls->next;
+     *b = sls->next;
 
+   Num_Strings--;
    free_sls (sls);
 }
 
@@ -635,10 +860,7 @@ char *_pSLcreate_via_alloced_slstring (char *s, size_t len)
    cache_string (sls);
 #endif
 
-   hash = MAP_HASH_TO_INDEX(hash);
-   sls->next = String_Hash_Table [(unsigned int)hash];
-   String_Hash_Table [(unsigned int)hash] = sls;
-
+   insert_sls (sls);
    return s;
 }
 
@@ -730,3 +952,64 @@ SLstr_Hash_Type _pSLstring_get_hash (SLstr_Type *s)
    sls = (SLstring_Type *) (s - offsetof(SLstring_Type,bytes[0]));
    return sls->hash;
 }
+
+static unsigned int max_chain_length (String_Table_Type *t, SLstr_Hash_Type i0)
+{
+   unsigned int max_len = 0;
+   SLstr_Hash_Type i;
+
+   for (i = i0; i < t->size; i++)
+     {
+	SLstring_Type *sls = t->buckets[i];
+	unsigned int len = 0;
+
+	while (sls != NULL)
+	  {
+	     len++;
+	     sls = sls->next;
+	  }
+	if (len > max_len)
+	  max_len = len;
+     }
+   return max_len;
+}
+
+/* Usage: s = _slstring_stats ();
+ * Returns a struct that describes the state of the string hash table.
+ */
+void _pSLstring_stats_intrinsic (void)
+{
+#define NUM_STATS_FIELDS 6
+   static SLFUTURE_CONST char *field_names[NUM_STATS_FIELDS] =
+     {
+	"num_strings", "num_buckets", "load_factor", "max_chain",
+	"num_resizes", "rehashing"
+     };
+   SLtype field_types[NUM_STATS_FIELDS];
+   VOID_STAR field_values[NUM_STATS_FIELDS];
+   unsigned long num_strings, num_buckets;
+   unsigned int max_chain, max_chain_old;
+   double load_factor;
+   int rehashing;
+
+   num_strings = Num_Strings;
+   num_buckets = String_Table.size;
+   load_factor = (double) num_strings / (double) num_buckets;
+   max_chain = max_chain_length (&String_Table, 0);
+   rehashing = (Old_String_Table.buckets != NULL);
+   if (rehashing)
+     {
+	max_chain_old = max_chain_length (&Old_String_Table, Rehash_Index);
+	if (max_chain_old > max_chain)
+	  max_chain = max_chain_old;
+     }
+
+   field_types[0] = SLANG_ULONG_TYPE; field_values[0] = &num_strings;
+   field_types[1] = SLANG_ULONG_TYPE; field_values[1] = &num_buckets;
+   field_types[2] = SLANG_DOUBLE_TYPE; field_values[2] = &load_factor;
+   field_types[3] = SLANG_UINT_TYPE; field_values[3] = &max_chain;
+   field_types[4] = SLANG_UINT_TYPE; field_values[4] = &Num_Resizes;
+   field_types[5] = SLANG_INT_TYPE; field_values[5] = &rehashing;
+
+   (void) SLstruct_create_struct (NUM_STATS_FIELDS, field_names, field_types, field_values);
+}
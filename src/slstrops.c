@@ -1867,71 +1867,131 @@ static void strcompress_vintrin (char *white) /*{{{*/
 
 /*}}}*/
 
-#if defined(__GNUC__)
-# pragma GCC diagnostic ignored "-Wformat-nonliteral"
-#endif
-static char *SLdo_sprintf (char *fmt) /*{{{*/
+/* A format string is compiled into a list of conversion specifications.
+ * Each one holds the literal text that precedes the conversion, and what
+ * was parsed from the conversion.  The list ends with an element whose
+ * conv field is 0, which holds the text following the last conversion.
+ * Compiled formats are cached by the address of the format string, which
+ * is unique since the string is an slstring.
+ */
+#define MAX_FORMAT_PREFIX_LEN	40
+typedef struct
 {
-   register char *p = fmt;
-   char *out = NULL, *outp = NULL;
-   char dfmt[1024];	       /* used to hold part of format */
-   char *f, *f1;
-   char *str;
-   unsigned int want_width, width, precis;
-   int int_var, use_string;
-   long long_var;
-#ifdef HAVE_LONG_LONG
-   long long llong_var;
-#endif
-   size_t len = 0, malloc_len = 0, dlen;
-   int do_free;
-   unsigned int guess_size;
-#if SLANG_HAS_FLOAT
-   int use_double;
-   double x;
-#endif
-   unsigned char uch;
-   int use_long = 0, use_alt_format = 0;
-   SLuchar_Type utf8_buf[SLUTF8_MAX_MBLEN+1];
+   SLCONST char *text;		       /* literal text before the conversion */
+   size_t text_len;
+   char conv;			       /* conversion character, or 0 */
+   char use_long;		       /* 1 for l, 2 for ll */
+   char use_alt_format;		       /* # flag */
+   char want_width;		       /* a width or a * was given */
+   char want_precis;		       /* a precision or a * was given */
+   char has_precis;		       /* a . was given */
+   char is_plain;		       /* no flags, width, or precision */
+   char width_star;		       /* the width is given by an argument */
+   char precis_star;		       /* the precision is given by an argument */
+   unsigned int width;
+   unsigned int precis;
+   char flags[8];		       /* % and the flag characters */
+   /* When neither the width nor the precision is given by an argument,
+    * this is the part of the C format that precedes the length modifier.
+    */
+   char prefix[MAX_FORMAT_PREFIX_LEN];
+}
+Format_Spec_Type;
 
-   while (1)
+typedef struct
+{
+   SLstr_Type *fmt;
+   Format_Spec_Type *specs;
+   unsigned int num_args;	       /* number of arguments consumed */
+   int ref_count;
+}
+Compiled_Format_Type;
+
+#define FORMAT_CACHE_SIZE	64     /* must be a power of 2 */
+static Compiled_Format_Type *Format_Cache[FORMAT_CACHE_SIZE];
+
+static void free_compiled_format (Compiled_Format_Type *cf)
+{
+   if (cf == NULL)
+     return;
+   if (cf->ref_count > 1)
      {
-	char ch;
+	cf->ref_count--;
+	return;
+     }
+   _pSLang_free_slstring (cf->fmt);
+   SLfree ((char *) cf->specs);
+   SLfree ((char *) cf);
+}
 
-	while ((ch = *p) != 0)
+/* Writes the part of the C format that precedes the length modifier to f,
+ * and returns a pointer to the end of it.
+ */
+static char *make_format_prefix (Format_Spec_Type *spec, char *f,
+				 unsigned int width, unsigned int precis, int with_precis)
+{
+   strcpy (f, spec->flags);
+   f += strlen (f);
+   if (spec->want_width)
+     {
+	sprintf (f, "%u", width);
+	f += strlen (f);
+     }
+   if (with_precis && spec->has_precis)
+     {
+	*f++ = '.';
+	if (spec->want_precis)
 	  {
-	     if (ch == '%')
-	       break;
-	     p++;
+	     sprintf (f, "%u", precis);
+	     f += strlen (f);
 	  }
+     }
+   *f = 0;
+   return f;
+}
 
-	/* p points at '%' or 0 */
+static Compiled_Format_Type *compile_format (SLstr_Type *fmt)
+{
+   Compiled_Format_Type *cf;
+   Format_Spec_Type *spec;
+   SLCONST char *p;
+   unsigned int num_specs;
+   char ch;
 
-	dlen = (unsigned int) (p - fmt);
+   num_specs = 1;
+   p = fmt;
+   while ((ch = *p++) != 0)
+     {
+	if (ch == '%') num_specs++;
+     }
 
-	if (len + dlen >= malloc_len)
-	  {
-	     malloc_len = len + dlen + 512;
-	     if (out == NULL) outp = (char *)SLmalloc(malloc_len + 1);
-	     else outp = (char *)SLrealloc(out, malloc_len + 1);
-	     if (NULL == outp)
-	       return out;
-	     out = outp;
-	     outp = out + len;
-	  }
+   if (NULL == (cf = (Compiled_Format_Type *) SLcalloc (1, sizeof (Compiled_Format_Type))))
+     return NULL;
+   if (NULL == (cf->specs = (Format_Spec_Type *) SLcalloc (num_specs, sizeof (Format_Spec_Type))))
+     {
+	SLfree ((char *) cf);
+	return NULL;
+     }
+   cf->fmt = (SLstr_Type *) _pSLstring_dup_slstring (fmt);
+   cf->ref_count = 1;
 
-	strncpy(outp, fmt, dlen);
-	len += dlen;
-	outp = out + len;
-	*outp = 0;
-	if (ch == 0) break;
+   p = fmt;
+   spec = cf->specs;
+   while (1)
+     {
+	char *f;
 
-	/* bump it beyond '%' */
-	++p;
-	fmt = p;
+	spec->text = p;
+	while (((ch = *p) != 0) && (ch != '%'))
+	  p++;
+	spec->text_len = (size_t) (p - spec->text);
+	if (ch == 0)
+	  break;
 
-	f = dfmt;
-	*f++ = ch;
+	/* bump it beyond '%' */
+	p++;
+	f = spec->flags;
+	*f++ = '%';
 	/* handle flag char */
 	ch = *p++;
 
@@ -1939,27 +1999,23 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	if ((ch == '-') || (ch == '+') || (ch == ' ') || (ch == '#'))
 	  {
 	     if (ch == '#')
-	       use_alt_format = 1;
+	       spec->use_alt_format = 1;
 	     *f++ = ch;
 	     ch = *p++;
 	     if ((ch == '-') || (ch == '+') || (ch == ' ') || (ch == '#'))
 	       {
 		  if (ch == '#')
-		    use_alt_format = 1;
+		    spec->use_alt_format = 1;
 		  *f++ = ch;
 		  ch = *p++;
 	       }
 	  }
 
 	/* width */
-	/* I have got to parse it myself so that I can see how big it needs
-	 * to be.
-	 */
-	want_width = width = 0;
 	if (ch == '*')
 	  {
-	     if (SLang_pop_uinteger(&width)) return (out);
-	     want_width = 1;
+	     spec->width_star = 1;
+	     spec->want_width = 1;
 	     ch = *p++;
 	  }
 	else
@@ -1972,43 +2028,213 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 
 	     while ((ch <= '9') && (ch >= '0'))
 	       {
-		  width = width * 10 + (ch - '0');
+		  spec->width = spec->width * 10 + (ch - '0');
 		  ch = *p++;
-		  want_width = 1;
+		  spec->want_width = 1;
 	       }
 	  }
+	*f = 0;
 
-	if (want_width)
-	  {
-	     sprintf(f, "%u", width);
-	     f += strlen (f);
-	  }
-	precis = 0;
 	/* precision -- also indicates max number of chars from string */
 	if (ch == '.')
 	  {
-	     *f++ = ch;
+	     spec->has_precis = 1;
 	     ch = *p++;
-	     want_width = 0;
 	     if (ch == '*')
 	       {
-		  if (SLang_pop_uinteger(&precis)) return (out);
+		  spec->precis_star = 1;
+		  spec->want_precis = 1;
 		  ch = *p++;
-		  want_width = 1;
 	       }
 	     else while ((ch <= '9') && (ch >= '0'))
 	       {
-		  precis = precis * 10 + (ch - '0');
+		  spec->precis = spec->precis * 10 + (ch - '0');
 		  ch = *p++;
-		  want_width = 1;
+		  spec->want_precis = 1;
 	       }
-	     if (want_width)
+	  }
+
+	if (ch == 'l')
+	  {
+	     spec->use_long = 1;
+	     ch = *p++;
+	     if (ch == 'l')
 	       {
-		  sprintf(f, "%u", precis);
-		  f += strlen (f);
+		  spec->use_long = 2;	       /* long long */
+		  ch = *p++;
 	       }
-	     else precis = 0;
 	  }
+	else if (ch == 'h') ch = *p++; /* not supported */
+
+	switch (ch)
+	  {
+	   case 'B': case 'S': case 's': case '%': case 'c': case 'b':
+	   case 'd': case 'i': case 'o': case 'u': case 'X': case 'x':
+	   case 'p':
+	     break;
+	   case 'f': case 'e': case 'g': case 'E': case 'G':
+#if SLANG_HAS_FLOAT
+	     break;
+#endif
+	   default:
+	     _pSLang_verror (SL_INVALID_PARM, "Invalid printf format");
+	     free_compiled_format (cf);
+	     return NULL;
+	  }
+	spec->conv = ch;
+	cf->num_args += (ch != '%') + spec->width_star + spec->precis_star;
+
+	spec->is_plain = ((spec->flags[1] == 0) && (spec->want_width == 0)
+			  && (spec->has_precis == 0));
+
+	/* The width and precision are too small to overflow the prefix */
+	if ((spec->width_star == 0) && (spec->precis_star == 0))
+	  (void) make_format_prefix (spec, spec->prefix, spec->width, spec->precis, (ch != 'B'));
+
+	spec++;
+     }
+   return cf;
+}
+
+static Compiled_Format_Type *get_compiled_format (SLstr_Type *fmt)
+{
+   Compiled_Format_Type *cf;
+   unsigned int i;
+
+   i = (unsigned int) (_pSLstring_get_hash (fmt) & (FORMAT_CACHE_SIZE - 1));
+   cf = Format_Cache[i];
+   if ((cf == NULL) || (cf->fmt != fmt))
+     {
+	if (NULL == (cf = compile_format (fmt)))
+	  return NULL;
+	free_compiled_format (Format_Cache[i]);
+	Format_Cache[i] = cf;
+     }
+   /* The caller gets a reference since a conversion may call a function
+    * that uses another format, removing this one from the cache.
+    */
+   cf->ref_count++;
+   return cf;
+}
+
+#ifdef HAVE_LONG_LONG
+typedef long long Format_Int_Type;
+typedef unsigned long long Format_UInt_Type;
+#else
+typedef long Format_Int_Type;
+typedef unsigned long Format_UInt_Type;
+#endif
+
+/* Writes v to buf as sprintf (buf, "%d", v) would, and returns the length */
+static size_t format_decimal (char *buf, Format_Int_Type v)
+{
+   char tmp[3 * sizeof (Format_UInt_Type) + 2];
+   char *t = tmp + sizeof (tmp);
+   Format_UInt_Type u = (v < 0) ? (Format_UInt_Type) 0 - (Format_UInt_Type) v : (Format_UInt_Type) v;
+   size_t n;
+
+   do
+     {
+	*--t = (char) ('0' + (u % 10));
+	u /= 10;
+     }
+   while (u != 0);
+   if (v < 0) *--t = '-';
+
+   n = (size_t) ((tmp + sizeof (tmp)) - t);
+   memcpy (buf, t, n);
+   buf[n] = 0;
+   return n;
+}
+
+/* Returns the length of what sprintf wrote to buf, given its return value.
+ * sprintf fails if the output would be too long, e.g., for a width that
+ * exceeds INT_MAX.  Then the conversion produces no output, as it did when
+ * the length was measured using strlen.
+ */
+static size_t sprintf_len (char *buf, int n)
+{
+   if (n < 0)
+     {
+	*buf = 0;
+	return 0;
+     }
+   return (size_t) n;
+}
+
+#if defined(__GNUC__)
+# pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#endif
+/* Formats the arguments on the stack using cf.  The result is written to
+ * *bufp, which is a malloced buffer of *sizep+1 bytes, or NULL.  It is
+ * reallocated as necessary.  The length of the result is returned in
+ * *lenp.
+ */
+static int format_compiled (Compiled_Format_Type *cf, char **bufp, size_t *sizep, size_t *lenp) /*{{{*/
+{
+   Format_Spec_Type *spec = cf->specs;
+   char *out = *bufp, *outp = NULL;
+   char dfmt[MAX_FORMAT_PREFIX_LEN + 8];
+   char *f;
+   char *str;
+   unsigned int width, precis;
+   int int_var, use_string;
+   long long_var;
+#ifdef HAVE_LONG_LONG
+   long long llong_var;
+#endif
+   size_t len = 0, malloc_len = *sizep, dlen;
+   int do_free;
+   unsigned int guess_size;
+#if SLANG_HAS_FLOAT
+   int use_double;
+   double x;
+#endif
+   unsigned char uch;
+   int use_long;
+   char ch;
+   SLuchar_Type utf8_buf[SLUTF8_MAX_MBLEN+1];
+
+   while (1)
+     {
+	dlen = spec->text_len;
+
+	if (len + dlen >= malloc_len)
+	  {
+	     malloc_len = len + dlen + 512;
+	     if (out == NULL) outp = (char *)SLmalloc(malloc_len + 1);
+	     else outp = (char *)SLrealloc(out, malloc_len + 1);
+	     if (NULL == outp)
+	       goto return_error;
+	     out = outp;
+	  }
+	outp = out + len;
+
+	memcpy (outp, spec->text, dlen);
+	len += dlen;
+	outp = out + len;
+	*outp = 0;
+	if ((ch = spec->conv) == 0) break;
+
+	width = spec->width;
+	precis = spec->precis;
+	if ((spec->width_star == 0) && (spec->precis_star == 0))
+	  {
+	     strcpy (dfmt, spec->prefix);
+	     f = dfmt + strlen (dfmt);
+	  }
+	else
+	  {
+	     if (spec->width_star
+		 && (-1 == SLang_pop_uinteger (&width)))
+	       goto return_error;
+	     if (spec->precis_star
+		 && (-1 == SLang_pop_uinteger (&precis)))
+	       goto return_error;
+	     f = make_format_prefix (spec, dfmt, width, precis, (ch != 'B'));
+	  }
+	if (spec->want_width == 0) width = 0;
+	if (spec->want_precis == 0) precis = 0;
 
 	long_var = 0;
 	int_var = 0;
@@ -2020,41 +2246,17 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 #if SLANG_HAS_FLOAT
 	use_double = 0;
 #endif
-	use_long = 0;
+	use_long = spec->use_long;
 	use_string = 0;
 	do_free = 0;
 
-	if (ch == 'l')
-	  {
-	     use_long = 1;
-	     ch = *p++;
-	     if (ch == 'l')
-	       {
-		  use_long = 2;	       /* long long */
-		  ch = *p++;
-	       }
-	  }
-	else if (ch == 'h') ch = *p++; /* not supported */
-
 	/* Now the actual format specifier */
 	switch (ch)
 	  {
 	   case 'B':
-	     if (-1 == _pSLformat_as_binary (precis, use_alt_format))
-	       return out;
-	     /* Remove the precision value from the format string */
-	     f1 = f-1;
-	     while (f1 > dfmt)
-	       {
-		  if (*f1 == '.')
-		    {
-		       *f1 = 0;
-		       f = f1;
-		       break;
-		    }
-		  f1--;
-	       }
-
+	     /* The precision was left out of the format */
+	     if (-1 == _pSLformat_as_binary (precis, spec->use_alt_format))
+	       goto return_error;
 	     /* fall through */
 	   case 'S':
 	     if (ch == 'S')
@@ -2063,9 +2265,9 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	     /* fall through */
 	   case 's':
 	     if (-1 == SLang_pop_slstring(&str))
-	       return (out);
+	       goto return_error;
 	     do_free = 1;
-	     guess_size = strlen(str);
+	     guess_size = (unsigned int) _pSLstring_bytelen (str);
 	     use_string = 1;
 	     break;
 
@@ -2077,21 +2279,22 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	     break;
 
 	   case 'c':
-#if 0
-	     if (use_long)
-#endif
 	       {
 		  SLwchar_Type wc;
 
 		  if (-1 == _pSLang_pop_wchar (&wc))
-		    return out;
+		    goto return_error;
 		  if ((_pSLinterp_UTF8_Mode == 0) && (wc <= 0xFF))
 		    {
 		       utf8_buf[0] = (unsigned char)wc;
 		       utf8_buf[1] = 0;
 		    }
 		  else if (NULL == SLutf8_encode_null_terminate (wc, utf8_buf))
-		    return out;
+		    {
+		       _pSLang_verror (SL_InvalidParm_Error, "invalid character for %%c: 0x%lX",
+				       (unsigned long) wc);
+		       goto return_error;
+		    }
 		  ch = 's';
 		  str = (char *)utf8_buf;
 		  use_string = 1;
@@ -2102,7 +2305,7 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	     use_long = 0;
 	     guess_size = 1;
 	     if (-1 == SLang_pop_uchar (&uch))
-	       return out;
+	       goto return_error;
 	     int_var = (int) uch;
 	     ch = 'c';
 	     break;
@@ -2117,7 +2320,7 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	     if (use_long > 1)
 	       {
 		  if (-1 == SLang_pop_long_long (&llong_var))
-		    return out;
+		    goto return_error;
 # ifdef __WIN32__
 		  *f++ = 'I'; *f++ = '6'; *f++ = '4';
 # else
@@ -2129,20 +2332,20 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	       if (use_long)
 		 {
 		    if (-1 == SLang_pop_long (&long_var))
-		      return out;
+		      goto return_error;
 		    *f++ = 'l';
 		 }
 	     else if (-1 == SLang_pop_int (&int_var))
-	       return out;
+	       goto return_error;
 	     break;
 
+#if SLANG_HAS_FLOAT
 	   case 'f':
 	   case 'e':
 	   case 'g':
 	   case 'E':
 	   case 'G':
-#if SLANG_HAS_FLOAT
-	     if (SLang_pop_double(&x)) return (out);
+	     if (SLang_pop_double(&x)) goto return_error;
 	     use_double = 1;
 	     guess_size = 256;
 	     if (fabs(x) > 1e38)
@@ -2161,18 +2364,15 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	     break;
 #endif
 	   case 'p':
+	   default:		       /* not reached: checked by compile_format */
 	     guess_size = 32;
 	     /* Pointer type?? Why?? */
 	     if (-1 == SLdo_pop ())
-	       return out;
+	       goto return_error;
 	     str = (char *) _pSLang_get_run_stack_pointer ();
 	     use_string = 1;
 	     use_long = 0;
 	     break;
-
-	   default:
-	     _pSLang_verror (SL_INVALID_PARM, "Invalid printf format");
-	     return(out);
 	  }
 	*f++ = ch; *f = 0;
 
@@ -2186,44 +2386,62 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 	     if (outp == NULL)
 	       {
 		  SLang_set_error (SL_MALLOC_ERROR);
-		  return (out);
+		  goto return_error;
 	       }
 	     out = outp;
 	     outp = out + len;
 	     malloc_len = len + guess_size;
 	  }
 
+	/* Plain %s and %d conversions do not need sprintf */
 	if (use_string)
 	  {
-	     sprintf(outp, dfmt, str);
+	     if (spec->is_plain && (ch == 's'))
+	       {
+		  dlen = do_free ? _pSLstring_bytelen (str) : strlen (str);
+		  memcpy (outp, str, dlen + 1);
+	       }
+	     else
+	       dlen = sprintf_len (outp, sprintf (outp, dfmt, str));
 	     if (do_free) _pSLang_free_slstring (str);
 	  }
 #if SLANG_HAS_FLOAT
-	else if (use_double) sprintf(outp, dfmt, x);
+	else if (use_double) dlen = sprintf_len (outp, sprintf (outp, dfmt, x));
+#endif
+	else if (spec->is_plain && ((ch == 'd') || (ch == 'i')))
+	  {
+#ifdef HAVE_LONG_LONG
+	     if (use_long > 1)
+	       dlen = format_decimal (outp, llong_var);
+	     else
 #endif
+	       dlen = format_decimal (outp, use_long ? long_var : int_var);
+	  }
 	else if (use_long)
 	  {
 #ifdef HAVE_LONG_LONG
 	     if (use_long > 1)
-	       sprintf (outp, dfmt, llong_var);
+	       dlen = sprintf_len (outp, sprintf (outp, dfmt, llong_var));
 	     else
 #endif
-	       sprintf (outp, dfmt, long_var);
+	       dlen = sprintf_len (outp, sprintf (outp, dfmt, long_var));
 	  }
-	else sprintf(outp, dfmt, int_var);
+	else dlen = sprintf_len (outp, sprintf (outp, dfmt, int_var));
 
-	len += strlen(outp);
+	len += dlen;
 	outp = out + len;
-	fmt = p;
+	spec++;
      }
 
-   if (out != NULL)
-     {
-	outp = (char *)SLrealloc (out, (unsigned int) (outp - out) + 1);
-	if (outp != NULL) out = outp;
-     }
+   *bufp = out;
+   *sizep = malloc_len;
+   *lenp = len;
+   return 0;
 
-   return (out);
+return_error:
+   *bufp = out;
+   *sizep = malloc_len;
+   return -1;
 }
 #if defined(__GNUC__)
 # pragma GCC diagnostic warning "-Wformat-nonliteral"
@@ -2231,31 +2449,69 @@ static char *SLdo_sprintf (char *fmt) /*{{{*/
 
 /*}}}*/
 
-int _pSLstrops_do_sprintf_n (int n) /*{{{*/
+static char *SLdo_sprintf (SLstr_Type *fmt) /*{{{*/
+{
+   Compiled_Format_Type *cf;
+   char *out = NULL, *p;
+   size_t size = 0, len;
+   int status;
+
+   if (NULL == (cf = get_compiled_format (fmt)))
+     return NULL;
+   status = format_compiled (cf, &out, &size, &len);
+   free_compiled_format (cf);
+
+   if (status == -1)
+     {
+	SLfree (out);
+	return NULL;
+     }
+   if (NULL != (p = (char *)SLrealloc (out, len + 1)))
+     out = p;
+   return out;
+}
+
+/*}}}*/
+
+/* Pops the format and the n arguments that follow it, and returns the
+ * formatted string as a malloced string, or NULL upon error.
+ */
+char *_pSLstrops_sprintf_n (int n) /*{{{*/
 {
    char *p;
    char *fmt;
-   SLang_Object_Type *ptr;
    int ofs;
 
+   /* ofs is the depth of the stack below the arguments.  A pointer cannot
+    * be used since the stack may move.
+    */
    if (-1 == (ofs = SLreverse_stack (n + 1)))
-     return -1;
-
-   ptr = _pSLang_get_run_stack_base () + ofs;
+     return NULL;
 
    if (SLang_pop_slstring(&fmt))
-     return -1;
+     return NULL;
 
    p = SLdo_sprintf (fmt);
    _pSLang_free_slstring (fmt);
 
-   SLdo_pop_n (_pSLang_get_run_stack_pointer () - ptr);
+   SLdo_pop_n (SLstack_depth () - ofs);
 
    if (_pSLang_Error)
      {
 	SLfree (p);
-	return -1;
+	return NULL;
      }
+   return p;
+}
+
+/*}}}*/
+
+int _pSLstrops_do_sprintf_n (int n) /*{{{*/
+{
+   char *p;
+
+   if (NULL == (p = _pSLstrops_sprintf_n (n)))
+     return -1;
 
    return SLang_push_malloced_string (p);
 }
@@ -2272,6 +2528,133 @@ static void sprintf_cmd (void)
    _pSLstrops_do_sprintf_n (SLang_Num_Function_Args - 1);    /* do not include format */
 }
 
+static int push_array_element (SLang_Array_Type *at, SLuindex_Type i)
+{
+   VOID_STAR addr = (VOID_STAR) ((char *) at->data + i * at->sizeof_type);
+
+   if ((at->flags & SLARR_DATA_VALUE_IS_POINTER)
+       && (*(VOID_STAR *) addr == NULL))
+     return SLang_push_null ();
+
+   return (*at->cl->cl_apush) (at->data_type, addr);
+}
+
+/* Usage: String_Type[] array_sprintf (fmt, args...)
+ * The format is applied to the corresponding elements of the array
+ * arguments.  Scalar arguments are used for every element.
+ */
+static void array_sprintf_cmd (void) /*{{{*/
+{
+   SLang_Array_Type **ats, *at_control, *bt = NULL;
+   Compiled_Format_Type *cf = NULL;
+   SLstr_Type *fmt = NULL, **strs;
+   char *buf = NULL;
+   size_t size = 0, len;
+   SLuindex_Type i, num_elements;
+   SLindex_Type one = 1;
+   int j, nargs, depth, control;
+
+   nargs = SLang_Num_Function_Args - 1;
+   if (nargs < 0)
+     {
+	_pSLang_verror (SL_Usage_Error, "Usage: String_Type[] = array_sprintf (fmt, args...)");
+	return;
+     }
+
+   if (NULL == (ats = (SLang_Array_Type **) SLcalloc (nargs + 1, sizeof (SLang_Array_Type *))))
+     return;
+
+   for (j = nargs; j > 0; j--)
+     {
+	if (-1 == SLang_pop_array (&ats[j-1], 1))
+	  {
+	     SLdo_pop_n (j);
+	     goto free_and_return;
+	  }
+     }
+   if (-1 == SLang_pop_slstring (&fmt))
+     goto free_and_return;
+
+   /* The shape of the result is that of the first array argument */
+   at_control = NULL;
+   control = 0;
+   for (j = 0; j < nargs; j++)
+     {
+	if (0 == (ats[j]->flags & SLARR_DERIVED_FROM_SCALAR))
+	  {
+	     at_control = ats[j];
+	     control = j;
+	     break;
+	  }
+     }
+   num_elements = (at_control == NULL) ? 1 : at_control->num_elements;
+   for (j = 0; j < nargs; j++)
+     {
+	if ((0 == (ats[j]->flags & SLARR_DERIVED_FROM_SCALAR))
+	    && (ats[j]->num_elements != num_elements))
+	  {
+	     _pSLang_verror (SL_InvalidParm_Error,
+			     "array_sprintf: argument %d does not have the same number of elements as argument %d",
+			     j + 2, control + 2);
+	     goto free_and_return;
+	  }
+     }
+
+   if (NULL == (cf = get_compiled_format (fmt)))
+     goto free_and_return;
+   if (cf->num_args > (unsigned int) nargs)
+     {
+	_pSLang_verror (SL_NumArgs_Error, "array_sprintf: the format requires %u arguments",
+			cf->num_args);
+	goto free_and_return;
+     }
+
+   if (at_control == NULL)
+     bt = SLang_create_array (SLANG_STRING_TYPE, 0, NULL, &one, 1);
+   else
+     bt = SLang_create_array (SLANG_STRING_TYPE, 0, NULL, at_control->dims, at_control->num_dims);
+   if (bt == NULL)
+     goto free_and_return;
+
+   /* The output buffer is reused for each element */
+   strs = (SLstr_Type **) bt->data;
+   depth = SLstack_depth ();
+   for (i = 0; i < num_elements; i++)
+     {
+	int status = -1;
+
+	/* Push the arguments in reverse order so that the first is on top */
+	for (j = nargs; j > 0; j--)
+	  {
+	     SLang_Array_Type *at = ats[j-1];
+	     if (-1 == push_array_element (at, (at->flags & SLARR_DERIVED_FROM_SCALAR) ? 0 : i))
+	       break;
+	  }
+	if (j == 0)
+	  status = format_compiled (cf, &buf, &size, &len);
+	SLdo_pop_n (SLstack_depth () - depth);
+
+	if ((status == -1) || _pSLang_Error
+	    || (NULL == (strs[i] = SLang_create_nslstring (buf, len))))
+	  goto free_and_return;
+     }
+
+   (void) SLang_push_array (bt, 0);
+
+free_and_return:
+   SLfree (buf);
+   if (bt != NULL) SLang_free_array (bt);
+   free_compiled_format (cf);
+   _pSLang_free_slstring (fmt);
+   for (j = 0; j < nargs; j++)
+     {
+	if (ats[j] != NULL) SLang_free_array (ats[j]);
+     }
+   SLfree ((char *) ats);
+}
+
+/*}}}*/
+
 /* converts string s to a form that can be used in an eval */
 /* UTF-8 ok */
 static void make_printable_string(unsigned char *s) /*{{{*/
@@ -2414,80 +2797,133 @@ static int is_list_element_cmd (char *list, char *elem, SLwchar_Type *delim_ptr)
 /*}}}*/
 
 /* Regular expression routines for strings */
-#define NUM_CACHED_REGEXP 5
-typedef struct
+
+/* Compiled patterns are kept in a cache whose size may be set using
+ * set_regexp_cache_size.  The cached patterns are found by a hash table
+ * keyed by the pattern, which is an slstring, and are kept in a list in
+ * the order of their most recent use, so that the least recently used
+ * pattern is the one dropped when the cache is full.  The head of the
+ * list is the pattern used by string_match_nth.
+ */
+#define DEFAULT_REGEXP_CACHE_SIZE 32
+#define REGEXP_HASH_TABLE_SIZE 64	       /* must be a power of 2 */
+typedef struct _Regexp_Type
 {
    SLRegexp_Type *regexp;
    char *pattern;
    unsigned int match_byte_offset;
+   struct _Regexp_Type *prev, *next;   /* in the order of use */
+   struct _Regexp_Type *hash_next;
 }
 Regexp_Type;
-static unsigned int Cache_Indices[NUM_CACHED_REGEXP];
-static Regexp_Type Regexp_Cache[NUM_CACHED_REGEXP];
+static Regexp_Type *Regexp_Hash_Table[REGEXP_HASH_TABLE_SIZE];
+static Regexp_Type *Regexp_Cache_Head;
+static Regexp_Type *Regexp_Cache_Tail;
+static unsigned int Num_Cached_Regexps;
+static unsigned int Regexp_Cache_Size = DEFAULT_REGEXP_CACHE_SIZE;
 
 static int init_regexp_cache (void)
 {
-   unsigned int i;
+   memset ((char *) Regexp_Hash_Table, 0, sizeof (Regexp_Hash_Table));
+   Regexp_Cache_Head = Regexp_Cache_Tail = NULL;
+   Num_Cached_Regexps = 0;
+   return 0;
+}
 
-   for (i = 0; i < NUM_CACHED_REGEXP; i++)
-     Cache_Indices[i] = i;
+static Regexp_Type **regexp_hash_bucket (char *pat)
+{
+   return Regexp_Hash_Table + (_pSLstring_get_hash (pat) & (REGEXP_HASH_TABLE_SIZE-1));
+}
 
-   return 0;
+static void unlink_cached_regexp (Regexp_Type *r)
+{
+   if (r->prev == NULL) Regexp_Cache_Head = r->next;
+   else r->prev->next = r->next;
+   if (r->next == NULL) Regexp_Cache_Tail = r->prev;
+   else r->next->prev = r->prev;
+   r->prev = r->next = NULL;
 }
 
-static Regexp_Type *get_regexp (char *pat)
+static void push_cached_regexp (Regexp_Type *r)
 {
-   Regexp_Type *r;
-   unsigned int i, j;
+   r->prev = NULL;
+   r->next = Regexp_Cache_Head;
+   if (Regexp_Cache_Head != NULL) Regexp_Cache_Head->prev = r;
+   else Regexp_Cache_Tail = r;
+   Regexp_Cache_Head = r;
+}
 
-   for (i = 0; i < NUM_CACHED_REGEXP; i++)
+/* Drops the least recently used patterns until there are at most n */
+static void trim_regexp_cache (unsigned int n)
+{
+   while (Num_Cached_Regexps > n)
      {
-	r = Regexp_Cache + Cache_Indices[i];
-	if (r->pattern != pat) continue; /* slstring comparison */
+	Regexp_Type *r = Regexp_Cache_Tail;
+	Regexp_Type **rp = regexp_hash_bucket (r->pattern);
 
-	if ((r->regexp == NULL)
-	    && (NULL == (r->regexp = SLregexp_compile (pat, 0))))
-	  return NULL;
+	while (*rp != r)
+	  rp = &(*rp)->hash_next;
+	*rp = r->hash_next;
 
-	goto update_cache_and_return;
+	unlink_cached_regexp (r);
+	SLregexp_free (r->regexp);
+	SLang_free_slstring (r->pattern);
+	SLfree ((char *) r);
+	Num_Cached_Regexps--;
      }
+}
 
-   /* Here, r is set to Regexp_Cache + Cache_Indices[i] */
-
-   SLang_free_slstring (r->pattern);   /* NULL ok */
-   if (NULL == (r->pattern = SLang_create_slstring (pat)))
-     return NULL;
-
-   SLregexp_free (r->regexp);	       /* NULL ok */
-   if (NULL == (r->regexp = SLregexp_compile (pat, 0)))
-     return NULL;
-
-   /* Drop */
-
-update_cache_and_return:
-   i = r - Regexp_Cache;
-   if (i == Cache_Indices[0]) return r;
+static Regexp_Type *get_regexp (char *pat)
+{
+   Regexp_Type *r, **bucket;
 
-   j = 1;
-   while (j < NUM_CACHED_REGEXP)
+   bucket = regexp_hash_bucket (pat);
+   for (r = *bucket; r != NULL; r = r->hash_next)
      {
-	if (i != Cache_Indices[j])
-	  {
-	     j++;
-	     continue;
-	  }
+	if (r->pattern != pat) continue; /* slstring comparison */
 
-	while (j > 0)
+	if (r != Regexp_Cache_Head)
 	  {
-	     Cache_Indices[j] = Cache_Indices[j-1];
-	     j--;
+	     unlink_cached_regexp (r);
+	     push_cached_regexp (r);
 	  }
-	Cache_Indices[0] = i;
-	break;
+	return r;
      }
+
+   if (NULL == (r = (Regexp_Type *) SLcalloc (1, sizeof (Regexp_Type))))
+     return NULL;
+   if (NULL == (r->regexp = SLregexp_compile (pat, 0)))
+     {
+	SLfree ((char *) r);
+	return NULL;
+     }
+   r->pattern = (char *) _pSLstring_dup_slstring (pat);
+
+   trim_regexp_cache (Regexp_Cache_Size - 1);
+   r->hash_next = *bucket;
+   *bucket = r;
+   push_cached_regexp (r);
+   Num_Cached_Regexps++;
    return r;
 }
 
+static void set_regexp_cache_size_cmd (int *np)
+{
+   if (*np < 1)
+     {
+	_pSLang_verror (SL_InvalidParm_Error, "The regular expression cache size must be at least 1");
+	return;
+     }
+   Regexp_Cache_Size = (unsigned int) *np;
+   trim_regexp_cache (Regexp_Cache_Size);
+}
+
+static int get_regexp_cache_size_cmd (void)
+{
+   return (int) Regexp_Cache_Size;
+}
+
+/* str must be an slstring */
 static int string_match_internal (char *str, Regexp_Type *r, int n) /*{{{*/
 {
    char *match;
@@ -2495,7 +2931,7 @@ static int string_match_internal (char *str, Regexp_Type *r, int n) /*{{{*/
    size_t byte_offset;
 
    byte_offset = (unsigned int) (n - 1);
-   len = strlen(str);
+   len = _pSLstring_bytelen (str);
 
    if (byte_offset > len)
      return 0;
@@ -2510,44 +2946,81 @@ static int string_match_internal (char *str, Regexp_Type *r, int n) /*{{{*/
 
 /*}}}*/
 
-
-static int pop_string_match_args (int nargs, char **strp, char **patp, int *np)
+/* Pops the pattern and the optional position, leaving the string, which
+ * may be an array of strings, on the stack.
+ */
+static int pop_string_match_pattern (int nargs, char **patp, int *np)
 {
-   *strp = *patp = NULL;
+   *patp = NULL;
 
    if (nargs == 2)
      *np = 1;
    else if (-1 == SLang_pop_int (np))
      return -1;
 
-   if (-1 == SLang_pop_slstring (patp))
-     return -1;
+   return SLang_pop_slstring (patp);
+}
 
-   if (0 == SLang_pop_slstring (strp))
+/* The string_match and string_matches functions may be applied to an
+ * array of strings, in which case the pattern is compiled once and the
+ * result is an array.  The submatches reported by string_match_nth are
+ * those of the last string that was matched.
+ */
+static int pop_string_match_array (SLang_Array_Type **atp)
+{
+   *atp = NULL;
+   if (SLang_peek_at_stack () != SLANG_ARRAY_TYPE)
      return 0;
-
-   SLang_free_slstring (*patp);
-   *patp = NULL;
-   return -1;
+   if (-1 == SLang_pop_array_of_type (atp, SLANG_STRING_TYPE))
+     return -1;
+   return 1;
 }
 
-static int string_match_cmd (void)
+static void string_match_cmd (void)
 {
+   SLang_Array_Type *at, *int_at;
    Regexp_Type *r;
    char *str, *pat;
+   char **strs;
+   int *positions;
+   SLuindex_Type i, num;
    int n, status;
 
-   if (-1 == pop_string_match_args (SLang_Num_Function_Args, &str, &pat, &n))
-     return -1;
+   if (-1 == pop_string_match_pattern (SLang_Num_Function_Args, &pat, &n))
+     return;
 
-   if (NULL == (r = get_regexp (pat)))
-     status = -1;
-   else
-     status = string_match_internal (str, r, n);
+   if (-1 == (status = pop_string_match_array (&at)))
+     goto free_and_return;
 
-   SLang_free_slstring (str);
+   if (status == 0)
+     {
+	if (-1 == SLang_pop_slstring (&str))
+	  goto free_and_return;
+
+	if (NULL != (r = get_regexp (pat)))
+	  (void) SLang_push_int (string_match_internal (str, r, n));
+	SLang_free_slstring (str);
+	goto free_and_return;
+     }
+
+   if ((NULL == (r = get_regexp (pat)))
+       || (NULL == (int_at = SLang_create_array1 (SLANG_INT_TYPE, 0, NULL, at->dims, at->num_dims, 0))))
+     goto free_and_return;
+
+   strs = (char **) at->data;
+   positions = (int *) int_at->data;
+   num = at->num_elements;
+   for (i = 0; i < num; i++)
+     {
+	if (strs[i] == NULL)
+	  continue;
+	positions[i] = string_match_internal (strs[i], r, n);
+     }
+   (void) SLang_push_array (int_at, 1);
+
+free_and_return:
+   SLang_free_array (at);	       /* NULL ok */
    SLang_free_slstring (pat);
-   return status;
 }
 
 static int string_match_nth_cmd (int *nptr) /*{{{*/
@@ -2555,8 +3028,8 @@ static int string_match_nth_cmd (int *nptr) /*{{{*/
    SLuindex_Type ofs, len;
    Regexp_Type *r;
 
-   r = Regexp_Cache + Cache_Indices[0];
-   if (r->regexp == NULL)
+   r = Regexp_Cache_Head;
+   if (r == NULL)
      {
 	_pSLang_verror (SL_RunTime_Error, "A successful call to string_match was not made");
 	return -1;
@@ -2577,26 +3050,21 @@ static int string_match_nth_cmd (int *nptr) /*{{{*/
 
 /*}}}*/
 
-static int string_matches_internal (char *str, char *pat, int n)
+/* Returns 0 if str does not match, in which case *atp is set to NULL, 1
+ * if it does, or -1 upon error.
+ */
+static int string_matches_internal (char *str, Regexp_Type *r, int n, SLang_Array_Type **atp)
 {
    SLstrlen_Type lens[10];
    SLstrlen_Type offsets[10];
-   Regexp_Type *r;
    char **strs;
    SLang_Array_Type *at;
    SLindex_Type num;
    SLuindex_Type i;
-   int status;
-
-   if (NULL == (r = get_regexp (pat)))
-     return -1;
 
-   status = string_match_internal (str, r, n);
-   if (status <= 0)
-     {
-	SLang_push_null ();
-	return -1;
-     }
+   *atp = NULL;
+   if (0 == string_match_internal (str, r, n))
+     return 0;
 
    for (i = 0; i < 10; i++)
      {
@@ -2620,19 +3088,64 @@ static int string_matches_internal (char *str, char *pat, int n)
 	  }
      }
 
-   return SLang_push_array (at, 1);
+   *atp = at;
+   return 1;
 }
 
 static void string_matches_cmd (void)
 {
+   SLang_Array_Type *at, *matches_at, *bt;
+   SLang_Array_Type **matches;
+   Regexp_Type *r;
    char *str, *pat;
-   int n;
+   char **strs;
+   SLuindex_Type i, num;
+   int n, status;
 
-   if (-1 == pop_string_match_args (SLang_Num_Function_Args, &str, &pat, &n))
+   if (-1 == pop_string_match_pattern (SLang_Num_Function_Args, &pat, &n))
      return;
 
-   (void) string_matches_internal (str, pat, n);
-   SLang_free_slstring (str);
+   if (-1 == (status = pop_string_match_array (&at)))
+     goto free_and_return;
+
+   if (status == 0)
+     {
+	if (-1 == SLang_pop_slstring (&str))
+	  goto free_and_return;
+
+	if ((NULL != (r = get_regexp (pat)))
+	    && (-1 != string_matches_internal (str, r, n, &bt)))
+	  {
+	     if (bt == NULL)
+	       (void) SLang_push_null ();
+	     else
+	       (void) SLang_push_array (bt, 1);
+	  }
+	SLang_free_slstring (str);
+	goto free_and_return;
+     }
+
+   if ((NULL == (r = get_regexp (pat)))
+       || (NULL == (matches_at = SLang_create_array1 (SLANG_ARRAY_TYPE, 0, NULL, at->dims, at->num_dims, 0))))
+     goto free_and_return;
+
+   strs = (char **) at->data;
+   matches = (SLang_Array_Type **) matches_at->data;
+   num = at->num_elements;
+   for (i = 0; i < num; i++)
+     {
+	if (strs[i] == NULL)
+	  continue;
+	if (-1 == string_matches_internal (strs[i], r, n, matches + i))
+	  {
+	     SLang_free_array (matches_at);
+	     goto free_and_return;
+	  }
+     }
+   (void) SLang_push_array (matches_at, 1);
+
+free_and_return:
+   SLang_free_array (at);	       /* NULL ok */
    SLang_free_slstring (pat);
 }
 
@@ -3151,9 +3664,11 @@ static SLang_Intrin_Fun_Type Strops_Table [] = /*{{{*/
    MAKE_INTRINSIC_2("strbytesub",  strbytesub_cmd, SLANG_VOID_TYPE, SLANG_INT_TYPE, SLANG_UCHAR_TYPE),
    MAKE_INTRINSIC_3("extract_element", extract_element_cmd, SLANG_VOID_TYPE, SLANG_STRING_TYPE, SLANG_INT_TYPE, SLANG_WCHAR_TYPE),
    MAKE_INTRINSIC_3("is_list_element", is_list_element_cmd, SLANG_INT_TYPE, SLANG_STRING_TYPE, SLANG_STRING_TYPE, SLANG_WCHAR_TYPE),
-   MAKE_INTRINSIC_0("string_match", string_match_cmd, SLANG_INT_TYPE),
+   MAKE_INTRINSIC_0("string_match", string_match_cmd, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_0("string_matches", string_matches_cmd, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_I("string_match_nth", string_match_nth_cmd, SLANG_INT_TYPE),
+   MAKE_INTRINSIC_I("set_regexp_cache_size", set_regexp_cache_size_cmd, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("get_regexp_cache_size", get_regexp_cache_size_cmd, SLANG_INT_TYPE),
    MAKE_INTRINSIC_0("strlow", strlow_vintrin, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_1("tolower", tolower_cmd, SLANG_INT_TYPE, SLANG_WCHAR_TYPE),
    MAKE_INTRINSIC_1("toupper", toupper_cmd, SLANG_INT_TYPE, SLANG_WCHAR_TYPE),
@@ -3164,6 +3679,7 @@ static SLang_Intrin_Fun_Type Strops_Table [] = /*{{{*/
    MAKE_INTRINSIC_S("strcompress", strcompress_vintrin, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_I("Sprintf", sprintf_n_cmd, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_0("sprintf", sprintf_cmd, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("array_sprintf", array_sprintf_cmd, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_0("sscanf", _pSLang_sscanf, SLANG_INT_TYPE),
    MAKE_INTRINSIC_S("make_printable_string", make_printable_string, SLANG_VOID_TYPE),
    MAKE_INTRINSIC_3("str_quote_string", str_quote_string_cmd, SLANG_VOID_TYPE, SLANG_STRING_TYPE, SLANG_STRING_TYPE, SLANG_WCHAR_TYPE),
@@ -211,6 +211,34 @@ static _pSLstruct_Field_Type *find_field (_pSLang_Struct_Type *s, SLCONST char *
    return find_field_in_fields (s->fields, s->nfields, name);
 }
 
+/* Here *cache is the index of the field where name was last found.  It is
+ * checked first, and updated if the field is found elsewhere.  Since
+ * structs with the same layout have their fields in the same order, this
+ * avoids the search when the same code is applied to many such structs.
+ * The cache may be NULL.
+ */
+static _pSLstruct_Field_Type *find_field_cached (_pSLang_Struct_Type *s, SLCONST char *name,
+						unsigned char *cache)
+{
+   _pSLstruct_Field_Type *f;
+   unsigned int i;
+
+   if (cache == NULL)
+     return find_field (s, name);
+
+   i = *cache;
+   if ((i < s->nfields) && (s->fields[i].name == name))
+     return s->fields + i;
+
+   if (NULL == (f = find_field (s, name)))
+     return NULL;
+
+   i = (unsigned int) (f - s->fields);
+   if (i <= 0xFF)
+     *cache = (unsigned char) i;
+   return f;
+}
+
 static _pSLstruct_Field_Type *find_field_strcmp (_pSLang_Struct_Type *s, SLCONST char *name)
 {
    _pSLstruct_Field_Type *f, *fmax;
@@ -245,6 +273,20 @@ SLang_Object_Type *_pSLstruct_get_field_value (SLang_Struct_Type *s, SLCONST cha
    return &f->obj;
 }
 
+/* Like _pSLstruct_get_field_value, but name must be an slstring.  The cache
+ * is as described for find_field_cached.
+ */
+SLang_Object_Type *_pSLstruct_get_field_value_cached (SLang_Struct_Type *s, SLCONST char *name,
+						     unsigned char *cache)
+{
+   _pSLstruct_Field_Type *f = find_field_cached (s, name, cache);
+
+   if (f == NULL)
+     return NULL;
+
+   return &f->obj;
+}
+
 static _pSLstruct_Field_Type *pop_field (_pSLang_Struct_Type *s, SLCONST char *name,
 					_pSLstruct_Field_Type *(*find)(_pSLang_Struct_Type *, SLCONST char *))
 {
@@ -1701,6 +1743,24 @@ int _pSLstruct_push_field (SLang_Struct_Type *s, SLFUTURE_CONST char *name, int
    return ret;
 }
 
+int _pSLstruct_push_field_cached (SLang_Struct_Type *s, SLFUTURE_CONST char *name,
+				  unsigned char *cache, int do_free)
+{
+   _pSLstruct_Field_Type *f;
+   int ret;
+
+   if (NULL == (f = find_field_cached (s, name, cache)))
+     {
+	_pSLang_verror (SL_INVALID_PARM, "struct has no field named %s", name);
+	if (do_free) SLang_free_struct (s);
+	return -1;
+     }
+
+   ret = _pSLpush_slang_obj (&f->obj);
+   if (do_free) SLang_free_struct (s);
+   return ret;
+}
+
 static int struct_sget (SLtype type, SLFUTURE_CONST char *name)
 {
    _pSLang_Struct_Type *s;
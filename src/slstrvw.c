@@ -0,0 +1,569 @@
+/* String views: substrings that refer to the bytes of another string */
+/*
+Copyright (C) 2004-2020,2021 John E. Davis
+
+This file is part of the S-Lang Library.
+
+The S-Lang Library is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the
+License, or (at your option) any later version.
+
+The S-Lang Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+USA.
+*/
+
+#include "slinclud.h"
+
+#include "slang.h"
+#include "_slang.h"
+
+/* Every string created by substr, strchop, strtok, etc. is copied, hashed,
+ * and added to the string table.  A view instead holds a reference to the
+ * string that it was taken from, along with an offset and a length.  It is
+ * converted to a string, which is interned, only when it is used where a
+ * string is required, e.g., as the key of an associative array.  Views
+ * may be compared with each other and with strings without converting
+ * them.
+ *
+ *    strview (s [,pos [,len]])       like substrbytes
+ *    strview_chop (s, delim)         like strchop without a quote character
+ *    strview_tok (s [,white])        like strtok
+ *    strview_trim (s [,white])       like strtrim
+ *    length (v), string (v), typecast (v, String_Type)
+ *
+ * Here, s may be a string or a view.  A view of a view refers to the
+ * original string.
+ */
+
+typedef struct
+{
+   SLstr_Type *str;		       /* the string that is referred to */
+   SLstrlen_Type offset;
+   SLstrlen_Type len;
+   int ref_count;
+}
+StrView_Type;
+
+#define VIEW_BYTES(v) ((v)->str + (v)->offset)
+
+static SLwchar_Lut_Type *WhiteSpace_Lut;
+
+static void free_strview (StrView_Type *v)
+{
+   if (v == NULL)
+     return;
+
+   if (v->ref_count > 1)
+     {
+	v->ref_count--;
+	return;
+     }
+   _pSLang_free_slstring (v->str);
+   SLfree ((char *) v);
+}
+
+/* This does not take over the reference to str */
+static StrView_Type *create_strview (SLstr_Type *str, SLstrlen_Type offset, SLstrlen_Type len)
+{
+   StrView_Type *v;
+
+   if (NULL == (v = (StrView_Type *) SLmalloc (sizeof (StrView_Type))))
+     return NULL;
+
+   v->str = (SLstr_Type *) _pSLstring_dup_slstring (str);
+   v->offset = offset;
+   v->len = len;
+   v->ref_count = 1;
+   return v;
+}
+
+static int push_strview (StrView_Type *v, int free_flag)
+{
+   /* SLclass_push_ptr_obj does not do memory management */
+   if (-1 == SLclass_push_ptr_obj (SLANG_STRVIEW_TYPE, (VOID_STAR) v))
+     {
+	if (free_flag) free_strview (v);
+	return -1;
+     }
+
+   if (free_flag == 0)
+     v->ref_count++;
+
+   return 0;
+}
+
+/* Pops a string or a view as a string, an offset, and a length.  The
+ * caller must free the string.
+ */
+static int pop_bytes (SLstr_Type **strp, SLstrlen_Type *offsetp, SLstrlen_Type *lenp)
+{
+   StrView_Type *v;
+
+   if (SLang_peek_at_stack () == SLANG_STRVIEW_TYPE)
+     {
+	if (-1 == SLclass_pop_ptr_obj (SLANG_STRVIEW_TYPE, (VOID_STAR *) &v))
+	  return -1;
+	*strp = (SLstr_Type *) _pSLstring_dup_slstring (v->str);
+	*offsetp = v->offset;
+	*lenp = v->len;
+	free_strview (v);
+	return 0;
+     }
+
+   if (-1 == SLang_pop_slstring (strp))
+     return -1;
+   *offsetp = 0;
+   *lenp = (SLstrlen_Type) _pSLstring_bytelen (*strp);
+   return 0;
+}
+
+/* Creates an array of views of str from the n (offset,len) pairs in ofs */
+static SLang_Array_Type *create_strview_array (SLstr_Type *str, SLstrlen_Type *ofs, SLindex_Type n)
+{
+   SLang_Array_Type *at;
+   StrView_Type **data;
+   SLindex_Type i;
+
+   if (NULL == (at = SLang_create_array (SLANG_STRVIEW_TYPE, 0, NULL, &n, 1)))
+     return NULL;
+
+   data = (StrView_Type **) at->data;
+   for (i = 0; i < n; i++)
+     {
+	if (NULL == (data[i] = create_strview (str, ofs[2*i], ofs[2*i+1])))
+	  {
+	     SLang_free_array (at);
+	     return NULL;
+	  }
+     }
+   return at;
+}
+
+/* Appends an (offset,len) pair to a growing list of them */
+static int append_range (SLstrlen_Type **ofsp, SLindex_Type *np, SLindex_Type *maxp,
+			 SLstrlen_Type offset, SLstrlen_Type len)
+{
+   SLstrlen_Type *ofs = *ofsp;
+
+   if (*np == *maxp)
+     {
+	SLindex_Type max = *maxp ? 2 * *maxp : 64;
+	if (NULL == (ofs = (SLstrlen_Type *) _SLrecalloc ((char *) ofs, 2 * max, sizeof (SLstrlen_Type))))
+	  return -1;
+	*ofsp = ofs;
+	*maxp = max;
+     }
+   ofs[2 * *np] = offset;
+   ofs[2 * *np + 1] = len;
+   *np += 1;
+   return 0;
+}
+
+/* Usage: v = strview (s [,pos [,len]]) -- pos is a 1-based byte offset */
+static void strview_intrin (void)
+{
+   SLstr_Type *str;
+   SLstrlen_Type offset, len;
+   int n = 1, m = -1;
+   size_t ofs;
+
+   switch (SLang_Num_Function_Args)
+     {
+      case 3:
+	if (-1 == SLang_pop_integer (&m))
+	  return;
+	/* fall through */
+      case 2:
+	if (-1 == SLang_pop_integer (&n))
+	  return;
+	/* fall through */
+      case 1:
+	break;
+
+      default:
+	_pSLang_verror (SL_Usage_Error, "Usage: v = strview (s [,pos [,len]])");
+	return;
+     }
+
+   if (-1 == pop_bytes (&str, &offset, &len))
+     return;
+
+   /* As in substrbytes, out of range values are clipped */
+   ofs = (size_t) (n - 1);
+   if (ofs > len) ofs = len;
+   if ((m < 0) || ((size_t) m > len - ofs)) m = (int) (len - ofs);
+
+   (void) push_strview (create_strview (str, offset + (SLstrlen_Type) ofs, (SLstrlen_Type) m), 1);
+   _pSLang_free_slstring (str);
+}
+
+/* Usage: a = strview_chop (s, delim) */
+static void strview_chop_intrin (SLwchar_Type *delimp)
+{
+   SLuchar_Type delim[SLUTF8_MAX_MBLEN+1];
+   unsigned int delim_len;
+   SLstr_Type *str;
+   SLstrlen_Type offset, len;
+   SLuchar_Type *s, *s0, *smax;
+   SLstrlen_Type *ofs = NULL;
+   SLindex_Type n = 0, max = 0;
+
+   if (-1 == pop_bytes (&str, &offset, &len))
+     return;
+
+   if (NULL == _pSLinterp_encode_wchar (*delimp, delim, &delim_len))
+     goto free_and_return;
+
+   s0 = s = (SLuchar_Type *) str + offset;
+   smax = s + len;
+   while (1)
+     {
+	/* The UTF-8 encoding of a character cannot occur within the
+	 * encoding of another, so the delimiter may be found bytewise.
+	 */
+	while ((s < smax)
+	       && (NULL != (s = (SLuchar_Type *) SLmemchr ((char *) s, delim[0], (int) (smax - s))))
+	       && ((delim_len > (unsigned int) (smax - s))
+		   || (0 != memcmp ((char *) s, (char *) delim, delim_len))))
+	  s++;
+	if ((s == NULL) || (s >= smax))
+	  s = smax;
+
+	if (-1 == append_range (&ofs, &n, &max, (SLstrlen_Type) (s0 - (SLuchar_Type *) str),
+				(SLstrlen_Type) (s - s0)))
+	  goto free_and_return;
+
+	if (s == smax)
+	  break;
+	s0 = s = s + delim_len;
+     }
+
+   (void) SLang_push_array (create_strview_array (str, ofs, n), 1);
+
+free_and_return:
+   SLfree ((char *) ofs);
+   _pSLang_free_slstring (str);
+}
+
+static SLwchar_Lut_Type *pop_white_lut (int *invertp)
+{
+   SLwchar_Lut_Type *lut;
+   char *white;
+
+   *invertp = 0;
+   if (SLang_Num_Function_Args == 1)
+     {
+	if (WhiteSpace_Lut == NULL)
+	  WhiteSpace_Lut = SLwchar_strtolut ((SLuchar_Type *)"\\s", 1, 1);
+	return WhiteSpace_Lut;
+     }
+
+   if (-1 == SLang_pop_slstring (&white))
+     return NULL;
+   if (*white == '^')
+     *invertp = 1;
+   lut = SLwchar_strtolut ((SLuchar_Type *)white + *invertp, 1, 1);
+   _pSLang_free_slstring (white);
+   return lut;
+}
+
+/* Usage: a = strview_tok (s [,white]) */
+static void strview_tok_intrin (void)
+{
+   SLwchar_Lut_Type *lut;
+   SLstr_Type *str;
+   SLstrlen_Type offset, len;
+   SLuchar_Type *s, *s0, *smax;
+   SLstrlen_Type *ofs = NULL;
+   SLindex_Type n = 0, max = 0;
+   int invert;
+
+   if (NULL == (lut = pop_white_lut (&invert)))
+     return;
+
+   if (-1 == pop_bytes (&str, &offset, &len))
+     goto free_lut;
+
+   s = (SLuchar_Type *) str + offset;
+   smax = s + len;
+   while (s < smax)
+     {
+	s0 = SLwchar_skip_range (lut, s, smax, 0, invert);
+	if (s0 == smax)
+	  break;
+	s = SLwchar_skip_range (lut, s0, smax, 0, !invert);
+
+	if (-1 == append_range (&ofs, &n, &max, (SLstrlen_Type) (s0 - (SLuchar_Type *) str),
+				(SLstrlen_Type) (s - s0)))
+	  goto free_and_return;
+     }
+
+   (void) SLang_push_array (create_strview_array (str, ofs, n), 1);
+
+free_and_return:
+   SLfree ((char *) ofs);
+   _pSLang_free_slstring (str);
+free_lut:
+   if (lut != WhiteSpace_Lut)
+     SLwchar_free_lut (lut);
+}
+
+/* Usage: v = strview_trim (s [,white]) */
+static void strview_trim_intrin (void)
+{
+   SLwchar_Lut_Type *lut;
+   SLstr_Type *str;
+   SLstrlen_Type offset, len;
+   SLuchar_Type *a, *b;
+   int invert;
+
+   if (NULL == (lut = pop_white_lut (&invert)))
+     return;
+
+   if (0 == pop_bytes (&str, &offset, &len))
+     {
+	a = (SLuchar_Type *) str + offset;
+	b = a + len;
+	a = SLwchar_skip_range (lut, a, b, 0, invert);
+	b = SLwchar_bskip_range (lut, a, b, 0, invert);
+	(void) push_strview (create_strview (str, (SLstrlen_Type) (a - (SLuchar_Type *) str),
+					     (SLstrlen_Type) (b - a)), 1);
+	_pSLang_free_slstring (str);
+     }
+
+   if (lut != WhiteSpace_Lut)
+     SLwchar_free_lut (lut);
+}
+
+static SLang_Intrin_Fun_Type Intrin_Table [] =
+{
+   MAKE_INTRINSIC_0("strview", strview_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_1("strview_chop", strview_chop_intrin, SLANG_VOID_TYPE, SLANG_WCHAR_TYPE),
+   MAKE_INTRINSIC_0("strview_tok", strview_tok_intrin, SLANG_VOID_TYPE),
+   MAKE_INTRINSIC_0("strview_trim", strview_trim_intrin, SLANG_VOID_TYPE),
+   SLANG_END_INTRIN_FUN_TABLE
+};
+
+/* Returns the bytes of the ith element of an array of strings or views */
+static int get_nth_bytes (SLtype type, VOID_STAR p, SLuindex_Type i,
+			  SLCONST char **bytesp, SLstrlen_Type *lenp)
+{
+   if (type == SLANG_STRVIEW_TYPE)
+     {
+	StrView_Type *v = ((StrView_Type **) p)[i];
+	if (v == NULL)
+	  return -1;
+	*bytesp = VIEW_BYTES(v);
+	*lenp = v->len;
+	return 0;
+     }
+   else
+     {
+	SLstr_Type *s = ((SLstr_Type **) p)[i];
+	if (s == NULL)
+	  return -1;
+	*bytesp = s;
+	*lenp = (SLstrlen_Type) _pSLstring_bytelen (s);
+	return 0;
+     }
+}
+
+static int compare_bytes (SLCONST char *a, SLstrlen_Type na, SLCONST char *b, SLstrlen_Type nb)
+{
+   int ret = memcmp (a, b, (na < nb) ? na : nb);
+   if (ret != 0)
+     return ret;
+   if (na == nb)
+     return 0;
+   return (na < nb) ? -1 : 1;
+}
+
+static int strview_bin_op_result (int op, SLtype a, SLtype b, SLtype *c)
+{
+   (void) a;
+   (void) b;
+   switch (op)
+     {
+      default:
+	return 0;
+
+      case SLANG_PLUS:
+	*c = SLANG_STRING_TYPE;
+	break;
+
+      case SLANG_GT:
+      case SLANG_GE:
+      case SLANG_LT:
+      case SLANG_LE:
+      case SLANG_EQ:
+      case SLANG_NE:
+	*c = SLANG_CHAR_TYPE;
+	break;
+     }
+   return 1;
+}
+
+static int strview_bin_op (int op,
+			   SLtype a_type, VOID_STAR ap, SLuindex_Type na,
+			   SLtype b_type, VOID_STAR bp, SLuindex_Type nb,
+			   VOID_STAR cp)
+{
+   SLuindex_Type n, n_max, ia, ib;
+   char *ic = (char *) cp;
+   SLstr_Type **sc = (SLstr_Type **) cp;
+
+   n_max = (na > nb) ? na : nb;
+   for (n = 0; n < n_max; n++)
+     {
+	SLCONST char *a, *b;
+	SLstrlen_Type len_a, len_b;
+	int cmp;
+
+	ia = (na == 1) ? 0 : n;
+	ib = (nb == 1) ? 0 : n;
+	if ((-1 == get_nth_bytes (a_type, ap, ia, &a, &len_a))
+	    || (-1 == get_nth_bytes (b_type, bp, ib, &b, &len_b)))
+	  {
+	     _pSLang_verror (SL_VARIABLE_UNINITIALIZED,
+			     "String element[%lu] not initialized for binary operation", (unsigned long)n);
+	     goto return_error;
+	  }
+
+	if (op == SLANG_PLUS)
+	  {
+	     char *buf;
+
+	     /* The bytes of a view are not null terminated */
+	     if (NULL == (buf = (char *) SLmalloc (len_a + len_b + 1)))
+	       goto return_error;
+	     memcpy (buf, a, len_a);
+	     memcpy (buf + len_a, b, len_b);
+	     sc[n] = SLang_create_nslstring (buf, len_a + len_b);
+	     SLfree (buf);
+	     if (sc[n] == NULL)
+	       goto return_error;
+	     continue;
+	  }
+
+	cmp = compare_bytes (a, len_a, b, len_b);
+	switch (op)
+	  {
+	   case SLANG_EQ: ic[n] = (cmp == 0); break;
+	   case SLANG_NE: ic[n] = (cmp != 0); break;
+	   case SLANG_GT: ic[n] = (cmp > 0); break;
+	   case SLANG_GE: ic[n] = (cmp >= 0); break;
+	   case SLANG_LT: ic[n] = (cmp < 0); break;
+	   case SLANG_LE: ic[n] = (cmp <= 0); break;
+	  }
+     }
+   return 1;
+
+return_error:
+   if (op == SLANG_PLUS)
+     {
+	while (n > 0)
+	  {
+	     n--;
+	     _pSLang_free_slstring (sc[n]);
+	     sc[n] = NULL;
+	  }
+     }
+   return -1;
+}
+
+static int strview_to_string (SLtype a_type, VOID_STAR ap, SLuindex_Type na,
+			      SLtype b_type, VOID_STAR bp)
+{
+   StrView_Type **a = (StrView_Type **) ap;
+   SLstr_Type **s = (SLstr_Type **) bp;
+   SLuindex_Type i;
+
+   (void) a_type;
+   (void) b_type;
+
+   for (i = 0; i < na; i++)
+     {
+	if (a[i] == NULL)
+	  {
+	     s[i] = NULL;
+	     continue;
+	  }
+	if (NULL == (s[i] = SLang_create_nslstring (VIEW_BYTES(a[i]), a[i]->len)))
+	  {
+	     while (i != 0)
+	       {
+		  i--;
+		  _pSLang_free_slstring (s[i]);
+		  s[i] = NULL;
+	       }
+	     return -1;
+	  }
+     }
+   return 1;
+}
+
+static int strview_length (SLtype type, VOID_STAR v, SLuindex_Type *len)
+{
+   (void) type;
+   *len = (*(StrView_Type **) v)->len;
+   return 0;
+}
+
+static char *string_method (SLtype type, VOID_STAR p)
+{
+   StrView_Type *v;
+
+   (void) type;
+   v = *(StrView_Type **) p;
+   return SLmake_nstring (VIEW_BYTES(v), v->len);
+}
+
+static void cl_strview_destroy (SLtype type, VOID_STAR ptr)
+{
+   (void) type;
+   free_strview (*(StrView_Type **) ptr);
+}
+
+static int cl_strview_push (SLtype type, VOID_STAR ptr)
+{
+   (void) type;
+   return push_strview (*(StrView_Type **) ptr, 0);
+}
+
+int _pSLang_init_slstrvw (void)
+{
+   SLang_Class_Type *cl;
+
+   if (SLclass_is_class_defined (SLANG_STRVIEW_TYPE))
+     return 0;
+
+   if (NULL == (cl = SLclass_allocate_class ("StringView_Type")))
+     return -1;
+
+   (void) SLclass_set_destroy_function (cl, cl_strview_destroy);
+   (void) SLclass_set_push_function (cl, cl_strview_push);
+   (void) SLclass_set_string_function (cl, string_method);
+   cl->cl_length = strview_length;
+
+   if (-1 == SLclass_register_class (cl, SLANG_STRVIEW_TYPE, sizeof (StrView_Type), SLANG_CLASS_TYPE_PTR))
+     return -1;
+
+   if ((-1 == SLclass_add_typecast (SLANG_STRVIEW_TYPE, SLANG_STRING_TYPE, strview_to_string, 1))
+       || (-1 == SLclass_add_binary_op (SLANG_STRVIEW_TYPE, SLANG_STRVIEW_TYPE, strview_bin_op, strview_bin_op_result))
+       || (-1 == SLclass_add_binary_op (SLANG_STRVIEW_TYPE, SLANG_STRING_TYPE, strview_bin_op, strview_bin_op_result))
+       || (-1 == SLclass_add_binary_op (SLANG_STRING_TYPE, SLANG_STRVIEW_TYPE, strview_bin_op, strview_bin_op_result)))
+     return -1;
+
+   if (-1 == SLadd_intrin_fun_table (Intrin_Table, NULL))
+     return -1;
+
+   return 0;
+}
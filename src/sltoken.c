@@ -21,6 +21,19 @@ USA.
 
 #include "slinclud.h"
 
+#include <sys/types.h>
+#ifdef VMS
+# include <stat.h>
+#else
+# include <sys/stat.h>
+#endif
+#ifdef HAVE_FCNTL_H
+# include <fcntl.h>
+#endif
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+#endif
+
 #include "slang.h"
 #include "_slang.h"
 
@@ -1425,13 +1438,12 @@ int _pSLget_token (_pSLang_Token_Type *tok)
      }
 }
 
-static int prep_exists_function (SLprep_Type *pt, SLFUTURE_CONST char *line)
+static int exists_function (SLFUTURE_CONST char *line)
 {
    char buf[MAX_FILE_LINE_LEN+1], *b, *bmax;
    unsigned char ch;
    unsigned char comment;
 
-   (void) pt;
    bmax = buf + (sizeof (buf) - 1);
 
    comment = (unsigned char)'%';
@@ -1464,24 +1476,14 @@ static int prep_exists_function (SLprep_Type *pt, SLFUTURE_CONST char *line)
    return 0;
 }
 
-static int prep_eval_expr (SLprep_Type *pt, SLFUTURE_CONST char *expr)
+static int eval_expr (SLFUTURE_CONST char *expr1)
 {
    int ret;
-   SLCONST char *end;
    void (*compile)(_pSLang_Token_Type *);
-   char *expr1;
 #if SLANG_HAS_BOSEOS
    int boseos;
 #endif
 
-   (void) pt;
-   end = strchr (expr, '\n');
-   if (end == NULL)
-     end = expr + strlen (expr);
-   expr1 = SLmake_nstring (expr, (unsigned int) (end - expr));
-   if (expr1 == NULL)
-     return -1;
-
    compile = _pSLcompile_ptr;
    _pSLcompile_ptr = _pSLcompile;
 #if SLANG_HAS_BOSEOS
@@ -1498,11 +1500,59 @@ static int prep_eval_expr (SLprep_Type *pt, SLFUTURE_CONST char *expr)
    _pSLang_Compile_BOSEOS = boseos;
 #endif
    _pSLcompile_ptr = compile;
+   return ret;
+}
+
+/* The outcomes of these conditions are recorded when a bytecode image is
+ * produced.
+ */
+static int prep_exists_function (SLprep_Type *pt, SLFUTURE_CONST char *line)
+{
+   SLCONST char *end;
+   char *line1;
+   int ret;
 
+   (void) pt;
+   end = strchr (line, '\n');
+   if (end == NULL)
+     end = line + strlen (line);
+   if (NULL == (line1 = SLmake_nstring (line, (unsigned int) (end - line))))
+     return -1;
+
+   ret = exists_function (line1);
+   _pSLcompile_add_image_guard (_pSLIMAGE_GUARD_EXISTS, line1, ret);
+   SLfree (line1);
+   return ret;
+}
+
+static int prep_eval_expr (SLprep_Type *pt, SLFUTURE_CONST char *expr)
+{
+   SLCONST char *end;
+   char *expr1;
+   int ret;
+
+   (void) pt;
+   end = strchr (expr, '\n');
+   if (end == NULL)
+     end = expr + strlen (expr);
+   if (NULL == (expr1 = SLmake_nstring (expr, (unsigned int) (end - expr))))
+     return -1;
+
+   ret = eval_expr (expr1);
+   _pSLcompile_add_image_guard (_pSLIMAGE_GUARD_EVAL, expr1, ret);
    SLfree (expr1);
    return ret;
 }
 
+static int check_image_guard (int kind, SLFUTURE_CONST char *text)
+{
+   if (kind == _pSLIMAGE_GUARD_EXISTS)
+     return exists_function (text);
+   if (kind == _pSLIMAGE_GUARD_EVAL)
+     return eval_expr (text);
+   return -1;
+}
+
 int SLang_load_object (SLang_Load_Type *x)
 {
    SLprep_Type *this_pp;
@@ -1766,6 +1816,353 @@ int SLang_load_file_verbose (int v)
    return v1;
 }
 
+/*{{{ Bytecode images */
+
+/* When enabled via SLang_bytecode_cache, the compiled form of a loaded file
+ * is saved as a bytecode image in a file of the same name with a "c"
+ * appended, e.g., foo.slc for foo.sl.  The image consists of a header that
+ * identifies the source file and the library that produced it, followed by
+ * the data from _pSLcompile_end_image.  It is used in place of the source
+ * file only if the header matches, including the checksum of the data.
+ * Note that the preprocessor directives are evaluated when the image is
+ * produced and not when it is loaded.
+ */
+int _pSLang_Bytecode_Cache = SLANG_BYTECODE_CACHE_READ;
+int SLang_bytecode_cache (int mode)
+{
+   int mode1 = _pSLang_Bytecode_Cache;
+   _pSLang_Bytecode_Cache = mode;
+   return mode1;
+}
+
+#define IMAGE_MAGIC		"\033SLC"
+#define IMAGE_FORMAT		2
+#define IMAGE_BYTE_ORDER	0x01020304
+
+typedef struct
+{
+   char magic[4];
+   _pSLuint32_Type format;
+   _pSLuint32_Type version;	       /* SLANG_VERSION */
+   _pSLuint32_Type sizes;
+   _pSLuint32_Type byte_order;
+   _pSLuint32_Type compile_flags;
+   _pSLuint32_Type defines;	       /* the symbols for #ifdef */
+   _pSLuint32_Type source_mtime[2];    /* lo, hi */
+   _pSLuint32_Type source_size[2];
+   _pSLuint32_Type data_len;
+   _pSLuint32_Type checksum;	       /* Adler-32 of the data */
+}
+Image_Header_Type;
+
+typedef struct
+{
+   char *file;			       /* SLmalloced name of the image */
+   int write;			       /* non-zero if the image is to be written */
+   int have_source;
+   unsigned long source_mtime;
+   unsigned long source_size;
+   unsigned char *data;		       /* contents of the image file */
+   size_t data_size;
+   int is_mapped;
+}
+Bytecode_Image_Type;
+
+static void init_image_header (Image_Header_Type *h, Bytecode_Image_Type *im)
+{
+   SLFUTURE_CONST char **defines;
+   unsigned long defines_hash = 0;
+   unsigned int flags = 0;
+
+#if SLANG_HAS_BOSEOS
+   flags |= (_pSLang_Compile_BOSEOS & 0xFF) | ((_pSLang_Compile_BOFEOF & 0xFF) << 8);
+#endif
+   if (_pSLinterp_UTF8_Mode)
+     flags |= 0x10000;
+
+   /* The sum does not depend upon the order of the definitions */
+   for (defines = _pSLdefines; *defines != NULL; defines++)
+     defines_hash += _pSLstring_get_hash ((SLstr_Type *) *defines);
+
+   memset ((char *) h, 0, sizeof (Image_Header_Type));
+   memcpy (h->magic, IMAGE_MAGIC, 4);
+   h->format = IMAGE_FORMAT;
+   h->version = SLANG_VERSION;
+   h->sizes = sizeof (long) | (sizeof (double) << 8) | (sizeof (VOID_STAR) << 16);
+   h->byte_order = IMAGE_BYTE_ORDER;
+   h->compile_flags = flags;
+   h->defines = (_pSLuint32_Type) (defines_hash & 0xFFFFFFFFUL);
+   /* The shifts avoid a warning when long is 32 bits */
+   h->source_mtime[0] = (_pSLuint32_Type) (im->source_mtime & 0xFFFFFFFFUL);
+   h->source_mtime[1] = (_pSLuint32_Type) ((im->source_mtime >> 16) >> 16);
+   h->source_size[0] = (_pSLuint32_Type) (im->source_size & 0xFFFFFFFFUL);
+   h->source_size[1] = (_pSLuint32_Type) ((im->source_size >> 16) >> 16);
+}
+
+static int map_image_file (Bytecode_Image_Type *im)
+{
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+   struct stat st;
+   VOID_STAR addr;
+   int fd;
+
+   if (-1 == (fd = open (im->file, O_RDONLY)))
+     return -1;
+
+   if ((-1 == fstat (fd, &st)) || (st.st_size == 0))
+     {
+	(void) close (fd);
+	return -1;
+     }
+
+   addr = mmap (NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   (void) close (fd);
+   if (addr == MAP_FAILED)
+     return -1;
+
+   im->data = (unsigned char *) addr;
+   im->data_size = (size_t) st.st_size;
+   im->is_mapped = 1;
+   return 0;
+#else
+   FILE *fp;
+   long size;
+
+   if (NULL == (fp = fopen (im->file, "rb")))
+     return -1;
+
+   if ((0 != fseek (fp, 0, SEEK_END))
+       || (0 >= (size = ftell (fp)))
+       || (0 != fseek (fp, 0, SEEK_SET))
+       || (NULL == (im->data = (unsigned char *) SLmalloc ((unsigned int) size))))
+     {
+	fclose (fp);
+	return -1;
+     }
+   if (1 != fread (im->data, (size_t) size, 1, fp))
+     {
+	fclose (fp);
+	SLfree ((char *) im->data);
+	im->data = NULL;
+	return -1;
+     }
+   fclose (fp);
+   im->data_size = (size_t) size;
+   im->is_mapped = 0;
+   return 0;
+#endif
+}
+
+static void unmap_image_file (Bytecode_Image_Type *im)
+{
+   if (im->data == NULL)
+     return;
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+   if (im->is_mapped)
+     (void) munmap ((VOID_STAR) im->data, im->data_size);
+   else
+#endif
+     SLfree ((char *) im->data);
+   im->data = NULL;
+}
+
+static _pSLuint32_Type image_checksum (SLCONST unsigned char *data, size_t len)
+{
+   unsigned long a = 1, b = 0;
+
+   while (len)
+     {
+	/* 5552 is the most bytes that can be summed before b overflows */
+	size_t n = (len < 5552) ? len : 5552;
+	len -= n;
+	while (n--)
+	  {
+	     a += *data++;
+	     b += a;
+	  }
+	a %= 65521;
+	b %= 65521;
+     }
+   return (_pSLuint32_Type) ((b << 16) | a);
+}
+
+static int image_is_valid (Bytecode_Image_Type *im)
+{
+   Image_Header_Type h, h1;
+
+   if (im->data_size < sizeof (Image_Header_Type))
+     return 0;
+
+   memcpy ((char *) &h, im->data, sizeof (Image_Header_Type));
+   init_image_header (&h1, im);
+   if ((0 != memcmp (h.magic, h1.magic, 4))
+       || (h.format != h1.format)
+       || (h.version != h1.version)
+       || (h.sizes != h1.sizes)
+       || (h.byte_order != h1.byte_order)
+       || (h.compile_flags != h1.compile_flags)
+       || (h.defines != h1.defines)
+       || (h.data_len != im->data_size - sizeof (Image_Header_Type)))
+     return 0;
+
+   /* An image without its source file is used as is */
+   if (im->have_source
+       && ((h.source_mtime[0] != h1.source_mtime[0])
+	   || (h.source_mtime[1] != h1.source_mtime[1])
+	   || (h.source_size[0] != h1.source_size[0])
+	   || (h.source_size[1] != h1.source_size[1])))
+     return 0;
+
+   return (h.checksum == image_checksum (im->data + sizeof (Image_Header_Type), h.data_len));
+}
+
+/* Returns 1 if im->data holds a valid image of the named file, 0 if the
+ * file is to be compiled, or -1 upon error.  If the name is that of an image,
+ * it is replaced by the name of the source file, if any.
+ */
+static int check_bytecode_image (char **namep, Bytecode_Image_Type *im)
+{
+   char *name = *namep, *source;
+   char *ext = SLpath_extname (name);
+   unsigned int len = (unsigned int) strlen (name);
+   struct stat st;
+
+   if (0 == strcmp (ext, ".sl"))
+     {
+	if (NULL == (im->file = SLmalloc (len + 2)))
+	  return -1;
+	strcpy (im->file, name);
+	strcpy (im->file + len, "c");
+	source = name;
+     }
+   else if (0 == strcmp (ext, ".slc"))
+     {
+	if (NULL == (im->file = SLmake_string (name)))
+	  return -1;
+	if (NULL == (source = SLang_create_nslstring (name, len - 1)))
+	  return -1;
+     }
+   else return 0;
+
+   if (0 == stat (source, &st))
+     {
+	im->have_source = 1;
+	im->source_mtime = (unsigned long) st.st_mtime;
+	im->source_size = (unsigned long) st.st_size;
+     }
+
+   if (0 == map_image_file (im))
+     {
+	int is_image;
+
+	if ((_pSLang_Bytecode_Cache & SLANG_BYTECODE_CACHE_READ)
+	    && image_is_valid (im))
+	  {
+	     if (source != name)
+	       {
+		  if (im->have_source == 0)
+		    {
+		       SLang_free_slstring (source);
+		       return 1;
+		    }
+		  SLang_free_slstring (name);
+		  *namep = source;
+	       }
+	     return 1;
+	  }
+
+	is_image = ((im->data_size >= 4)
+		    && (0 == memcmp (im->data, IMAGE_MAGIC, 4)));
+	unmap_image_file (im);
+
+	/* Do not overwrite a file produced by SLang_byte_compile_file */
+	if (is_image == 0)
+	  {
+	     if (source != name)
+	       SLang_free_slstring (source);
+	     return 0;
+	  }
+
+	if (source != name)
+	  {
+	     if (im->have_source == 0)
+	       {
+		  _pSLang_verror (SL_OBJ_NOPEN, "%s: bytecode image is out of date", name);
+		  SLang_free_slstring (source);
+		  return -1;
+	       }
+	     SLang_free_slstring (name);
+	     *namep = source;
+	  }
+     }
+   else if (source != name)
+     SLang_free_slstring (source);
+
+   im->write = (im->have_source
+		&& (_pSLang_Bytecode_Cache & SLANG_BYTECODE_CACHE_WRITE));
+   return 0;
+}
+
+/* I/O errors are ignored since the image is only an optimization */
+static void write_bytecode_image (Bytecode_Image_Type *im, unsigned char *data, unsigned int len)
+{
+   Image_Header_Type h;
+   char *tmpfile;
+   FILE *fp;
+   int ok;
+
+   if (NULL == (tmpfile = SLmalloc (strlen (im->file) + 32)))
+     return;
+#ifdef REAL_UNIX_SYSTEM
+   sprintf (tmpfile, "%s.%lu", im->file, (unsigned long) getpid ());
+#else
+   sprintf (tmpfile, "%s.tmp", im->file);
+#endif
+
+   init_image_header (&h, im);
+   h.data_len = len;
+   h.checksum = image_checksum (data, len);
+
+   if (NULL == (fp = fopen (tmpfile, "wb")))
+     {
+	SLfree (tmpfile);
+	return;
+     }
+   ok = ((1 == fwrite ((char *) &h, sizeof (Image_Header_Type), 1, fp))
+	 && (1 == fwrite ((char *) data, len, 1, fp)));
+   if (EOF == fclose (fp))
+     ok = 0;
+
+   if ((ok == 0) || (0 != rename (tmpfile, im->file)))
+     (void) remove (tmpfile);
+   SLfree (tmpfile);
+}
+
+/* Returns 1 if the image was loaded, 0 if it cannot be used, or -1 upon error */
+static int load_bytecode_image (SLang_Load_Type *x, Bytecode_Image_Type *im)
+{
+#if SLANG_HAS_BOSEOS
+   int save_compile_boseos = _pSLang_Compile_BOSEOS;
+   int save_compile_bofeof = _pSLang_Compile_BOFEOF;
+#endif
+   int save_auto_declare_variables = _pSLang_Auto_Declare_Globals;
+   int status;
+
+   /* As in SLang_load_object */
+   _pSLang_Auto_Declare_Globals = x->auto_declare_globals;
+   status = _pSLcompile_load_image (x, im->data + sizeof (Image_Header_Type),
+				    (unsigned int) (im->data_size - sizeof (Image_Header_Type)),
+				    check_image_guard);
+   _pSLang_Auto_Declare_Globals = save_auto_declare_variables;
+#if SLANG_HAS_BOSEOS
+   _pSLang_Compile_BOSEOS = save_compile_boseos;
+   _pSLang_Compile_BOFEOF = save_compile_bofeof;
+#endif
+   return status;
+}
+
+/*}}}*/
+
 /* Note that file could be freed from Slang during run of this routine
  * so get it and store it !! (e.g., autoloading)
  */
@@ -1779,6 +2176,7 @@ int SLang_load_file (SLFUTURE_CONST char *f)
 int SLns_load_file (SLFUTURE_CONST char *f, SLFUTURE_CONST char *ns_name)
 {
    File_Client_Data_Type client_data;
+   Bytecode_Image_Type image;
    SLang_Load_Type *x;
    char *name, *buf;
    FILE *fp;
@@ -1797,13 +2195,49 @@ int SLns_load_file (SLFUTURE_CONST char *f, SLFUTURE_CONST char *ns_name)
    if (name == NULL)
      return -1;
 
+   memset ((char *) &image, 0, sizeof (Bytecode_Image_Type));
+   if ((f != NULL) && _pSLang_Bytecode_Cache
+       /* SLang_byte_compile_file does not compile the file */
+       && (_pSLcompile_ptr == _pSLcompile)
+       && (-1 == check_bytecode_image (&name, &image)))
+     {
+	SLfree (image.file);
+	SLang_free_slstring (name);
+	return -1;
+     }
+
    if (NULL == (x = SLns_allocate_load_type (name, ns_name)))
      {
+	unmap_image_file (&image);
+	SLfree (image.file);
 	SLang_free_slstring (name);
 	return -1;
      }
 
    buf = NULL;
+   fp = NULL;
+
+   if (image.data != NULL)
+     {
+	int status;
+
+	if (_pSLang_Load_File_Verbose & SLANG_LOAD_FILE_VERBOSE)
+	  SLang_vmessage ("Loading %s", image.file);
+	status = load_bytecode_image (x, &image);
+	unmap_image_file (&image);
+	if (status != 0)
+	  goto free_return;
+
+	/* The conditions upon which the image depends have changed, or the
+	 * image is corrupt.
+	 */
+	if (image.have_source == 0)
+	  {
+	     _pSLang_verror (SL_OBJ_NOPEN, "%s: bytecode image is out of date", image.file);
+	     goto free_return;
+	  }
+	image.write = (_pSLang_Bytecode_Cache & SLANG_BYTECODE_CACHE_WRITE);
+     }
 
    if (f != NULL)
      {
@@ -1829,13 +2263,28 @@ int SLns_load_file (SLFUTURE_CONST char *f, SLFUTURE_CONST char *ns_name)
 	x->client_data = (VOID_STAR) &client_data;
 	x->read = read_from_file;
 
+	if (image.write)
+	  _pSLcompile_start_image ();
 	(void) SLang_load_object (x);
+	if (image.write)
+	  {
+	     unsigned char *data;
+	     unsigned int len;
+
+	     if (NULL != (data = _pSLcompile_end_image (&len)))
+	       {
+		  write_bytecode_image (&image, data, len);
+		  SLfree ((char *) data);
+	       }
+	  }
      }
 
+free_return:
    if ((fp != NULL) && (fp != stdin))
      fclose (fp);
 
    SLfree (buf);
+   SLfree (image.file);
    SLang_free_slstring (name);
    SLdeallocate_load_type (x);
 
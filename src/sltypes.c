@@ -598,7 +598,7 @@ static int ref_push (SLtype type, VOID_STAR ptr)
 
 int SLang_assign_to_ref (SLang_Ref_Type *ref, SLtype type, VOID_STAR v)
 {
-   SLang_Object_Type *stkptr;
+   int depth;
    SLang_Class_Type *cl;
 
    cl = _pSLclass_get_class (type);
@@ -623,11 +623,11 @@ int SLang_assign_to_ref (SLang_Ref_Type *ref, SLtype type, VOID_STAR v)
    if (-1 == (*cl->cl_apush) (type, v))
      return -1;
 
-   stkptr = _pSLang_get_run_stack_pointer ();
+   depth = SLstack_depth ();
    if (0 == _pSLang_deref_assign (ref))
      return 0;
 
-   if (stkptr != _pSLang_get_run_stack_pointer ())
+   if (depth != SLstack_depth ())
      SLdo_pop ();
 
    return -1;
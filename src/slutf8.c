@@ -24,6 +24,10 @@ USA.
 #include "slang.h"
 #include "_slang.h"
 
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
 static unsigned char Len_Map[256] =
 {
   0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,  /* - 31 */
@@ -116,6 +120,62 @@ static SLwchar_Type fast_utf8_decode (SLuchar_Type *u, unsigned int len)
    return w;
 }
 
+/* Strings are often mostly ASCII.  The following functions skip over a
+ * run of bytes that do not have the high bit set, testing several bytes at
+ * a time.  They return a pointer to the first (or, for bskip_ascii, one
+ * past the last) non-ASCII byte, or to the end of the region.
+ */
+#define ASCII_WORD_ONES	(~(unsigned long)0 / 0xFF)
+#define ASCII_WORD_HIGH	(ASCII_WORD_ONES * 0x80)
+
+static SLuchar_Type *skip_ascii (SLuchar_Type *s, SLuchar_Type *smax)
+{
+#if defined(__SSE2__)
+   while (s + 16 <= smax)
+     {
+	if (_mm_movemask_epi8 (_mm_loadu_si128 ((__m128i *) s)))
+	  break;
+	s += 16;
+     }
+#else
+   while (s + sizeof (unsigned long) <= smax)
+     {
+	unsigned long w;
+	memcpy ((char *) &w, (char *) s, sizeof (unsigned long));
+	if (w & ASCII_WORD_HIGH)
+	  break;
+	s += sizeof (unsigned long);
+     }
+#endif
+   while ((s < smax) && (*s < 0x80))
+     s++;
+   return s;
+}
+
+static SLuchar_Type *bskip_ascii (SLuchar_Type *smin, SLuchar_Type *s)
+{
+#if defined(__SSE2__)
+   while (s >= smin + 16)
+     {
+	if (_mm_movemask_epi8 (_mm_loadu_si128 ((__m128i *) (s - 16))))
+	  break;
+	s -= 16;
+     }
+#else
+   while (s >= smin + sizeof (unsigned long))
+     {
+	unsigned long w;
+	memcpy ((char *) &w, (char *) (s - sizeof (unsigned long)), sizeof (unsigned long));
+	if (w & ASCII_WORD_HIGH)
+	  break;
+	s -= sizeof (unsigned long);
+     }
+#endif
+   while ((s > smin) && (s[-1] < 0x80))
+     s--;
+   return s;
+}
+
 unsigned char *SLutf8_skip_char (unsigned char *s, unsigned char *smax)
 {
    unsigned int len;
@@ -145,8 +205,20 @@ SLuchar_Type *SLutf8_skip_chars (SLuchar_Type *s, SLuchar_Type *smax,
    n = 0;
    while ((n < num) && (s < smax))
      {
-	unsigned int len = Len_Map[*s];
+	unsigned int len;
+
+	if (*s < 0x80)
+	  {
+	     SLuchar_Type *s1 = smax;
+	     if ((SLstrlen_Type) (smax - s) > num - n)
+	       s1 = s + (num - n);
+	     s1 = skip_ascii (s + 1, s1);
+	     n += (SLstrlen_Type) (s1 - s);
+	     s = s1;
+	     continue;
+	  }
 
+	len = Len_Map[*s];
 	if (len <= 1)
 	  {
 	     n++;
@@ -219,8 +291,12 @@ SLuchar_Type *SLutf8_bskip_chars (SLuchar_Type *smin, SLuchar_Type *s,
 	ch = *s;
 	if (ch < 0x80)
 	  {
-	     n++;
-	     smax = s;
+	     SLuchar_Type *s0 = smin;
+	     if ((SLstrlen_Type) (s - smin) > num - n - 1)
+	       s0 = s - (num - n - 1);
+	     s0 = bskip_ascii (s0, s);
+	     n += 1 + (SLstrlen_Type) (s - s0);
+	     s = smax = s0;
 	     continue;
 	  }
 
@@ -0,0 +1,286 @@
+/* Benchmark for the string hash function.  For several sets of keys, it
+ * measures the rate of hashing, interning and looking up strings, and of
+ * inserting and looking up associative array keys.  It also shows how the
+ * keys are distributed among the buckets of a table whose size is the
+ * smallest power of 2 not less than the number of keys, compared with
+ * what a random hash would give.  To compare the hash functions, build
+ * the library with the different values of SLSTRING_HASH_FUNCTION (see
+ * sllimits.h), then
+ *
+ *   make hashbench
+ *   ./hashbench [num_keys]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <slang.h>
+
+#define MAX_KEY_LEN	256
+#define MAX_CHAIN_BIN	8
+
+static SLFUTURE_CONST char *Prefixes[] =
+{
+   "SLang", "get", "set", "is", "push", "pop", "create", "free", "find", "_pSL"
+};
+static SLFUTURE_CONST char *Nouns[] =
+{
+   "string", "array", "value", "list", "struct", "name", "table", "key",
+   "buffer", "object", "index", "hash"
+};
+
+static void make_identifier (char *buf, unsigned int i)
+{
+   unsigned int np = sizeof(Prefixes)/sizeof(Prefixes[0]);
+   unsigned int nn = sizeof(Nouns)/sizeof(Nouns[0]);
+
+   sprintf (buf, "%s_%s%u", Prefixes[i % np], Nouns[(i / np) % nn], i / (np * nn));
+}
+
+static void make_integer (char *buf, unsigned int i)
+{
+   sprintf (buf, "%u", i);
+}
+
+static void make_hex_id (char *buf, unsigned int i)
+{
+   sprintf (buf, "user-%08lx", (unsigned long) (i * 2654435761UL) & 0xFFFFFFFFUL);
+}
+
+static void make_path (char *buf, unsigned int i)
+{
+   sprintf (buf, "/usr/local/share/slsh/local-packages/mod%u/src/file%u.sl", i / 100, i % 100);
+}
+
+static void make_log_line (char *buf, unsigned int i)
+{
+   sprintf (buf, "2021-06-%02u 12:%02u:%02u GET /api/v1/items/%u?page=%u HTTP/1.1 200 %u \"Mozilla/5.0 (X11; Linux x86_64)\"",
+	    1 + i % 28, (i / 60) % 60, i % 60, i, i % 17, 100 + i % 9000);
+}
+
+typedef struct
+{
+   SLFUTURE_CONST char *name;
+   void (*make_key) (char *, unsigned int);
+}
+Key_Set_Type;
+
+static Key_Set_Type Key_Sets[] =
+{
+   {"identifiers", make_identifier},
+   {"integers", make_integer},
+   {"hex ids", make_hex_id},
+   {"paths", make_path},
+   {"log lines", make_log_line},
+   {NULL, NULL}
+};
+
+static double seconds (clock_t t0)
+{
+   return (double) (clock () - t0) / CLOCKS_PER_SEC;
+}
+
+/* Prints the rate in millions of operations per second */
+static void print_rate (SLFUTURE_CONST char *what, unsigned long n, double t)
+{
+   if (t <= 0.0)
+     fprintf (stdout, "  %-14s      -\n", what);
+   else
+     fprintf (stdout, "  %-14s %6.2f M/s\n", what, 1e-6 * n / t);
+}
+
+static void bench_hash (char **keys, unsigned int n)
+{
+   unsigned int reps = 1 + 4000000 / n;
+   unsigned int r, i;
+   unsigned long sum = 0;
+   clock_t t0 = clock ();
+
+   for (r = 0; r < reps; r++)
+     {
+	for (i = 0; i < n; i++)
+	  sum += SLcompute_string_hash (keys[i]);
+     }
+   print_rate ("hash", (unsigned long) reps * n, seconds (t0));
+   if (sum == 1) fputc (' ', stdout);	       /* keep the loop */
+}
+
+static int bench_intern (char **keys, unsigned int n, SLstr_Type **sls)
+{
+   unsigned int i;
+   clock_t t0;
+
+   t0 = clock ();
+   for (i = 0; i < n; i++)
+     {
+	if (NULL == (sls[i] = SLang_create_slstring (keys[i])))
+	  return -1;
+     }
+   print_rate ("intern", n, seconds (t0));
+
+   t0 = clock ();
+   for (i = 0; i < n; i++)
+     {
+	SLstr_Type *s = SLang_create_slstring (keys[i]);
+	if (s != sls[i])
+	  {
+	     fprintf (stderr, "intern lookup of %s failed\n", keys[i]);
+	     return -1;
+	  }
+	SLang_free_slstring (s);
+     }
+   print_rate ("intern lookup", n, seconds (t0));
+   return 0;
+}
+
+static int bench_assoc (SLstr_Type **sls, unsigned int n)
+{
+   SLang_Assoc_Array_Type *a;
+   unsigned int i;
+   clock_t t0;
+   int ret = -1;
+
+   if (NULL == (a = SLang_create_assoc (SLANG_INT_TYPE, 0)))
+     return -1;
+
+   t0 = clock ();
+   for (i = 0; i < n; i++)
+     {
+	if ((-1 == SLang_push_int ((int) i))
+	    || (-1 == SLang_assoc_put (a, sls[i])))
+	  goto free_and_return;
+     }
+   print_rate ("assoc insert", n, seconds (t0));
+
+   t0 = clock ();
+   for (i = 0; i < n; i++)
+     {
+	int v;
+	if ((-1 == SLang_assoc_get (a, sls[i], NULL))
+	    || (-1 == SLang_pop_int (&v)))
+	  goto free_and_return;
+	if (v != (int) i)
+	  {
+	     fprintf (stderr, "assoc lookup of %s failed\n", sls[i]);
+	     goto free_and_return;
+	  }
+     }
+   print_rate ("assoc lookup", n, seconds (t0));
+   ret = 0;
+
+free_and_return:
+   SLang_free_assoc (a);
+   return ret;
+}
+
+static int show_chains (char **keys, unsigned int n)
+{
+   unsigned long num_buckets = 1;
+   unsigned int *counts, max_chain = 0;
+   unsigned long bins[MAX_CHAIN_BIN + 1];
+   double load, p;
+   unsigned int i;
+
+   while (num_buckets < n)
+     num_buckets *= 2;
+   if (NULL == (counts = (unsigned int *) calloc (num_buckets, sizeof (unsigned int))))
+     return -1;
+
+   for (i = 0; i < n; i++)
+     counts[SLcompute_string_hash (keys[i]) & (num_buckets - 1)]++;
+
+   memset ((char *) bins, 0, sizeof (bins));
+   for (i = 0; i < num_buckets; i++)
+     {
+	unsigned int c = counts[i];
+	if (c > max_chain) max_chain = c;
+	if (c > MAX_CHAIN_BIN) c = MAX_CHAIN_BIN;
+	bins[c]++;
+     }
+   free (counts);
+
+   load = (double) n / num_buckets;
+   fprintf (stdout, "  chains: %lu buckets, load %.2f, longest %u\n", num_buckets, load, max_chain);
+   fprintf (stdout, "    length   buckets  random\n");
+   p = exp (-load);		       /* Poisson probability of 0 */
+   for (i = 0; i <= MAX_CHAIN_BIN; i++)
+     {
+	fprintf (stdout, "    %s%-5u %7.3f%% %7.3f%%\n", (i == MAX_CHAIN_BIN ? ">=" : "  "), i,
+		 100.0 * bins[i] / num_buckets, 100.0 * p);
+	p = p * load / (i + 1);
+     }
+   return 0;
+}
+
+static int run_key_set (Key_Set_Type *ks, unsigned int n)
+{
+   char **keys;
+   SLstr_Type **sls;
+   char buf[MAX_KEY_LEN];
+   unsigned int i;
+   unsigned long num_bytes = 0;
+   int ret = -1;
+
+   keys = (char **) calloc (n, sizeof (char *));
+   sls = (SLstr_Type **) calloc (n, sizeof (SLstr_Type *));
+   if ((keys == NULL) || (sls == NULL))
+     goto free_and_return;
+
+   for (i = 0; i < n; i++)
+     {
+	(*ks->make_key) (buf, i);
+	num_bytes += strlen (buf);
+	if (NULL == (keys[i] = (char *) malloc (strlen (buf) + 1)))
+	  goto free_and_return;
+	strcpy (keys[i], buf);
+     }
+
+   fprintf (stdout, "%s: %u keys, mean length %.1f, e.g. %s\n",
+	    ks->name, n, (double) num_bytes / n, keys[n/2]);
+
+   bench_hash (keys, n);
+   if ((-1 == bench_intern (keys, n, sls))
+       || (-1 == bench_assoc (sls, n))
+       || (-1 == show_chains (keys, n)))
+     goto free_and_return;
+   fputc ('\n', stdout);
+   ret = 0;
+
+free_and_return:
+   for (i = 0; i < n; i++)
+     {
+	if (keys != NULL) free (keys[i]);
+	if (sls != NULL) SLang_free_slstring (sls[i]);
+     }
+   free (keys);
+   free (sls);
+   return ret;
+}
+
+int main (int argc, char **argv)
+{
+   unsigned int n = 200000;
+   Key_Set_Type *ks;
+
+   if (argc > 1)
+     n = (unsigned int) atoi (argv[1]);
+   if ((argc > 2) || (n == 0))
+     {
+	fprintf (stderr, "Usage: %s [num_keys]\n", argv[0]);
+	return 1;
+     }
+
+   if (-1 == SLang_init_all ())
+     return 1;
+
+   for (ks = Key_Sets; ks->name != NULL; ks++)
+     {
+	if (-1 == run_key_set (ks, n))
+	  {
+	     fprintf (stderr, "%s: benchmark failed\n", ks->name);
+	     return 1;
+	  }
+     }
+   return 0;
+}
@@ -0,0 +1,99 @@
+#define MAX_API_INTERPS 8
+static SLang_Interp_Type *Api_Interps[MAX_API_INTERPS];
+
+static int api_interp_new (void)
+{
+   int i;
+
+   for (i = 0; i < MAX_API_INTERPS; i++)
+     {
+	if (Api_Interps[i] != NULL)
+	  continue;
+
+	if (NULL == (Api_Interps[i] = SLang_create_interp ()))
+	  {
+	     SLang_verror (SL_Any_Error, "Failed: SLang_create_interp");
+	     return -1;
+	  }
+	return i;
+     }
+   SLang_verror (SL_LimitExceeded_Error, "Too many interpreter instances");
+   return -1;
+}
+
+static SLang_Interp_Type *get_api_interp (int i)
+{
+   if ((i < 0) || (i >= MAX_API_INTERPS) || (Api_Interps[i] == NULL))
+     {
+	SLang_verror (SL_Index_Error, "Invalid interpreter instance %d", i);
+	return NULL;
+     }
+   return Api_Interps[i];
+}
+
+static void api_interp_free (int *ip)
+{
+   SLang_Interp_Type *interp;
+
+   if (NULL == (interp = get_api_interp (*ip)))
+     return;
+
+   SLang_free_interp (interp);
+   Api_Interps[*ip] = NULL;
+}
+
+/* Evaluate the string in another instance, and return the value that it
+ * left on the stack, or NULL if none.  Errors propagate to the caller.
+ */
+static void api_interp_eval (int *ip, char *str)
+{
+   SLang_Interp_Type *interp, *current;
+   SLang_Any_Type *any = NULL;
+   int status;
+
+   if (NULL == (interp = get_api_interp (*ip)))
+     return;
+
+   current = SLang_get_interp ();
+   (void) SLang_set_interp (interp);
+   status = SLang_load_string (str);
+   if ((status == 0) && (SLstack_depth () > 0))
+     status = SLang_pop_anytype (&any);
+   (void) SLang_set_interp (current);
+
+   if (SLang_get_interp () != current)
+     SLang_verror (SL_Any_Error, "Failed: SLang_set_interp");
+
+   if (status == -1)
+     return;
+
+   if (any == NULL)
+     {
+	(void) SLang_push_null ();
+	return;
+     }
+   (void) SLang_push_anytype (any);
+   SLang_free_anytype (any);
+}
+
+static int api_interp_table_fun (void)
+{
+   return 1;
+}
+
+static SLang_Intrin_Fun_Type Api_Interp_Table [] =
+{
+   MAKE_INTRINSIC_0("api_interp_table_fun", api_interp_table_fun, SLANG_INT_TYPE),
+   SLANG_END_INTRIN_FUN_TABLE
+};
+
+static void api_interp_add_table (void)
+{
+   (void) SLadd_intrin_fun_table (Api_Interp_Table, NULL);
+}
+
+#define INTERP_API_TEST_INTRINSICS \
+   MAKE_INTRINSIC_0("api_interp_new", api_interp_new, SLANG_INT_TYPE), \
+   MAKE_INTRINSIC_I("api_interp_free", api_interp_free, SLANG_VOID_TYPE), \
+   MAKE_INTRINSIC_IS("api_interp_eval", api_interp_eval, SLANG_VOID_TYPE), \
+   MAKE_INTRINSIC_0("api_interp_add_table", api_interp_add_table, SLANG_VOID_TYPE)
@@ -0,0 +1,276 @@
+/* Benchmark for SLsearch_forward.  It searches a text of English-like
+ * words for keys of several lengths, both case-sensitively and
+ * case-insensitively, counts all of the matches, and prints the rate at
+ * which the text was scanned.  For each length, eight keys are taken from
+ * the text, and eight more keys that do not occur in it are made by
+ * changing the byte in the middle of each.  The counts are checked
+ * against a simple search.  For comparison, the rate of strstr is shown
+ * for the case-sensitive searches.  To compare the search algorithms, build the library with the
+ * different values of SLSEARCH_FIRST_LAST_FILTER (see sllimits.h), then
+ *
+ *   make searchbench
+ *   ./searchbench [text_size]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <slang.h>
+
+#define MAX_KEY_LEN	256
+#define NUM_KEYS	8
+
+static SLFUTURE_CONST char *Words[] =
+{
+   "the", "of", "and", "a", "to", "in", "is", "you", "that", "it", "he",
+   "was", "for", "on", "are", "as", "with", "his", "they", "at", "be",
+   "this", "have", "from", "or", "one", "had", "by", "word", "but", "not",
+   "what", "all", "were", "we", "when", "your", "can", "said", "there",
+   "string", "search", "interpreter", "array", "function", "variable",
+   "structure", "namespace", "expression", "character", "buffer", "window"
+};
+
+static unsigned long Seed = 12345;
+
+static unsigned int next_random (void)
+{
+   Seed = Seed * 1103515245UL + 12345UL;
+   return (unsigned int) ((Seed >> 16) & 0x7FFF);
+}
+
+static char *make_text (unsigned int len)
+{
+   unsigned int nwords = sizeof(Words)/sizeof(Words[0]);
+   unsigned int i = 0;
+   char *text;
+
+   if (NULL == (text = (char *) malloc (len + 1)))
+     return NULL;
+
+   while (i < len)
+     {
+	SLFUTURE_CONST char *w = Words[next_random () % nwords];
+	unsigned int r = next_random ();
+	unsigned int j = 0;
+
+	while ((w[j] != 0) && (i < len))
+	  {
+	     char ch = w[j];
+	     if ((j == 0) && (r % 8 == 0))
+	       ch = UPPER_CASE(ch);
+	     text[i++] = ch;
+	     j++;
+	  }
+	if (i < len)
+	  text[i++] = ((r % 16) == 0) ? '\n' : ' ';
+     }
+   text[len] = 0;
+   return text;
+}
+
+static double seconds (clock_t t0)
+{
+   return (double) (clock () - t0) / CLOCKS_PER_SEC;
+}
+
+static int keys_match (SLuchar_Type *p, SLuchar_Type *key, unsigned int len, int caseless)
+{
+   unsigned int i;
+
+   for (i = 0; i < len; i++)
+     {
+	if (p[i] == key[i])
+	  continue;
+	if (caseless && (UPPER_CASE(p[i]) == UPPER_CASE(key[i])))
+	  continue;
+	return 0;
+     }
+   return 1;
+}
+
+static unsigned long simple_count (SLuchar_Type *text, unsigned int text_len,
+				   SLuchar_Type *key, unsigned int key_len, int caseless)
+{
+   unsigned long count = 0;
+   unsigned int i;
+
+   for (i = 0; i + key_len <= text_len; i++)
+     count += keys_match (text + i, key, key_len, caseless);
+   return count;
+}
+
+static unsigned long search_count (SLsearch_Type *st, SLuchar_Type *text, unsigned int text_len)
+{
+   SLuchar_Type *p = text, *pmax = text + text_len;
+   unsigned long count = 0;
+
+   while (NULL != (p = SLsearch_forward (st, p, pmax)))
+     {
+	count++;
+	p++;
+     }
+   return count;
+}
+
+static unsigned long strstr_count (char *text, char *key)
+{
+   unsigned long count = 0;
+
+   while (NULL != (text = strstr (text, key)))
+     {
+	count++;
+	text++;
+     }
+   return count;
+}
+
+/* Prints the rate in megabytes per second */
+static void print_rate (double bytes, double t)
+{
+   if (t <= 0.0)
+     fprintf (stdout, "        -");
+   else
+     fprintf (stdout, " %8.0f", 1e-6 * bytes / t);
+}
+
+/* Search for each of the num_keys keys and print the total number of
+ * matches, and the rate for all of the keys.
+ */
+static int bench_keys (char *text, unsigned int text_len, char **keys, unsigned int num_keys,
+		       int caseless)
+{
+   unsigned int key_len = strlen (keys[0]);
+   unsigned int reps = 1 + (16 * 1024 * 1024) / text_len;
+   unsigned long count, expected, total;
+   double t, tstrstr;
+   unsigned int k, r;
+   clock_t t0;
+   int flags = caseless ? SLSEARCH_CASELESS : 0;
+
+   total = 0;
+   t = tstrstr = 0.0;
+   for (k = 0; k < num_keys; k++)
+     {
+	char *key = keys[k];
+	SLsearch_Type *st;
+
+	if (NULL == (st = SLsearch_new ((SLuchar_Type *) key, flags)))
+	  return -1;
+
+	expected = simple_count ((SLuchar_Type *) text, text_len, (SLuchar_Type *) key, key_len, caseless);
+	total += expected;
+
+	count = 0;
+	t0 = clock ();
+	for (r = 0; r < reps; r++)
+	  count += search_count (st, (SLuchar_Type *) text, text_len);
+	t += seconds (t0);
+	SLsearch_delete (st);
+
+	if (count != reps * expected)
+	  {
+	     fprintf (stderr, "SLsearch_forward found %lu matches of \"%s\", not %lu\n",
+		      count / reps, key, expected);
+	     return -1;
+	  }
+
+	if (caseless)
+	  continue;
+
+	count = 0;
+	t0 = clock ();
+	for (r = 0; r < reps; r++)
+	  count += strstr_count (text, key);
+	tstrstr += seconds (t0);
+	if (count != reps * expected)
+	  {
+	     fprintf (stderr, "strstr found %lu matches of \"%s\", not %lu\n",
+		      count / reps, key, expected);
+	     return -1;
+	  }
+     }
+
+   fprintf (stdout, "  %4u  %-9s %8lu", key_len, caseless ? "caseless" : "case", total);
+   print_rate ((double) reps * num_keys * text_len, t);
+   if (caseless == 0)
+     print_rate ((double) reps * num_keys * text_len, tstrstr);
+   fputc ('\n', stdout);
+   return 0;
+}
+
+static int run_keys (char *text, unsigned int text_len, int caseless)
+{
+   static unsigned int Key_Lens[] = {1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 128, MAX_KEY_LEN};
+   char keys[NUM_KEYS][MAX_KEY_LEN + 1];
+   char *key_ptrs[NUM_KEYS];
+   unsigned int i, j, k, missing;
+
+   for (missing = 0; missing < 2; missing++)
+     {
+	fprintf (stdout, "%s keys:\n", missing ? "Missing" : "Present");
+	fprintf (stdout, "  %4s  %-9s %8s %8s %8s\n", "len", "mode", "matches",
+		 "MB/s", caseless ? "" : "strstr");
+	for (i = 0; i < sizeof(Key_Lens)/sizeof(Key_Lens[0]); i++)
+	  {
+	     unsigned int len = Key_Lens[i];
+
+	     if (len > text_len / 2)
+	       continue;
+	     /* Take the keys from the second half of the text */
+	     for (k = 0; k < NUM_KEYS; k++)
+	       {
+		  char *key = keys[k];
+		  unsigned int pos = text_len / 2 + (k * (text_len / 2 - len)) / NUM_KEYS;
+
+		  memcpy (key, text + pos, len);
+		  key[len] = 0;
+		  if (missing)
+		    key[len / 2] = '#';
+		  if (caseless)
+		    {
+		       for (j = 0; j < len; j++)
+			 key[j] = (j % 2) ? LOWER_CASE(key[j]) : UPPER_CASE(key[j]);
+		    }
+		  key_ptrs[k] = key;
+	       }
+	     if (-1 == bench_keys (text, text_len, key_ptrs, NUM_KEYS, caseless))
+	       return -1;
+	  }
+     }
+   return 0;
+}
+
+int main (int argc, char **argv)
+{
+   unsigned int text_len = 4 * 1024 * 1024;
+   char *text;
+   int caseless;
+
+   if (argc > 1)
+     text_len = (unsigned int) atoi (argv[1]);
+   if ((argc > 2) || (text_len < 16))
+     {
+	fprintf (stderr, "Usage: %s [text_size]\n", argv[0]);
+	return 1;
+     }
+
+   if (-1 == SLang_init_all ())
+     return 1;
+   SLang_init_case_tables ();
+
+   if (NULL == (text = make_text (text_len)))
+     return 1;
+
+   fprintf (stdout, "Searching %u bytes of text\n", text_len);
+   for (caseless = 0; caseless < 2; caseless++)
+     {
+	if (-1 == run_keys (text, text_len, caseless))
+	  {
+	     fprintf (stderr, "benchmark failed\n");
+	     free (text);
+	     return 1;
+	  }
+     }
+   free (text);
+   return 0;
+}
@@ -506,6 +506,7 @@ static int invoke_interrupts (void)
 
 #include "assoc.c"
 #include "list.c"
+#include "interp.c"
 
 static void fake_import (char *);
 static SLang_Intrin_Fun_Type Intrinsics [] =
@@ -543,6 +544,7 @@ static SLang_Intrin_Fun_Type Intrinsics [] =
 
    ASSOC_API_TEST_INTRINSICS,
    LIST_API_TEST_INTRINSICS,
+   INTERP_API_TEST_INTRINSICS,
 
    SLANG_END_INTRIN_FUN_TABLE
 };